@@ -16,6 +16,7 @@
 #include <SharedUtil.h>
 #include <HifiConfigVariantMap.h>
 #include <ShutdownEventListener.h>
+#include <Trace.h>
 
 #include "Assignment.h"
 #include "AssignmentClient.h"
@@ -44,6 +45,9 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     // use the verbose message handler in Logging
     qInstallMessageHandler(LogHandler::verboseMessageHandler);
 
+    // records a trace of this process (and of each forked child) if HIFI_TRACE_FILE is set
+    Trace::startFromEnvironment();
+
     // parse command-line
     QCommandLineParser parser;
     parser.setApplicationDescription("High Fidelity Assignment Client");
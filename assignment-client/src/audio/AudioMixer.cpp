@@ -48,27 +48,26 @@
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <StDev.h>
+#include <Trace.h>
 #include <UUID.h>
 
-#include "AudioRingBuffer.h"
+#include "AudioMixKernels.h"
+#include "AudioMixerThrottle.h"
 #include "AudioMixerClientData.h"
 #include "AvatarAudioStream.h"
-#include "InjectedAudioStream.h"
 
 #include "AudioMixer.h"
 
-const float LOUDNESS_TO_DISTANCE_RATIO = 0.00001f;
-const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
 const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
+const int DEFAULT_MIX_THREADS = 1;
 
 InboundAudioStream::Settings AudioMixer::_streamSettings;
 
 bool AudioMixer::_printStreamStats = false;
-
-bool AudioMixer::_enableFilter = true;
+bool AudioMixer::_compressMixedAudio = true;
 
 bool AudioMixer::shouldMute(float quietestFrame) {
     return (quietestFrame > _noiseMutingThreshold);
@@ -76,14 +75,15 @@ bool AudioMixer::shouldMute(float quietestFrame) {
 
 AudioMixer::AudioMixer(NLPacket& packet) :
     ThreadedAssignment(packet),
-    _trailingSleepRatio(1.0f),
-    _minAudibilityThreshold(LOUDNESS_TO_DISTANCE_RATIO / 2.0f),
-    _performanceThrottlingRatio(0.0f),
-    _attenuationPerDoublingInDistance(DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
     _noiseMutingThreshold(DEFAULT_NOISE_MUTING_THRESHOLD),
     _numStatFrames(0),
     _sumListeners(0),
     _sumMixes(0),
+    _sumPreparedSources(0),
+    _sumListenerGroups(0),
+    _sumSharedMixes(0),
+    _sumMixedAudioPackets(0),
+    _sumMixedAudioBytes(0),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -107,372 +107,6 @@ AudioMixer::AudioMixer(NLPacket& packet) :
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
 }
 
-const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
-const float RADIUS_OF_HEAD = 0.076f;
-
-int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                         const QUuid& streamUUID,
-                                                         PositionalAudioStream* streamToAdd,
-                                                         AvatarAudioStream* listeningNodeStream) {
-    // If repetition with fade is enabled:
-    // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
-    // This is preferable to not mixing it at all since that's equivalent to inserting silence.
-    // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
-    // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
-    // This improves the perceived quality of the audio slightly.
-
-    bool showDebug = false;  // (randFloat() < 0.05f);
-
-    float repeatedFrameFadeFactor = 1.0f;
-
-    if (!streamToAdd->lastPopSucceeded()) {
-        if (_streamSettings._repetitionWithFade && !streamToAdd->getLastPopOutput().isNull()) {
-            // reptition with fade is enabled, and we do have a valid previous frame to repeat.
-            // calculate its fade factor, which depends on how many times it's already been repeated.
-            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd->getConsecutiveNotMixedCount() - 1);
-            if (repeatedFrameFadeFactor == 0.0f) {
-                return 0;
-            }
-        } else {
-            return 0;
-        }
-    }
-
-    // at this point, we know streamToAdd's last pop output is valid
-
-    // if the frame we're about to mix is silent, bail
-    if (streamToAdd->getLastPopOutputLoudness() == 0.0f) {
-        return 0;
-    }
-
-    float bearingRelativeAngleToSource = 0.0f;
-    float attenuationCoefficient = 1.0f;
-    int numSamplesDelay = 0;
-    float weakChannelAmplitudeRatio = 1.0f;
-
-    //  Is the source that I am mixing my own?
-    bool sourceIsSelf = (streamToAdd == listeningNodeStream);
-
-    glm::vec3 relativePosition = streamToAdd->getPosition() - listeningNodeStream->getPosition();
-
-    float distanceBetween = glm::length(relativePosition);
-
-    if (distanceBetween < EPSILON) {
-        distanceBetween = EPSILON;
-    }
-
-    if (streamToAdd->getLastPopOutputTrailingLoudness() / distanceBetween <= _minAudibilityThreshold) {
-        // according to mixer performance we have decided this does not get to be mixed in
-        // bail out
-        return 0;
-    }
-
-    ++_sumMixes;
-
-    if (streamToAdd->getType() == PositionalAudioStream::Injector) {
-        attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
-        if (showDebug) {
-            qDebug() << "AttenuationRatio: " << reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
-        }
-    }
-
-    if (showDebug) {
-        qDebug() << "distance: " << distanceBetween;
-    }
-
-    glm::quat inverseOrientation = glm::inverse(listeningNodeStream->getOrientation());
-
-    if (!sourceIsSelf && (streamToAdd->getType() == PositionalAudioStream::Microphone)) {
-        //  source is another avatar, apply fixed off-axis attenuation to make them quieter as they turn away from listener
-        glm::vec3 rotatedListenerPosition = glm::inverse(streamToAdd->getOrientation()) * relativePosition;
-
-        float angleOfDelivery = glm::angle(glm::vec3(0.0f, 0.0f, -1.0f),
-                                           glm::normalize(rotatedListenerPosition));
-
-        const float MAX_OFF_AXIS_ATTENUATION = 0.2f;
-        const float OFF_AXIS_ATTENUATION_FORMULA_STEP = (1 - MAX_OFF_AXIS_ATTENUATION) / 2.0f;
-
-        float offAxisCoefficient = MAX_OFF_AXIS_ATTENUATION +
-                                    (OFF_AXIS_ATTENUATION_FORMULA_STEP * (angleOfDelivery / PI_OVER_TWO));
-
-        if (showDebug) {
-            qDebug() << "angleOfDelivery" << angleOfDelivery << "offAxisCoefficient: " << offAxisCoefficient;
-
-        }
-        // multiply the current attenuation coefficient by the calculated off axis coefficient
-
-        attenuationCoefficient *= offAxisCoefficient;
-    }
-
-    float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
-    for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
-            attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
-            break;
-        }
-    }
-
-    if (distanceBetween >= ATTENUATION_BEGINS_AT_DISTANCE) {
-        // calculate the distance coefficient using the distance to this node
-        float distanceCoefficient = 1 - (logf(distanceBetween / ATTENUATION_BEGINS_AT_DISTANCE) / logf(2.0f)
-                                         * attenuationPerDoublingInDistance);
-
-        if (distanceCoefficient < 0) {
-            distanceCoefficient = 0;
-        }
-
-        // multiply the current attenuation coefficient by the distance coefficient
-        attenuationCoefficient *= distanceCoefficient;
-        if (showDebug) {
-            qDebug() << "distanceCoefficient: " << distanceCoefficient;
-        }
-    }
-
-    if (!sourceIsSelf) {
-        //  Compute sample delay for the two ears to create phase panning
-        glm::vec3 rotatedSourcePosition = inverseOrientation * relativePosition;
-
-        // project the rotated source position vector onto the XZ plane
-        rotatedSourcePosition.y = 0.0f;
-
-        // produce an oriented angle about the y-axis
-        bearingRelativeAngleToSource = glm::orientedAngle(glm::vec3(0.0f, 0.0f, -1.0f),
-                                                          glm::normalize(rotatedSourcePosition),
-                                                          glm::vec3(0.0f, 1.0f, 0.0f));
-
-        const float PHASE_AMPLITUDE_RATIO_AT_90 = 0.5;
-
-        // figure out the number of samples of delay and the ratio of the amplitude
-        // in the weak channel for audio spatialization
-        float sinRatio = fabsf(sinf(bearingRelativeAngleToSource));
-        numSamplesDelay = SAMPLE_PHASE_DELAY_AT_90 * sinRatio;
-        weakChannelAmplitudeRatio = 1 - (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio);
-
-        if (distanceBetween < RADIUS_OF_HEAD) {
-            // Diminish phase panning if source would be inside head
-            numSamplesDelay *= distanceBetween / RADIUS_OF_HEAD;
-            weakChannelAmplitudeRatio += (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio) * distanceBetween / RADIUS_OF_HEAD;
-        }
-    }
-
-    if (showDebug) {
-        qDebug() << "attenuation: " << attenuationCoefficient;
-        qDebug() << "bearingRelativeAngleToSource: " << bearingRelativeAngleToSource << " numSamplesDelay: " << numSamplesDelay;
-    }
-
-    AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
-
-    if (!streamToAdd->isStereo()) {
-        // this is a mono stream, which means it gets full attenuation and spatialization
-
-        // we need to do several things in this process:
-        //    1) convert from mono to stereo by copying each input sample into the left and right output samples
-        //    2)
-        //    2) apply an attenuation AND fade to all samples (left and right)
-        //    3) based on the bearing relative angle to the source we will weaken and delay either the left or
-        //       right channel of the input into the output
-        //    4) because one of these channels is delayed, we will need to use historical samples from
-        //       the input stream for that delayed channel
-
-        // Mono input to stereo output (item 1 above)
-        int OUTPUT_SAMPLES_PER_INPUT_SAMPLE = 2;
-        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        int maxOutputIndex = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-
-        // attenuation and fade applied to all samples (item 2 above)
-        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
-
-        // determine which side is weak and delayed (item 3 above)
-        bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
-
-        // since we're converting from mono to stereo, we'll use these two indices to step through
-        // the output samples. we'll increment each index independently in the loop
-        int leftDestinationIndex = 0;
-        int rightDestinationIndex = 1;
-
-        // One of our two channels will be delayed (determined below). We'll use this index to step
-        // through filling in our output with the historical samples for the delayed channel.  (item 4 above)
-        int delayedChannelHistoricalAudioOutputIndex;
-
-        // All samples will be attenuated by at least this much
-        float leftSideAttenuation = attenuationAndFade;
-        float rightSideAttenuation = attenuationAndFade;
-
-        // The weak/delayed channel will be attenuated by this additional amount
-        float attenuationAndWeakChannelRatioAndFade = attenuationAndFade * weakChannelAmplitudeRatio;
-
-        // Now, based on the determination of which side is weak and delayed, set up our true starting point
-        // for our indexes, as well as the appropriate attenuation for each channel
-        if (rightSideWeakAndDelayed) {
-            delayedChannelHistoricalAudioOutputIndex = rightDestinationIndex;
-            rightSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            rightDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        } else {
-            delayedChannelHistoricalAudioOutputIndex = leftDestinationIndex;
-            leftSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            leftDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        }
-
-        // If there was a sample delay for this stream, we need to pull samples prior to the official start of the input
-        // and stick those samples at the beginning of the output. We only need to loop through this for the weak/delayed
-        // side, since the normal side is fully handled below. (item 4 above)
-        if (numSamplesDelay > 0) {
-
-            // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
-            // maybe make AudioRingBuffer have 1 extra frame in its buffer
-            AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
-
-            for (int i = 0; i < numSamplesDelay; i++) {
-                int16_t originalHistoricalSample = *delayStreamSourceSamples;
-
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
-                                                                                 * attenuationAndWeakChannelRatioAndFade;
-                ++delayStreamSourceSamples; // move our input pointer
-                delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
-            }
-        }
-
-        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation
-        for (int inputSample = 0; inputSample < inputSampleCount; inputSample++) {
-            int16_t originalSample = streamPopOutput[inputSample];
-            int16_t leftSideSample = originalSample * leftSideAttenuation;
-            int16_t rightSideSample = originalSample * rightSideAttenuation;
-
-            // since we might be delayed, don't write beyond our maxOutputIndex
-            if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
-            }
-            if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
-            }
-
-            leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-            rightDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        }
-
-    } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
-
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
-
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
-        }
-    }
-
-    if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
-
-        const float TWO_OVER_PI = 2.0f / PI;
-
-        const float ZERO_DB = 1.0f;
-        const float NEGATIVE_ONE_DB = 0.891f;
-        const float NEGATIVE_THREE_DB = 0.708f;
-
-        const float FILTER_GAIN_AT_0 = ZERO_DB; // source is in front
-        const float FILTER_GAIN_AT_90 = NEGATIVE_ONE_DB; // source is incident to left or right ear
-        const float FILTER_GAIN_AT_180 = NEGATIVE_THREE_DB; // source is behind
-
-        const float FILTER_CUTOFF_FREQUENCY_HZ = 1000.0f;
-
-        const float penumbraFilterFrequency = FILTER_CUTOFF_FREQUENCY_HZ; // constant frequency
-        const float penumbraFilterSlope = NEGATIVE_THREE_DB; // constant slope
-
-        float penumbraFilterGainL;
-        float penumbraFilterGainR;
-
-        // variable gain calculation broken down by quadrant
-        if (-bearingRelativeAngleToSource < -PI_OVER_TWO && -bearingRelativeAngleToSource > -PI) {
-            penumbraFilterGainL = TWO_OVER_PI *
-                (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_180) * (-bearingRelativeAngleToSource + PI_OVER_TWO) + FILTER_GAIN_AT_0;
-            penumbraFilterGainR = TWO_OVER_PI *
-                (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_180) * (-bearingRelativeAngleToSource + PI_OVER_TWO) + FILTER_GAIN_AT_90;
-        } else if (-bearingRelativeAngleToSource <= PI && -bearingRelativeAngleToSource > PI_OVER_TWO) {
-            penumbraFilterGainL = TWO_OVER_PI *
-                (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_90) * (-bearingRelativeAngleToSource - PI) + FILTER_GAIN_AT_180;
-            penumbraFilterGainR = TWO_OVER_PI *
-                (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_0) * (-bearingRelativeAngleToSource - PI) + FILTER_GAIN_AT_180;
-        } else if (-bearingRelativeAngleToSource <= PI_OVER_TWO && -bearingRelativeAngleToSource > 0) {
-            penumbraFilterGainL = TWO_OVER_PI *
-                (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_0) * (-bearingRelativeAngleToSource - PI_OVER_TWO) + FILTER_GAIN_AT_90;
-            penumbraFilterGainR = FILTER_GAIN_AT_0;
-        } else {
-            penumbraFilterGainL = FILTER_GAIN_AT_0;
-            penumbraFilterGainR =  TWO_OVER_PI *
-                (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_90) * (-bearingRelativeAngleToSource) + FILTER_GAIN_AT_0;
-        }
-
-        if (distanceBetween < RADIUS_OF_HEAD) {
-            // Diminish effect if source would be inside head
-            penumbraFilterGainL += (1.0f - penumbraFilterGainL) * (1.0f - distanceBetween / RADIUS_OF_HEAD);
-            penumbraFilterGainR += (1.0f - penumbraFilterGainR) * (1.0f - distanceBetween / RADIUS_OF_HEAD);
-        }
-
-        bool wantDebug = false;
-        if (wantDebug) {
-            qDebug() << "gainL=" << penumbraFilterGainL
-                     << "gainR=" << penumbraFilterGainR
-                     << "angle=" << -bearingRelativeAngleToSource;
-        }
-
-        // Get our per listener/source data so we can get our filter
-        AudioFilterHSF1s& penumbraFilter = listenerNodeData->getListenerSourcePairData(streamUUID)->getPenumbraFilter();
-
-        // set the gain on both filter channels
-        penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
-        penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
-    }
-
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
-    }
-
-    return 1;
-}
-
-int AudioMixer::prepareMixForListeningNode(Node* node) {
-    AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
-    AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
-
-    // zero out the client mix for this node
-    memset(_preMixSamples, 0, sizeof(_preMixSamples));
-    memset(_mixSamples, 0, sizeof(_mixSamples));
-
-    // loop through all other nodes that have sufficient audio to mix
-    int streamsMixed = 0;
-
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
-
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
-
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
-
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
-                }
-
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
-                }
-            }
-        }
-    });
-
-    return streamsMixed;
-}
-
 void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
     // Send stream properties
     bool hasReverb = false;
@@ -569,19 +203,57 @@ void AudioMixer::sendStatsPacket() {
     static QJsonObject statsObject;
 
     statsObject["useDynamicJitterBuffers"] = _streamSettings._dynamicJitterBuffers;
-    statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100.0f;
-    statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
+    statsObject["trailing_sleep_percentage"] = _throttle.getTrailingSleepRatio() * 100.0f;
+    statsObject["performance_throttling_ratio"] = _throttle.getPerformanceThrottlingRatio();
+    statsObject["mix_threads"] = _spatializer.getNumMixThreads();
+    statsObject["mix_kernels"] = AudioMixKernels::getInstructionSetName(AudioMixKernels::getInstructionSet());
 
     statsObject["average_listeners_per_frame"] = (float) _sumListeners / (float) _numStatFrames;
 
+    // read before addPacketStatsAndSendStatsPacket resets them along with the packet stats
+    int sendSyscalls = 0;
+    int receiveSyscalls = 0;
+    DependencyManager::get<NodeList>()->getSyscallStats(sendSyscalls, receiveSyscalls);
+
+    if (_numStatFrames > 0) {
+        statsObject["send_syscalls_per_frame"] = (float) sendSyscalls / (float) _numStatFrames;
+        statsObject["receive_syscalls_per_frame"] = (float) receiveSyscalls / (float) _numStatFrames;
+        statsObject["average_prepared_sources_per_frame"] = (float) _sumPreparedSources / (float) _numStatFrames;
+        statsObject["average_listener_groups_per_frame"] = (float) _sumListenerGroups / (float) _numStatFrames;
+        statsObject["average_shared_mixes_per_frame"] = (float) _sumSharedMixes / (float) _numStatFrames;
+    } else {
+        statsObject["send_syscalls_per_frame"] = 0.0;
+        statsObject["receive_syscalls_per_frame"] = 0.0;
+        statsObject["average_prepared_sources_per_frame"] = 0.0;
+        statsObject["average_listener_groups_per_frame"] = 0.0;
+        statsObject["average_shared_mixes_per_frame"] = 0.0;
+    }
+
+    statsObject["shared_mixes_enabled"] = _spatializer.getSharedMixesEnabled();
+    statsObject["shared_mixes"] = _sumSharedMixes;
+
     if (_sumListeners > 0) {
         statsObject["average_mixes_per_listener"] = (float) _sumMixes / (float) _sumListeners;
     } else {
         statsObject["average_mixes_per_listener"] = 0.0;
     }
 
+    if (_sumMixedAudioPackets > 0) {
+        statsObject["average_mixed_audio_bytes"] = (float) _sumMixedAudioBytes / (float) _sumMixedAudioPackets;
+        statsObject["mixed_audio_compression_ratio"] = (float) _sumMixedAudioPackets * AudioConstants::NETWORK_FRAME_BYTES_STEREO
+            / (float) _sumMixedAudioBytes;
+    } else {
+        statsObject["average_mixed_audio_bytes"] = 0.0;
+        statsObject["mixed_audio_compression_ratio"] = 0.0;
+    }
+
     _sumListeners = 0;
     _sumMixes = 0;
+    _sumPreparedSources = 0;
+    _sumListenerGroups = 0;
+    _sumSharedMixes = 0;
+    _sumMixedAudioPackets = 0;
+    _sumMixedAudioBytes = 0;
     _numStatFrames = 0;
 
     QJsonObject readPendingDatagramStats;
@@ -684,67 +356,17 @@ void AudioMixer::run() {
     // check the settings object to see if we have anything we can parse out
     parseSettingsObject(settingsObject);
 
+    // everything this thread sends during a frame goes out in a batch once the frame is done
+    nodeList->setSendBatchingThread(QThread::currentThread());
+
     int nextFrame = 0;
     QElapsedTimer timer;
     timer.start();
 
     int usecToSleep = AudioConstants::NETWORK_FRAME_USECS;
 
-    const int TRAILING_AVERAGE_FRAMES = 100;
-    int framesSinceCutoffEvent = TRAILING_AVERAGE_FRAMES;
-
     while (!_isFinished) {
-        const float STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.10f;
-        const float BACK_OFF_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.20f;
-
-        const float RATIO_BACK_OFF = 0.02f;
-
-        const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_AVERAGE_FRAMES;
-        const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
-
-        if (usecToSleep < 0) {
-            usecToSleep = 0;
-        }
-
-        _trailingSleepRatio = (PREVIOUS_FRAMES_RATIO * _trailingSleepRatio)
-            + (usecToSleep * CURRENT_FRAME_RATIO / (float) AudioConstants::NETWORK_FRAME_USECS);
-
-        float lastCutoffRatio = _performanceThrottlingRatio;
-        bool hasRatioChanged = false;
-
-        if (framesSinceCutoffEvent >= TRAILING_AVERAGE_FRAMES) {
-            if (_trailingSleepRatio <= STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD) {
-                // we're struggling - change our min required loudness to reduce some load
-                _performanceThrottlingRatio = _performanceThrottlingRatio + (0.5f * (1.0f - _performanceThrottlingRatio));
-
-                qDebug() << "Mixer is struggling, sleeping" << _trailingSleepRatio * 100 << "% of frame time. Old cutoff was"
-                    << lastCutoffRatio << "and is now" << _performanceThrottlingRatio;
-                hasRatioChanged = true;
-            } else if (_trailingSleepRatio >= BACK_OFF_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD && _performanceThrottlingRatio != 0) {
-                // we've recovered and can back off the required loudness
-                _performanceThrottlingRatio = _performanceThrottlingRatio - RATIO_BACK_OFF;
-
-                if (_performanceThrottlingRatio < 0) {
-                    _performanceThrottlingRatio = 0;
-                }
-
-                qDebug() << "Mixer is recovering, sleeping" << _trailingSleepRatio * 100 << "% of frame time. Old cutoff was"
-                    << lastCutoffRatio << "and is now" << _performanceThrottlingRatio;
-                hasRatioChanged = true;
-            }
-
-            if (hasRatioChanged) {
-                // set out min audability threshold from the new ratio
-                _minAudibilityThreshold = LOUDNESS_TO_DISTANCE_RATIO / (2.0f * (1.0f - _performanceThrottlingRatio));
-                qDebug() << "Minimum audability required to be mixed is now" << _minAudibilityThreshold;
-
-                framesSinceCutoffEvent = 0;
-            }
-        }
-
-        if (!hasRatioChanged) {
-            ++framesSinceCutoffEvent;
-        }
+        _throttle.frameStarted(usecToSleep);
 
         quint64 now = usecTimestampNow();
         if (now - _lastPerSecondCallbackTime > USECS_PER_SECOND) {
@@ -752,6 +374,9 @@ void AudioMixer::run() {
             _lastPerSecondCallbackTime = now;
         }
 
+        _frameSourceNodes.clear();
+        _frameListenerNodes.clear();
+
         nodeList->eachNode([&](const SharedNodePointer& node) {
 
             if (node->getLinkedData()) {
@@ -769,54 +394,101 @@ void AudioMixer::run() {
                     nodeList->sendPacket(std::move(mutePacket), *node);
                 }
 
+                _frameSourceNodes.push_back(node);
+
                 if (node->getType() == NodeType::Agent && node->getActiveSocket()
                     && nodeData->getAvatarAudioStream()) {
+                    _frameListenerNodes.push_back(node);
+                }
+            }
+        });
+
+        // every frame has been popped, so the streams are read-only while they are prepared and the workers mix
+        _spatializer.setMinAudibilityThreshold(_throttle.getMinAudibilityThreshold());
+        foreach (const SharedNodePointer& node, _frameSourceNodes) {
+            AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
+
+            const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+            for (i = audioStreams.constBegin(); i != audioStreams.constEnd(); i++) {
+                PositionalAudioStream* stream = i.value();
+                QUuid streamUUID = (stream->getType() == PositionalAudioStream::Microphone) ? node->getUUID() : i.key();
+                _spatializer.addSource(stream, nodeData, streamUUID);
+            }
+        }
+        foreach (const SharedNodePointer& node, _frameListenerNodes) {
+            _spatializer.addListener((AudioMixerClientData*)node->getLinkedData());
+        }
+        _spatializer.mixFrame();
 
-                    int streamsMixed = prepareMixForListeningNode(node.data());
+        _sumPreparedSources += _spatializer.getFrameSourceCount();
+        if (_spatializer.getSharedMixesEnabled()) {
+            _sumListenerGroups += _spatializer.getFrameListenerGroupCount();
+            _sumSharedMixes += _spatializer.getFrameSharedMixCount();
+        }
 
-                    std::unique_ptr<NLPacket> mixPacket;
+        // packets are sent from the mixer thread only, in the order the listeners were gathered
+        foreach (const SharedNodePointer& node, _frameListenerNodes) {
+            AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
 
-                    if (streamsMixed > 0) {
-                        int mixPacketBytes = sizeof(quint16) + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
+            int streamsMixed = nodeData->getStreamsMixed();
 
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
+            std::unique_ptr<NLPacket> mixPacket;
 
-                        // pack mixed audio samples
-                        mixPacket->write(reinterpret_cast<char*>(_mixSamples),
-                                         AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                    } else {
-                        int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
-                        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
+            if (streamsMixed > 0) {
+                const QByteArray& encodedMix = nodeData->getEncodedMix();
+                int mixPacketBytes = sizeof(quint16) + sizeof(quint8) + encodedMix.size();
+                mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
 
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                mixPacket->writePrimitive(sequence);
 
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        mixPacket->writePrimitive(numSilentSamples);
-                    }
+                // pack the codec of the mix
+                quint8 codecType = nodeData->getEncodedMixCodec();
+                mixPacket->writePrimitive(codecType);
 
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
+                // pack mixed audio samples, as encoded by the mix worker
+                mixPacket->write(encodedMix.constData(), encodedMix.size());
 
-                    // send mixed audio packet
-                    nodeList->sendPacket(std::move(mixPacket), *node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
+                ++_sumMixedAudioPackets;
+                _sumMixedAudioBytes += encodedMix.size();
+            } else {
+                int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
+                mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
 
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
+                // pack sequence number
+                quint16 sequence = nodeData->getOutgoingSequenceNumber();
+                mixPacket->writePrimitive(sequence);
 
-                    ++_sumListeners;
-                }
+                // pack number of silent audio samples
+                quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+                mixPacket->writePrimitive(numSilentSamples);
+            }
+
+            // Send audio environment
+            sendAudioEnvironmentPacket(node);
+
+            // send mixed audio packet
+            nodeList->sendPacket(std::move(mixPacket), *node);
+            nodeData->incrementOutgoingMixedAudioSequenceNumber();
+
+            // send an audio stream stats packet if it's time
+            if (_sendAudioStreamStats) {
+                nodeData->sendAudioStreamStatsPackets(node);
+                _sendAudioStreamStats = false;
             }
-        });
+
+            _sumMixes += streamsMixed;
+            ++_sumListeners;
+        }
+
+        nodeList->flushSendQueue();
+
+        // don't hold on to nodes that may be killed before the next frame
+        _spatializer.endFrame();
+        _frameSourceNodes.clear();
+        _frameListenerNodes.clear();
 
         ++_numStatFrames;
 
@@ -836,9 +508,12 @@ void AudioMixer::run() {
             usleep(usecToSleep);
         }
     }
+
+    nodeList->setSendBatchingThread(nullptr);
 }
 
 void AudioMixer::perSecondActions() {
+    TRACE_SCOPE("AudioMixer::perSecondActions");
     _sendAudioStreamStats = true;
 
     int callsLastSecond = _datagramsReadPerCallStats.getCurrentIntervalSamples();
@@ -955,12 +630,65 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
 
         const QString REPETITION_WITH_FADE_JSON_KEY = "repetition_with_fade";
         _streamSettings._repetitionWithFade = audioBufferGroupObject[REPETITION_WITH_FADE_JSON_KEY].toBool();
+        _spatializer.setRepetitionWithFade(_streamSettings._repetitionWithFade);
         if (_streamSettings._repetitionWithFade) {
             qDebug() << "Repetition with fade enabled";
         } else {
             qDebug() << "Repetition with fade disabled";
         }
 
+        const QString MIX_THREADS_JSON_KEY = "mix_threads";
+        int numMixThreads = audioBufferGroupObject[MIX_THREADS_JSON_KEY].toString().toInt(&ok);
+        if (!ok) {
+            numMixThreads = DEFAULT_MIX_THREADS;
+        }
+        _spatializer.setNumMixThreads(numMixThreads);
+        qDebug() << "Mixing listeners on" << _spatializer.getNumMixThreads() << "thread(s)";
+
+        const QString COMPRESS_MIXED_AUDIO_JSON_KEY = "compress_mixed_audio";
+        if (audioBufferGroupObject.contains(COMPRESS_MIXED_AUDIO_JSON_KEY)) {
+            _compressMixedAudio = audioBufferGroupObject[COMPRESS_MIXED_AUDIO_JSON_KEY].toBool();
+        }
+        if (_compressMixedAudio) {
+            qDebug() << "Mixed audio is sent with the codec of each listener's own audio";
+        } else {
+            qDebug() << "Mixed audio is sent uncompressed";
+        }
+
+        const QString ENABLE_SHARED_MIXES_JSON_KEY = "enable_shared_mixes";
+        bool enableSharedMixes = audioBufferGroupObject[ENABLE_SHARED_MIXES_JSON_KEY].toBool();
+        if (enableSharedMixes) {
+            const QString SHARED_MIX_POSITION_TOLERANCE_JSON_KEY = "shared_mix_position_tolerance";
+            float sharedMixPositionTolerance =
+                audioBufferGroupObject[SHARED_MIX_POSITION_TOLERANCE_JSON_KEY].toString().toFloat(&ok);
+            if (!ok) {
+                sharedMixPositionTolerance = DEFAULT_SHARED_MIX_POSITION_TOLERANCE;
+            }
+
+            const QString SHARED_MIX_ORIENTATION_TOLERANCE_JSON_KEY = "shared_mix_orientation_tolerance";
+            float sharedMixOrientationTolerance =
+                audioBufferGroupObject[SHARED_MIX_ORIENTATION_TOLERANCE_JSON_KEY].toString().toFloat(&ok);
+            if (!ok) {
+                sharedMixOrientationTolerance = DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE;
+            }
+
+            const QString SHARED_MIX_NEAR_DISTANCE_JSON_KEY = "shared_mix_near_distance";
+            float sharedMixNearDistance = audioBufferGroupObject[SHARED_MIX_NEAR_DISTANCE_JSON_KEY].toString().toFloat(&ok);
+            if (!ok) {
+                sharedMixNearDistance = DEFAULT_SHARED_MIX_NEAR_DISTANCE;
+            }
+
+            _spatializer.setSharedMixes(true, sharedMixPositionTolerance, sharedMixOrientationTolerance,
+                                        sharedMixNearDistance);
+            qDebug() << "Sharing mixes between listeners within" << sharedMixPositionTolerance << "m and"
+                << sharedMixOrientationTolerance << "degrees of each other, for sources at least"
+                << sharedMixNearDistance << "m away";
+        } else {
+            _spatializer.setSharedMixes(false, DEFAULT_SHARED_MIX_POSITION_TOLERANCE,
+                                        DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE, DEFAULT_SHARED_MIX_NEAR_DISTANCE);
+            qDebug() << "Every listener gets its own mix";
+        }
+
         const QString PRINT_STREAM_STATS_JSON_KEY = "print_stream_stats";
         _printStreamStats = audioBufferGroupObject[PRINT_STREAM_STATS_JSON_KEY].toBool();
         if (_printStreamStats) {
@@ -976,8 +704,8 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             bool ok = false;
             float attenuation = audioEnvGroupObject[ATTENATION_PER_DOULING_IN_DISTANCE].toString().toFloat(&ok);
             if (ok) {
-                _attenuationPerDoublingInDistance = attenuation;
-                qDebug() << "Attenuation per doubling in distance changed to" << _attenuationPerDoublingInDistance;
+                _spatializer.setAttenuationPerDoublingInDistance(attenuation);
+                qDebug() << "Attenuation per doubling in distance changed to" << attenuation;
             }
         }
 
@@ -993,9 +721,9 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
 
         const QString FILTER_KEY = "enable_filter";
         if (audioEnvGroupObject[FILTER_KEY].isBool()) {
-            _enableFilter = audioEnvGroupObject[FILTER_KEY].toBool();
+            _spatializer.setEnableFilter(audioEnvGroupObject[FILTER_KEY].toBool());
         }
-        if (_enableFilter) {
+        if (_spatializer.getEnableFilter()) {
             qDebug() << "Filter enabled";
         }
 
@@ -1041,6 +769,7 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                     }
                 }
             }
+            _spatializer.setAudioZones(_audioZones);
         }
 
         const QString ATTENUATION_COEFFICIENTS = "attenuation_coefficients";
@@ -1057,7 +786,7 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                     coefficientObject.contains(LISTENER) &&
                     coefficientObject.contains(COEFFICIENT)) {
 
-                    ZonesSettings settings;
+                    AudioSpatializer::ZonesSettings settings;
 
                     bool ok;
                     settings.source = coefficientObject.value(SOURCE).toString();
@@ -1067,7 +796,7 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
                     if (ok && settings.coefficient >= 0.0f && settings.coefficient <= 1.0f &&
                         _audioZones.contains(settings.source) && _audioZones.contains(settings.listener)) {
 
-                        _zonesSettings.push_back(settings);
+                        _spatializer.addZonesSettings(settings);
                         qDebug() << "Added Coefficient:" << settings.source << settings.listener << settings.coefficient;
                     }
                 }
@@ -13,15 +13,15 @@
 #define hifi_AudioMixer_h
 
 #include <AABox.h>
+#include <AudioMixerThrottle.h>
 #include <AudioRingBuffer.h>
+#include <AudioSpatializer.h>
 #include <ThreadedAssignment.h>
 
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioMixerClientData;
 
-const int SAMPLE_PHASE_DELAY_AT_90 = 20;
-
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
@@ -38,54 +38,39 @@ public slots:
     void sendStatsPacket();
 
     static const InboundAudioStream::Settings& getStreamSettings() { return _streamSettings; }
+    static bool getCompressMixedAudio() { return _compressMixedAudio; }
 
 private slots:
     void handleNodeAudioPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
     void handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
 
 private:
-    /// adds one stream to the mix for a listening node
-    int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                    const QUuid& streamUUID,
-                                                    PositionalAudioStream* streamToAdd,
-                                                    AvatarAudioStream* listeningNodeStream);
-
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
-
     /// Send Audio Environment packet for a single node
     void sendAudioEnvironmentPacket(SharedNodePointer node);
 
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
-
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
-
     void perSecondActions();
 
     bool shouldMute(float quietestFrame);
 
     void parseSettingsObject(const QJsonObject& settingsObject);
 
-    float _trailingSleepRatio;
-    float _minAudibilityThreshold;
-    float _performanceThrottlingRatio;
-    float _attenuationPerDoublingInDistance;
+    AudioMixerThrottle _throttle;
+    AudioSpatializer _spatializer;
     float _noiseMutingThreshold;
     int _numStatFrames;
     int _sumListeners;
     int _sumMixes;
+    int _sumPreparedSources;
+    int _sumListenerGroups;
+    int _sumSharedMixes; // listeners mixed from the base mix of a group of more than one
+    int _sumMixedAudioPackets;
+    qint64 _sumMixedAudioBytes; // the encoded audio data of those packets
+
+    // nodes gathered once per frame after their frames are popped, held until the spatializer is done with their streams
+    QVector<SharedNodePointer> _frameSourceNodes;
+    QVector<SharedNodePointer> _frameListenerNodes;
 
     QHash<QString, AABox> _audioZones;
-    struct ZonesSettings {
-        QString source;
-        QString listener;
-        float coefficient;
-    };
-    QVector<ZonesSettings> _zonesSettings;
     struct ReverbSettings {
         QString zone;
         float reverbTime;
@@ -96,7 +81,7 @@ private:
     static InboundAudioStream::Settings _streamSettings;
 
     static bool _printStreamStats;
-    static bool _enableFilter;
+    static bool _compressMixedAudio;
 
     quint64 _lastPerSecondCallbackTime;
 
@@ -24,8 +24,10 @@
 AudioMixerClientData::AudioMixerClientData() :
     _audioStreams(),
     _outgoingMixedAudioSequenceNumber(0),
+    _streamsMixed(0),
     _downstreamAudioStreamStats()
 {
+    memset(_mixSamples, 0, sizeof(_mixSamples));
 }
 
 AudioMixerClientData::~AudioMixerClientData() {
@@ -49,6 +51,31 @@ AvatarAudioStream* AudioMixerClientData::getAvatarAudioStream() const {
     return NULL;
 }
 
+void AudioMixerClientData::mixFinished(int streamsMixed) {
+    setStreamsMixed(streamsMixed);
+
+    if (streamsMixed > 0) {
+        // encoding is per listener too, so it is spread across the workers along with the mixing
+        encodeMix(AudioMixer::getCompressMixedAudio());
+    }
+}
+
+void AudioMixerClientData::encodeMix(bool compressMixedAudio) {
+    const int MIX_CHANNELS = 2;
+
+    AvatarAudioStream* avatarAudioStream = getAvatarAudioStream();
+    quint8 codecType = (compressMixedAudio && avatarAudioStream) ? avatarAudioStream->getIncomingCodecType()
+                                                                 : (quint8)AudioCodec::PCM;
+    if (!_mixEncoder || _mixEncoder->getType() != codecType) {
+        // the stream only takes codecs that this build knows
+        _mixEncoder = AudioCodec::create(codecType);
+    }
+
+    _encodedMix.resize(_mixEncoder->getEncodedSize(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, MIX_CHANNELS));
+    _encodedMix.resize(_mixEncoder->encode(_mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, MIX_CHANNELS,
+                                           _encodedMix.data()));
+}
+
 int AudioMixerClientData::parseData(NLPacket& packet) {
     PacketType::Value packetType = packet.getType();
     
@@ -215,6 +242,8 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
     downstreamStats["min_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMin);
     downstreamStats["max_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMax);
     downstreamStats["avg_gap_30s"] = formatUsecTime(streamStats._timeGapWindowAverage);
+    downstreamStats["codec"] = AudioCodec::getTypeName(streamStats._codec);
+    downstreamStats["codec_ratio"] = streamStats.getCompressionRatio();
 
     result["downstream"] = downstreamStats;
 
@@ -240,6 +269,8 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
         upstreamStats["min_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMin);
         upstreamStats["max_gap_30s"] = formatUsecTime(streamStats._timeGapWindowMax);
         upstreamStats["avg_gap_30s"] = formatUsecTime(streamStats._timeGapWindowAverage);
+        upstreamStats["codec"] = AudioCodec::getTypeName(streamStats._codec);
+        upstreamStats["codec_ratio"] = streamStats.getCompressionRatio();
 
         result["upstream"] = upstreamStats;
     } else {
@@ -319,6 +350,10 @@ void AudioMixerClientData::printAudioStreamStats(const AudioStreamStats& streamS
         formatUsecTime(streamStats._timeGapWindowMin).toLatin1().data(),
         formatUsecTime(streamStats._timeGapWindowMax).toLatin1().data(),
         formatUsecTime(streamStats._timeGapWindowAverage).toLatin1().data());
+
+    printf("                            Codec | %s, compression: %.2f:1\n",
+        AudioCodec::getTypeName(streamStats._codec),
+        (double)streamStats.getCompressionRatio());
 }
 
 
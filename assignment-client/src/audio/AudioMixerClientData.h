@@ -15,26 +15,13 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
-#include <AudioFormat.h> // For AudioFilterHSF1s and _penumbraFilter
-#include <AudioBuffer.h> // For AudioFilterHSF1s and _penumbraFilter
-#include <AudioFilter.h> // For AudioFilterHSF1s and _penumbraFilter
-#include <AudioFilterBank.h> // For AudioFilterHSF1s and _penumbraFilter
+#include <AudioCodec.h>
+#include <AudioSpatializer.h>
 
 #include "PositionalAudioStream.h"
 #include "AvatarAudioStream.h"
 
-class PerListenerSourcePairData {
-public:
-    PerListenerSourcePairData() {
-        _penumbraFilter.initialize(AudioConstants::SAMPLE_RATE, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
-    };
-    AudioFilterHSF1s& getPenumbraFilter() { return _penumbraFilter; }
-
-private:
-    AudioFilterHSF1s _penumbraFilter;
-};
-
-class AudioMixerClientData : public NodeData {
+class AudioMixerClientData : public NodeData, public AudioMixListener {
 public:
     AudioMixerClientData();
     ~AudioMixerClientData();
@@ -57,7 +44,23 @@ public:
 
     void printUpstreamDownstreamStats() const;
 
-    PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
+    virtual PositionalAudioStream* getListenerStream() const { return getAvatarAudioStream(); }
+    virtual PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
+
+    // the mix for this listener in the current frame, written by whichever mix worker picked it up
+    virtual int16_t* getMixSamples() { return _mixSamples; }
+    int getStreamsMixed() const { return _streamsMixed; }
+    void setStreamsMixed(int streamsMixed) { _streamsMixed = streamsMixed; }
+
+    /// records how many streams were mixed and encodes the mix, on the mix worker that mixed it
+    virtual void mixFinished(int streamsMixed);
+
+    /// encodes this frame's mix with the codec the listener sends its own audio with, or as raw PCM if mixed audio is
+    /// not to be compressed. Called by the mix worker that mixed it.
+    void encodeMix(bool compressMixedAudio);
+    const QByteArray& getEncodedMix() const { return _encodedMix; }
+    quint8 getEncodedMixCodec() const { return _mixEncoder ? _mixEncoder->getType() : AudioCodec::PCM; }
+
 private:
     void printAudioStreamStats(const AudioStreamStats& streamStats) const;
 
@@ -69,6 +72,12 @@ private:
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
+    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int _streamsMixed;
+
+    std::unique_ptr<AudioCodec> _mixEncoder;
+    QByteArray _encodedMix;
+
     AudioStreamStats _downstreamAudioStreamStats;
 };
 
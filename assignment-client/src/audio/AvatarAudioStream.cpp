@@ -27,6 +27,11 @@ int AvatarAudioStream::parseStreamProperties(PacketType::Value type, const QByte
         readBytes += sizeof(quint16);
         numAudioSamples = (int)numSilentSamples;
 
+        // the codec the client sends its audio with, which is also the one it gets its mix sent with. One we do not
+        // know leaves the codec as it was
+        setIncomingCodec(packetAfterSeqNum.at(readBytes), _isStereo ? 2 : 1);
+        readBytes += sizeof(quint8);
+
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
 
@@ -46,12 +51,22 @@ int AvatarAudioStream::parseStreamProperties(PacketType::Value type, const QByte
             _isStereo = isStereo;
         }
 
+        // read the codec of the audio data
+        quint8 codecType = packetAfterSeqNum.at(readBytes);
+        readBytes += sizeof(quint8);
+
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
         
         // calculate how many samples are in this packet
         int numAudioBytes = packetAfterSeqNum.size() - readBytes;
-        numAudioSamples = numAudioBytes / sizeof(int16_t);
+        if (setIncomingCodec(codecType, isStereo ? 2 : 1)) {
+            numAudioSamples = _incomingCodec->getDecodedSamples(numAudioBytes, isStereo ? 2 : 1);
+        } else {
+            // audio we can not decode is skipped
+            numAudioSamples = 0;
+            readBytes = packetAfterSeqNum.size();
+        }
     }
 
     return readBytes;
@@ -15,6 +15,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QTimer>
 #include <QtCore/QThread>
 
@@ -23,6 +24,7 @@
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <UUID.h>
+#include <Trace.h>
 #include <TryLocker.h>
 
 #include "AvatarMixerClientData.h"
@@ -32,6 +34,36 @@ const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 
 const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
 const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) * 1000;
+const int DEFAULT_BROADCAST_THREADS = 1;
+
+// builds packets for receivers pulled from the AvatarMixer's per-frame queue, each worker owns its own random generator
+class AvatarMixerWorker : public QRunnable {
+public:
+    AvatarMixerWorker(AvatarMixer* mixer) : _mixer(mixer), _generator(std::random_device()()) { setAutoDelete(false); }
+
+    virtual void run() {
+        _mixer->broadcastQueuedReceivers(_generator);
+    }
+
+private:
+    AvatarMixer* _mixer;
+    std::mt19937 _generator;
+};
+
+// runs a worker on the mixer's thread pool and signals the mixer once it has drained the queue
+class AvatarMixerPooledWorker : public AvatarMixerWorker {
+public:
+    AvatarMixerPooledWorker(AvatarMixer* mixer, QSemaphore& doneSemaphore) :
+        AvatarMixerWorker(mixer), _doneSemaphore(doneSemaphore) {}
+
+    virtual void run() {
+        AvatarMixerWorker::run();
+        _doneSemaphore.release();
+    }
+
+private:
+    QSemaphore& _doneSemaphore;
+};
 
 AvatarMixer::AvatarMixer(NLPacket& packet) :
     ThreadedAssignment(packet),
@@ -42,16 +74,22 @@ AvatarMixer::AvatarMixer(NLPacket& packet) :
     _sumListeners(0),
     _numStatFrames(0),
     _sumBillboardPackets(0),
-    _sumIdentityPackets(0)
+    _sumIdentityPackets(0),
+    _sumAvatarDataEncodeRequests(0),
+    _sumAvatarDataEncodeCacheHits(0),
+    _sumAvatarsConsidered(0)
 {
     // make sure we hear about node kills so we can tell the other nodes
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::AvatarData, this, "handleAvatarDataPacket");
+    // avatar data is parsed under the node data mutex, so it can be handled right on the thread that reads the socket
+    packetReceiver.registerDirectCallback(PacketType::AvatarData, this, &AvatarMixer::handleAvatarDataPacket);
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "handleAvatarIdentityPacket");
     packetReceiver.registerListener(PacketType::AvatarBillboard, this, "handleAvatarBillboardPacket");
     packetReceiver.registerListener(PacketType::KillAvatar, this, "handleKillAvatarPacket");
+
+    setupBroadcastWorkers(DEFAULT_BROADCAST_THREADS);
 }
 
 AvatarMixer::~AvatarMixer() {
@@ -61,14 +99,45 @@ AvatarMixer::~AvatarMixer() {
 
     _broadcastThread.quit();
     _broadcastThread.wait();
+
+    // the node list outlives us, so stop it batching for a thread that is going away
+    DependencyManager::get<NodeList>()->setSendBatchingThread(nullptr);
+
+    _broadcastThreadPool.waitForDone();
+    qDeleteAll(_broadcastWorkers);
+}
+
+void AvatarMixer::setupBroadcastWorkers(int numBroadcastThreads) {
+    if (numBroadcastThreads <= 0) {
+        numBroadcastThreads = QThread::idealThreadCount();
+    }
+    numBroadcastThreads = std::max(numBroadcastThreads, 1);
+
+    _broadcastThreadPool.waitForDone();
+    qDeleteAll(_broadcastWorkers);
+    _broadcastWorkers.clear();
+
+    // the first worker always runs on the broadcast thread, the rest are handed to the pool each frame
+    _broadcastWorkers.push_back(new AvatarMixerWorker(this));
+    for (int i = 1; i < numBroadcastThreads; ++i) {
+        _broadcastWorkers.push_back(new AvatarMixerPooledWorker(this, _broadcastWorkersDone));
+    }
+
+    _broadcastThreadPool.setMaxThreadCount(std::max(numBroadcastThreads - 1, 1));
+    // keep the pool threads around between frames instead of tearing them down after each broadcast
+    _broadcastThreadPool.setExpiryTimeout(-1);
 }
 
 const float BILLBOARD_AND_IDENTITY_SEND_PROBABILITY = 1.0f / 300.0f;
 
+// how many avatars past the full rate distance each receiver looks at per frame
+const int MAX_FAR_AVATARS_CONSIDERED_PER_FRAME = 32;
+
 // NOTE: some additional optimizations to consider.
 //    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
 //       if the avatar is not in view or in the keyhole.
 void AvatarMixer::broadcastAvatarData() {
+    TRACE_SCOPE("AvatarMixer::broadcastAvatarData");
 
     int idleTime = QDateTime::currentMSecsSinceEpoch() - _lastFrameTimestamp;
 
@@ -128,243 +197,334 @@ void AvatarMixer::broadcastAvatarData() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    // setup for distributed random floating point values
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_real_distribution<float> distribution;
+    // take one pass over the avatars to snapshot everything the receivers need from them and index their positions.
+    // The workers building packets below only ever read this snapshot, so they never contend on a sender's mutex
+    _frameAvatars.clear();
+    _avatarGrid.clear();
 
     nodeList->eachMatchingNode(
         [&](const SharedNodePointer& node)->bool {
-            if (!node->getLinkedData()) {
-                return false;
-            }
-            if (node->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!node->getActiveSocket()) {
-                return false;
-            }
-            return true;
+            return node->getLinkedData() != nullptr;
         },
         [&](const SharedNodePointer& node) {
             AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
-            MutexTryLocker lock(nodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
+
+            // wait for the lock instead of skipping this avatar, it is only ever held briefly while a packet is parsed
+            QMutexLocker nodeDataLocker(&nodeData->getMutex());
+
+            FrameAvatar frameAvatar;
+            frameAvatar.node = node;
+            frameAvatar.data = nodeData;
+            frameAvatar.position = nodeData->getAvatar().getPosition();
+            frameAvatar.sequenceNumber = node->getLastSequenceNumberForPacketType(PacketType::AvatarData);
+
+            bool wasCacheHit = false;
+            frameAvatar.avatarDataSegment = nodeData->getAvatarDataSegment(node->getUUID(), frameAvatar.sequenceNumber,
+                                                                           wasCacheHit);
+            ++_sumAvatarDataEncodeRequests;
+            if (wasCacheHit) {
+                ++_sumAvatarDataEncodeCacheHits;
             }
-            ++_sumListeners;
 
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getPosition();
+            frameAvatar.billboardChangeTimestamp = nodeData->getBillboardChangeTimestamp();
+            if (frameAvatar.billboardChangeTimestamp > 0) {
+                frameAvatar.billboard = nodeData->getAvatar().getBillboard();
+            }
+
+            frameAvatar.identityChangeTimestamp = nodeData->getIdentityChangeTimestamp();
+            if (frameAvatar.identityChangeTimestamp > 0) {
+                frameAvatar.identityPacketData = nodeData->getIdentityPacketData(node->getUUID());
+            }
+
+            _avatarGrid.insert(_frameAvatars.size(), frameAvatar.position);
+            _frameAvatars.push_back(frameAvatar);
+        }
+    );
 
-            // reset the internal state for correct random number distribution
-            distribution.reset();
+    int numFrameAvatars = _frameAvatars.size();
 
-            // reset the max distance for this frame
-            float maxAvatarDistanceThisFrame = 0.0f;
+    // past the full rate distance we only consider every _farAvatarStride'th avatar each frame, and scale up the
+    // send probability of the ones we do consider to keep the expected send rate for far avatars where it was
+    _farAvatarStride = std::max(1, (numFrameAvatars + MAX_FAR_AVATARS_CONSIDERED_PER_FRAME - 1)
+                                   / MAX_FAR_AVATARS_CONSIDERED_PER_FRAME);
 
-            // reset the number of sent avatars
-            nodeData->resetNumAvatarsSentLastFrame();
+    // every agent we can reach gets a packet this frame
+    for (int avatarIndex = 0; avatarIndex < numFrameAvatars; ++avatarIndex) {
+        const SharedNodePointer& node = _frameAvatars[avatarIndex].node;
+        if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
+            _frameReceivers.push_back(std::unique_ptr<FrameReceiver>(new FrameReceiver(avatarIndex)));
+        }
+    }
 
-            // keep a counter of the number of considered avatars
-            int numOtherAvatars = 0;
+    broadcastReceiversForFrame();
 
-            // keep track of outbound data rate specifically for avatar data
-            int numAvatarDataBytes = 0;
+    // the packets are sent from this thread once every worker is done with them
+    for (auto& receiver : _frameReceivers) {
+        const SharedNodePointer& node = _frameAvatars[receiver->avatarIndex].node;
 
-            // keep track of the number of other avatars held back in this frame
-            int numAvatarsHeldBack = 0;
+        for (auto& packet : receiver->packets) {
+            nodeList->sendPacket(std::move(packet), *node);
+        }
 
-            // keep track of the number of other avatar frames skipped
-            int numAvatarsWithSkippedFrames = 0;
+        nodeList->sendPacketList(receiver->avatarPacketList, *node);
 
-            // use the data rate specifically for avatar data for FRD adjustment checks
-            float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
+        _sumAvatarsConsidered += receiver->numAvatarsConsidered;
+        _sumBillboardPackets += receiver->numBillboardPackets;
+        _sumIdentityPackets += receiver->numIdentityPackets;
+    }
+    _sumListeners += _frameReceivers.size();
 
-            // Check if it is time to adjust what we send this client based on the observed
-            // bandwidth to this node. We do this once a second, which is also the window for
-            // the bandwidth reported by node->getOutboundBandwidth();
-            if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
+    // everything above was queued, send it with as few syscalls as we can
+    nodeList->flushSendQueue();
 
-                const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
-                const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
-                const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
+    // don't hold on to nodes that may be killed before the next frame
+    _frameReceivers.clear();
+    _frameAvatars.clear();
 
-                // get the current full rate distance so we can work with it
-                float currentFullRateDistance = nodeData->getFullRateDistance();
+    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
 
-                if (avatarDataRateLastSecond > _maxKbpsPerNode) {
+void AvatarMixer::broadcastQueuedReceivers(std::mt19937& generator) {
+    int receiverIndex;
+    while ((receiverIndex = _nextFrameReceiverIndex.fetchAndAddOrdered(1)) < (int) _frameReceivers.size()) {
+        broadcastToReceiver(*_frameReceivers[receiverIndex], generator);
+    }
+}
 
-                    // is the FRD greater than the farthest avatar?
-                    // if so, before we calculate anything, set it to that distance
-                    currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+void AvatarMixer::broadcastReceiversForFrame() {
+    _nextFrameReceiverIndex.store(0);
 
-                    // we're adjusting the full rate distance to target a bandwidth in the middle
-                    // of the hysterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+    // don't wake up more pooled workers than there are receivers for them to take
+    int numPooledWorkers = std::min(_broadcastWorkers.size(), (int) _frameReceivers.size()) - 1;
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
-                           && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
-                    // we are constrained AND we've recovered to below the acceptable ratio
-                    // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+    for (int i = 1; i <= numPooledWorkers; ++i) {
+        _broadcastThreadPool.start(_broadcastWorkers[i]);
+    }
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                }
-            } else {
-                nodeData->incrementNumFramesSinceFRDAdjustment();
-            }
+    // the broadcast thread works through the queue alongside the pool, then waits for the stragglers
+    _broadcastWorkers[0]->run();
 
-            // setup a PacketList for the avatarPackets
-            NLPacketList avatarPacketList(PacketType::BulkAvatarData);
+    if (numPooledWorkers > 0) {
+        _broadcastWorkersDone.acquire(numPooledWorkers);
+    }
+}
+
+void AvatarMixer::broadcastToReceiver(FrameReceiver& receiver, std::mt19937& generator) {
+    TRACE_SCOPE("AvatarMixer::broadcastToReceiver");
+    const FrameAvatar& receiverAvatar = _frameAvatars[receiver.avatarIndex];
+    AvatarMixerClientData* nodeData = receiverAvatar.data;
 
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    if (!otherNode->getLinkedData()) {
-                        return false;
-                    }
-                    if (otherNode->getUUID() == node->getUUID()) {
-                        return false;
-                    }
+    // the receiver's own state is only touched by this worker, but the packet handlers can still get at it
+    QMutexLocker nodeDataLocker(&nodeData->getMutex());
 
-                    return true;
-                },
-                [&](const SharedNodePointer& otherNode) {
-                    ++numOtherAvatars;
+    glm::vec3 myPosition = receiverAvatar.position;
+
+    // setup for distributed random floating point values
+    std::uniform_real_distribution<float> distribution;
 
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
+    // reset the number of sent avatars
+    nodeData->resetNumAvatarsSentLastFrame();
 
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
+    // every other avatar in the frame is a candidate, even if we don't look at all of them
+    int numOtherAvatars = _frameAvatars.size() - 1;
 
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getPosition();
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
+    // keep track of outbound data rate specifically for avatar data
+    int numAvatarDataBytes = 0;
 
-                    // potentially update the max full rate distance for this frame
-                    maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+    // keep track of the number of other avatars held back in this frame
+    int numAvatarsHeldBack = 0;
 
-                    if (distanceToAvatar != 0.0f
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
-                    }
+    // keep track of the number of other avatar frames skipped
+    int numAvatarsWithSkippedFrames = 0;
 
-                    PacketSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    PacketSequenceNumber lastSeqFromSender = otherNode->getLastSequenceNumberForPacketType(PacketType::AvatarData);
+    // use the data rate specifically for avatar data for FRD adjustment checks
+    float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
 
-                    if (lastSeqToReceiver > lastSeqFromSender) {
-                        // Did we somehow get out of order packets from the sender?
-                        // We don't expect this to happen - in RELEASE we add this to a trackable stat
-                        // and in DEBUG we crash on the assert
+    // Check if it is time to adjust what we send this client based on the observed
+    // bandwidth to this node. We do this once a second, which is also the window for
+    // the bandwidth reported by node->getOutboundBandwidth();
+    if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
 
-                        otherNodeData->incrementNumOutOfOrderSends();
+        const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
+        const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
+        const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
 
-                        assert(false);
-                    }
+        // get the current full rate distance so we can work with it
+        float currentFullRateDistance = nodeData->getFullRateDistance();
 
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    }
+        if (avatarDataRateLastSecond > _maxKbpsPerNode) {
 
-                    // we're going to send this avatar
+            // is the FRD greater than the farthest avatar?
+            // if so, before we calculate anything, set it to that distance
+            currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
 
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
+            // we're adjusting the full rate distance to target a bandwidth in the middle
+            // of the hysterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
 
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(),
-                        otherNode->getLastSequenceNumberForPacketType(PacketType::AvatarData));
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
+                   && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
+            // we are constrained AND we've recovered to below the acceptable ratio
+            // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
 
-                    // start a new segment in the PacketList for this avatar
-                    avatarPacketList.startSegment();
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        }
+    } else {
+        nodeData->incrementNumFramesSinceFRDAdjustment();
+    }
 
-                    numAvatarDataBytes += avatarPacketList.write(otherNode->getUUID().toRfc4122());
-                    numAvatarDataBytes += avatarPacketList.write(otherAvatar.toByteArray());
+    float fullRateDistance = nodeData->getFullRateDistance();
 
-                    avatarPacketList.endSegment();
+    // the farthest of the avatars we measure the distance to this frame
+    float maxAvatarDistance = 0.0f;
 
-                    // if the receiving avatar has just connected make sure we send out the mesh and billboard
-                    // for this avatar (assuming they exist)
-                    bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets();
+    // this is an AGENT we have received head data from
+    // send back a packet with other active node data to this node
+    auto considerOtherAvatar = [&](const FrameAvatar& other, float distanceToAvatar, float sendProbabilityScale) {
+        ++receiver.numAvatarsConsidered;
 
-                    // we will also force a send of billboard or identity packet
-                    // if either has changed in the last frame
+        //  Decide whether to send this avatar's data based on it's distance from us
 
-                    if (otherNodeData->getBillboardChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                            || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+        //  The full rate distance is the distance at which EVERY update will be sent for this avatar
+        //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
+        if (distanceToAvatar != 0.0f
+            && distribution(generator) > sendProbabilityScale * (fullRateDistance / distanceToAvatar)) {
+            return;
+        }
 
-                        QByteArray rfcUUID = otherNode->getUUID().toRfc4122();
-                        QByteArray billboard = otherNodeData->getAvatar().getBillboard();
+        const QUuid& otherUUID = other.node->getUUID();
+        PacketSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherUUID);
+        PacketSequenceNumber lastSeqFromSender = other.sequenceNumber;
 
-                        auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + billboard.size());
-                        billboardPacket->write(rfcUUID);
-                        billboardPacket->write(billboard);
+        if (lastSeqToReceiver > lastSeqFromSender) {
+            // Did we somehow get out of order packets from the sender?
+            // We don't expect this to happen - in RELEASE we add this to a trackable stat
+            // and in DEBUG we crash on the assert
 
-                        nodeList->sendPacket(std::move(billboardPacket), *node);
+            other.data->incrementNumOutOfOrderSends();
 
-                        ++_sumBillboardPackets;
-                    }
+            assert(false);
+        }
 
-                    if (otherNodeData->getIdentityChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || randFloat() < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+        // make sure we haven't already sent this data from this sender to this receiver
+        // or that somehow we haven't sent
+        if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+            ++numAvatarsHeldBack;
+            return;
+        } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
+            // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+            ++numAvatarsWithSkippedFrames;
+        }
 
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
+        // we're going to send this avatar
 
-                        auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+        // increment the number of avatars sent to this reciever
+        nodeData->incrementNumAvatarsSentLastFrame();
 
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+        // set the last sent sequence number for this sender on the receiver
+        nodeData->setLastBroadcastSequenceNumber(otherUUID, lastSeqFromSender);
 
-                        identityPacket->write(individualData);
+        // start a new segment in the PacketList for this avatar
+        receiver.avatarPacketList.startSegment();
 
-                        nodeList->sendPacket(std::move(identityPacket), *node);
+        numAvatarDataBytes += receiver.avatarPacketList.write(other.avatarDataSegment);
 
-                        ++_sumIdentityPackets;
-                    }
-            });
-            
-            // close the current packet so that we're always sending something
-            avatarPacketList.closeCurrentPacket(true);
+        receiver.avatarPacketList.endSegment();
 
-            // send the avatar data PacketList
-            nodeList->sendPacketList(avatarPacketList, *node);
+        // if the receiving avatar has just connected make sure we send out the mesh and billboard
+        // for this avatar (assuming they exist)
+        bool forceSend = !nodeData->checkAndSetHasReceivedFirstPackets();
 
-            // record the bytes sent for other avatar data in the AvatarMixerClientData
-            nodeData->recordSentAvatarData(numAvatarDataBytes);
+        // we will also force a send of billboard or identity packet
+        // if either has changed in the last frame
 
-            // record the number of avatars held back this frame
-            nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
-            nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+        if (other.billboardChangeTimestamp > 0
+            && (forceSend
+                || other.billboardChangeTimestamp > _lastFrameTimestamp
+                || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
 
-            if (numOtherAvatars == 0) {
-                // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
-                nodeData->setMaxAvatarDistance(FLT_MAX);
-            } else {
-                nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
-            }
+            QByteArray rfcUUID = otherUUID.toRfc4122();
+
+            auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + other.billboard.size());
+            billboardPacket->write(rfcUUID);
+            billboardPacket->write(other.billboard);
+
+            receiver.packets.push_back(std::move(billboardPacket));
+
+            ++receiver.numBillboardPackets;
         }
-    );
 
-    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+        if (other.identityChangeTimestamp > 0
+            && (forceSend
+                || other.identityChangeTimestamp > _lastFrameTimestamp
+                || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+
+            auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, other.identityPacketData.size());
+
+            identityPacket->write(other.identityPacketData);
+
+            receiver.packets.push_back(std::move(identityPacket));
+
+            ++receiver.numIdentityPackets;
+        }
+    };
+
+    // every avatar inside the full rate distance gets considered at full rate
+    _avatarGrid.forEachInRadius(myPosition, fullRateDistance, [&](int otherIndex) {
+        if (otherIndex == receiver.avatarIndex) {
+            return;
+        }
+
+        float distanceToAvatar = glm::distance(myPosition, _frameAvatars[otherIndex].position);
+        maxAvatarDistance = std::max(maxAvatarDistance, distanceToAvatar);
+        if (distanceToAvatar <= fullRateDistance) {
+            considerOtherAvatar(_frameAvatars[otherIndex], distanceToAvatar, 1.0f);
+        }
+    });
+
+    // then a rotating sample of the avatars outside of it
+    int farAvatarOffset = nodeData->getFarAvatarSampleOffset() % _farAvatarStride;
+    for (int otherIndex = farAvatarOffset; otherIndex < _frameAvatars.size(); otherIndex += _farAvatarStride) {
+        if (otherIndex == receiver.avatarIndex) {
+            continue;
+        }
+
+        float distanceToAvatar = glm::distance(myPosition, _frameAvatars[otherIndex].position);
+        maxAvatarDistance = std::max(maxAvatarDistance, distanceToAvatar);
+        if (distanceToAvatar > fullRateDistance) {
+            considerOtherAvatar(_frameAvatars[otherIndex], distanceToAvatar, (float) _farAvatarStride);
+        }
+    }
+    nodeData->setFarAvatarSampleOffset(farAvatarOffset + 1);
+
+    // close the current packet so that we're always sending something
+    receiver.avatarPacketList.closeCurrentPacket(true);
+
+    // record the bytes sent for other avatar data in the AvatarMixerClientData
+    nodeData->recordSentAvatarData(numAvatarDataBytes);
+
+    // record the number of avatars held back this frame
+    nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
+    nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+
+    if (numOtherAvatars == 0) {
+        // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
+        nodeData->setMaxAvatarDistance(FLT_MAX);
+    } else {
+        // every avatar inside the full rate distance is measured each frame, but the ones outside it only once in
+        // _farAvatarStride frames, so the farthest avatar is only known once the far sample has gone all the way round
+        if (farAvatarOffset != 0) {
+            maxAvatarDistance = std::max(maxAvatarDistance, nodeData->getSampledMaxAvatarDistance());
+        }
+        nodeData->setSampledMaxAvatarDistance(maxAvatarDistance);
+        if (farAvatarOffset == _farAvatarStride - 1) {
+            nodeData->setMaxAvatarDistance(maxAvatarDistance);
+        }
+    }
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
@@ -448,6 +608,28 @@ void AvatarMixer::sendStatsPacket() {
     statsObject["average_billboard_packets_per_frame"] = (float) _sumBillboardPackets / (float) _numStatFrames;
     statsObject["average_identity_packets_per_frame"] = (float) _sumIdentityPackets / (float) _numStatFrames;
 
+    if (_sumAvatarDataEncodeRequests > 0) {
+        statsObject["avatar_data_encode_cache_hit_ratio"] =
+            (float) _sumAvatarDataEncodeCacheHits / (float) _sumAvatarDataEncodeRequests;
+    } else {
+        statsObject["avatar_data_encode_cache_hit_ratio"] = 0.0;
+    }
+
+    if (_sumListeners > 0) {
+        statsObject["average_avatars_considered_per_listener"] = (float) _sumAvatarsConsidered / (float) _sumListeners;
+    } else {
+        statsObject["average_avatars_considered_per_listener"] = 0.0;
+    }
+
+    statsObject["broadcast_threads"] = _broadcastWorkers.size();
+
+    // read before addPacketStatsAndSendStatsPacket resets them along with the packet stats
+    int sendSyscalls = 0;
+    int receiveSyscalls = 0;
+    DependencyManager::get<NodeList>()->getSyscallStats(sendSyscalls, receiveSyscalls);
+    statsObject["send_syscalls_per_frame"] = (float) sendSyscalls / (float) _numStatFrames;
+    statsObject["receive_syscalls_per_frame"] = (float) receiveSyscalls / (float) _numStatFrames;
+
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
 
@@ -485,6 +667,9 @@ void AvatarMixer::sendStatsPacket() {
     _sumListeners = 0;
     _sumBillboardPackets = 0;
     _sumIdentityPackets = 0;
+    _sumAvatarDataEncodeRequests = 0;
+    _sumAvatarDataEncodeCacheHits = 0;
+    _sumAvatarsConsidered = 0;
     _numStatFrames = 0;
 }
 
@@ -528,6 +713,9 @@ void AvatarMixer::run() {
     // parse the settings to pull out the values we need
     parseDomainServerSettings(domainHandler.getSettingsObject());
 
+    // the packets for a frame are queued on the broadcast thread and flushed once it is done with them
+    nodeList->setSendBatchingThread(&_broadcastThread);
+
     // start the broadcastThread
     _broadcastThread.start();
 }
@@ -544,4 +732,14 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
 
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
+
+    const QString BROADCAST_THREADS_KEY = "broadcast_threads";
+    bool ok = false;
+    int numBroadcastThreads =
+        domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[BROADCAST_THREADS_KEY].toString().toInt(&ok);
+    if (!ok) {
+        numBroadcastThreads = DEFAULT_BROADCAST_THREADS;
+    }
+    setupBroadcastWorkers(numBroadcastThreads);
+    qDebug() << "Broadcasting avatar data on" << _broadcastWorkers.size() << "thread(s)";
 }
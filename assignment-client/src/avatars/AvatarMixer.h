@@ -15,8 +15,24 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <NLPacket.h>
+#include <NLPacketList.h>
 #include <ThreadedAssignment.h>
 
+#include "AvatarSpatialGrid.h"
+
+class AvatarMixerClientData;
+class AvatarMixerWorker;
+
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -38,8 +54,42 @@ private slots:
     void handleKillAvatarPacket(QSharedPointer<NLPacket> packet);
     
 private:
+    friend class AvatarMixerWorker;
+
+    // an avatar taking part in the current broadcast frame, with everything receivers need from it as of the
+    // start of the frame
+    struct FrameAvatar {
+        SharedNodePointer node;
+        AvatarMixerClientData* data;
+        glm::vec3 position;
+        PacketSequenceNumber sequenceNumber;
+        QByteArray avatarDataSegment;
+        quint64 billboardChangeTimestamp;
+        QByteArray billboard;
+        quint64 identityChangeTimestamp;
+        QByteArray identityPacketData;
+    };
+
+    // the packets built for one receiver this frame, sent from the broadcast thread once the workers are done
+    struct FrameReceiver {
+        FrameReceiver(int avatarIndex) : avatarIndex(avatarIndex), avatarPacketList(PacketType::BulkAvatarData) {}
+
+        int avatarIndex;
+        NLPacketList avatarPacketList;
+        std::vector<std::unique_ptr<NLPacket>> packets;
+
+        int numAvatarsConsidered = 0;
+        int numBillboardPackets = 0;
+        int numIdentityPackets = 0;
+    };
+
     void broadcastAvatarData();
     void parseDomainServerSettings(const QJsonObject& domainSettings);
+
+    void setupBroadcastWorkers(int numBroadcastThreads);
+    void broadcastReceiversForFrame();
+    void broadcastQueuedReceivers(std::mt19937& generator);
+    void broadcastToReceiver(FrameReceiver& receiver, std::mt19937& generator);
     
     QThread _broadcastThread;
     
@@ -52,9 +102,22 @@ private:
     int _numStatFrames;
     int _sumBillboardPackets;
     int _sumIdentityPackets;
+    int _sumAvatarDataEncodeRequests;
+    int _sumAvatarDataEncodeCacheHits;
+    int _sumAvatarsConsidered;
 
     float _maxKbpsPerNode = 0.0f;
 
+    QVector<FrameAvatar> _frameAvatars;
+    AvatarSpatialGrid _avatarGrid;
+    int _farAvatarStride = 1;
+
+    std::vector<std::unique_ptr<FrameReceiver>> _frameReceivers;
+    QAtomicInt _nextFrameReceiverIndex;
+    QThreadPool _broadcastThreadPool;
+    QVector<AvatarMixerWorker*> _broadcastWorkers;
+    QSemaphore _broadcastWorkersDone;
+
     QTimer* _broadcastTimer = nullptr;
 };
 
@@ -10,10 +10,15 @@
 //
 
 #include <udt/PacketHeaders.h>
+#include <UUID.h>
 
 #include "AvatarMixerClientData.h"
 
 int AvatarMixerClientData::parseData(NLPacket& packet) {
+    // the sequence number of the packet is noted before it is parsed, so a segment cached under it may have been encoded
+    // from the avatar as it was before this packet
+    _hasAvatarDataSegment = false;
+
     // compute the offset to the data payload
     return _avatar.parseDataFromBuffer(packet.read(packet.bytesLeftToRead()));
 }
@@ -24,6 +29,32 @@ bool AvatarMixerClientData::checkAndSetHasReceivedFirstPackets() {
     return oldValue;
 }
 
+const QByteArray& AvatarMixerClientData::getAvatarDataSegment(const QUuid& nodeUUID, PacketSequenceNumber sequenceNumber,
+                                                              bool& wasCacheHit) {
+    wasCacheHit = _hasAvatarDataSegment && _avatarDataSegmentSequenceNumber == sequenceNumber;
+
+    if (!wasCacheHit) {
+        _avatarDataSegment = nodeUUID.toRfc4122();
+        _avatarDataSegment.append(_avatar.toByteArray());
+
+        _avatarDataSegmentSequenceNumber = sequenceNumber;
+        _hasAvatarDataSegment = true;
+    }
+
+    return _avatarDataSegment;
+}
+
+const QByteArray& AvatarMixerClientData::getIdentityPacketData(const QUuid& nodeUUID) {
+    if (!_hasIdentityPacketData) {
+        _identityPacketData = _avatar.identityByteArray();
+        _identityPacketData.replace(0, NUM_BYTES_RFC4122_UUID, nodeUUID.toRfc4122());
+
+        _hasIdentityPacketData = true;
+    }
+
+    return _identityPacketData;
+}
+
 PacketSequenceNumber AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const {
     // return the matching PacketSequenceNumber, or the default if we don't have it
     auto nodeMatch = _lastBroadcastSequenceNumbers.find(nodeUUID);
@@ -41,7 +72,7 @@ void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["num_avatars_sent_last_frame"] = _numAvatarsSentLastFrame;
     jsonObject["avg_other_avatar_starves_per_second"] = getAvgNumOtherAvatarStarvesPerSecond();
     jsonObject["avg_other_avatar_skips_per_second"] = getAvgNumOtherAvatarSkipsPerSecond();
-    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends;
+    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends.load();
     
     jsonObject[OUTBOUND_AVATAR_DATA_STATS_KEY] = getOutboundAvatarDataKbps();
 }
@@ -16,6 +16,7 @@
 #include <cfloat>
 #include <unordered_map>
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QJsonObject>
 #include <QtCore/QUrl>
 
@@ -36,6 +37,11 @@ public:
     
     bool checkAndSetHasReceivedFirstPackets();
 
+    /// the BulkAvatarData segment (node UUID followed by the encoded avatar) for this avatar. The avatar is only
+    /// re-encoded when sequenceNumber moves past the one the cached segment was built for, so every receiver in a
+    /// broadcast frame shares one encoding. wasCacheHit is set when the cached segment was reused.
+    const QByteArray& getAvatarDataSegment(const QUuid& nodeUUID, PacketSequenceNumber sequenceNumber, bool& wasCacheHit);
+
     PacketSequenceNumber getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
     void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, PacketSequenceNumber sequenceNumber)
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
@@ -45,7 +51,12 @@ public:
     void setBillboardChangeTimestamp(quint64 billboardChangeTimestamp) { _billboardChangeTimestamp = billboardChangeTimestamp; }
     
     quint64 getIdentityChangeTimestamp() const { return _identityChangeTimestamp; }
-    void setIdentityChangeTimestamp(quint64 identityChangeTimestamp) { _identityChangeTimestamp = identityChangeTimestamp; }
+    void setIdentityChangeTimestamp(quint64 identityChangeTimestamp)
+        { _identityChangeTimestamp = identityChangeTimestamp; _hasIdentityPacketData = false; }
+
+    /// the AvatarIdentity payload for this avatar, with nodeUUID in place of the UUID the client sent. Only rebuilt when
+    /// the identity changes.
+    const QByteArray& getIdentityPacketData(const QUuid& nodeUUID);
    
     void setFullRateDistance(float fullRateDistance) { _fullRateDistance = fullRateDistance; }
     float getFullRateDistance() const { return _fullRateDistance; }
@@ -53,6 +64,13 @@ public:
     void setMaxAvatarDistance(float maxAvatarDistance) { _maxAvatarDistance = maxAvatarDistance; }
     float getMaxAvatarDistance() const { return _maxAvatarDistance; }
 
+    int getFarAvatarSampleOffset() const { return _farAvatarSampleOffset; }
+    void setFarAvatarSampleOffset(int farAvatarSampleOffset) { _farAvatarSampleOffset = farAvatarSampleOffset; }
+
+    /// the farthest avatar measured since the far avatar sample last started over at offset zero
+    void setSampledMaxAvatarDistance(float sampledMaxAvatarDistance) { _sampledMaxAvatarDistance = sampledMaxAvatarDistance; }
+    float getSampledMaxAvatarDistance() const { return _sampledMaxAvatarDistance; }
+
     void resetNumAvatarsSentLastFrame() { _numAvatarsSentLastFrame = 0; }
     void incrementNumAvatarsSentLastFrame() { ++_numAvatarsSentLastFrame; }
     int getNumAvatarsSentLastFrame() const { return _numAvatarsSentLastFrame; }
@@ -63,7 +81,7 @@ public:
     void recordNumOtherAvatarSkips(int numOtherAvatarSkips) { _otherAvatarSkips.updateAverage((float) numOtherAvatarSkips); }
     float getAvgNumOtherAvatarSkipsPerSecond() const { return _otherAvatarSkips.getAverageSampleValuePerSecond(); }
 
-    void incrementNumOutOfOrderSends() { ++_numOutOfOrderSends; }
+    void incrementNumOutOfOrderSends() { _numOutOfOrderSends.ref(); }
 
     int getNumFramesSinceFRDAdjustment() const { return _numFramesSinceAdjustment; }
     void incrementNumFramesSinceFRDAdjustment() { ++_numFramesSinceAdjustment; }
@@ -81,18 +99,28 @@ private:
     std::unordered_map<QUuid, PacketSequenceNumber, UUIDHasher> _lastBroadcastSequenceNumbers;
 
     bool _hasReceivedFirstPackets = false;
+
+    QByteArray _avatarDataSegment;
+    PacketSequenceNumber _avatarDataSegmentSequenceNumber = 0;
+    bool _hasAvatarDataSegment = false;
+
     quint64 _billboardChangeTimestamp = 0;
     quint64 _identityChangeTimestamp = 0;
+
+    QByteArray _identityPacketData;
+    bool _hasIdentityPacketData = false;
     
     float _fullRateDistance = FLT_MAX;
     float _maxAvatarDistance = FLT_MAX;
+    int _farAvatarSampleOffset = 0;
+    float _sampledMaxAvatarDistance = 0.0f;
     
     int _numAvatarsSentLastFrame = 0;
     int _numFramesSinceAdjustment = 0;
 
     SimpleMovingAverage _otherAvatarStarves;
     SimpleMovingAverage _otherAvatarSkips;
-    int _numOutOfOrderSends = 0;
+    QAtomicInt _numOutOfOrderSends;
     
     SimpleMovingAverage _avgOtherAvatarDataRate;
 };
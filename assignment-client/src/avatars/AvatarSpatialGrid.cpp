@@ -0,0 +1,48 @@
+//
+//  AvatarSpatialGrid.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarSpatialGrid.h"
+
+AvatarSpatialGrid::AvatarSpatialGrid(float cellSize) :
+    _cellSize(cellSize),
+    _minimum(FLT_MAX),
+    _maximum(-FLT_MAX),
+    _numAvatars(0)
+{
+}
+
+void AvatarSpatialGrid::clear() {
+    // keep the per cell vectors around, most avatars stay in the same cell from one frame to the next
+    for (auto& cell : _cells) {
+        cell.second.clear();
+    }
+
+    _minimum = glm::vec3(FLT_MAX);
+    _maximum = glm::vec3(-FLT_MAX);
+    _numAvatars = 0;
+}
+
+void AvatarSpatialGrid::insert(int index, const glm::vec3& position) {
+    _cells[keyForCell(cellCoordinatesFor(position))].push_back(index);
+
+    _minimum = glm::min(_minimum, position);
+    _maximum = glm::max(_maximum, position);
+    ++_numAvatars;
+}
+
+glm::ivec3 AvatarSpatialGrid::cellCoordinatesFor(const glm::vec3& position) const {
+    return glm::ivec3(glm::floor(position / _cellSize));
+}
+
+AvatarSpatialGrid::CellKey AvatarSpatialGrid::keyForCell(const glm::ivec3& cell) {
+    // 21 bits per axis, which covers far more than the domain at any sensible cell size
+    const CellKey AXIS_MASK = (1ULL << 21) - 1;
+    return ((CellKey)cell.x & AXIS_MASK) | (((CellKey)cell.y & AXIS_MASK) << 21) | (((CellKey)cell.z & AXIS_MASK) << 42);
+}
@@ -0,0 +1,93 @@
+//
+//  AvatarSpatialGrid.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSpatialGrid_h
+#define hifi_AvatarSpatialGrid_h
+
+#include <cfloat>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+const float DEFAULT_AVATAR_GRID_CELL_SIZE = 8.0f; // meters
+
+// Uniform grid of avatar positions, rebuilt by the avatar mixer every broadcast frame so that
+// each receiver only has to look at the avatars near it
+class AvatarSpatialGrid {
+public:
+    AvatarSpatialGrid(float cellSize = DEFAULT_AVATAR_GRID_CELL_SIZE);
+
+    void clear();
+
+    /// adds the avatar with the given index (into the caller's own list of avatars) at position
+    void insert(int index, const glm::vec3& position);
+
+    int size() const { return _numAvatars; }
+
+    /// calls functor(index) for every avatar in a cell overlapping the sphere. Avatars outside the sphere but inside
+    /// an overlapping cell are included as well, so callers still need to check distances.
+    template<typename F> void forEachInRadius(const glm::vec3& center, float radius, F functor) const;
+
+private:
+    typedef unsigned long long CellKey;
+
+    glm::ivec3 cellCoordinatesFor(const glm::vec3& position) const;
+    static CellKey keyForCell(const glm::ivec3& cell);
+
+    float _cellSize;
+    std::unordered_map<CellKey, std::vector<int>> _cells;
+    glm::vec3 _minimum;
+    glm::vec3 _maximum;
+    int _numAvatars;
+};
+
+template<typename F> void AvatarSpatialGrid::forEachInRadius(const glm::vec3& center, float radius, F functor) const {
+    if (_numAvatars == 0) {
+        return;
+    }
+
+    // clip the query box to the avatars we actually have so huge radii (FLT_MAX) stay finite
+    glm::vec3 queryMinimum = glm::max(center - glm::vec3(radius), _minimum);
+    glm::vec3 queryMaximum = glm::min(center + glm::vec3(radius), _maximum);
+    if (glm::any(glm::greaterThan(queryMinimum, queryMaximum))) {
+        return;
+    }
+
+    glm::ivec3 firstCell = cellCoordinatesFor(queryMinimum);
+    glm::ivec3 lastCell = cellCoordinatesFor(queryMaximum);
+    glm::ivec3 cellSpan = lastCell - firstCell + glm::ivec3(1);
+    double numQueryCells = (double)cellSpan.x * (double)cellSpan.y * (double)cellSpan.z;
+
+    if (numQueryCells >= (double)_cells.size()) {
+        // cheaper to walk the occupied cells than to probe every cell in the query box
+        for (auto& cell : _cells) {
+            for (int index : cell.second) {
+                functor(index);
+            }
+        }
+        return;
+    }
+
+    for (int x = firstCell.x; x <= lastCell.x; ++x) {
+        for (int y = firstCell.y; y <= lastCell.y; ++y) {
+            for (int z = firstCell.z; z <= lastCell.z; ++z) {
+                auto cell = _cells.find(keyForCell(glm::ivec3(x, y, z)));
+                if (cell != _cells.end()) {
+                    for (int index : cell->second) {
+                        functor(index);
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif // hifi_AvatarSpatialGrid_h
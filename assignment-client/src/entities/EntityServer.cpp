@@ -70,6 +70,16 @@ void EntityServer::beforeRun() {
 }
 
 void EntityServer::entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) {
+    entityEdited(newEntity.getEntityItemID(), senderNode);
+}
+
+void EntityServer::entityEdited(const EntityItemID& entityID, const SharedNodePointer& senderNode) {
+    // the sender ignores what we send it of the entity while its own edit is newer, so whatever it was sent since
+    // may not be what it has
+    EntityNodeData* nodeData = static_cast<EntityNodeData*>(senderNode->getLinkedData());
+    if (nodeData) {
+        nodeData->baselines.forgetItemLater(entityID);
+    }
 }
 
 
@@ -100,6 +110,11 @@ int EntityServer::sendSpecialPackets(const SharedNodePointer& node, OctreeQueryN
         EntityTree* tree = static_cast<EntityTree*>(_tree);
         bool hasMoreToSend = true;
 
+        // an entity that comes back under the same ID is not the one the client was sent
+        foreach (const QUuid& entityID, tree->getEntitiesDeletedSince(deletedEntitiesSentAt)) {
+            queryNode->baselines.forgetItem(entityID);
+        }
+
         packetsSent = 0;
 
         while (hasMoreToSend) {
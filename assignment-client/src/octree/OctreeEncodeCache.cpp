@@ -0,0 +1,118 @@
+//
+//  OctreeEncodeCache.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEncodeCache.h"
+
+const int MAX_CACHED_SCENES = 16;
+const int MAX_CACHED_SCENE_SIZE = 4 * 1024 * 1024; // uncompressed bytes
+
+bool OctreeEncodeCache::EncodeInputs::operator==(const EncodeInputs& other) const {
+    return targetSize == other.targetSize
+        && startSize == other.startSize
+        && wantColor == other.wantColor
+        && boundaryLevelAdjust == other.boundaryLevelAdjust
+        && octreeSizeScale == other.octreeSizeScale
+        && forceSendScene == other.forceSendScene;
+}
+
+OctreeEncodeCache::Scene::Scene(OctreeElement* root, quint64 rootLastChanged, const ViewFrustum& viewFrustum) :
+    _root(root),
+    _rootLastChanged(rootLastChanged),
+    _viewFrustum(viewFrustum)
+{
+}
+
+bool OctreeEncodeCache::Scene::matches(OctreeElement* root, quint64 rootLastChanged, const ViewFrustum& viewFrustum) const {
+    return root == _root && rootLastChanged == _rootLastChanged && _viewFrustum.matches(viewFrustum);
+}
+
+const OctreeEncodeCache::EncodedStep* OctreeEncodeCache::Scene::getStep(int index, const EncodeInputs& inputs) const {
+    if (index < _steps.size() && _steps[index].inputs == inputs) {
+        return &_steps[index];
+    }
+    return NULL;
+}
+
+bool OctreeEncodeCache::Scene::addStep(const EncodeInputs& inputs, const unsigned char* data, int length, int bytesWritten,
+                                       EncodeBitstreamParams::reason stopReason, bool completedScene, float encodeTime) {
+    if (_dataSize + length > MAX_CACHED_SCENE_SIZE) {
+        return false;
+    }
+
+    EncodedStep step;
+    step.inputs = inputs;
+    step.data = QByteArray(reinterpret_cast<const char*>(data), length);
+    step.bytesWritten = bytesWritten;
+    step.stopReason = stopReason;
+    step.completedScene = completedScene;
+    step.encodeTime = encodeTime;
+    _steps.push_back(step);
+
+    _dataSize += length;
+    return true;
+}
+
+OctreeEncodeCache::ScenePointer OctreeEncodeCache::findScene(OctreeElement* root, quint64 rootLastChanged,
+                                                             const ViewFrustum& viewFrustum) {
+    QMutexLocker locker(&_mutex);
+
+    _sceneLookups++;
+    foreach (const ScenePointer& scene, _scenes) {
+        if (scene->matches(root, rootLastChanged, viewFrustum)) {
+            _sceneHits++;
+            return scene;
+        }
+    }
+    return ScenePointer();
+}
+
+void OctreeEncodeCache::addScene(const ScenePointer& scene) {
+    if (!scene->isComplete()) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    // scenes of an older version of the tree can never be used again
+    QList<ScenePointer>::iterator it = _scenes.begin();
+    while (it != _scenes.end()) {
+        if ((*it)->getRootLastChanged() > scene->getRootLastChanged()) {
+            return;
+        } else if ((*it)->isStale(scene->getRootLastChanged())) {
+            it = _scenes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    _scenes.push_back(scene);
+    while (_scenes.size() > MAX_CACHED_SCENES) {
+        _scenes.pop_front();
+    }
+}
+
+void OctreeEncodeCache::trackReusedEncode(float encodeTimeSaved) {
+    QMutexLocker locker(&_mutex);
+    _reusedEncodes++;
+    _encodeTimeSaved += encodeTimeSaved;
+}
+
+int OctreeEncodeCache::getCachedSceneCount() {
+    QMutexLocker locker(&_mutex);
+    return _scenes.size();
+}
+
+void OctreeEncodeCache::resetStats() {
+    QMutexLocker locker(&_mutex);
+    _sceneLookups = 0;
+    _sceneHits = 0;
+    _reusedEncodes = 0;
+    _encodeTimeSaved = 0.0;
+}
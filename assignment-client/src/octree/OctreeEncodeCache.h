@@ -0,0 +1,120 @@
+//
+//  OctreeEncodeCache.h
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Shares encoded scenes between the octree send threads
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEncodeCache_h
+#define hifi_OctreeEncodeCache_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+
+#include <Octree.h>
+#include <ViewFrustum.h>
+
+/// Keeps the output of the encodeTreeBitstream() calls that made up a full scene, so that send threads whose clients ask
+/// for the same scene of the same version of the tree can append the encoded bytes instead of encoding them again.
+///
+/// A scene is cached as a whole rather than per subtree: the extra encode data an EntityTree keeps for a scene makes each
+/// call depend on the ones before it, so a call can only be reused when every call before it was reused too.
+class OctreeEncodeCache {
+public:
+    /// everything, other than the tree and the view, that decides what a single encodeTreeBitstream() call writes
+    class EncodeInputs {
+    public:
+        int targetSize; // of the packet data
+        int startSize; // uncompressed bytes already in the packet data
+        bool wantColor;
+        int boundaryLevelAdjust;
+        float octreeSizeScale;
+        bool forceSendScene;
+
+        bool operator==(const EncodeInputs& other) const;
+    };
+
+    /// the result of one encodeTreeBitstream() call
+    class EncodedStep {
+    public:
+        EncodeInputs inputs;
+        QByteArray data; // what the call appended to the uncompressed stream
+        int bytesWritten;
+        EncodeBitstreamParams::reason stopReason;
+        bool completedScene;
+        float encodeTime;
+    };
+
+    class Scene {
+    public:
+        Scene(OctreeElement* root, quint64 rootLastChanged, const ViewFrustum& viewFrustum);
+
+        /// true if this scene was encoded from the same version of the tree for the same view. What the client was sent
+        /// before does not matter, since a full scene that is not a view delta sends everything in view.
+        bool matches(OctreeElement* root, quint64 rootLastChanged, const ViewFrustum& viewFrustum) const;
+
+        /// true if the tree was changed since the scene started encoding
+        bool isStale(quint64 rootLastChanged) const { return rootLastChanged != _rootLastChanged; }
+
+        /// the step at index if it was encoded with the same inputs, otherwise NULL
+        const EncodedStep* getStep(int index, const EncodeInputs& inputs) const;
+
+        /// records the next step of a scene being encoded. Returns false if the scene grew too large to cache, in which
+        /// case the scene should be dropped.
+        bool addStep(const EncodeInputs& inputs, const unsigned char* data, int length, int bytesWritten,
+                     EncodeBitstreamParams::reason stopReason, bool completedScene, float encodeTime);
+
+        bool isComplete() const { return !_steps.isEmpty() && _steps.last().completedScene; }
+
+        quint64 getRootLastChanged() const { return _rootLastChanged; }
+        int getStepCount() const { return _steps.size(); }
+        int getDataSize() const { return _dataSize; }
+
+    private:
+        OctreeElement* _root; // only compared, never dereferenced
+        quint64 _rootLastChanged;
+        ViewFrustum _viewFrustum;
+
+        QVector<EncodedStep> _steps;
+        int _dataSize = 0;
+    };
+
+    typedef QSharedPointer<Scene> ScenePointer;
+
+    /// returns a complete cached scene matching the client's view, or a null pointer
+    ScenePointer findScene(OctreeElement* root, quint64 rootLastChanged, const ViewFrustum& viewFrustum);
+
+    /// shares a completely encoded scene with the other send threads
+    void addScene(const ScenePointer& scene);
+
+    /// called when a step of a cached scene was used in place of an encode
+    void trackReusedEncode(float encodeTimeSaved);
+
+    int getSceneLookups() const { return _sceneLookups; }
+    int getSceneHits() const { return _sceneHits; }
+    float getSceneHitRate() const { return _sceneLookups == 0 ? 0.0f : (float)_sceneHits / (float)_sceneLookups; }
+    quint64 getReusedEncodes() const { return _reusedEncodes; }
+    double getEncodeTimeSaved() const { return _encodeTimeSaved; } /// in usecs
+    int getCachedSceneCount();
+
+    void resetStats();
+
+private:
+    QMutex _mutex;
+    QList<ScenePointer> _scenes; // oldest first
+
+    int _sceneLookups = 0;
+    int _sceneHits = 0;
+    quint64 _reusedEncodes = 0;
+    double _encodeTimeSaved = 0.0;
+};
+
+#endif // hifi_OctreeEncodeCache_h
@@ -22,6 +22,16 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// edits are applied in epochs, each holding the tree's write lock for a run of whole packets. This bounds how long the
+// send threads are kept from reading the tree by a single epoch.
+const quint64 MAX_EDIT_EPOCH_USECS = 5 * USECS_PER_MSEC;
+
+// the sequence number and sent time ahead of the edit messages in an edit packet
+const int EDIT_PACKET_HEADER_BYTES = sizeof(unsigned short int) + sizeof(quint64);
+
+// a batch with fewer decodable packets than this is decoded one edit at a time as it is applied
+const int MIN_PACKETS_TO_DECODE_IN_PARALLEL = 2;
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -30,8 +40,12 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _totalLockWaitTime(0),
     _totalElementsInPacket(0),
     _totalPackets(0),
+    _totalEditEpochs(0),
+    _totalElementsDecodedInParallel(0),
     _lastNackTime(usecTimestampNow()),
-    _shuttingDown(false)
+    _shuttingDown(false),
+    _editEpochStartedAt(0),
+    _editDecoder(myServer->getOctree())
 {
 }
 
@@ -41,6 +55,8 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalLockWaitTime = 0;
     _totalElementsInPacket = 0;
     _totalPackets = 0;
+    _totalEditEpochs = 0;
+    _totalElementsDecodedInParallel = 0;
     _lastNackTime = usecTimestampNow();
 
     _singleSenderStats.clear();
@@ -65,21 +81,80 @@ void OctreeInboundPacketProcessor::preProcess() {
     }
 }
 
+void OctreeInboundPacketProcessor::prepareToProcess(const std::list<NodeSharedPacketPair>& packets) {
+    if (!_myServer->wantsParallelEditDecoding() || _shuttingDown) {
+        return;
+    }
+
+    // decoding doesn't need the tree, so the send threads keep reading it while the edits of the batch are decoded
+    Octree* tree = _myServer->getOctree();
+    for (auto& packetPair : packets) {
+        const NLPacket* packet = packetPair.second.data();
+        PacketType::Value packetType = packet->getType();
+        if (tree->handlesEditPacketType(packetType) && tree->canDecodeEditPacketType(packetType)
+                && packet->getPayloadSize() > EDIT_PACKET_HEADER_BYTES) {
+            const unsigned char* editData = reinterpret_cast<const unsigned char*>(packet->getPayload())
+                + EDIT_PACKET_HEADER_BYTES;
+            int index = _editDecoder.addPacket(packetType, editData, packet->getPayloadSize() - EDIT_PACKET_HEADER_BYTES);
+            _decodedPackets.insert(packet, index);
+        }
+    }
+
+    if (_editDecoder.getPacketCount() < MIN_PACKETS_TO_DECODE_IN_PARALLEL) {
+        _editDecoder.clear();
+        _decodedPackets.clear();
+        return;
+    }
+    _editDecoder.decode();
+}
+
 void OctreeInboundPacketProcessor::midProcess() {
-    // check if it's time to send a nack. If yes, do so
     quint64 now = usecTimestampNow();
+
+    // let the send threads in between packets as soon as one of them waits for the tree, or once this epoch has
+    // run long enough
+    if (_editEpochStartedAt != 0
+        && (_myServer->getOctree()->hasWaitingReaders() || now - _editEpochStartedAt >= MAX_EDIT_EPOCH_USECS)) {
+        endEditEpoch();
+    }
+
+    // check if it's time to send a nack. If yes, do so
     if (now - _lastNackTime >= TOO_LONG_SINCE_LAST_NACK) {
+        endEditEpoch();
         _lastNackTime = now;
         sendNackPackets();
     }
 }
 
+void OctreeInboundPacketProcessor::postProcess() {
+    endEditEpoch();
+
+    _editDecoder.clear();
+    _decodedPackets.clear();
+}
+
+void OctreeInboundPacketProcessor::beginEditEpoch() {
+    if (_editEpochStartedAt == 0) {
+        _myServer->getOctree()->lockForWrite();
+        _editEpochStartedAt = usecTimestampNow();
+        _totalEditEpochs++;
+    }
+}
+
+void OctreeInboundPacketProcessor::endEditEpoch() {
+    if (_editEpochStartedAt != 0) {
+        _myServer->getOctree()->unlock();
+        _editEpochStartedAt = 0;
+    }
+}
+
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
         return;
     }
 
+    TRACE_SCOPE("OctreeInboundPacketProcessor::processPacket");
     bool debugProcessPacket = _myServer->wantsVerboseDebug();
 
     if (debugProcessPacket) {
@@ -142,6 +217,29 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<NLPacket> packet
             }
         }
         
+        // the edits decoded ahead with the rest of the batch only have to be applied
+        QHash<const NLPacket*, int>::const_iterator decodedPacket = _decodedPackets.constFind(packet.data());
+        if (decodedPacket != _decodedPackets.constEnd()) {
+            int decodedBytes;
+            QVector<OctreeDecodedEdit*> decodedEdits = _editDecoder.takeEdits(decodedPacket.value(), decodedBytes);
+            foreach (OctreeDecodedEdit* decodedEdit, decodedEdits) {
+                quint64 startLock = usecTimestampNow();
+                beginEditEpoch();
+                quint64 startProcess = usecTimestampNow();
+                _myServer->getOctree()->applyDecodedEdit(packetType, *decodedEdit, sendingNode);
+                quint64 endProcess = usecTimestampNow();
+
+                editsInPacket++;
+                processTime += endProcess - startProcess;
+                lockWaitTime += startProcess - startLock;
+                delete decodedEdit;
+            }
+            _totalElementsDecodedInParallel += decodedEdits.size();
+
+            // anything that could not be decoded ahead is processed below
+            packet->seek(packet->pos() + decodedBytes);
+        }
+
         const unsigned char* editData = nullptr;
         
         while (packet->bytesLeftToRead() > 0) {
@@ -160,7 +258,7 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<NLPacket> packet
             }
 
             quint64 startLock = usecTimestampNow();
-            _myServer->getOctree()->lockForWrite();
+            beginEditEpoch();
             quint64 startProcess = usecTimestampNow();
             int editDataBytesRead =
                 _myServer->getOctree()->processEditPacketData(*packet, editData, maxSize, sendingNode);
@@ -170,7 +268,6 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<NLPacket> packet
                                 << "editDataBytesRead=" << editDataBytesRead;
             }
 
-            _myServer->getOctree()->unlock();
             quint64 endProcess = usecTimestampNow();
 
             editsInPacket++;
@@ -16,6 +16,8 @@
 
 #include <ReceivedPacketProcessor.h>
 
+#include <OctreeEditDecoder.h>
+
 #include "SequenceNumberStats.h"
 
 class OctreeServer;
@@ -69,6 +71,10 @@ public:
                 { return _totalElementsInPacket == 0 ? 0 : _totalProcessTime / _totalElementsInPacket; }
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
+    quint64 getTotalEditEpochs() const { return _totalEditEpochs; }
+    quint64 getTotalElementsDecodedInParallel() const { return _totalElementsDecodedInParallel; }
+    float getAverageElementsPerEditEpoch() const
+                { return _totalEditEpochs == 0 ? 0.0f : (float)_totalElementsInPacket / (float)_totalEditEpochs; }
 
     void resetStats();
 
@@ -82,11 +88,19 @@ protected:
 
     virtual unsigned long getMaxWait() const;
     virtual void preProcess();
+    virtual void prepareToProcess(const std::list<NodeSharedPacketPair>& packets);
     virtual void midProcess();
+    virtual void postProcess();
 
 private:
     int sendNackPackets();
 
+    /// takes the tree's write lock for the edits that follow, unless the current epoch already holds it
+    void beginEditEpoch();
+
+    /// releases the tree's write lock, publishing the edits of the current epoch to the send threads
+    void endEditEpoch();
+
 private:
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
             int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
@@ -99,10 +113,17 @@ private:
     quint64 _totalLockWaitTime;
     quint64 _totalElementsInPacket;
     quint64 _totalPackets;
+    quint64 _totalEditEpochs;
+    quint64 _totalElementsDecodedInParallel;
     
     NodeToSenderStatsMap _singleSenderStats;
 
     quint64 _lastNackTime;
     bool _shuttingDown;
+
+    quint64 _editEpochStartedAt; // 0 when no epoch holds the tree's write lock
+
+    OctreeEditDecoder _editDecoder;
+    QHash<const NLPacket*, int> _decodedPackets; // the index of each packet of the current batch in _editDecoder
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
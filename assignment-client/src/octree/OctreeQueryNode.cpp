@@ -94,6 +94,7 @@ void OctreeQueryNode::sendThreadFinished() {
 
 void OctreeQueryNode::initializeOctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) {
     _octreeSendThread = new OctreeSendThread(myServer, node);
+    baselines.setClientID(node->getUUID());
 
     // we want to be notified when the thread finishes
     connect(_octreeSendThread, &GenericThread::finished, this, &OctreeQueryNode::sendThreadFinished);
@@ -368,13 +369,20 @@ bool OctreeQueryNode::hasNextNackedPacket() const {
 const NLPacket* OctreeQueryNode::getNextNackedPacket() {
     if (!_nackedSequenceNumbers.isEmpty()) {
         // could return null if packet is not in the history
-        return _sentPacketHistory.getPacket(_nackedSequenceNumbers.dequeue());
+        const NLPacket* packet = _sentPacketHistory.getPacket(_nackedSequenceNumbers.dequeue());
+        if (!packet) {
+            // the client missed properties that we can no longer resend, so we don't know what it has anymore
+            baselines.reset();
+        }
+        return packet;
     }
 
     return nullptr;
 }
 
 void OctreeQueryNode::parseNackPacket(NLPacket& packet) {
+    _lastNackTime = usecTimestampNow();
+
     // read sequence numbers
     while (packet.bytesLeftToRead()) {
         OCTREE_PACKET_SEQUENCE sequenceNumber;
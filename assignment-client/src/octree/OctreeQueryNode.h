@@ -12,10 +12,12 @@
 #ifndef hifi_OctreeQueryNode_h
 #define hifi_OctreeQueryNode_h
 
+#include <atomic>
 #include <iostream>
 
 #include <CoverageMap.h>
 #include <NodeData.h>
+#include <OctreeClientBaselines.h>
 #include <OctreeConstants.h>
 #include <OctreeElementBag.h>
 #include <OctreePacketData.h>
@@ -57,6 +59,7 @@ public:
     OctreeElementBag elementBag;
     CoverageMap map;
     OctreeElementExtraEncodeData extraEncodeData;
+    OctreeClientBaselines baselines;
 
     ViewFrustum& getCurrentViewFrustum() { return _currentViewFrustum; }
     ViewFrustum& getLastKnownViewFrustum() { return _lastKnownViewFrustum; }
@@ -111,6 +114,7 @@ public:
     void parseNackPacket(NLPacket& packet);
     bool hasNextNackedPacket() const;
     const NLPacket* getNextNackedPacket();
+    quint64 getLastNackTime() const { return _lastNackTime; }
 
 private slots:
     void sendThreadFinished();
@@ -155,6 +159,7 @@ private:
 
     SentPacketHistory _sentPacketHistory;
     QQueue<OCTREE_PACKET_SEQUENCE> _nackedSequenceNumbers;
+    std::atomic<quint64> _lastNackTime { 0 };
 
     quint64 _sceneSendStartTime = 0;
 };
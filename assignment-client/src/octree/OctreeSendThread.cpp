@@ -27,7 +27,9 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
     _nodeUUID(node->getUUID()),
     _packetData(),
     _nodeMissingCount(0),
-    _isShuttingDown(false)
+    _isShuttingDown(false),
+    _cachedSceneStep(0),
+    _wantVisibleSet(false)
 {
     QString safeServerName("Octree");
 
@@ -84,6 +86,7 @@ bool OctreeSendThread::process() {
 
             // Sometimes the node data has not yet been linked, in which case we can't really do anything
             if (nodeData && !nodeData->isShuttingDown()) {
+                TRACE_SCOPE("OctreeSendThread::packetDistributor");
                 bool viewFrustumChanged = nodeData->updateCurrentViewFrustum();
                 packetDistributor(nodeData, viewFrustumChanged);
             }
@@ -120,6 +123,7 @@ quint64 OctreeSendThread::_totalWastedBytes = 0;
 quint64 OctreeSendThread::_totalPackets = 0;
 
 int OctreeSendThread::handlePacketSend(OctreeQueryNode* nodeData, int& trueBytesSent, int& truePacketsSent) {
+    TRACE_SCOPE("OctreeSendThread::handlePacketSend");
     OctreeServer::didHandlePacketSend(this);
 
     // if we're shutting down, then exit early
@@ -332,6 +336,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         if (wantCompression) {
             targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
         }
+        nodeData->baselines.dropPending();
         _packetData.changeSettings(wantCompression, targetSize);
     }
 
@@ -390,6 +395,39 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
         } else {
             nodeData->elementBag.insert(_myServer->getOctree()->getRoot());
         }
+
+        // a full scene sends the client everything again, whatever it was sent before. It is only recorded as the
+        // client's baselines, so that its encoding stays the same for every client and can be shared. A client that
+        // has not nacked since its baselines were reset may not nack at all, so it is sent everything again every so
+        // often in case it missed something
+        quint64 lastBaselinesReset = nodeData->baselines.getLastResetTime();
+        if (isFullScene || (nodeData->getLastNackTime() < lastBaselinesReset &&
+                            usecTimestampNow() - lastBaselinesReset > CLIENT_BASELINES_EXPIRY_USECS)) {
+            nodeData->baselines.reset();
+        }
+        nodeData->baselines.setRecordOnly(isFullScene);
+
+        // full scenes can be shared with the other clients looking at the same version of the tree with the same view
+        _recordingScene.clear();
+        _cachedScene.clear();
+        _cachedSceneStep = 0;
+
+        // a full scene is where searching the client's visible elements up front on several threads pays off
+        _visibleSet.reset();
+        _wantVisibleSet = isFullScene && _myServer->wantsParallelSceneTraversal();
+
+        // wantDelta is only set while the view is changing, so this includes the full scene a delta client gets once
+        // its view stops changing. Only a full scene whose LOD changed while the view was still moving is left out.
+        if (isFullScene && !wantDelta && !nodeData->getWantOcclusionCulling()) {
+            OctreeElement* root = _myServer->getOctree()->getRoot();
+            quint64 rootLastChanged = root->getLastChanged();
+
+            _cachedScene = _myServer->getEncodeCache().findScene(root, rootLastChanged, nodeData->getCurrentViewFrustum());
+            if (!_cachedScene) {
+                _recordingScene = OctreeEncodeCache::ScenePointer(
+                    new OctreeEncodeCache::Scene(root, rootLastChanged, nodeData->getCurrentViewFrustum()));
+            }
+        }
     }
 
     // If we have something in our elementBag, then turn them into packets and send them out...
@@ -415,70 +453,147 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
             bool lastNodeDidntFit = false; // assume each node fits
             if (!nodeData->elementBag.isEmpty()) {
 
-                quint64 lockWaitStart = usecTimestampNow();
-                _myServer->getOctree()->lockForRead();
-                quint64 lockWaitEnd = usecTimestampNow();
-                lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
-                quint64 encodeStart = usecTimestampNow();
-
-                OctreeElement* subTree = nodeData->elementBag.extract();
-
-                /* TODO: Looking for a way to prevent locking and encoding a tree that is not
-                // going to result in any packets being sent...
-                //
-                // If our node is root, and the root hasn't changed, and our view hasn't changed,
-                // and we've already seen at least one duplicate packet, then we probably don't need
-                // to lock the tree and encode, because the result should be that no bytes will be
-                // encoded, and this will be a duplicate packet from the  last one we sent...
-                OctreeElement* root = _myServer->getOctree()->getRoot();
-                bool skipEncode = false;
-                if (
-                        (subTree == root)
-                        && (nodeData->getLastRootTimestamp() == root->getLastChanged())
-                        && !viewFrustumChanged
-                        && (nodeData->getDuplicatePacketCount() > 0)
-                ) {
-                    qDebug() << "is root, root not changed, view not changed, already seen a duplicate!"
-                        << "Can we skip it?";
-                    skipEncode = true;
-                }
-                */
-
-                bool wantOcclusionCulling = nodeData->getWantOcclusionCulling();
-                CoverageMap* coverageMap = wantOcclusionCulling ? &nodeData->map : IGNORE_COVERAGE_MAP;
-
                 float octreeSizeScale = nodeData->getOctreeSizeScale();
                 int boundaryLevelAdjustClient = nodeData->getBoundaryLevelAdjust();
 
                 int boundaryLevelAdjust = boundaryLevelAdjustClient + (viewFrustumChanged && nodeData->getWantLowResMoving()
                                                                        ? LOW_RES_MOVING_ADJUST : NO_BOUNDARY_ADJUST);
 
-                EncodeBitstreamParams params(INT_MAX, &nodeData->getCurrentViewFrustum(), wantColor,
-                                             WANT_EXISTS_BITS, DONT_CHOP, wantDelta, lastViewFrustum,
-                                             wantOcclusionCulling, coverageMap, boundaryLevelAdjust, octreeSizeScale,
-                                             nodeData->getLastTimeBagEmpty(),
-                                             isFullScene, &nodeData->stats, _myServer->getJurisdiction(),
-                                             &nodeData->extraEncodeData);
+                OctreeEncodeCache::EncodeInputs encodeInputs = { (int)_packetData.getTargetSize(),
+                                                                 _packetData.getUncompressedSize(), wantColor,
+                                                                 boundaryLevelAdjust, octreeSizeScale, isFullScene };
+
+                // if another send thread already encoded this scene, use its output for as long as we would have
+                // encoded exactly the same thing
+                const OctreeEncodeCache::EncodedStep* cachedStep = NULL;
+                if (_cachedScene) {
+                    if (!_cachedScene->isStale(_myServer->getOctree()->getRoot()->getLastChanged())) {
+                        cachedStep = _cachedScene->getStep(_cachedSceneStep, encodeInputs);
+                    }
+                    if (!cachedStep) {
+                        // we never touched our bag while using the cached scene, so we encode ourselves starting over
+                        // from the root that is still in it
+                        _cachedScene.clear();
+                    }
+                }
+
+                EncodeBitstreamParams::reason stopReason;
 
-                // TODO: should this include the lock time or not? This stat is sent down to the client,
-                // it seems like it may be a good idea to include the lock time as part of the encode time
-                // are reported to client. Since you can encode without the lock
-                nodeData->stats.encodeStarted();
+                if (cachedStep) {
+                    quint64 encodeStart = usecTimestampNow();
 
-                bytesWritten = _myServer->getOctree()->encodeTreeBitstream(subTree, &_packetData, nodeData->elementBag, params);
+                    _packetData.appendRawData(cachedStep->data);
+                    bytesWritten = cachedStep->bytesWritten;
+                    stopReason = cachedStep->stopReason;
+                    completedScene = cachedStep->completedScene;
 
-                quint64 encodeEnd = usecTimestampNow();
-                encodeElapsedUsec = (float)(encodeEnd - encodeStart);
+                    quint64 encodeEnd = usecTimestampNow();
+                    encodeElapsedUsec = (float)(encodeEnd - encodeStart);
+                    _myServer->getEncodeCache().trackReusedEncode(cachedStep->encodeTime - encodeElapsedUsec);
 
-                // If after calling encodeTreeBitstream() there are no nodes left to send, then we know we've
-                // sent the entire scene. We want to know this below so we'll actually write this content into
-                // the packet and send it
-                completedScene = nodeData->elementBag.isEmpty();
+                    if (completedScene) {
+                        nodeData->elementBag.deleteAll();
+                        _cachedScene.clear();
+                    } else {
+                        _cachedSceneStep++;
+                    }
+                } else {
+                    quint64 lockWaitStart = usecTimestampNow();
+                    _myServer->getOctree()->lockForRead();
+                    quint64 lockWaitEnd = usecTimestampNow();
+                    lockWaitElapsedUsec = (float)(lockWaitEnd - lockWaitStart);
+                    quint64 encodeStart = usecTimestampNow();
+
+                    OctreeElement* subTree = nodeData->elementBag.extract();
+
+                    /* TODO: Looking for a way to prevent locking and encoding a tree that is not
+                    // going to result in any packets being sent...
+                    //
+                    // If our node is root, and the root hasn't changed, and our view hasn't changed,
+                    // and we've already seen at least one duplicate packet, then we probably don't need
+                    // to lock the tree and encode, because the result should be that no bytes will be
+                    // encoded, and this will be a duplicate packet from the  last one we sent...
+                    OctreeElement* root = _myServer->getOctree()->getRoot();
+                    bool skipEncode = false;
+                    if (
+                            (subTree == root)
+                            && (nodeData->getLastRootTimestamp() == root->getLastChanged())
+                            && !viewFrustumChanged
+                            && (nodeData->getDuplicatePacketCount() > 0)
+                    ) {
+                        qDebug() << "is root, root not changed, view not changed, already seen a duplicate!"
+                            << "Can we skip it?";
+                        skipEncode = true;
+                    }
+                    */
+
+                    bool wantOcclusionCulling = nodeData->getWantOcclusionCulling();
+                    CoverageMap* coverageMap = wantOcclusionCulling ? &nodeData->map : IGNORE_COVERAGE_MAP;
+
+                    // the visible set is only good for as long as neither the tree nor the view changed, once it is
+                    // dropped the rest of the scene is encoded with the tests done inline
+                    const ViewFrustum& currentViewFrustum = nodeData->getCurrentViewFrustum();
+                    quint64 rootLastChanged = _myServer->getOctree()->getRoot()->getLastChanged();
+                    if (_visibleSet && !_visibleSet->matches(rootLastChanged, currentViewFrustum,
+                                                             boundaryLevelAdjust, octreeSizeScale)) {
+                        _visibleSet.reset();
+                    }
+                    if (_wantVisibleSet) {
+                        _wantVisibleSet = false;
+                        _visibleSet.reset(new OctreeVisibleSet(currentViewFrustum, boundaryLevelAdjust, octreeSizeScale));
+                        _visibleSet->compute(_myServer->getOctree()->getRoot());
+                        OctreeServer::trackVisibleSetTime(_visibleSet->getComputeTime());
+                    }
+
+                    EncodeBitstreamParams params(INT_MAX, &currentViewFrustum, wantColor,
+                                                 WANT_EXISTS_BITS, DONT_CHOP, wantDelta, lastViewFrustum,
+                                                 wantOcclusionCulling, coverageMap, boundaryLevelAdjust, octreeSizeScale,
+                                                 nodeData->getLastTimeBagEmpty(),
+                                                 isFullScene, &nodeData->stats, _myServer->getJurisdiction(),
+                                                 &nodeData->extraEncodeData, _visibleSet.data());
+
+                    // TODO: should this include the lock time or not? This stat is sent down to the client,
+                    // it seems like it may be a good idea to include the lock time as part of the encode time
+                    // are reported to client. Since you can encode without the lock
+                    nodeData->stats.encodeStarted();
+
+                    _packetData.setClientBaselines(_myServer->wantsClientBaselines() ? &nodeData->baselines : NULL);
+                    bytesWritten = _myServer->getOctree()->encodeTreeBitstream(subTree, &_packetData,
+                                                                               nodeData->elementBag, params);
+
+                    quint64 encodeEnd = usecTimestampNow();
+                    encodeElapsedUsec = (float)(encodeEnd - encodeStart);
+                    stopReason = params.stopReason;
+
+                    // If after calling encodeTreeBitstream() there are no nodes left to send, then we know we've
+                    // sent the entire scene. We want to know this below so we'll actually write this content into
+                    // the packet and send it
+                    completedScene = nodeData->elementBag.isEmpty();
+
+                    // keep what we encoded for other clients with the same view, unless the tree changed under us
+                    if (_recordingScene) {
+                        int dataStart = encodeInputs.startSize;
+                        bool keepRecording = !wantOcclusionCulling
+                            && !_recordingScene->isStale(_myServer->getOctree()->getRoot()->getLastChanged())
+                            && _recordingScene->addStep(encodeInputs, _packetData.getUncompressedData(dataStart),
+                                                        _packetData.getUncompressedSize() - dataStart, bytesWritten,
+                                                        stopReason, completedScene, encodeElapsedUsec);
+                        if (keepRecording && completedScene) {
+                            _myServer->getEncodeCache().addScene(_recordingScene);
+                        }
+                        if (!keepRecording || completedScene) {
+                            _recordingScene.clear();
+                        }
+                    }
+
+                    nodeData->stats.encodeStopped();
+                    _myServer->getOctree()->unlock();
+                }
 
                 // if we're trying to fill a full size packet, then we use this logic to determine if we have a DIDNT_FIT case.
                 if (_packetData.getTargetSize() == MAX_OCTREE_PACKET_DATA_SIZE) {
                     if (_packetData.hasContent() && bytesWritten == 0 &&
-                            params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+                            stopReason == EncodeBitstreamParams::DIDNT_FIT) {
                         lastNodeDidntFit = true;
                     }
                 } else {
@@ -486,13 +601,10 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                     // content or not... because in this case even if we were unable to pack any data, we want to drop
                     // below to our sendNow logic, but we do want to track that we attempted to pack extra
                     extraPackingAttempts++;
-                    if (bytesWritten == 0 && params.stopReason == EncodeBitstreamParams::DIDNT_FIT) {
+                    if (bytesWritten == 0 && stopReason == EncodeBitstreamParams::DIDNT_FIT) {
                         lastNodeDidntFit = true;
                     }
                 }
-
-                nodeData->stats.encodeStopped();
-                _myServer->getOctree()->unlock();
             } else {
                 // If the bag was empty then we didn't even attempt to encode, and so we know the bytesWritten were 0
                 bytesWritten = 0;
@@ -522,6 +634,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                     }
 
                     nodeData->writeToPacket(_packetData.getFinalizedData(), _packetData.getFinalizedSize());
+                    nodeData->baselines.commitPending(_packetData, &nodeData->stats);
                     extraPackingAttempts = 0;
                     quint64 compressAndWriteEnd = usecTimestampNow();
                     compressAndWriteElapsedUsec = (float)(compressAndWriteEnd - compressAndWriteStart);
@@ -556,6 +669,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                     // a larger compressed size then uncompressed size
                     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) - COMPRESS_PADDING;
                 }
+                nodeData->baselines.dropPending();
                 _packetData.changeSettings(nodeData->getWantCompression(), targetSize); // will do reset
 
             }
@@ -14,9 +14,13 @@
 #ifndef hifi_OctreeSendThread_h
 #define hifi_OctreeSendThread_h
 
+#include <QtCore/QScopedPointer>
+
 #include <GenericThread.h>
 #include <OctreeElementBag.h>
+#include <OctreeVisibleSet.h>
 
+#include "OctreeEncodeCache.h"
 #include "OctreeQueryNode.h"
 
 class OctreeServer;
@@ -53,6 +57,13 @@ private:
 
     int _nodeMissingCount;
     bool _isShuttingDown;
+
+    OctreeEncodeCache::ScenePointer _recordingScene; // the scene we are encoding, shared once it is complete
+    OctreeEncodeCache::ScenePointer _cachedScene; // a scene another thread encoded, used in place of encoding it
+    int _cachedSceneStep;
+
+    bool _wantVisibleSet; // set when a full scene starts, the set is searched for by the first encode of the scene
+    QScopedPointer<OctreeVisibleSet> _visibleSet; // dropped as soon as the tree or the client's view changes
 };
 
 #endif // hifi_OctreeSendThread_h
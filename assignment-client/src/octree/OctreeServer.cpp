@@ -67,6 +67,8 @@ int OctreeServer::_longCompress = 0;
 int OctreeServer::_shortCompress = 0;
 int OctreeServer::_noCompress = 0;
 
+SimpleMovingAverage OctreeServer::_averageVisibleSetTime(MOVING_AVERAGE_SAMPLE_COUNTS);
+
 SimpleMovingAverage OctreeServer::_averagePacketSendingTime(MOVING_AVERAGE_SAMPLE_COUNTS);
 int OctreeServer::_noSend = 0;
 
@@ -113,6 +115,8 @@ void OctreeServer::resetSendingStats() {
     _shortCompress = 0;
     _noCompress = 0;
 
+    _averageVisibleSetTime.reset();
+
     _averagePacketSendingTime.reset();
     _noSend = 0;
 
@@ -124,6 +128,8 @@ void OctreeServer::resetSendingStats() {
     _longProcessWait = 0;
     _shortProcessWait = 0;
     _noProcessWait = 0;
+
+    _encodeCache.resetStats();
 }
 
 void OctreeServer::trackEncodeTime(float time) {
@@ -226,6 +232,9 @@ OctreeServer::OctreeServer(NLPacket& packet) :
     _debugSending(false),
     _debugReceiving(false),
     _verboseDebug(false),
+    _wantParallelSceneTraversal(true),
+    _wantClientBaselines(true),
+    _wantParallelEditDecoding(true),
     _jurisdiction(NULL),
     _jurisdictionSender(NULL),
     _octreeInboundPacketProcessor(NULL),
@@ -369,6 +378,11 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             statsString += QString("%1 File Load Took ").arg(getMyServerName());
             statsString += getFileLoadTime();
             statsString += "\r\n";
+            if (_tree->getLastJSONReadEntityCount() > 0) {
+                statsString += QString().sprintf("%s File Load Read %d entities, %.0f entities/sec\r\n",
+                                                 qPrintable(getMyServerName()), _tree->getLastJSONReadEntityCount(),
+                                                 (double)_tree->getLastJSONReadEntitiesPerSecond());
+            }
 
         } else {
             statsString += "Octree file not yet loaded...\r\n";
@@ -536,6 +550,21 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          (double)_averageExtraLongEncodeTime.getAverage(),
                                          (double)(extraLongVsTotalEncode * AS_PERCENT), _extraLongEncode);
 
+        float encodeCacheHitRate = _encodeCache.getSceneHitRate();
+        statsString += QString().sprintf("         Encode cache scene hit rate:    %9.2f%%  (%d of %d scenes)\r\n",
+                                         (double)(encodeCacheHitRate * AS_PERCENT), _encodeCache.getSceneHits(),
+                                         _encodeCache.getSceneLookups());
+        statsString += QString().sprintf("       Encodes reused from the cache:    %9llu (%d scenes cached)\r\n",
+                                         (unsigned long long)_encodeCache.getReusedEncodes(),
+                                         _encodeCache.getCachedSceneCount());
+        statsString += QString().sprintf("          Encode time saved by cache:    %9.2f msecs\r\n\r\n",
+                                         _encodeCache.getEncodeTimeSaved() / USECS_PER_MSEC);
+
+        statsString += QString().sprintf("     Average visible set search time:    %9.2f usecs (%s) samples: %12d \r\n\r\n",
+                                         (double)getAverageVisibleSetTime(),
+                                         _wantParallelSceneTraversal ? "parallel" : "disabled",
+                                         _averageVisibleSetTime.getSampleCount());
+
 
         float averageCompressAndWriteTime = getAverageCompressAndWriteTime();
         statsString += QString().sprintf("     Average compress and write time:    %9.2f usecs\r\n",
@@ -664,6 +693,15 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             .arg(locale.toString((uint)averageProcessTimePerElement).rightJustified(COLUMN_WIDTH, ' '));
         statsString += QString("  Average Wait Lock Time/Element: %1 usecs\r\n")
             .arg(locale.toString((uint)averageLockWaitTimePerElement).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("               Total Edit Epochs: %1 epochs\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getTotalEditEpochs())
+                 .rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString().sprintf("     Average Elements/Edit Epoch: %f elements/epoch\r\n",
+                                         (double)_octreeInboundPacketProcessor->getAverageElementsPerEditEpoch());
+        statsString += QString("    Elements Decoded in Parallel: %1 elements (%2)\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getTotalElementsDecodedInParallel())
+                 .rightJustified(COLUMN_WIDTH, ' '))
+            .arg(_wantParallelEditDecoding ? "parallel" : "disabled");
 
         statsString += QString("             Average Decode Time: %1 usecs\r\n")
             .arg(locale.toString((uint)averageDecodeTime).rightJustified(COLUMN_WIDTH, ' '));
@@ -745,6 +783,8 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += "                                 -----------\r\n";
         statsString += QString().sprintf("                         Total:  %8.2f %s\r\n",
                                          OctreeElement::getTotalMemoryUsage() / (double)memoryScale, memoryScaleLabel);
+        statsString += QString().sprintf("        Pooled Memory Reserved:  %8.2f %s\r\n",
+                                         OctreeElement::getPooledMemoryReserved() / (double)memoryScale, memoryScaleLabel);
         statsString += "\r\n";
 
         statsString += "OctreeElement Children Population Statistics...\r\n";
@@ -958,6 +998,21 @@ void OctreeServer::readConfiguration() {
     readOptionBool(QString("debugTimestampNow"), settingsSectionObject, _debugTimestampNow);
     qDebug() << "debugTimestampNow=" << _debugTimestampNow;
 
+    bool noParallelSceneTraversal;
+    readOptionBool(QString("NoParallelSceneTraversal"), settingsSectionObject, noParallelSceneTraversal);
+    _wantParallelSceneTraversal = !noParallelSceneTraversal;
+    qDebug() << "wantParallelSceneTraversal=" << _wantParallelSceneTraversal;
+
+    bool noClientBaselines;
+    readOptionBool(QString("NoClientBaselines"), settingsSectionObject, noClientBaselines);
+    _wantClientBaselines = !noClientBaselines;
+    qDebug() << "wantClientBaselines=" << _wantClientBaselines;
+
+    bool noParallelEditDecoding;
+    readOptionBool(QString("NoParallelEditDecoding"), settingsSectionObject, noParallelEditDecoding);
+    _wantParallelEditDecoding = !noParallelEditDecoding;
+    qDebug() << "wantParallelEditDecoding=" << _wantParallelEditDecoding;
+
     bool noPersist;
     readOptionBool(QString("NoPersist"), settingsSectionObject, noPersist);
     _wantPersist = !noPersist;
@@ -1349,6 +1404,9 @@ void OctreeServer::sendStatsPacket() {
     statsObject2[baseName + QString(".2.outbound.timing.2.avgInsideTime")] = getAverageInsideTime();
     statsObject2[baseName + QString(".2.outbound.timing.3.avgTreeLockTime")] = getAverageTreeWaitTime();
     statsObject2[baseName + QString(".2.outbound.timing.4.avgEncodeTime")] = getAverageEncodeTime();
+    statsObject2[baseName + QString(".2.outbound.timing.4.encodeCacheHitRate")] = _encodeCache.getSceneHitRate();
+    statsObject2[baseName + QString(".2.outbound.timing.4.encodeTimeSavedMsecs")] =
+        _encodeCache.getEncodeTimeSaved() / USECS_PER_MSEC;
     statsObject2[baseName + QString(".2.outbound.timing.5.avgCompressAndWriteTime")] = getAverageCompressAndWriteTime();
     statsObject2[baseName + QString(".2.outbound.timing.5.avgSendTime")] = getAveragePacketSendingTime();
     statsObject2[baseName + QString(".2.outbound.timing.5.nodeWaitTime")] = getAverageNodeWaitTime();
@@ -1363,6 +1421,10 @@ void OctreeServer::sendStatsPacket() {
         (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
     statsObject3[baseName + QString(".3.inbound.data.2.totalElements")] =
         (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+    statsObject3[baseName + QString(".3.inbound.data.3.elementsPerEditEpoch")] =
+        (double)_octreeInboundPacketProcessor->getAverageElementsPerEditEpoch();
+    statsObject3[baseName + QString(".3.inbound.data.4.elementsDecodedInParallel")] =
+        (double)_octreeInboundPacketProcessor->getTotalElementsDecodedInParallel();
     statsObject3[baseName + QString(".3.inbound.timing.1.avgTransitTimePerPacket")] =
         (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
     statsObject3[baseName + QString(".3.inbound.timing.2.avgProcessTimePerPacket")] =
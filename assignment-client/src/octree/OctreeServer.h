@@ -21,6 +21,7 @@
 #include <ThreadedAssignment.h>
 #include <EnvironmentData.h>
 
+#include "OctreeEncodeCache.h"
 #include "OctreePersistThread.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
@@ -41,9 +42,13 @@ public:
     bool wantsDebugSending() const { return _debugSending; }
     bool wantsDebugReceiving() const { return _debugReceiving; }
     bool wantsVerboseDebug() const { return _verboseDebug; }
+    bool wantsParallelSceneTraversal() const { return _wantParallelSceneTraversal; }
+    bool wantsClientBaselines() const { return _wantClientBaselines; }
+    bool wantsParallelEditDecoding() const { return _wantParallelEditDecoding; }
 
     Octree* getOctree() { return _tree; }
     JurisdictionMap* getJurisdiction() { return _jurisdiction; }
+    OctreeEncodeCache& getEncodeCache() { return _encodeCache; }
 
     int getPacketsPerClientPerInterval() const { return std::min(_packetsPerClientPerInterval,
                                 std::max(1, getPacketsTotalPerInterval() / std::max(1, getCurrentClientCount()))); }
@@ -98,6 +103,9 @@ public:
     static void trackPacketSendingTime(float time);
     static float getAveragePacketSendingTime() { return _averagePacketSendingTime.getAverage(); }
 
+    static void trackVisibleSetTime(float time) { _averageVisibleSetTime.updateAverage(time); }
+    static float getAverageVisibleSetTime() { return _averageVisibleSetTime.getAverage(); }
+
     static void trackProcessWaitTime(float time);
     static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
 
@@ -166,10 +174,14 @@ protected:
     bool _debugReceiving;
     bool _debugTimestampNow;
     bool _verboseDebug;
+    bool _wantParallelSceneTraversal;
+    bool _wantClientBaselines;
+    bool _wantParallelEditDecoding;
     JurisdictionMap* _jurisdiction;
     JurisdictionSender* _jurisdictionSender;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
+    OctreeEncodeCache _encodeCache;
 
     int _persistInterval;
     bool _wantBackup;
@@ -217,6 +229,8 @@ protected:
     static int _shortCompress;
     static int _noCompress;
 
+    static SimpleMovingAverage _averageVisibleSetTime;
+
     static SimpleMovingAverage _averagePacketSendingTime;
     static int _noSend;
 
@@ -633,6 +633,9 @@ void DomainServer::processConnectRequestPacket(QSharedPointer<NLPacket> packet)
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
     
     packetStream >> nodeInterestList;
+
+    quint8 verificationHashMethod;
+    packetStream >> verificationHashMethod;
     
     if (packet->bytesLeftToRead() > 0) {
         // try to verify username
@@ -735,6 +738,10 @@ void DomainServer::processConnectRequestPacket(QSharedPointer<NLPacket> packet)
         // if this was a static assignment set the UUID, set the sendingSockAddr
         DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(newNode->getLinkedData());
 
+        // hold on to the newest verification hash this node supports, we pick the one it uses with each other node
+        nodeData->setVerificationHashMethod(VerificationHash::methodForConnection(
+            (VerificationHash::Method) verificationHashMethod, VerificationHash::BEST_METHOD));
+
         if (isAssignment) {
             nodeData->setAssignmentUUID(matchingQueuedAssignment->getUUID());
             nodeData->setWalletUUID(pendingAssigneeData->getWalletUUID());
@@ -1044,6 +1051,9 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
                     // pack the secret that these two nodes will use to communicate with each other
                     domainListStream << connectionSecretForNodes(node, otherNode);
 
+                    // and the hash they will verify each other's packets with
+                    domainListStream << (quint8) verificationHashMethodForNodes(node, otherNode);
+
                     // we've added the node we wanted so end the segment now
                     domainListPackets.endSegment();
                 }
@@ -1079,6 +1089,19 @@ QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, con
     return QUuid();
 }
 
+VerificationHash::Method DomainServer::verificationHashMethodForNodes(const SharedNodePointer& nodeA,
+                                                                    const SharedNodePointer& nodeB) {
+    DomainServerNodeData* nodeAData = dynamic_cast<DomainServerNodeData*>(nodeA->getLinkedData());
+    DomainServerNodeData* nodeBData = dynamic_cast<DomainServerNodeData*>(nodeB->getLinkedData());
+
+    if (nodeAData && nodeBData) {
+        return VerificationHash::methodForConnection(nodeAData->getVerificationHashMethod(),
+                                                     nodeBData->getVerificationHashMethod());
+    }
+
+    return VerificationHash::MD5;
+}
+
 void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
 
     auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
@@ -1110,6 +1133,9 @@ void DomainServer::broadcastNewNode(const SharedNodePointer& addedNode) {
             // replace the bytes at the end of the packet for the connection secret between these nodes
             addNodePacket->write(rfcConnectionSecret);
 
+            // followed by the hash they will verify each other's packets with
+            addNodePacket->writePrimitive((quint8) verificationHashMethodForNodes(node, addedNode));
+
             // send off this packet to the node
             limitedNodeList->sendUnreliablePacket(*addNodePacket, *node);
         }
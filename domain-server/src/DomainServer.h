@@ -103,6 +103,7 @@ private:
                               const NodeSet& nodeInterestSet);
 
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
+    VerificationHash::Method verificationHashMethodForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
     void broadcastNewNode(const SharedNodePointer& node);
 
     void parseAssignmentConfigs(QSet<Assignment::Type>& excludedTypes);
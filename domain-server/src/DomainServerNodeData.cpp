@@ -26,7 +26,8 @@ DomainServerNodeData::DomainServerNodeData() :
     _paymentIntervalTimer(),
     _statsJSONObject(),
     _sendingSockAddr(),
-    _isAuthenticated(true)
+    _isAuthenticated(true),
+    _verificationHashMethod(VerificationHash::MD5)
 {
     _paymentIntervalTimer.start();
 }
@@ -20,6 +20,7 @@
 #include <NLPacket.h>
 #include <NodeData.h>
 #include <NodeType.h>
+#include <VerificationHash.h>
 
 class DomainServerNodeData : public NodeData {
 public:
@@ -48,6 +49,10 @@ public:
 
     QHash<QUuid, QUuid>& getSessionSecretHash() { return _sessionSecretHash; }
 
+    /// the newest packet verification hash this node told us it supports when it connected
+    VerificationHash::Method getVerificationHashMethod() const { return _verificationHashMethod; }
+    void setVerificationHashMethod(VerificationHash::Method method) { _verificationHashMethod = method; }
+
     const NodeSet& getNodeInterestSet() const { return _nodeInterestSet; }
     void setNodeInterestSet(const NodeSet& nodeInterestSet) { _nodeInterestSet = nodeInterestSet; }
 private:
@@ -62,6 +67,7 @@ private:
     HifiSockAddr _sendingSockAddr;
     bool _isAuthenticated;
     NodeSet _nodeInterestSet;
+    VerificationHash::Method _verificationHashMethod;
 };
 
 #endif // hifi_DomainServerNodeData_h
@@ -92,6 +92,7 @@
 #include <SoundCache.h>
 #include <TextureCache.h>
 #include <Tooltip.h>
+#include <Trace.h>
 #include <UserActivityLogger.h>
 #include <UUID.h>
 #include <input-plugins/UserInputMapper.h>
@@ -353,6 +354,9 @@ Application::Application(int& argc, char** argv, QElapsedTimer &startup_time) :
 
     qInstallMessageHandler(messageHandler);
 
+    // records a trace of this run if HIFI_TRACE_FILE is set
+    Trace::startFromEnvironment();
+
     QFontDatabase::addApplicationFont(PathUtils::resourcesPath() + "styles/Inconsolata.otf");
     _window->setWindowTitle("Interface");
 
@@ -915,7 +919,7 @@ void Application::paintGL() {
                           lodManager->getBoundaryLevelAdjust(), RenderArgs::DEFAULT_RENDER_MODE,
                           RenderArgs::MONO, RenderArgs::RENDER_DEBUG_NONE);
 
-    PerformanceTimer perfTimer("paintGL");
+    PERFORMANCE_TIMER("paintGL");
 
 
     PerformanceWarning::setSuppressShortTimings(Menu::getInstance()->isOptionChecked(MenuOption::SuppressShortTimings));
@@ -950,7 +954,7 @@ void Application::paintGL() {
     }
 
     {
-        PerformanceTimer perfTimer("renderOverlay");
+        PERFORMANCE_TIMER("renderOverlay");
         // NOTE: There is no batch associated with this renderArgs
         // the ApplicationOverlay class assumes it's viewport is setup to be the device size
         QSize size = qApp->getDeviceSize();
@@ -1921,7 +1925,7 @@ void Application::idle() {
         }
     }
 
-    PerformanceTimer perfTimer("idle");
+    PERFORMANCE_TIMER("idle");
     if (_aboutToQuit) {
         return; // bail early, nothing to do here.
     }
@@ -1942,14 +1946,14 @@ void Application::idle() {
     if (timeSinceLastUpdate > targetFramePeriod) {
         _lastTimeUpdated.start();
         {
-            PerformanceTimer perfTimer("update");
+            PERFORMANCE_TIMER("update");
             PerformanceWarning warn(showWarnings, "Application::idle()... update()");
             const float BIGGEST_DELTA_TIME_SECS = 0.25f;
             PROFILE_RANGE(__FUNCTION__ "/idleUpdate");
             update(glm::clamp((float)timeSinceLastUpdate / 1000.0f, 0.0f, BIGGEST_DELTA_TIME_SECS));
         }
         {
-            PerformanceTimer perfTimer("updateGL");
+            PERFORMANCE_TIMER("updateGL");
             PerformanceWarning warn(showWarnings, "Application::idle()... updateGL()");
             getActiveDisplayPlugin()->idle();
             auto inputPlugins = PluginManager::getInstance()->getInputPlugins();
@@ -1962,7 +1966,7 @@ void Application::idle() {
             }
         }
         {
-            PerformanceTimer perfTimer("rest");
+            PERFORMANCE_TIMER("rest");
             PerformanceWarning warn(showWarnings, "Application::idle()... rest of it");
             _idleLoopStdev.addValue(timeSinceLastUpdate);
 
@@ -2095,12 +2099,16 @@ bool Application::exportEntities(const QString& filename, const QVector<EntityIt
         return false;
     }
 
+    QVector<EntityItemID> entityIDs;
+    QVector<EntityItemProperties> entitiesProperties;
     for (auto entityItem : entities) {
         auto properties = entityItem->getProperties();
 
         properties.setPosition(properties.getPosition() - root);
-        exportTree.addEntity(entityItem->getEntityItemID(), properties);
+        entityIDs << entityItem->getEntityItemID();
+        entitiesProperties << properties;
     }
+    exportTree.addEntities(entityIDs, entitiesProperties);
 
     exportTree.writeToJSONFile(filename.toLocal8Bit().constData());
 
@@ -2117,12 +2125,15 @@ bool Application::exportEntities(const QString& filename, float x, float y, floa
         glm::vec3 root(x, y, z);
         EntityTree exportTree;
 
+        QVector<EntityItemID> entityIDs;
+        QVector<EntityItemProperties> entitiesProperties;
         for (int i = 0; i < entities.size(); i++) {
             EntityItemProperties properties = entities.at(i)->getProperties();
-            EntityItemID id = entities.at(i)->getEntityItemID();
             properties.setPosition(properties.getPosition() - root);
-            exportTree.addEntity(id, properties);
+            entityIDs << entities.at(i)->getEntityItemID();
+            entitiesProperties << properties;
         }
+        exportTree.addEntities(entityIDs, entitiesProperties);
         exportTree.writeToSVOFile(filename.toLocal8Bit().constData());
     } else {
         qCDebug(interfaceapp) << "No models were selected";
@@ -2272,7 +2283,7 @@ bool Application::isLookingAtMyAvatar(AvatarSharedPointer avatar) {
 }
 
 void Application::updateLOD() {
-    PerformanceTimer perfTimer("LOD");
+    PERFORMANCE_TIMER("LOD");
     // adjust it unless we were asked to disable this feature, or if we're currently in throttleRendering mode
     if (!isThrottleRendering()) {
         DependencyManager::get<LODManager>()->autoAdjustLOD(_fps);
@@ -2282,7 +2293,7 @@ void Application::updateLOD() {
 }
 
 void Application::updateMouseRay() {
-    PerformanceTimer perfTimer("mouseRay");
+    PERFORMANCE_TIMER("mouseRay");
 
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateMouseRay()");
@@ -2305,7 +2316,7 @@ void Application::updateMouseRay() {
 }
 
 void Application::updateMyAvatarLookAtPosition() {
-    PerformanceTimer perfTimer("lookAt");
+    PERFORMANCE_TIMER("lookAt");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateMyAvatarLookAtPosition()");
 
@@ -2378,7 +2389,7 @@ void Application::updateMyAvatarLookAtPosition() {
 }
 
 void Application::updateThreads(float deltaTime) {
-    PerformanceTimer perfTimer("updateThreads");
+    PERFORMANCE_TIMER("updateThreads");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateThreads()");
 
@@ -2429,13 +2440,13 @@ void Application::rotationModeChanged() {
 }
 
 void Application::updateCamera(float deltaTime) {
-    PerformanceTimer perfTimer("updateCamera");
+    PERFORMANCE_TIMER("updateCamera");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateCamera()");
 }
 
 void Application::updateDialogs(float deltaTime) {
-    PerformanceTimer perfTimer("updateDialogs");
+    PERFORMANCE_TIMER("updateDialogs");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateDialogs()");
     auto dialogsManager = DependencyManager::get<DialogsManager>();
@@ -2459,7 +2470,7 @@ void Application::updateDialogs(float deltaTime) {
 }
 
 void Application::updateCursor(float deltaTime) {
-    PerformanceTimer perfTimer("updateCursor");
+    PERFORMANCE_TIMER("updateCursor");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateCursor()");
 
@@ -2483,7 +2494,7 @@ void Application::update(float deltaTime) {
     _myAvatar->updateFromHMDSensorMatrix(getHMDSensorPose());
 
     {
-        PerformanceTimer perfTimer("devices");
+        PERFORMANCE_TIMER("devices");
         DeviceTracker::updateAll();
 
         FaceTracker* tracker = getSelectedFaceTracker();
@@ -2586,7 +2597,7 @@ void Application::update(float deltaTime) {
     updateCursor(deltaTime); // Handle cursor updates
 
     {
-        PerformanceTimer perfTimer("physics");
+        PERFORMANCE_TIMER("physics");
         _myAvatar->relayDriveKeysToCharacterController();
 
         _entitySimulation.lock();
@@ -2635,7 +2646,7 @@ void Application::update(float deltaTime) {
             _physicsEngine.dumpStatsIfNecessary();
 
             if (!_aboutToQuit) {
-                PerformanceTimer perfTimer("entities");
+                PERFORMANCE_TIMER("entities");
                 // Collision events (and their scripts) must not be handled when we're locked, above. (That would risk
                 // deadlock.)
                 _entitySimulation.handleCollisionEvents(collisionEvents);
@@ -2647,19 +2658,19 @@ void Application::update(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("overlays");
+        PERFORMANCE_TIMER("overlays");
         _overlays.update(deltaTime);
     }
 
     {
-        PerformanceTimer perfTimer("myAvatar");
+        PERFORMANCE_TIMER("myAvatar");
         updateMyAvatarLookAtPosition();
         // Sample hardware, update view frustum if needed, and send avatar data to mixer/nodes
         DependencyManager::get<AvatarManager>()->updateMyAvatar(deltaTime);
     }
 
     {
-        PerformanceTimer perfTimer("emitSimulating");
+        PERFORMANCE_TIMER("emitSimulating");
         // let external parties know we're updating
         emit simulating(deltaTime);
     }
@@ -2671,7 +2682,7 @@ void Application::update(float deltaTime) {
     // actually need to calculate the view frustum planes to send these details
     // to the server.
     {
-        PerformanceTimer perfTimer("loadViewFrustum");
+        PERFORMANCE_TIMER("loadViewFrustum");
         loadViewFrustum(_myCamera, _viewFrustum);
     }
 
@@ -2679,7 +2690,7 @@ void Application::update(float deltaTime) {
 
     // Update my voxel servers with my current voxel query...
     {
-        PerformanceTimer perfTimer("queryOctree");
+        PERFORMANCE_TIMER("queryOctree");
         quint64 sinceLastQuery = now - _lastQueriedTime;
         const quint64 TOO_LONG_SINCE_LAST_QUERY = 3 * USECS_PER_SECOND;
         bool queryIsDue = sinceLastQuery > TOO_LONG_SINCE_LAST_QUERY;
@@ -3115,7 +3126,7 @@ namespace render {
     template <> const Item::Bound payloadGetBound(const WorldBoxRenderData::Pointer& stuff) { return Item::Bound(); }
     template <> void payloadRender(const WorldBoxRenderData::Pointer& stuff, RenderArgs* args) {
         if (args->_renderMode != RenderArgs::MIRROR_RENDER_MODE && Menu::getInstance()->isOptionChecked(MenuOption::Stats)) {
-            PerformanceTimer perfTimer("worldBox");
+            PERFORMANCE_TIMER("worldBox");
 
             auto& batch = *args->_batch;
             DependencyManager::get<DeferredLightingEffect>()->bindSimpleProgram(batch);
@@ -3155,7 +3166,7 @@ namespace render {
         if (skyStage->getBackgroundMode() == model::SunSkyStage::NO_BACKGROUND) {
         } else if (skyStage->getBackgroundMode() == model::SunSkyStage::SKY_DOME) {
            if (/*!selfAvatarOnly &&*/ Menu::getInstance()->isOptionChecked(MenuOption::Stars)) {
-                PerformanceTimer perfTimer("stars");
+                PERFORMANCE_TIMER("stars");
                 PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                     "Application::payloadRender<BackgroundRenderData>() ... stars...");
                 // should be the first rendering pass - w/o depth buffer / lighting
@@ -3210,7 +3221,7 @@ namespace render {
 
                 // draw the sky dome
                 if (/*!selfAvatarOnly &&*/ Menu::getInstance()->isOptionChecked(MenuOption::Atmosphere)) {
-                    PerformanceTimer perfTimer("atmosphere");
+                    PERFORMANCE_TIMER("atmosphere");
                     PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                         "Application::displaySide() ... atmosphere...");
 
@@ -3219,7 +3230,7 @@ namespace render {
 
             }
         } else if (skyStage->getBackgroundMode() == model::SunSkyStage::SKY_BOX) {
-            PerformanceTimer perfTimer("skybox");
+            PERFORMANCE_TIMER("skybox");
 
             skybox = skyStage->getSkybox();
             if (skybox) {
@@ -3238,7 +3249,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
 
     activeRenderingThread = QThread::currentThread();
     PROFILE_RANGE(__FUNCTION__);
-    PerformanceTimer perfTimer("display");
+    PERFORMANCE_TIMER("display");
     PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings), "Application::displaySide()");
 
     // load the view frustum
@@ -3263,7 +3274,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
     if (!selfAvatarOnly) {
         if (DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities()) {
             // render models...
-            PerformanceTimer perfTimer("entities");
+            PERFORMANCE_TIMER("entities");
             PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                 "Application::displaySide() ... entities...");
 
@@ -3311,7 +3322,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
     }
 
     {
-        PerformanceTimer perfTimer("SceneProcessPendingChanges");
+        PERFORMANCE_TIMER("SceneProcessPendingChanges");
         _main3DScene->enqueuePendingChanges(pendingChanges);
 
         _main3DScene->processPendingChangesQueue();
@@ -3319,7 +3330,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
 
     // For now every frame pass the renderContext
     {
-        PerformanceTimer perfTimer("EngineRun");
+        PERFORMANCE_TIMER("EngineRun");
         render::RenderContext renderContext;
 
         auto sceneInterface = DependencyManager::get<SceneScriptingInterface>();
@@ -3363,7 +3374,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
     if (!selfAvatarOnly) {
         // give external parties a change to hook in
         {
-            PerformanceTimer perfTimer("inWorldInterface");
+            PERFORMANCE_TIMER("inWorldInterface");
             emit renderingInWorldInterface();
         }
     }
@@ -146,7 +146,7 @@ float Avatar::getLODDistance() const {
 }
 
 void Avatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    PERFORMANCE_TIMER("simulate");
 
     // update the avatar's position according to its referential
     if (_referential) {
@@ -192,14 +192,14 @@ void Avatar::simulate(float deltaTime) {
         ViewFrustum::OUTSIDE;
 
     {
-        PerformanceTimer perfTimer("hand");
+        PERFORMANCE_TIMER("hand");
         getHand()->simulate(deltaTime, false);
     }
     _skeletonModel.setLODDistance(getLODDistance());
 
     if (!_shouldRenderBillboard && inViewFrustum) {
         {
-            PerformanceTimer perfTimer("skeleton");
+            PERFORMANCE_TIMER("skeleton");
             if (_hasNewJointRotations) {
                 for (int i = 0; i < _jointData.size(); i++) {
                     const JointData& data = _jointData.at(i);
@@ -211,7 +211,7 @@ void Avatar::simulate(float deltaTime) {
             _hasNewJointRotations = false;
         }
         {
-            PerformanceTimer perfTimer("head");
+            PERFORMANCE_TIMER("head");
             glm::vec3 headPosition = _position;
             _skeletonModel.getHeadPosition(headPosition);
             Head* head = getHead();
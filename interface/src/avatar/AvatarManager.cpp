@@ -100,7 +100,7 @@ void AvatarManager::updateMyAvatar(float deltaTime) {
 
     if (dt > MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS) {
         // send head/hand data to the avatar mixer and voxel server
-        PerformanceTimer perfTimer("send");
+        PERFORMANCE_TIMER("send");
         _myAvatar->sendAvatarDataPacket();
         _lastSendAvatarDataTime = now;
     }
@@ -113,7 +113,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateAvatars()");
 
-    PerformanceTimer perfTimer("otherAvatars");
+    PERFORMANCE_TIMER("otherAvatars");
 
     // simulate avatars
     AvatarHash::iterator avatarIterator = _avatarHash.begin();
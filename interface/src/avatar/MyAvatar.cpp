@@ -174,7 +174,7 @@ void MyAvatar::update(float deltaTime) {
 }
 
 void MyAvatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    PERFORMANCE_TIMER("simulate");
 
     // Play back recording
     if (_player && _player->isPlaying()) {
@@ -187,19 +187,19 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("transform");
+        PERFORMANCE_TIMER("transform");
         updateOrientation(deltaTime);
         updatePosition(deltaTime);
     }
 
     {
-        PerformanceTimer perfTimer("hand");
+        PERFORMANCE_TIMER("hand");
         // update avatar skeleton and simulate hand and head
         getHand()->simulate(deltaTime, true);
     }
 
     {
-        PerformanceTimer perfTimer("skeleton");
+        PERFORMANCE_TIMER("skeleton");
         _skeletonModel.simulate(deltaTime);
     }
 
@@ -209,12 +209,12 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("attachments");
+        PERFORMANCE_TIMER("attachments");
         simulateAttachments(deltaTime);
     }
 
     {
-        PerformanceTimer perfTimer("joints");
+        PERFORMANCE_TIMER("joints");
         // copy out the skeleton joints from the model
         _jointData.resize(_rig->getJointStateCount());
         for (int i = 0; i < _jointData.size(); i++) {
@@ -224,7 +224,7 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("head");
+        PERFORMANCE_TIMER("head");
         Head* head = getHead();
         glm::vec3 headPosition;
         if (!_skeletonModel.getHeadPosition(headPosition)) {
@@ -14,6 +14,7 @@
 #include <cstdio>
 
 #include <AudioClient.h>
+#include <AudioCodec.h>
 #include <AudioConstants.h>
 #include <AudioIOStats.h>
 #include <DependencyManager.h>
@@ -207,6 +208,8 @@ void AudioStatsDialog::renderAudioStreamStats(const AudioStreamStats* streamStat
                                 QString("Inter-packet timegaps (overall) | min: %1, max: %2, avg: %3").arg(formatUsecTime(streamStats->_timeGapMin).toLatin1().data()).arg(formatUsecTime(streamStats->_timeGapMax).toLatin1().data()).arg(formatUsecTime(streamStats->_timeGapAverage).toLatin1().data()));
     audioStreamStats->push_back(
                                 QString("Inter-packet timegaps (last 30s) | min: %1, max: %2, avg: %3").arg(formatUsecTime(streamStats->_timeGapWindowMin).toLatin1().data()).arg(formatUsecTime(streamStats->_timeGapWindowMax).toLatin1().data()).arg(QString::number(streamStats->_timeGapWindowAverage).toLatin1().data()));
+    audioStreamStats->push_back(
+                                QString("Codec | %1, compression: %2:1").arg(AudioCodec::getTypeName(streamStats->_codec)).arg(QString::number(streamStats->getCompressionRatio(), 'f', 2)));
     
 }
 
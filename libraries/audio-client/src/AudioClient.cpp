@@ -790,13 +790,16 @@ void AudioClient::handleAudioInput() {
         // we don't have an audioPacket yet - set that up now
         _audioPacket = NLPacket::create(PacketType::MicrophoneAudioNoEcho);
     }
+    if (!_inputEncoder) {
+        _inputEncoder = AudioCodec::create(AudioCodec::DEFAULT_TYPE);
+    }
 
     float inputToNetworkInputRatio = calculateDeviceToNetworkInputRatio();
 
     int inputSamplesRequired = (int)((float)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * inputToNetworkInputRatio);
 
-    static int leadingBytes = sizeof(quint16) + sizeof(glm::vec3) + sizeof(glm::quat) + sizeof(quint8);
-    int16_t* networkAudioSamples = (int16_t*)(_audioPacket->getPayload() + leadingBytes);
+    // gathered here and encoded into the packet once the rest of the packet is written
+    int16_t networkAudioSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
     QByteArray inputByteArray = _inputDevice->readAll();
 
@@ -929,6 +932,10 @@ void AudioClient::handleAudioInput() {
                 _audioPacket->writePrimitive(isStereo);
             }
 
+            // pack the codec of our audio, silent frames carry it too so that the mixer knows it for our mix
+            quint8 codecType = _inputEncoder->getType();
+            _audioPacket->writePrimitive(codecType);
+
             // pack the three float positions
             _audioPacket->writePrimitive(headPosition);
 
@@ -936,8 +943,10 @@ void AudioClient::handleAudioInput() {
             _audioPacket->writePrimitive(headOrientation);
             
             if (_audioPacket->getType() != PacketType::SilentAudioFrame) {
-                // audio samples have already been packed (written to networkAudioSamples)
-                _audioPacket->setPayloadSize(_audioPacket->getPayloadSize() + numNetworkBytes);
+                // encode the audio samples gathered above (in networkAudioSamples) straight into the packet
+                int encodedBytes = _inputEncoder->encode(networkAudioSamples, numNetworkSamples, isStereo ? 2 : 1,
+                                                         _audioPacket->getPayload() + _audioPacket->pos());
+                _audioPacket->setPayloadSize(_audioPacket->getPayloadSize() + encodedBytes);
             }
             
             _stats.sentPacket();
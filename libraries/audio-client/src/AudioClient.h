@@ -26,6 +26,7 @@
 
 #include <AbstractAudioInterface.h>
 #include <AudioBuffer.h>
+#include <AudioCodec.h>
 #include <AudioEffectOptions.h>
 #include <AudioFormat.h>
 #include <AudioGain.h>
@@ -318,6 +319,7 @@ private:
     bool _hasReceivedFirstPacket = false;
 
     std::unique_ptr<NLPacket> _audioPacket;
+    std::unique_ptr<AudioCodec> _inputEncoder; // the mixer sends our mix back with the same codec
 };
 
 
@@ -0,0 +1,204 @@
+//
+//  AudioCodec.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include "AudioCodec.h"
+
+namespace {
+
+class PCMCodec : public AudioCodec {
+public:
+    virtual Type getType() const { return PCM; }
+
+    virtual int getEncodedSize(int numSamples, int numChannels) const { return numSamples * sizeof(int16_t); }
+    virtual int getDecodedSamples(int numBytes, int numChannels) const { return numBytes / sizeof(int16_t); }
+
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* encoded) {
+        memcpy(encoded, samples, numSamples * sizeof(int16_t));
+        return numSamples * sizeof(int16_t);
+    }
+
+    virtual int decode(const char* encoded, int numBytes, int numChannels, int16_t* samples) {
+        int numSamples = getDecodedSamples(numBytes, numChannels);
+        memcpy(samples, encoded, numSamples * sizeof(int16_t));
+        return numSamples;
+    }
+};
+
+const int IMA_STEP_TABLE[] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060,
+    1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+    7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+const int IMA_MAX_STEP_INDEX = sizeof(IMA_STEP_TABLE) / sizeof(IMA_STEP_TABLE[0]) - 1;
+const int IMA_INDEX_TABLE[] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+const int MAX_CHANNELS = 2;
+
+/// IMA ADPCM, four bits a sample. Each channel starts the frame with a header holding the predicted sample and the step
+/// index, a little endian int16_t and a byte, padded to four bytes. The nibbles of the samples follow in the order the
+/// samples are interleaved in, two to a byte, low nibble first.
+class IMAADPCMCodec : public AudioCodec {
+public:
+    static const int CHANNEL_HEADER_BYTES = 4;
+
+    IMAADPCMCodec() { reset(); }
+
+    virtual Type getType() const { return IMA_ADPCM; }
+
+    virtual int getEncodedSize(int numSamples, int numChannels) const {
+        return numChannels * CHANNEL_HEADER_BYTES + (numSamples + 1) / 2;
+    }
+
+    virtual int getDecodedSamples(int numBytes, int numChannels) const {
+        int nibbleBytes = numBytes - numChannels * CHANNEL_HEADER_BYTES;
+        if (numChannels < 1 || numChannels > MAX_CHANNELS || nibbleBytes <= 0) {
+            return 0;
+        }
+        // network frames have an even number of samples, so the last nibble is never padding
+        int numSamples = nibbleBytes * 2;
+        return numSamples - numSamples % numChannels;
+    }
+
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* encoded) {
+        Q_ASSERT(numChannels >= 1 && numChannels <= MAX_CHANNELS);
+        unsigned char* output = reinterpret_cast<unsigned char*>(encoded);
+        for (int channel = 0; channel < numChannels; channel++) {
+            writeHeader(_state[channel], output);
+            output += CHANNEL_HEADER_BYTES;
+        }
+        for (int i = 0; i < numSamples; i++) {
+            ChannelState& state = _state[i % numChannels];
+            int nibble = encodeSample(state, samples[i]);
+            if (i % 2 == 0) {
+                output[i / 2] = nibble;
+            } else {
+                output[i / 2] |= nibble << 4;
+            }
+        }
+        return getEncodedSize(numSamples, numChannels);
+    }
+
+    virtual int decode(const char* encoded, int numBytes, int numChannels, int16_t* samples) {
+        int numSamples = getDecodedSamples(numBytes, numChannels);
+        if (numSamples == 0) {
+            return 0;
+        }
+        const unsigned char* input = reinterpret_cast<const unsigned char*>(encoded);
+        ChannelState state[MAX_CHANNELS];
+        for (int channel = 0; channel < numChannels; channel++) {
+            readHeader(input, state[channel]);
+            input += CHANNEL_HEADER_BYTES;
+        }
+        for (int i = 0; i < numSamples; i++) {
+            int nibble = (i % 2 == 0) ? (input[i / 2] & 0x0f) : (input[i / 2] >> 4);
+            samples[i] = decodeNibble(state[i % numChannels], nibble);
+        }
+        return numSamples;
+    }
+
+    virtual void reset() {
+        for (int channel = 0; channel < MAX_CHANNELS; channel++) {
+            _state[channel].predicted = 0;
+            _state[channel].stepIndex = 0;
+        }
+    }
+
+private:
+    struct ChannelState {
+        int predicted;
+        int stepIndex;
+    };
+
+    static void writeHeader(const ChannelState& state, unsigned char* header) {
+        header[0] = (unsigned char)(state.predicted & 0xff);
+        header[1] = (unsigned char)((state.predicted >> 8) & 0xff);
+        header[2] = (unsigned char)state.stepIndex;
+        header[3] = 0;
+    }
+
+    static void readHeader(const unsigned char* header, ChannelState& state) {
+        state.predicted = (int16_t)(header[0] | (header[1] << 8));
+        state.stepIndex = std::min((int)header[2], IMA_MAX_STEP_INDEX);
+    }
+
+    // the encoder steps its state with the decoder's own arithmetic, so that both predict the same samples
+    static int16_t decodeNibble(ChannelState& state, int nibble) {
+        int step = IMA_STEP_TABLE[state.stepIndex];
+        int delta = step >> 3;
+        if (nibble & 4) {
+            delta += step;
+        }
+        if (nibble & 2) {
+            delta += step >> 1;
+        }
+        if (nibble & 1) {
+            delta += step >> 2;
+        }
+        state.predicted += (nibble & 8) ? -delta : delta;
+        state.predicted = std::max(-32768, std::min(state.predicted, 32767));
+        state.stepIndex = std::max(0, std::min(state.stepIndex + IMA_INDEX_TABLE[nibble], IMA_MAX_STEP_INDEX));
+        return (int16_t)state.predicted;
+    }
+
+    static int encodeSample(ChannelState& state, int16_t sample) {
+        int difference = sample - state.predicted;
+        int nibble = 0;
+        if (difference < 0) {
+            nibble = 8;
+            difference = -difference;
+        }
+        int step = IMA_STEP_TABLE[state.stepIndex];
+        if (difference >= step) {
+            nibble |= 4;
+            difference -= step;
+        }
+        step >>= 1;
+        if (difference >= step) {
+            nibble |= 2;
+            difference -= step;
+        }
+        step >>= 1;
+        if (difference >= step) {
+            nibble |= 1;
+        }
+        decodeNibble(state, nibble);
+        return nibble;
+    }
+
+    ChannelState _state[MAX_CHANNELS];
+};
+
+}
+
+std::unique_ptr<AudioCodec> AudioCodec::create(quint8 type) {
+    switch (type) {
+        case PCM:
+            return std::unique_ptr<AudioCodec>(new PCMCodec());
+        case IMA_ADPCM:
+            return std::unique_ptr<AudioCodec>(new IMAADPCMCodec());
+        default:
+            return std::unique_ptr<AudioCodec>();
+    }
+}
+
+const char* AudioCodec::getTypeName(quint8 type) {
+    switch (type) {
+        case PCM:
+            return "pcm";
+        case IMA_ADPCM:
+            return "ima_adpcm";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,62 @@
+//
+//  AudioCodec.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Encodes network audio frames for the wire
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodec_h
+#define hifi_AudioCodec_h
+
+#include <memory>
+#include <stdint.h>
+
+#include <QtCore/QtGlobal>
+
+/// A codec for the audio data of audio packets, which carry the type of the codec their audio data is encoded with.
+/// Samples are interleaved when there is more than one channel. An encoder may carry state from one frame to the next,
+/// but every encoded frame decodes on its own, so that a lost packet does not garble the ones after it.
+///
+/// To add a codec, add its type before NUM_TYPES and have create() return it.
+class AudioCodec {
+public:
+    enum Type : quint8 {
+        PCM = 0,
+        IMA_ADPCM,
+        NUM_TYPES
+    };
+
+    /// the codec clients encode their audio with, and so the one the mixer sends mixed audio with
+    static const Type DEFAULT_TYPE = IMA_ADPCM;
+
+    /// returns nullptr for a type this build does not know
+    static std::unique_ptr<AudioCodec> create(quint8 type);
+    static bool isKnownType(quint8 type) { return type < NUM_TYPES; }
+    static const char* getTypeName(quint8 type);
+
+    virtual ~AudioCodec() { }
+
+    virtual Type getType() const = 0;
+
+    /// the most bytes encode() writes for numSamples samples
+    virtual int getEncodedSize(int numSamples, int numChannels) const = 0;
+
+    /// the number of samples an encoded frame of numBytes decodes to
+    virtual int getDecodedSamples(int numBytes, int numChannels) const = 0;
+
+    /// returns the number of bytes written to encoded
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* encoded) = 0;
+
+    /// writes getDecodedSamples(numBytes, numChannels) samples, returns how many were written
+    virtual int decode(const char* encoded, int numBytes, int numChannels, int16_t* samples) = 0;
+
+    /// forgets the state carried over from the last frame encoded
+    virtual void reset() { }
+};
+
+#endif // hifi_AudioCodec_h
@@ -149,6 +149,31 @@ public:
         }
     }
 
+    // interleaved float samples, at whatever scale the caller mixes in (the filters are linear)
+    void render(const float* in, float* out, const uint32_t frameCount) {
+        if (frameCount > _frameCount) {
+            return;
+        }
+
+        for (uint32_t i = 0; i < frameCount; ++i) {
+            for (uint32_t j = 0; j < _channelCount; ++j) {
+                _buffer[j][i] = *in++;
+            }
+        }
+
+        for (uint32_t i = 0; i < _channelCount; ++i) {
+            for (uint32_t j = 0; j < _filterCount; ++j) {
+                _filters[j][i].render( &_buffer[i][0], &_buffer[i][0], frameCount );
+            }
+        }
+
+        for (uint32_t i = 0; i < frameCount; ++i) {
+            for (uint32_t j = 0; j < _channelCount; ++j) {
+                *out++ = _buffer[j][i];
+            }
+        }
+    }
+
     void render(AudioBufferFloat32& frameBuffer) {
         
         float32_t** samples = frameBuffer.getFrameData();
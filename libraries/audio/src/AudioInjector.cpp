@@ -19,6 +19,7 @@
 #include <soxr.h>
 
 #include "AbstractAudioInterface.h"
+#include "AudioInjectorManager.h"
 #include "AudioRingBuffer.h"
 #include "AudioLogging.h"
 #include "SoundCache.h"
@@ -149,133 +150,127 @@ void AudioInjector::injectToMixer() {
         _currentSendPosition = 0;
     }
 
-    auto nodeList = DependencyManager::get<NodeList>();
-
     // make sure we actually have samples downloaded to inject
-    if (_audioData.size()) {
+    if (!_audioData.size()) {
+        setIsFinished(true);
+        _isPlaying = !_isFinished; // Which can be false if a restart was requested
+        return;
+    }
 
-        auto audioPacket = NLPacket::create(PacketType::InjectAudio);
+    _audioPacket = NLPacket::create(PacketType::InjectAudio);
 
-        // setup the packet for injected audio
-        QDataStream audioPacketStream(audioPacket.get());
+    // setup the packet for injected audio
+    QDataStream audioPacketStream(_audioPacket.get());
 
-        // pack some placeholder sequence number for now
-        audioPacketStream << (quint16) 0;
+    // pack some placeholder sequence number for now
+    audioPacketStream << (quint16) 0;
 
-        // pack stream identifier (a generated UUID)
-        audioPacketStream << QUuid::createUuid();
+    // pack stream identifier (a generated UUID)
+    audioPacketStream << QUuid::createUuid();
 
-        // pack the stereo/mono type of the stream
-        audioPacketStream << _options.stereo;
+    // pack the stereo/mono type of the stream
+    audioPacketStream << _options.stereo;
 
-        // pack the flag for loopback
-        uchar loopbackFlag = (uchar) true;
-        audioPacketStream << loopbackFlag;
+    // pack the flag for loopback
+    uchar loopbackFlag = (uchar) true;
+    audioPacketStream << loopbackFlag;
 
-        // pack the position for injected audio
-        int positionOptionOffset = audioPacket->pos();
-        audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
-                                  sizeof(_options.position));
+    // pack the position for injected audio
+    _positionOptionOffset = _audioPacket->pos();
+    audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
+                              sizeof(_options.position));
 
-        // pack our orientation for injected audio
-        audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.orientation),
-                                  sizeof(_options.orientation));
+    // pack our orientation for injected audio
+    audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.orientation),
+                              sizeof(_options.orientation));
 
-        // pack zero for radius
-        float radius = 0;
-        audioPacketStream << radius;
+    // pack zero for radius
+    float radius = 0;
+    audioPacketStream << radius;
 
-        // pack 255 for attenuation byte
-        int volumeOptionOffset = audioPacket->pos();
-        quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
-        audioPacketStream << volume;
+    // pack 255 for attenuation byte
+    _volumeOptionOffset = _audioPacket->pos();
+    quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
+    audioPacketStream << volume;
 
-        audioPacketStream << _options.ignorePenumbra;
+    audioPacketStream << _options.ignorePenumbra;
 
-        int audioDataOffset = audioPacket->pos();
+    _audioDataOffset = _audioPacket->pos();
 
-        QElapsedTimer timer;
-        timer.start();
-        int nextFrame = 0;
+    _outgoingSequenceNumber = 0;
+    _framesSent = 0;
+    _frameTimer.start();
 
-        bool shouldLoop = _options.loop;
+    // from here on the injector thread's tick sends our frames as they come due
+    AudioInjectorManager::getInstance()->addInjector(this);
+}
 
-        // loop to send off our audio in NETWORK_BUFFER_LENGTH_SAMPLES_PER_CHANNEL byte chunks
-        quint16 outgoingInjectedAudioSequenceNumber = 0;
+bool AudioInjector::injectDueFrames(int& framesInjected) {
+    // grab our audio mixer from the NodeList, if it exists
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList ? nodeList->soloNodeOfType(NodeType::AudioMixer) : SharedNodePointer();
 
-        while (_currentSendPosition < _audioData.size() && !_shouldStop) {
+    // send two packets right away so the mixer can start playback, then one every frame
+    qint64 usecsElapsed = _frameTimer.nsecsElapsed() / 1000;
 
-            int bytesToCopy = std::min(((_options.stereo) ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
-                                       _audioData.size() - _currentSendPosition);
+    // send off our audio in NETWORK_BUFFER_LENGTH_SAMPLES_PER_CHANNEL byte chunks
+    while (_currentSendPosition < _audioData.size() && !_shouldStop
+           && (_framesSent < 2 || (qint64)(_framesSent - 1) * AudioConstants::NETWORK_FRAME_USECS <= usecsElapsed)) {
 
-            //  Measure the loudness of this frame
-            _loudness = 0.0f;
-            for (int i = 0; i < bytesToCopy; i += sizeof(int16_t)) {
-                _loudness += abs(*reinterpret_cast<int16_t*>(_audioData.data() + _currentSendPosition + i)) /
-                (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
-            }
-            _loudness /= (float)(bytesToCopy / sizeof(int16_t));
-            
-            audioPacket->seek(0);
-            
-            // pack the sequence number
-            audioPacket->writePrimitive(outgoingInjectedAudioSequenceNumber);
-
-            audioPacket->seek(positionOptionOffset);
-            audioPacket->writePrimitive(_options.position);
-            audioPacket->writePrimitive(_options.orientation);
-
-            volume = MAX_INJECTOR_VOLUME * _options.volume;
-            audioPacket->seek(volumeOptionOffset);
-            audioPacket->writePrimitive(volume);
-
-            audioPacket->seek(audioDataOffset);
-
-            // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
-            audioPacket->write(_audioData.data() + _currentSendPosition, bytesToCopy);
-
-            // set the correct size used for this packet
-            audioPacket->setPayloadSize(audioPacket->pos());
-
-            // grab our audio mixer from the NodeList, if it exists
-            SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
-            
-            if (audioMixer) {
-                // send off this audio packet
-                nodeList->sendUnreliablePacket(*audioPacket, *audioMixer);
-                outgoingInjectedAudioSequenceNumber++;
-            }
+        int bytesToCopy = std::min(((_options.stereo) ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL,
+                                   _audioData.size() - _currentSendPosition);
 
-            _currentSendPosition += bytesToCopy;
+        //  Measure the loudness of this frame
+        _loudness = 0.0f;
+        for (int i = 0; i < bytesToCopy; i += sizeof(int16_t)) {
+            _loudness += abs(*reinterpret_cast<int16_t*>(_audioData.data() + _currentSendPosition + i)) /
+            (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
+        }
+        _loudness /= (float)(bytesToCopy / sizeof(int16_t));
 
-            // send two packets before the first sleep so the mixer can start playback right away
+        _audioPacket->seek(0);
 
-            if (_currentSendPosition != bytesToCopy && _currentSendPosition < _audioData.size()) {
+        // pack the sequence number
+        _audioPacket->writePrimitive(_outgoingSequenceNumber);
 
-                // process events in case we have been told to stop and be deleted
-                QCoreApplication::processEvents();
+        _audioPacket->seek(_positionOptionOffset);
+        _audioPacket->writePrimitive(_options.position);
+        _audioPacket->writePrimitive(_options.orientation);
 
-                if (_shouldStop) {
-                    break;
-                }
+        quint8 volume = MAX_INJECTOR_VOLUME * _options.volume;
+        _audioPacket->seek(_volumeOptionOffset);
+        _audioPacket->writePrimitive(volume);
 
-                // not the first packet and not done
-                // sleep for the appropriate time
-                int usecToSleep = (++nextFrame * AudioConstants::NETWORK_FRAME_USECS) - timer.nsecsElapsed() / 1000;
+        _audioPacket->seek(_audioDataOffset);
 
-                if (usecToSleep > 0) {
-                    usleep(usecToSleep);
-                }
-            }
+        // copy the next NETWORK_BUFFER_LENGTH_BYTES_PER_CHANNEL bytes to the packet
+        _audioPacket->write(_audioData.data() + _currentSendPosition, bytesToCopy);
 
-            if (shouldLoop && _currentSendPosition >= _audioData.size()) {
-                _currentSendPosition = 0;
-            }
+        // set the correct size used for this packet
+        _audioPacket->setPayloadSize(_audioPacket->pos());
+
+        if (audioMixer) {
+            // send off this audio packet
+            nodeList->sendUnreliablePacket(*_audioPacket, *audioMixer);
+            _outgoingSequenceNumber++;
+        }
+
+        _currentSendPosition += bytesToCopy;
+        _framesSent++;
+        framesInjected++;
+
+        if (_options.loop && _currentSendPosition >= _audioData.size()) {
+            _currentSendPosition = 0;
         }
     }
 
-    setIsFinished(true);
-    _isPlaying = !_isFinished; // Which can be false if a restart was requested
+    if (_shouldStop || _currentSendPosition >= _audioData.size()) {
+        _audioPacket.reset();
+        setIsFinished(true);
+        _isPlaying = !_isFinished; // Which can be false if a restart was requested
+        return false;
+    }
+    return true;
 }
 
 void AudioInjector::stop() {
@@ -337,22 +332,11 @@ AudioInjector* AudioInjector::playSound(const QString& soundUrl, const float vol
 }
 
 AudioInjector* AudioInjector::playSound(const QByteArray& buffer, const AudioInjectorOptions options, AbstractAudioInterface* localInterface) {
-    QThread* injectorThread = new QThread();
-    injectorThread->setObjectName("Audio Injector Thread");
-
     AudioInjector* injector = new AudioInjector(buffer, options);
     injector->_isPlaying = true;
     injector->setLocalAudioInterface(localInterface);
 
-    injector->moveToThread(injectorThread);
-
-    // start injecting when the injector thread starts
-    connect(injectorThread, &QThread::started, injector, &AudioInjector::injectAudio);
-
-    // connect the right slots and signals for AudioInjector and thread cleanup
-    connect(injector, &AudioInjector::destroyed, injectorThread, &QThread::quit);
-    connect(injectorThread, &QThread::finished, injectorThread, &QThread::deleteLater);
-
-    injectorThread->start();
+    // every injector lives on the one injector thread, and starts injecting once it gets there
+    AudioInjectorManager::getInstance()->startInjector(injector);
     return injector;
 }
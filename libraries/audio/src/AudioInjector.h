@@ -12,6 +12,7 @@
 #ifndef hifi_AudioInjector_h
 #define hifi_AudioInjector_h
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QThread>
@@ -19,6 +20,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <NLPacket.h>
+
 #include "AudioInjectorLocalBuffer.h"
 #include "AudioInjectorOptions.h"
 #include "Sound.h"
@@ -69,8 +72,14 @@ signals:
     void finished();
 
 private:
+    friend class AudioInjectorManager;
+
     void injectToMixer();
     void injectLocally();
+
+    /// sends the frames that came due since the last call, called by the AudioInjectorManager on every tick. Returns
+    /// false once the injector has finished, adding the number of frames stepped through to framesInjected.
+    bool injectDueFrames(int& framesInjected);
     
     void setIsFinished(bool isFinished);
     
@@ -85,6 +94,15 @@ private:
     int _currentSendPosition = 0;
     AbstractAudioInterface* _localAudioInterface = NULL;
     AudioInjectorLocalBuffer* _localBuffer = NULL;
+
+    // the InjectAudio packet reused for every frame while sending to the mixer
+    std::unique_ptr<NLPacket> _audioPacket;
+    int _positionOptionOffset = 0;
+    int _volumeOptionOffset = 0;
+    int _audioDataOffset = 0;
+    quint16 _outgoingSequenceNumber = 0;
+    int _framesSent = 0;
+    QElapsedTimer _frameTimer;
 };
 
 
@@ -0,0 +1,106 @@
+//
+//  AudioInjectorManager.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+
+#include <NodeList.h>
+
+#include "AudioInjector.h"
+
+#include "AudioInjectorManager.h"
+
+AudioInjectorManager* AudioInjectorManager::getInstance() {
+    // never deleted, stop() ends the thread as the application quits
+    static AudioInjectorManager* sharedInstance = new AudioInjectorManager();
+    return sharedInstance;
+}
+
+AudioInjectorManager::AudioInjectorManager() :
+    _tickTimer(new QTimer(this)),
+    _injectorCount(0),
+    _totalFramesInjected(0),
+    _totalTicks(0)
+{
+    _thread.setObjectName("Audio Injector Thread");
+
+    _tickTimer->setTimerType(Qt::PreciseTimer);
+    _tickTimer->setInterval(TICK_INTERVAL_MSECS);
+    connect(_tickTimer, &QTimer::timeout, this, &AudioInjectorManager::tick);
+
+    moveToThread(&_thread);
+    _thread.start();
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &AudioInjectorManager::stop,
+                Qt::DirectConnection);
+    }
+}
+
+void AudioInjectorManager::startInjector(AudioInjector* injector) {
+    injector->moveToThread(&_thread);
+    QMetaObject::invokeMethod(injector, "injectAudio", Qt::QueuedConnection);
+}
+
+void AudioInjectorManager::stop() {
+    if (!_thread.isRunning()) {
+        return;
+    }
+    _thread.quit();
+    _thread.wait();
+}
+
+void AudioInjectorManager::addInjector(AudioInjector* injector) {
+    Q_ASSERT(QThread::currentThread() == &_thread);
+
+    // the first frames go out right away so the mixer can start playback, rather than on the next tick
+    int framesInjected = 0;
+    bool isSending = injector->injectDueFrames(framesInjected);
+    _totalFramesInjected += framesInjected;
+
+    if (isSending) {
+        _injectors.push_back(injector);
+        _injectorCount = _injectors.size();
+        if (!_tickTimer->isActive()) {
+            _tickTimer->start();
+        }
+    }
+}
+
+void AudioInjectorManager::tick() {
+    // the packets of a tick go out together. If another thread already batches its sends, as a mixer does, the
+    // injectors send one datagram at a time instead. Batching is let go of at the end of every tick, so that a mixer
+    // starting later can batch its own
+    auto nodeList = DependencyManager::get<NodeList>();
+    bool isBatchingSends = nodeList && nodeList->claimSendBatching(&_thread);
+
+    int framesInjected = 0;
+    for (int i = 0; i < _injectors.size(); ) {
+        AudioInjector* injector = _injectors[i].data();
+        if (injector && injector->injectDueFrames(framesInjected)) {
+            i++;
+        } else {
+            // finished, stopped or deleted, the order the injectors are stepped in does not matter
+            _injectors[i] = _injectors.last();
+            _injectors.pop_back();
+        }
+    }
+
+    if (isBatchingSends) {
+        nodeList->releaseSendBatching(&_thread);
+    }
+
+    _totalFramesInjected += framesInjected;
+    _totalTicks++;
+    _injectorCount = _injectors.size();
+    if (_injectors.isEmpty()) {
+        _tickTimer->stop();
+    }
+}
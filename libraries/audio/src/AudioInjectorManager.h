@@ -0,0 +1,73 @@
+//
+//  AudioInjectorManager.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Paces every audio injector in the process from one thread
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioInjectorManager_h
+#define hifi_AudioInjectorManager_h
+
+#include <atomic>
+
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+class AudioInjector;
+class QTimer;
+
+/// Owns the one thread all audio injectors live on. Injectors sending to the audio mixer are stepped from a single
+/// timer tick, each sending whatever frames have come due since the last tick, and the packets of a tick go out as one
+/// batch when the node socket can batch sends. Local only injectors live on the same thread, their audio is pulled by
+/// the local audio output.
+class AudioInjectorManager : public QObject {
+    Q_OBJECT
+public:
+    static const int TICK_INTERVAL_MSECS = 10;
+
+    static AudioInjectorManager* getInstance();
+
+    /// moves the injector to the injector thread and starts it there. Call from the thread the injector lives in.
+    void startInjector(AudioInjector* injector);
+
+    QThread* getThread() { return &_thread; }
+
+    /// injectors currently sending to the mixer
+    int getInjectorCount() const { return _injectorCount; }
+
+    /// frames of audio stepped through, whether or not there was an audio mixer to send them to
+    quint64 getTotalFramesInjected() const { return _totalFramesInjected; }
+    quint64 getTotalTicks() const { return _totalTicks; }
+
+public slots:
+    /// stops the injector thread, called as the application quits
+    void stop();
+
+private slots:
+    void tick();
+
+private:
+    friend class AudioInjector;
+
+    AudioInjectorManager();
+
+    /// called by an injector on the injector thread once it is ready to send, sends the frames due right away
+    void addInjector(AudioInjector* injector);
+
+    QThread _thread;
+    QTimer* _tickTimer;
+    QVector<QPointer<AudioInjector>> _injectors; // only touched on the injector thread
+
+    std::atomic<int> _injectorCount;
+    std::atomic<quint64> _totalFramesInjected;
+    std::atomic<quint64> _totalTicks;
+};
+
+#endif // hifi_AudioInjectorManager_h
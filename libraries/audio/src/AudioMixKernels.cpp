@@ -0,0 +1,295 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HIFI_MIX_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+const float MIN_MIX_SAMPLE_VALUE = -32768.0f;
+const float MAX_MIX_SAMPLE_VALUE = 32767.0f;
+
+static void mixMonoToStereoScalar(float* mix, const int16_t* leftInput, const int16_t* rightInput, int numFrames,
+                                  float leftGain, float rightGain) {
+    for (int i = 0; i < numFrames; ++i) {
+        mix[2 * i] += leftInput[i] * leftGain;
+        mix[2 * i + 1] += rightInput[i] * rightGain;
+    }
+}
+
+static void mixSamplesScalar(float* mix, const int16_t* input, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; ++i) {
+        mix[i] += input[i] * gain;
+    }
+}
+
+static void mixMonoToStereoFloatScalar(float* mix, const float* leftInput, const float* rightInput, int numFrames,
+                                       float leftGain, float rightGain) {
+    for (int i = 0; i < numFrames; ++i) {
+        mix[2 * i] += leftInput[i] * leftGain;
+        mix[2 * i + 1] += rightInput[i] * rightGain;
+    }
+}
+
+static void mixSamplesFloatScalar(float* mix, const float* input, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; ++i) {
+        mix[i] += input[i] * gain;
+    }
+}
+
+static void accumulateScalar(float* mix, const float* input, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        mix[i] += input[i];
+    }
+}
+
+static void convertToInt16Scalar(int16_t* output, const float* mix, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        float sample = std::min(std::max(mix[i], MIN_MIX_SAMPLE_VALUE), MAX_MIX_SAMPLE_VALUE);
+        // rounds with the current rounding mode, half to even by default, like the SIMD conversions
+        output[i] = (int16_t)lrintf(sample);
+    }
+}
+
+static const AudioMixKernels::KernelTable SCALAR_KERNELS = {
+    mixMonoToStereoScalar,
+    mixSamplesScalar,
+    mixMonoToStereoFloatScalar,
+    mixSamplesFloatScalar,
+    accumulateScalar,
+    convertToInt16Scalar
+};
+
+const AudioMixKernels::KernelTable* AudioMixKernels::getScalarKernelTable() {
+    return &SCALAR_KERNELS;
+}
+
+#ifdef HIFI_MIX_KERNELS_SSE2
+
+// sign extends the low (or high) four int16_t of a vector and converts them to float
+static inline __m128 lowInt16ToFloat(__m128i samples) {
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+}
+
+static inline __m128 highInt16ToFloat(__m128i samples) {
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+}
+
+static void mixMonoToStereoSSE2(float* mix, const int16_t* leftInput, const int16_t* rightInput, int numFrames,
+                                float leftGain, float rightGain) {
+    const __m128 leftGains = _mm_set1_ps(leftGain);
+    const __m128 rightGains = _mm_set1_ps(rightGain);
+
+    int i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        __m128 left = _mm_mul_ps(lowInt16ToFloat(_mm_loadl_epi64((const __m128i*)(leftInput + i))), leftGains);
+        __m128 right = _mm_mul_ps(lowInt16ToFloat(_mm_loadl_epi64((const __m128i*)(rightInput + i))), rightGains);
+
+        // interleave back into L R L R order
+        float* out = mix + 2 * i;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(left, right)));
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(left, right)));
+    }
+
+    mixMonoToStereoScalar(mix + 2 * i, leftInput + i, rightInput + i, numFrames - i, leftGain, rightGain);
+}
+
+static void mixSamplesSSE2(float* mix, const int16_t* input, int numSamples, float gain) {
+    const __m128 gains = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i samples = _mm_loadu_si128((const __m128i*)(input + i));
+        _mm_storeu_ps(mix + i, _mm_add_ps(_mm_loadu_ps(mix + i), _mm_mul_ps(lowInt16ToFloat(samples), gains)));
+        _mm_storeu_ps(mix + i + 4, _mm_add_ps(_mm_loadu_ps(mix + i + 4), _mm_mul_ps(highInt16ToFloat(samples), gains)));
+    }
+
+    mixSamplesScalar(mix + i, input + i, numSamples - i, gain);
+}
+
+static void mixMonoToStereoFloatSSE2(float* mix, const float* leftInput, const float* rightInput, int numFrames,
+                                     float leftGain, float rightGain) {
+    const __m128 leftGains = _mm_set1_ps(leftGain);
+    const __m128 rightGains = _mm_set1_ps(rightGain);
+
+    int i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        __m128 left = _mm_mul_ps(_mm_loadu_ps(leftInput + i), leftGains);
+        __m128 right = _mm_mul_ps(_mm_loadu_ps(rightInput + i), rightGains);
+
+        float* out = mix + 2 * i;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(left, right)));
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(left, right)));
+    }
+
+    mixMonoToStereoFloatScalar(mix + 2 * i, leftInput + i, rightInput + i, numFrames - i, leftGain, rightGain);
+}
+
+static void mixSamplesFloatSSE2(float* mix, const float* input, int numSamples, float gain) {
+    const __m128 gains = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(mix + i, _mm_add_ps(_mm_loadu_ps(mix + i), _mm_mul_ps(_mm_loadu_ps(input + i), gains)));
+    }
+
+    mixSamplesFloatScalar(mix + i, input + i, numSamples - i, gain);
+}
+
+static void accumulateSSE2(float* mix, const float* input, int numSamples) {
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        _mm_storeu_ps(mix + i, _mm_add_ps(_mm_loadu_ps(mix + i), _mm_loadu_ps(input + i)));
+    }
+
+    accumulateScalar(mix + i, input + i, numSamples - i);
+}
+
+static void convertToInt16SSE2(int16_t* output, const float* mix, int numSamples) {
+    // clamp before converting, out of range floats convert to INT_MIN and would saturate to the wrong end
+    const __m128 minValues = _mm_set1_ps(MIN_MIX_SAMPLE_VALUE);
+    const __m128 maxValues = _mm_set1_ps(MAX_MIX_SAMPLE_VALUE);
+
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        __m128i low = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(mix + i), minValues), maxValues));
+        __m128i high = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(mix + i + 4), minValues), maxValues));
+        _mm_storeu_si128((__m128i*)(output + i), _mm_packs_epi32(low, high));
+    }
+
+    convertToInt16Scalar(output + i, mix + i, numSamples - i);
+}
+
+static const AudioMixKernels::KernelTable SSE2_KERNELS = {
+    mixMonoToStereoSSE2,
+    mixSamplesSSE2,
+    mixMonoToStereoFloatSSE2,
+    mixSamplesFloatSSE2,
+    accumulateSSE2,
+    convertToInt16SSE2
+};
+
+static bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // the OS has to save the YMM registers for us (OSXSAVE and AVX, then XCR0 bits 1 and 2)
+    __cpuid(info, 1);
+    const int OSXSAVE_AND_AVX = (1 << 27) | (1 << 28);
+    if ((info[2] & OSXSAVE_AND_AVX) != OSXSAVE_AND_AVX || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+#endif // HIFI_MIX_KERNELS_SSE2
+
+static const AudioMixKernels::KernelTable* tableForInstructionSet(AudioMixKernels::InstructionSet instructionSet) {
+    switch (instructionSet) {
+#ifdef HIFI_MIX_KERNELS_SSE2
+        case AudioMixKernels::AVX2:
+            return AudioMixKernels::getAVX2KernelTable();
+        case AudioMixKernels::SSE2:
+            return &SSE2_KERNELS;
+#endif
+        default:
+            return &SCALAR_KERNELS;
+    }
+}
+
+static AudioMixKernels::InstructionSet detectBestInstructionSet() {
+#ifdef HIFI_MIX_KERNELS_SSE2
+    if (AudioMixKernels::getAVX2KernelTable() && cpuSupportsAVX2()) {
+        return AudioMixKernels::AVX2;
+    }
+    return AudioMixKernels::SSE2;
+#else
+    return AudioMixKernels::Scalar;
+#endif
+}
+
+static AudioMixKernels::InstructionSet bestInstructionSet = detectBestInstructionSet();
+static AudioMixKernels::InstructionSet currentInstructionSet = bestInstructionSet;
+static const AudioMixKernels::KernelTable* currentKernels = tableForInstructionSet(bestInstructionSet);
+
+namespace AudioMixKernels {
+
+    void mixMonoToStereo(float* mix, const int16_t* leftInput, const int16_t* rightInput, int numFrames,
+                         float leftGain, float rightGain) {
+        currentKernels->mixMonoToStereo(mix, leftInput, rightInput, numFrames, leftGain, rightGain);
+    }
+
+    void mixSamples(float* mix, const int16_t* input, int numSamples, float gain) {
+        currentKernels->mixSamples(mix, input, numSamples, gain);
+    }
+
+    void mixMonoToStereo(float* mix, const float* leftInput, const float* rightInput, int numFrames,
+                         float leftGain, float rightGain) {
+        currentKernels->mixMonoToStereoFloat(mix, leftInput, rightInput, numFrames, leftGain, rightGain);
+    }
+
+    void mixSamples(float* mix, const float* input, int numSamples, float gain) {
+        currentKernels->mixSamplesFloat(mix, input, numSamples, gain);
+    }
+
+    void accumulate(float* mix, const float* input, int numSamples) {
+        currentKernels->accumulate(mix, input, numSamples);
+    }
+
+    void convertToInt16(int16_t* output, const float* mix, int numSamples) {
+        currentKernels->convertToInt16(output, mix, numSamples);
+    }
+
+    InstructionSet getBestInstructionSet() {
+        return bestInstructionSet;
+    }
+
+    InstructionSet getInstructionSet() {
+        return currentInstructionSet;
+    }
+
+    InstructionSet setInstructionSet(InstructionSet instructionSet) {
+        currentInstructionSet = std::min(instructionSet, bestInstructionSet);
+        currentKernels = tableForInstructionSet(currentInstructionSet);
+        return currentInstructionSet;
+    }
+
+    const char* getInstructionSetName(InstructionSet instructionSet) {
+        switch (instructionSet) {
+            case AVX2:
+                return "AVX2";
+            case SSE2:
+                return "SSE2";
+            default:
+                return "Scalar";
+        }
+    }
+}
@@ -0,0 +1,75 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+// Mixing kernels used by the AudioMixer. Streams are accumulated into float mix buffers from contiguous (unwrapped)
+// int16_t frames, and the finished mix is converted back to int16_t with saturation once.
+// The implementation is picked at runtime from the instruction sets the CPU supports.
+namespace AudioMixKernels {
+
+    enum InstructionSet {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /// adds a mono frame to an interleaved stereo mix. The left and right channels read numFrames samples from their own
+    /// pointers into the same unwrapped frame, so a delayed channel is simply a pointer to earlier (historical) samples
+    void mixMonoToStereo(float* mix, const int16_t* leftInput, const int16_t* rightInput, int numFrames,
+                         float leftGain, float rightGain);
+
+    /// adds numSamples interleaved samples to the mix with a single gain
+    void mixSamples(float* mix, const int16_t* input, int numSamples, float gain);
+
+    /// the same as the above, for frames that were already converted to float, such as the mixer's prepared sources
+    void mixMonoToStereo(float* mix, const float* leftInput, const float* rightInput, int numFrames,
+                         float leftGain, float rightGain);
+    void mixSamples(float* mix, const float* input, int numSamples, float gain);
+
+    /// adds one float buffer to another
+    void accumulate(float* mix, const float* input, int numSamples);
+
+    /// converts a finished mix to int16_t, saturating at the sample limits
+    void convertToInt16(int16_t* output, const float* mix, int numSamples);
+
+    /// the most capable instruction set the CPU supports
+    InstructionSet getBestInstructionSet();
+
+    /// the instruction set the kernels currently dispatch to
+    InstructionSet getInstructionSet();
+
+    /// forces the kernels to a given instruction set, clamped to what the CPU supports. Returns the set in use.
+    InstructionSet setInstructionSet(InstructionSet instructionSet);
+
+    const char* getInstructionSetName(InstructionSet instructionSet);
+
+    // one implementation of every kernel, filled in per instruction set
+    struct KernelTable {
+        void (*mixMonoToStereo)(float*, const int16_t*, const int16_t*, int, float, float);
+        void (*mixSamples)(float*, const int16_t*, int, float);
+        void (*mixMonoToStereoFloat)(float*, const float*, const float*, int, float, float);
+        void (*mixSamplesFloat)(float*, const float*, int, float);
+        void (*accumulate)(float*, const float*, int);
+        void (*convertToInt16)(int16_t*, const float*, int);
+    };
+
+    /// the scalar kernels, which the SIMD kernels also use for the samples left over after their last full vector
+    const KernelTable* getScalarKernelTable();
+
+    /// the AVX2 kernels live in their own translation unit, built with AVX2 code generation where the compiler
+    /// needs it. Returns nullptr when they were not compiled for this target.
+    const KernelTable* getAVX2KernelTable();
+}
+
+#endif // hifi_AudioMixKernels_h
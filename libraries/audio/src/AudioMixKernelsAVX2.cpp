@@ -0,0 +1,151 @@
+//
+//  AudioMixKernelsAVX2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+//  Built with AVX2 code generation (see libraries/audio/CMakeLists.txt). Nothing in here may run before
+//  AudioMixKernels has checked that the CPU supports AVX2.
+//
+
+#include "AudioMixKernels.h"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && defined(_M_X64))
+
+#include <immintrin.h>
+
+static inline __m256 int16ToFloat(const int16_t* input) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)input)));
+}
+
+static void mixMonoToStereoAVX2(float* mix, const int16_t* leftInput, const int16_t* rightInput, int numFrames,
+                                float leftGain, float rightGain) {
+    const __m256 leftGains = _mm256_set1_ps(leftGain);
+    const __m256 rightGains = _mm256_set1_ps(rightGain);
+
+    int i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        __m256 left = _mm256_mul_ps(int16ToFloat(leftInput + i), leftGains);
+        __m256 right = _mm256_mul_ps(int16ToFloat(rightInput + i), rightGains);
+
+        // unpack works within 128 bit lanes, so swap the middle halves to get L R L R order across both outputs
+        __m256 lowPairs = _mm256_unpacklo_ps(left, right);
+        __m256 highPairs = _mm256_unpackhi_ps(left, right);
+
+        float* out = mix + 2 * i;
+        _mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_permute2f128_ps(lowPairs, highPairs, 0x20)));
+        _mm256_storeu_ps(out + 8,
+                         _mm256_add_ps(_mm256_loadu_ps(out + 8), _mm256_permute2f128_ps(lowPairs, highPairs, 0x31)));
+    }
+
+    for (; i < numFrames; ++i) {
+        mix[2 * i] += leftInput[i] * leftGain;
+        mix[2 * i + 1] += rightInput[i] * rightGain;
+    }
+}
+
+static void mixSamplesAVX2(float* mix, const int16_t* input, int numSamples, float gain) {
+    const __m256 gains = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(mix + i, _mm256_add_ps(_mm256_loadu_ps(mix + i), _mm256_mul_ps(int16ToFloat(input + i), gains)));
+    }
+
+    for (; i < numSamples; ++i) {
+        mix[i] += input[i] * gain;
+    }
+}
+
+static void mixMonoToStereoFloatAVX2(float* mix, const float* leftInput, const float* rightInput, int numFrames,
+                                     float leftGain, float rightGain) {
+    const __m256 leftGains = _mm256_set1_ps(leftGain);
+    const __m256 rightGains = _mm256_set1_ps(rightGain);
+
+    int i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        __m256 left = _mm256_mul_ps(_mm256_loadu_ps(leftInput + i), leftGains);
+        __m256 right = _mm256_mul_ps(_mm256_loadu_ps(rightInput + i), rightGains);
+
+        __m256 lowPairs = _mm256_unpacklo_ps(left, right);
+        __m256 highPairs = _mm256_unpackhi_ps(left, right);
+
+        float* out = mix + 2 * i;
+        _mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_permute2f128_ps(lowPairs, highPairs, 0x20)));
+        _mm256_storeu_ps(out + 8,
+                         _mm256_add_ps(_mm256_loadu_ps(out + 8), _mm256_permute2f128_ps(lowPairs, highPairs, 0x31)));
+    }
+
+    for (; i < numFrames; ++i) {
+        mix[2 * i] += leftInput[i] * leftGain;
+        mix[2 * i + 1] += rightInput[i] * rightGain;
+    }
+}
+
+static void mixSamplesFloatAVX2(float* mix, const float* input, int numSamples, float gain) {
+    const __m256 gains = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(mix + i,
+                         _mm256_add_ps(_mm256_loadu_ps(mix + i), _mm256_mul_ps(_mm256_loadu_ps(input + i), gains)));
+    }
+
+    for (; i < numSamples; ++i) {
+        mix[i] += input[i] * gain;
+    }
+}
+
+static void accumulateAVX2(float* mix, const float* input, int numSamples) {
+    int i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_ps(mix + i, _mm256_add_ps(_mm256_loadu_ps(mix + i), _mm256_loadu_ps(input + i)));
+    }
+
+    for (; i < numSamples; ++i) {
+        mix[i] += input[i];
+    }
+}
+
+static void convertToInt16AVX2(int16_t* output, const float* mix, int numSamples) {
+    const __m256 minValues = _mm256_set1_ps(-32768.0f);
+    const __m256 maxValues = _mm256_set1_ps(32767.0f);
+
+    int i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        __m256i low = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(mix + i), minValues), maxValues));
+        __m256i high = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(mix + i + 8), minValues),
+                                                        maxValues));
+
+        // packs works within 128 bit lanes, put the 64 bit quarters back in order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+        _mm256_storeu_si256((__m256i*)(output + i), packed);
+    }
+
+    // the same rounding as the vectors, half to even
+    AudioMixKernels::getScalarKernelTable()->convertToInt16(output + i, mix + i, numSamples - i);
+}
+
+static const AudioMixKernels::KernelTable AVX2_KERNELS = {
+    mixMonoToStereoAVX2,
+    mixSamplesAVX2,
+    mixMonoToStereoFloatAVX2,
+    mixSamplesFloatAVX2,
+    accumulateAVX2,
+    convertToInt16AVX2
+};
+
+const AudioMixKernels::KernelTable* AudioMixKernels::getAVX2KernelTable() {
+    return &AVX2_KERNELS;
+}
+
+#else
+
+const AudioMixKernels::KernelTable* AudioMixKernels::getAVX2KernelTable() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,81 @@
+//
+//  AudioMixerThrottle.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioConstants.h"
+#include "AudioLogging.h"
+
+#include "AudioMixerThrottle.h"
+
+const float LOUDNESS_TO_DISTANCE_RATIO = 0.00001f;
+
+AudioMixerThrottle::AudioMixerThrottle() :
+    _trailingSleepRatio(1.0f),
+    _performanceThrottlingRatio(0.0f),
+    _minAudibilityThreshold(LOUDNESS_TO_DISTANCE_RATIO / 2.0f),
+    _framesSinceCutoffEvent(TRAILING_AVERAGE_FRAMES)
+{
+
+}
+
+bool AudioMixerThrottle::frameStarted(int usecSlept) {
+    const float STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.10f;
+    const float BACK_OFF_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD = 0.20f;
+
+    const float RATIO_BACK_OFF = 0.02f;
+
+    const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_AVERAGE_FRAMES;
+    const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
+
+    if (usecSlept < 0) {
+        usecSlept = 0;
+    }
+
+    _trailingSleepRatio = (PREVIOUS_FRAMES_RATIO * _trailingSleepRatio)
+        + (usecSlept * CURRENT_FRAME_RATIO / (float) AudioConstants::NETWORK_FRAME_USECS);
+
+    float lastCutoffRatio = _performanceThrottlingRatio;
+    bool hasRatioChanged = false;
+
+    if (_framesSinceCutoffEvent >= TRAILING_AVERAGE_FRAMES) {
+        if (_trailingSleepRatio <= STRUGGLE_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD) {
+            // we're struggling - change our min required loudness to reduce some load
+            _performanceThrottlingRatio = _performanceThrottlingRatio + (0.5f * (1.0f - _performanceThrottlingRatio));
+
+            qCDebug(audio) << "Mixer is struggling, sleeping" << _trailingSleepRatio * 100 << "% of frame time. Old cutoff was"
+                << lastCutoffRatio << "and is now" << _performanceThrottlingRatio;
+            hasRatioChanged = true;
+        } else if (_trailingSleepRatio >= BACK_OFF_TRIGGER_SLEEP_PERCENTAGE_THRESHOLD && _performanceThrottlingRatio != 0) {
+            // we've recovered and can back off the required loudness
+            _performanceThrottlingRatio = _performanceThrottlingRatio - RATIO_BACK_OFF;
+
+            if (_performanceThrottlingRatio < 0) {
+                _performanceThrottlingRatio = 0;
+            }
+
+            qCDebug(audio) << "Mixer is recovering, sleeping" << _trailingSleepRatio * 100 << "% of frame time. Old cutoff was"
+                << lastCutoffRatio << "and is now" << _performanceThrottlingRatio;
+            hasRatioChanged = true;
+        }
+
+        if (hasRatioChanged) {
+            // set out min audability threshold from the new ratio
+            _minAudibilityThreshold = LOUDNESS_TO_DISTANCE_RATIO / (2.0f * (1.0f - _performanceThrottlingRatio));
+            qCDebug(audio) << "Minimum audability required to be mixed is now" << _minAudibilityThreshold;
+
+            _framesSinceCutoffEvent = 0;
+        }
+    }
+
+    if (!hasRatioChanged) {
+        ++_framesSinceCutoffEvent;
+    }
+
+    return hasRatioChanged;
+}
@@ -0,0 +1,42 @@
+//
+//  AudioMixerThrottle.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Decides how much the audio mixer sheds load from how much of each frame it has left over
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerThrottle_h
+#define hifi_AudioMixerThrottle_h
+
+/// Tracks the share of each frame the mixer spends sleeping. When that trails off the mixer is struggling, and the
+/// throttling ratio goes up, which raises the loudness over distance a stream needs to be mixed at all. Once the mixer
+/// has recovered the ratio backs off again. The ratio only moves once a trailing average's worth of frames have passed
+/// since it last did.
+class AudioMixerThrottle {
+public:
+    static const int TRAILING_AVERAGE_FRAMES = 100;
+
+    AudioMixerThrottle();
+
+    /// called once a frame with the usecs the mixer slept before it. Returns true if the throttling ratio changed.
+    bool frameStarted(int usecSlept);
+
+    float getTrailingSleepRatio() const { return _trailingSleepRatio; }
+    float getPerformanceThrottlingRatio() const { return _performanceThrottlingRatio; }
+
+    /// the trailing loudness over distance a stream must be above to be mixed
+    float getMinAudibilityThreshold() const { return _minAudibilityThreshold; }
+
+private:
+    float _trailingSleepRatio;
+    float _performanceThrottlingRatio;
+    float _minAudibilityThreshold;
+    int _framesSinceCutoffEvent;
+};
+
+#endif // hifi_AudioMixerThrottle_h
@@ -0,0 +1,571 @@
+//
+//  AudioSpatializer.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+#include <glm/gtx/vector_angle.hpp>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <Trace.h>
+
+#include "AudioLogging.h"
+#include "AudioMixKernels.h"
+#include "InjectedAudioStream.h"
+#include "PositionalAudioStream.h"
+
+#include "AudioSpatializer.h"
+
+// mixes listeners pulled from the spatializer's per-frame queue, each worker owns its own scratch buffer
+class AudioSpatializerWorker : public QRunnable {
+public:
+    AudioSpatializerWorker(AudioSpatializer* spatializer) : _spatializer(spatializer) { setAutoDelete(false); }
+
+    virtual void run() {
+        _spatializer->mixQueuedListeners(_scratch);
+    }
+
+private:
+    AudioSpatializer* _spatializer;
+    AudioMixScratch _scratch;
+};
+
+// runs a worker on the spatializer's thread pool and signals the spatializer once it has drained the queue
+class AudioSpatializerPooledWorker : public AudioSpatializerWorker {
+public:
+    AudioSpatializerPooledWorker(AudioSpatializer* spatializer, QSemaphore& doneSemaphore) :
+        AudioSpatializerWorker(spatializer), _doneSemaphore(doneSemaphore) {}
+
+    virtual void run() {
+        AudioSpatializerWorker::run();
+        _doneSemaphore.release();
+    }
+
+private:
+    QSemaphore& _doneSemaphore;
+};
+
+const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
+const float RADIUS_OF_HEAD = 0.076f;
+
+AudioSpatializer::AudioSpatializer() :
+    _attenuationPerDoublingInDistance(DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE),
+    _enableFilter(true),
+    _repetitionWithFade(false),
+    _minAudibilityThreshold(0.0f),
+    _enableSharedMixes(false),
+    _sharedMixPositionTolerance(DEFAULT_SHARED_MIX_POSITION_TOLERANCE),
+    _sharedMixOrientationTolerance(DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE),
+    _sharedMixNearDistance(DEFAULT_SHARED_MIX_NEAR_DISTANCE)
+{
+    setNumMixThreads(1);
+}
+
+AudioSpatializer::~AudioSpatializer() {
+    _threadPool.waitForDone();
+    qDeleteAll(_workers);
+}
+
+void AudioSpatializer::setSharedMixes(bool enabled, float positionTolerance, float orientationTolerance,
+                                      float nearDistance) {
+    _enableSharedMixes = enabled;
+    _sharedMixPositionTolerance = positionTolerance;
+    _sharedMixOrientationTolerance = orientationTolerance;
+    _sharedMixNearDistance = nearDistance;
+}
+
+void AudioSpatializer::setNumMixThreads(int numMixThreads) {
+    if (numMixThreads <= 0) {
+        numMixThreads = QThread::idealThreadCount();
+    }
+    numMixThreads = std::max(numMixThreads, 1);
+
+    _threadPool.waitForDone();
+    qDeleteAll(_workers);
+    _workers.clear();
+
+    // the first worker always runs on the mixing thread, the rest are handed to the pool each frame
+    _workers.push_back(new AudioSpatializerWorker(this));
+    for (int i = 1; i < numMixThreads; ++i) {
+        _workers.push_back(new AudioSpatializerPooledWorker(this, _workersDone));
+    }
+
+    _threadPool.setMaxThreadCount(std::max(numMixThreads - 1, 1));
+    // keep the pool threads around between frames instead of tearing them down after each mix
+    _threadPool.setExpiryTimeout(-1);
+}
+
+void AudioSpatializer::findZonesSettingsContaining(const glm::vec3& position, bool asSource, QBitArray& inZones) const {
+    inZones.resize(_zonesSettings.size());
+    for (int i = 0; i < _zonesSettings.size(); ++i) {
+        const QString& zone = asSource ? _zonesSettings[i].source : _zonesSettings[i].listener;
+        inZones.setBit(i, _audioZones.value(zone).contains(position));
+    }
+}
+
+void AudioSpatializer::addSource(PositionalAudioStream* stream, const AudioMixListener* owner,
+                                 const QUuid& streamUUID) {
+    // If repetition with fade is enabled:
+    // If the stream could not provide a frame (it was starved), then we'll mix its previously-mixed frame
+    // This is preferable to not mixing it at all since that's equivalent to inserting silence.
+    // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
+    // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
+    // This improves the perceived quality of the audio slightly.
+    float repeatedFrameFadeFactor = 1.0f;
+
+    if (!stream->lastPopSucceeded()) {
+        if (_repetitionWithFade && !stream->getLastPopOutput().isNull()) {
+            // reptition with fade is enabled, and we do have a valid previous frame to repeat.
+            // calculate its fade factor, which depends on how many times it's already been repeated.
+            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(stream->getConsecutiveNotMixedCount() - 1);
+            if (repeatedFrameFadeFactor == 0.0f) {
+                return;
+            }
+        } else {
+            return;
+        }
+    }
+
+    // at this point, we know the stream's last pop output is valid
+
+    // if the frame we're about to mix is silent, no listener will hear it
+    if (stream->getLastPopOutputLoudness() == 0.0f) {
+        return;
+    }
+
+    _sources.resize(_sources.size() + 1);
+    AudioMixSource& source = _sources.back();
+    source.stream = stream;
+    source.owner = owner;
+    source.streamUUID = streamUUID;
+    findZonesSettingsContaining(stream->getPosition(), true, source.inSourceZones);
+
+    // the fade and an injector's own attenuation are the same for every listener, so they go into the samples
+    float sourceGain = repeatedFrameFadeFactor;
+    if (stream->getType() == PositionalAudioStream::Injector) {
+        sourceGain *= reinterpret_cast<InjectedAudioStream*>(stream)->getAttenuationRatio();
+    }
+
+    int16_t streamSamples[SAMPLE_PHASE_DELAY_AT_90 + AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    AudioRingBuffer::ConstIterator streamPopOutput = stream->getLastPopOutput();
+    if (!stream->isStereo()) {
+        // a mono stream is phase delayed per listener, so the historical samples before the frame come along
+        // TODO: the historical samples may be inside the last frame written if the ringbuffer is completely full
+        // maybe make AudioRingBuffer have 1 extra frame in its buffer
+        int numSamples = SAMPLE_PHASE_DELAY_AT_90 + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        (streamPopOutput - SAMPLE_PHASE_DELAY_AT_90).readSamples(streamSamples, numSamples);
+        memset(source.samples, 0, numSamples * sizeof(float));
+        AudioMixKernels::mixSamples(source.samples, streamSamples, numSamples, sourceGain);
+    } else {
+        int numSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+        streamPopOutput.readSamples(streamSamples, numSamples);
+        float* frame = source.samples + SAMPLE_PHASE_DELAY_AT_90;
+        memset(frame, 0, numSamples * sizeof(float));
+        AudioMixKernels::mixSamples(frame, streamSamples, numSamples, sourceGain);
+    }
+}
+
+int AudioSpatializer::addSourceToMix(AudioMixListener& listener, const AudioMixSource& source,
+                                     AudioMixScratch& scratch) const {
+    // whether the stream has a frame to mix, its fade and its silence were settled when the source was added
+
+    bool showDebug = false;  // (randFloat() < 0.05f);
+
+    PositionalAudioStream* streamToAdd = source.stream;
+    PositionalAudioStream* listeningStream = listener.getListenerStream();
+
+    float bearingRelativeAngleToSource = 0.0f;
+    float attenuationCoefficient = 1.0f;
+    int numSamplesDelay = 0;
+    float weakChannelAmplitudeRatio = 1.0f;
+
+    //  Is the source that I am mixing my own?
+    bool sourceIsSelf = (streamToAdd == listeningStream);
+
+    glm::vec3 relativePosition = streamToAdd->getPosition() - listeningStream->getPosition();
+
+    float distanceBetween = glm::length(relativePosition);
+
+    if (distanceBetween < EPSILON) {
+        distanceBetween = EPSILON;
+    }
+
+    if (streamToAdd->getLastPopOutputTrailingLoudness() / distanceBetween <= _minAudibilityThreshold) {
+        // according to mixer performance we have decided this does not get to be mixed in
+        // bail out
+        return 0;
+    }
+
+    if (showDebug) {
+        qCDebug(audio) << "distance: " << distanceBetween;
+    }
+
+    glm::quat inverseOrientation = glm::inverse(listeningStream->getOrientation());
+
+    if (!sourceIsSelf && (streamToAdd->getType() == PositionalAudioStream::Microphone)) {
+        //  source is another avatar, apply fixed off-axis attenuation to make them quieter as they turn away from listener
+        glm::vec3 rotatedListenerPosition = glm::inverse(streamToAdd->getOrientation()) * relativePosition;
+
+        float angleOfDelivery = glm::angle(glm::vec3(0.0f, 0.0f, -1.0f),
+                                           glm::normalize(rotatedListenerPosition));
+
+        const float MAX_OFF_AXIS_ATTENUATION = 0.2f;
+        const float OFF_AXIS_ATTENUATION_FORMULA_STEP = (1 - MAX_OFF_AXIS_ATTENUATION) / 2.0f;
+
+        float offAxisCoefficient = MAX_OFF_AXIS_ATTENUATION +
+                                    (OFF_AXIS_ATTENUATION_FORMULA_STEP * (angleOfDelivery / PI_OVER_TWO));
+
+        if (showDebug) {
+            qCDebug(audio) << "angleOfDelivery" << angleOfDelivery << "offAxisCoefficient: " << offAxisCoefficient;
+
+        }
+        // multiply the current attenuation coefficient by the calculated off axis coefficient
+
+        attenuationCoefficient *= offAxisCoefficient;
+    }
+
+    float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
+    for (int i = 0; i < _zonesSettings.length(); ++i) {
+        if (source.inSourceZones.testBit(i) && scratch.inListenerZones.testBit(i)) {
+            attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
+            break;
+        }
+    }
+
+    if (distanceBetween >= ATTENUATION_BEGINS_AT_DISTANCE) {
+        // calculate the distance coefficient using the distance to this node
+        float distanceCoefficient = 1 - (logf(distanceBetween / ATTENUATION_BEGINS_AT_DISTANCE) / logf(2.0f)
+                                         * attenuationPerDoublingInDistance);
+
+        if (distanceCoefficient < 0) {
+            distanceCoefficient = 0;
+        }
+
+        // multiply the current attenuation coefficient by the distance coefficient
+        attenuationCoefficient *= distanceCoefficient;
+        if (showDebug) {
+            qCDebug(audio) << "distanceCoefficient: " << distanceCoefficient;
+        }
+    }
+
+    if (!sourceIsSelf) {
+        //  Compute sample delay for the two ears to create phase panning
+        glm::vec3 rotatedSourcePosition = inverseOrientation * relativePosition;
+
+        // project the rotated source position vector onto the XZ plane
+        rotatedSourcePosition.y = 0.0f;
+
+        // produce an oriented angle about the y-axis
+        bearingRelativeAngleToSource = glm::orientedAngle(glm::vec3(0.0f, 0.0f, -1.0f),
+                                                          glm::normalize(rotatedSourcePosition),
+                                                          glm::vec3(0.0f, 1.0f, 0.0f));
+
+        const float PHASE_AMPLITUDE_RATIO_AT_90 = 0.5;
+
+        // figure out the number of samples of delay and the ratio of the amplitude
+        // in the weak channel for audio spatialization
+        float sinRatio = fabsf(sinf(bearingRelativeAngleToSource));
+        numSamplesDelay = SAMPLE_PHASE_DELAY_AT_90 * sinRatio;
+        weakChannelAmplitudeRatio = 1 - (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio);
+
+        if (distanceBetween < RADIUS_OF_HEAD) {
+            // Diminish phase panning if source would be inside head
+            numSamplesDelay *= distanceBetween / RADIUS_OF_HEAD;
+            weakChannelAmplitudeRatio += (PHASE_AMPLITUDE_RATIO_AT_90 * sinRatio) * distanceBetween / RADIUS_OF_HEAD;
+        }
+    }
+
+    if (showDebug) {
+        qCDebug(audio) << "attenuation: " << attenuationCoefficient;
+        qCDebug(audio) << "bearingRelativeAngleToSource: " << bearingRelativeAngleToSource
+                       << " numSamplesDelay: " << numSamplesDelay;
+    }
+
+    // streams that get the penumbra filter are spatialized into the pre-mix first, everything else goes straight
+    // into the listener's mix
+    bool applyPenumbraFilter = !sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter();
+    float* streamMixSamples = applyPenumbraFilter ? scratch.preMixSamples : scratch.mixSamples;
+
+    if (applyPenumbraFilter) {
+        memset(scratch.preMixSamples, 0, sizeof(scratch.preMixSamples));
+    }
+
+    // the fade is already in the prepared samples
+    const float* frameStart = source.getFrame();
+
+    if (!streamToAdd->isStereo()) {
+        // this is a mono stream, which means it gets full attenuation and spatialization
+
+        // we need to do several things in this process:
+        //    1) convert from mono to stereo by copying each input sample into the left and right output samples
+        //    2) apply an attenuation to all samples (left and right)
+        //    3) based on the bearing relative angle to the source we will weaken and delay either the left or
+        //       right channel of the input into the output
+        //    4) because one of these channels is delayed, we will need to use historical samples from
+        //       the input stream for that delayed channel, which were prepared along with the frame
+
+        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2;
+
+        // determine which side is weak and delayed (item 3 above)
+        bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
+
+        // the weak/delayed channel will be attenuated by this additional amount
+        float attenuationAndWeakChannelRatio = attenuationCoefficient * weakChannelAmplitudeRatio;
+
+        // the delayed channel starts numSamplesDelay samples back into the history (items 1, 3 and 4 above)
+        const float* delayedSamples = frameStart - numSamplesDelay;
+
+        if (rightSideWeakAndDelayed) {
+            AudioMixKernels::mixMonoToStereo(streamMixSamples, frameStart, delayedSamples, inputSampleCount,
+                                             attenuationCoefficient, attenuationAndWeakChannelRatio);
+        } else {
+            AudioMixKernels::mixMonoToStereo(streamMixSamples, delayedSamples, frameStart, inputSampleCount,
+                                             attenuationAndWeakChannelRatio, attenuationCoefficient);
+        }
+    } else {
+        AudioMixKernels::mixSamples(streamMixSamples, frameStart, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                    attenuationCoefficient);
+    }
+
+    if (applyPenumbraFilter) {
+
+        const float TWO_OVER_PI = 2.0f / PI;
+
+        const float ZERO_DB = 1.0f;
+        const float NEGATIVE_ONE_DB = 0.891f;
+        const float NEGATIVE_THREE_DB = 0.708f;
+
+        const float FILTER_GAIN_AT_0 = ZERO_DB; // source is in front
+        const float FILTER_GAIN_AT_90 = NEGATIVE_ONE_DB; // source is incident to left or right ear
+        const float FILTER_GAIN_AT_180 = NEGATIVE_THREE_DB; // source is behind
+
+        const float FILTER_CUTOFF_FREQUENCY_HZ = 1000.0f;
+
+        const float penumbraFilterFrequency = FILTER_CUTOFF_FREQUENCY_HZ; // constant frequency
+        const float penumbraFilterSlope = NEGATIVE_THREE_DB; // constant slope
+
+        float penumbraFilterGainL;
+        float penumbraFilterGainR;
+
+        // variable gain calculation broken down by quadrant
+        if (-bearingRelativeAngleToSource < -PI_OVER_TWO && -bearingRelativeAngleToSource > -PI) {
+            penumbraFilterGainL = TWO_OVER_PI *
+                (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_180) * (-bearingRelativeAngleToSource + PI_OVER_TWO) + FILTER_GAIN_AT_0;
+            penumbraFilterGainR = TWO_OVER_PI *
+                (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_180) * (-bearingRelativeAngleToSource + PI_OVER_TWO) + FILTER_GAIN_AT_90;
+        } else if (-bearingRelativeAngleToSource <= PI && -bearingRelativeAngleToSource > PI_OVER_TWO) {
+            penumbraFilterGainL = TWO_OVER_PI *
+                (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_90) * (-bearingRelativeAngleToSource - PI) + FILTER_GAIN_AT_180;
+            penumbraFilterGainR = TWO_OVER_PI *
+                (FILTER_GAIN_AT_180 - FILTER_GAIN_AT_0) * (-bearingRelativeAngleToSource - PI) + FILTER_GAIN_AT_180;
+        } else if (-bearingRelativeAngleToSource <= PI_OVER_TWO && -bearingRelativeAngleToSource > 0) {
+            penumbraFilterGainL = TWO_OVER_PI *
+                (FILTER_GAIN_AT_90 - FILTER_GAIN_AT_0) * (-bearingRelativeAngleToSource - PI_OVER_TWO) + FILTER_GAIN_AT_90;
+            penumbraFilterGainR = FILTER_GAIN_AT_0;
+        } else {
+            penumbraFilterGainL = FILTER_GAIN_AT_0;
+            penumbraFilterGainR =  TWO_OVER_PI *
+                (FILTER_GAIN_AT_0 - FILTER_GAIN_AT_90) * (-bearingRelativeAngleToSource) + FILTER_GAIN_AT_0;
+        }
+
+        if (distanceBetween < RADIUS_OF_HEAD) {
+            // Diminish effect if source would be inside head
+            penumbraFilterGainL += (1.0f - penumbraFilterGainL) * (1.0f - distanceBetween / RADIUS_OF_HEAD);
+            penumbraFilterGainR += (1.0f - penumbraFilterGainR) * (1.0f - distanceBetween / RADIUS_OF_HEAD);
+        }
+
+        bool wantDebug = false;
+        if (wantDebug) {
+            qCDebug(audio) << "gainL=" << penumbraFilterGainL
+                           << "gainR=" << penumbraFilterGainR
+                           << "angle=" << -bearingRelativeAngleToSource;
+        }
+
+        // Get our per listener/source data so we can get our filter
+        AudioFilterHSF1s& penumbraFilter = listener.getListenerSourcePairData(source.streamUUID)->getPenumbraFilter();
+
+        // set the gain on both filter channels
+        penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
+        penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
+        penumbraFilter.render(scratch.preMixSamples, scratch.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
+
+        // Actually mix the filtered preMixSamples into the listener's mix here.
+        AudioMixKernels::accumulate(scratch.mixSamples, scratch.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+    }
+
+    return 1;
+}
+
+void AudioSpatializer::mixListener(AudioMixListener& listener, AudioMixScratch& scratch, bool baseMix) {
+    TRACE_SCOPE("AudioSpatializer::mixListener");
+    PositionalAudioStream* listeningStream = listener.getListenerStream();
+
+    // start the mix for this listener from silence, or from its group's base mix
+    int streamsMixed = 0;
+    if (baseMix) {
+        memcpy(scratch.mixSamples, scratch.baseMixSamples, sizeof(scratch.mixSamples));
+        streamsMixed = scratch.baseStreamsMixed;
+    } else {
+        memset(scratch.mixSamples, 0, sizeof(scratch.mixSamples));
+    }
+
+    // zones are resolved once per listener, the sources resolved theirs as they were added
+    findZonesSettingsContaining(listeningStream->getPosition(), false, scratch.inListenerZones);
+
+    // loop through all the sources prepared for this frame
+    for (int i = 0; i < (int)_sources.size(); ++i) {
+        const AudioMixSource& source = _sources[i];
+        if (baseMix && scratch.inBaseMix.testBit(i)) {
+            continue;
+        }
+        if (source.owner != &listener || source.stream->shouldLoopbackForNode()) {
+            streamsMixed += addSourceToMix(listener, source, scratch);
+        }
+    }
+
+    if (streamsMixed > 0) {
+        // saturate the float mix back down to 16 bit samples once, now that every stream is in it
+        AudioMixKernels::convertToInt16(listener.getMixSamples(), scratch.mixSamples,
+                                        AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+    }
+
+    listener.mixFinished(streamsMixed);
+}
+
+void AudioSpatializer::mixListenerGroup(const AudioListenerGroup& group, AudioMixScratch& scratch) {
+    if (group.listeners.size() == 1) {
+        mixListener(*group.listeners[0], scratch, false);
+        return;
+    }
+
+    TRACE_SCOPE("AudioSpatializer::mixListenerGroup");
+
+    // the base mix is every source far enough from the group that its members would hear it nearly the same,
+    // spatialized for the first member
+    AudioMixListener& firstListener = *group.listeners[0];
+    PositionalAudioStream* firstStream = firstListener.getListenerStream();
+
+    memset(scratch.mixSamples, 0, sizeof(scratch.mixSamples));
+    scratch.baseStreamsMixed = 0;
+    scratch.inBaseMix.fill(false, (int)_sources.size());
+    findZonesSettingsContaining(firstStream->getPosition(), false, scratch.inListenerZones);
+
+    for (int i = 0; i < (int)_sources.size(); ++i) {
+        const AudioMixSource& source = _sources[i];
+        if (!group.listeners.contains(const_cast<AudioMixListener*>(source.owner))
+            && glm::distance(source.stream->getPosition(), firstStream->getPosition()) >= _sharedMixNearDistance) {
+            scratch.inBaseMix.setBit(i);
+            scratch.baseStreamsMixed += addSourceToMix(firstListener, source, scratch);
+        }
+    }
+    memcpy(scratch.baseMixSamples, scratch.mixSamples, sizeof(scratch.baseMixSamples));
+
+    // each member adds the sources near the group, and those of the group's own listeners, to the base mix
+    foreach (AudioMixListener* listener, group.listeners) {
+        mixListener(*listener, scratch, true);
+    }
+}
+
+void AudioSpatializer::mixQueuedListeners(AudioMixScratch& scratch) {
+    int index;
+    if (_enableSharedMixes) {
+        while ((index = _nextListenerIndex.fetchAndAddOrdered(1)) < _listenerGroups.size()) {
+            mixListenerGroup(_listenerGroups[index], scratch);
+        }
+    } else {
+        while ((index = _nextListenerIndex.fetchAndAddOrdered(1)) < _listeners.size()) {
+            mixListener(*_listeners[index], scratch, false);
+        }
+    }
+}
+
+void AudioSpatializer::groupListeners() {
+    TRACE_SCOPE("AudioSpatializer::groupListeners");
+    _listenerGroups.clear();
+
+    // two orientations are within the tolerance when the rotation between them is, and |dot| is the cosine of half of it
+    const float minOrientationDot = cosf(glm::radians(_sharedMixOrientationTolerance) / 2.0f);
+
+    QVector<QBitArray> groupZones;
+    QBitArray listenerZones;
+
+    foreach (AudioMixListener* listener, _listeners) {
+        PositionalAudioStream* stream = listener->getListenerStream();
+
+        // the zone coefficients are looked up for the group's first listener, so a group never spans zones
+        findZonesSettingsContaining(stream->getPosition(), false, listenerZones);
+
+        int groupIndex = 0;
+        for (; groupIndex < _listenerGroups.size(); ++groupIndex) {
+            PositionalAudioStream* firstStream = _listenerGroups[groupIndex].listeners[0]->getListenerStream();
+
+            if (glm::distance(stream->getPosition(), firstStream->getPosition()) <= _sharedMixPositionTolerance
+                && fabsf(glm::dot(stream->getOrientation(), firstStream->getOrientation())) >= minOrientationDot
+                && groupZones[groupIndex] == listenerZones) {
+                break;
+            }
+        }
+
+        if (groupIndex == _listenerGroups.size()) {
+            _listenerGroups.push_back(AudioListenerGroup());
+            groupZones.push_back(listenerZones);
+        }
+
+        _listenerGroups[groupIndex].listeners.push_back(listener);
+    }
+}
+
+int AudioSpatializer::getFrameSharedMixCount() const {
+    int sharedMixes = 0;
+    foreach (const AudioListenerGroup& group, _listenerGroups) {
+        if (group.listeners.size() > 1) {
+            sharedMixes += group.listeners.size();
+        }
+    }
+    return sharedMixes;
+}
+
+void AudioSpatializer::mixFrame() {
+    TRACE_SCOPE("AudioSpatializer::mixFrame");
+    if (_enableSharedMixes) {
+        groupListeners();
+    }
+
+    _nextListenerIndex.store(0);
+
+    // don't wake up more pooled workers than there are listeners, or groups of them, for them to take
+    int numQueued = _enableSharedMixes ? _listenerGroups.size() : _listeners.size();
+    int numPooledWorkers = std::min(_workers.size(), numQueued) - 1;
+
+    for (int i = 1; i <= numPooledWorkers; ++i) {
+        _threadPool.start(_workers[i]);
+    }
+
+    // the calling thread works through the queue alongside the pool, then waits for the stragglers
+    _workers[0]->run();
+
+    if (numPooledWorkers > 0) {
+        _workersDone.acquire(numPooledWorkers);
+    }
+}
+
+void AudioSpatializer::endFrame() {
+    _sources.clear();
+    _listeners.clear();
+    _listenerGroups.clear();
+}
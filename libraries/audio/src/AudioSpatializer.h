@@ -0,0 +1,212 @@
+//
+//  AudioSpatializer.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Mixes the positional streams of a frame for each listener, spread across a pool of mix workers
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSpatializer_h
+#define hifi_AudioSpatializer_h
+
+#include <vector>
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QBitArray>
+#include <QtCore/QHash>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include <AABox.h>
+
+#include "AudioConstants.h"
+#include "AudioFormat.h" // For AudioFilterHSF1s and _penumbraFilter
+#include "AudioBuffer.h" // For AudioFilterHSF1s and _penumbraFilter
+#include "AudioFilter.h" // For AudioFilterHSF1s and _penumbraFilter
+#include "AudioFilterBank.h" // For AudioFilterHSF1s and _penumbraFilter
+
+class AudioSpatializerWorker;
+class PositionalAudioStream;
+
+const int SAMPLE_PHASE_DELAY_AT_90 = 20;
+
+const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
+const float DEFAULT_SHARED_MIX_POSITION_TOLERANCE = 0.5f;
+const float DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE = 15.0f;
+const float DEFAULT_SHARED_MIX_NEAR_DISTANCE = 5.0f;
+
+class PerListenerSourcePairData {
+public:
+    PerListenerSourcePairData() {
+        _penumbraFilter.initialize(AudioConstants::SAMPLE_RATE, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
+    };
+    AudioFilterHSF1s& getPenumbraFilter() { return _penumbraFilter; }
+
+private:
+    AudioFilterHSF1s _penumbraFilter;
+};
+
+/// what the spatializer needs of a listener, whose owner keeps it from frame to frame
+class AudioMixListener {
+public:
+    virtual ~AudioMixListener() { }
+
+    /// the listener's own stream, the listener hears from its position and orientation
+    virtual PositionalAudioStream* getListenerStream() const = 0;
+
+    virtual PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID) = 0;
+
+    /// the listener's mix in the current frame, written by whichever mix worker picked it up
+    virtual int16_t* getMixSamples() = 0;
+
+    /// called on the mix worker that mixed the listener, once its mix samples hold streamsMixed streams
+    virtual void mixFinished(int streamsMixed) = 0;
+};
+
+// a stream with audio to mix this frame, prepared once and then read by every listener's mix
+struct AudioMixSource {
+    PositionalAudioStream* stream;
+    const AudioMixListener* owner; // the listener the stream belongs to, if any
+    QUuid streamUUID; // the key of the source in each listener's per source data
+
+    // bit i is set when the stream is in the source zone of the i-th zone settings
+    QBitArray inSourceZones;
+
+    // the popped frame, unwrapped from its ring buffer and scaled by the gains that do not depend on the listener,
+    // preceded by the historical samples a phase delay can reach back to
+    float samples[SAMPLE_PHASE_DELAY_AT_90 + AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    const float* getFrame() const { return samples + SAMPLE_PHASE_DELAY_AT_90; }
+};
+
+// co-located listeners that share a base mix of their distant sources, which is computed for the first of them
+struct AudioListenerGroup {
+    QVector<AudioMixListener*> listeners; // the streams of the group's own listeners are never shared, however far away
+};
+
+// scratch space owned by each mix worker, so that listeners can be mixed concurrently
+struct AudioMixScratch {
+    // bit i is set when the listener is in the listener zone of the i-th zone settings
+    QBitArray inListenerZones;
+
+    // bit i is set when the i-th prepared source is in the base mix of the listener group being mixed
+    QBitArray inBaseMix;
+    float baseMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int baseStreamsMixed;
+
+    // used on a per stream basis to run the filter on before mixing
+    float preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    // the listener's mix, converted to 16 bit with saturation once every stream has been added
+    float mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+};
+
+/// Mixes a frame of positional streams for every listener. Each frame the streams with audio are added as sources,
+/// which prepares them once for every listener, and the listeners are added. mixFrame() then spatializes the sources
+/// for each listener, distance attenuated, phase panned and filtered, across the mix workers.
+///
+/// The streams must not change from addSource() until endFrame(). The settings must not change during a frame.
+class AudioSpatializer {
+public:
+    struct ZonesSettings {
+        QString source;
+        QString listener;
+        float coefficient;
+    };
+
+    AudioSpatializer();
+    ~AudioSpatializer();
+
+    void setAttenuationPerDoublingInDistance(float attenuation) { _attenuationPerDoublingInDistance = attenuation; }
+    float getAttenuationPerDoublingInDistance() const { return _attenuationPerDoublingInDistance; }
+
+    void setEnableFilter(bool enableFilter) { _enableFilter = enableFilter; }
+    bool getEnableFilter() const { return _enableFilter; }
+
+    /// a source whose stream starved is mixed from its last frame, faded out over the frames it keeps starving
+    void setRepetitionWithFade(bool repetitionWithFade) { _repetitionWithFade = repetitionWithFade; }
+
+    /// a source in the source zone and a listener in the listener zone of zone settings are attenuated by their
+    /// coefficient, the first of the settings that match wins
+    void setAudioZones(const QHash<QString, AABox>& audioZones) { _audioZones = audioZones; }
+    void addZonesSettings(const ZonesSettings& settings) { _zonesSettings.push_back(settings); }
+
+    /// listeners within positionTolerance and orientationTolerance degrees of each other share a mix of the sources at
+    /// least nearDistance away from them
+    void setSharedMixes(bool enabled, float positionTolerance, float orientationTolerance, float nearDistance);
+    bool getSharedMixesEnabled() const { return _enableSharedMixes; }
+
+    /// the number of threads listeners are mixed on, the calling thread included. 0 or less for one per core.
+    void setNumMixThreads(int numMixThreads);
+    int getNumMixThreads() const { return _workers.size(); }
+
+    /// sources quieter than this over their distance to a listener are left out of its mix, set every frame
+    void setMinAudibilityThreshold(float minAudibilityThreshold) { _minAudibilityThreshold = minAudibilityThreshold; }
+
+    /// prepares the stream's popped frame to be mixed, unless no listener would hear it
+    void addSource(PositionalAudioStream* stream, const AudioMixListener* owner, const QUuid& streamUUID);
+    void addListener(AudioMixListener* listener) { _listeners.push_back(listener); }
+
+    /// mixes every listener added this frame, mixFinished() is called for each of them before this returns
+    void mixFrame();
+
+    /// forgets the sources and listeners of this frame
+    void endFrame();
+
+    int getFrameSourceCount() const { return (int)_sources.size(); }
+    int getFrameListenerGroupCount() const { return _listenerGroups.size(); }
+    int getFrameSharedMixCount() const; // listeners mixed from the base mix of a group of more than one
+
+private:
+    friend class AudioSpatializerWorker;
+
+    /// sets bit i when position is in the given zone of the i-th zone settings
+    void findZonesSettingsContaining(const glm::vec3& position, bool asSource, QBitArray& inZones) const;
+
+    /// adds one prepared source to the float mix in scratch for a listener, returns 1 if it was mixed
+    int addSourceToMix(AudioMixListener& listener, const AudioMixSource& source, AudioMixScratch& scratch) const;
+
+    /// mixes one listener into its mix samples using the worker's scratch space. If baseMix is set, the mix starts
+    /// from the base mix of the listener's group in scratch, and only adds the sources left out of it
+    void mixListener(AudioMixListener& listener, AudioMixScratch& scratch, bool baseMix);
+
+    /// mixes every listener of a group, sharing the base mix of their distant sources between them
+    void mixListenerGroup(const AudioListenerGroup& group, AudioMixScratch& scratch);
+
+    /// pulls listeners, or listener groups when mixes are shared, off the shared queue and mixes them until the queue
+    /// is empty
+    void mixQueuedListeners(AudioMixScratch& scratch);
+
+    /// gathers the listeners of this frame into groups that can share a mix
+    void groupListeners();
+
+    float _attenuationPerDoublingInDistance;
+    bool _enableFilter;
+    bool _repetitionWithFade;
+    float _minAudibilityThreshold;
+
+    QHash<QString, AABox> _audioZones;
+    QVector<ZonesSettings> _zonesSettings;
+
+    bool _enableSharedMixes;
+    float _sharedMixPositionTolerance;
+    float _sharedMixOrientationTolerance; // in degrees
+    float _sharedMixNearDistance;
+
+    std::vector<AudioMixSource> _sources; // cleared each frame, but keeps its capacity
+    QVector<AudioMixListener*> _listeners;
+    QVector<AudioListenerGroup> _listenerGroups;
+    QAtomicInt _nextListenerIndex;
+
+    QThreadPool _threadPool;
+    QVector<AudioSpatializerWorker*> _workers;
+    QSemaphore _workersDone;
+};
+
+#endif // hifi_AudioSpatializer_h
@@ -32,6 +32,9 @@ public:
         _consecutiveNotMixedCount(0),
         _overflowCount(0),
         _framesDropped(0),
+        _codec(0),
+        _codedBytes(0),
+        _decodedBytes(0),
         _packetStreamStats(),
         _packetStreamWindowStats()
     {}
@@ -54,6 +57,13 @@ public:
     quint32 _overflowCount;
     quint32 _framesDropped;
 
+    // the AudioCodec::Type of the last audio received, and how many bytes of audio data were received and decoded to
+    quint8 _codec;
+    quint64 _codedBytes;
+    quint64 _decodedBytes;
+
+    float getCompressionRatio() const { return _codedBytes == 0 ? 1.0f : (float)_decodedBytes / (float)_codedBytes; }
+
     PacketStreamStats _packetStreamStats;
     PacketStreamStats _packetStreamWindowStats;
 };
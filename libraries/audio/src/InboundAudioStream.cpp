@@ -47,6 +47,11 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _currentJitterBufferFrames(0),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _repetitionWithFade(settings._repetitionWithFade),
+    _clock([] { return usecTimestampNow(); }),
+    _incomingCodec(AudioCodec::create(AudioCodec::PCM)),
+    _incomingCodecChannels(1),
+    _codedBytesReceived(0),
+    _decodedBytesReceived(0),
     _hasReverb(false)
 {
 }
@@ -77,6 +82,8 @@ void InboundAudioStream::resetStats() {
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
+    _codedBytesReceived = 0;
+    _decodedBytesReceived = 0;
 }
 
 void InboundAudioStream::clearBuffer() {
@@ -131,7 +138,8 @@ int InboundAudioStream::parseData(NLPacket& packet) {
             if (packet.getType() == PacketType::SilentAudioFrame) {
                 writeDroppableSilentSamples(networkSamples);
             } else {
-                parseAudioData(packet.getType(), packet.read(packet.bytesLeftToRead()), networkSamples);
+                parseAudioData(packet.getType(), decodeAudioData(packet.read(packet.bytesLeftToRead()), networkSamples),
+                               networkSamples);
             }
             break;
         }
@@ -171,10 +179,40 @@ int InboundAudioStream::parseStreamProperties(PacketType::Value type, const QByt
         numAudioSamples = numSilentSamples;
         return sizeof(quint16);
     } else {
-        // mixed audio packets do not have any info between the seq num and the audio data.
-        numAudioSamples = packetAfterSeqNum.size() / sizeof(int16_t);
-        return 0;
+        // mixed audio packets carry the codec of the stereo mix between the seq num and the audio data.
+        const int MIXED_AUDIO_CHANNELS = 2;
+        if (packetAfterSeqNum.isEmpty() || !setIncomingCodec(packetAfterSeqNum.at(0), MIXED_AUDIO_CHANNELS)) {
+            numAudioSamples = 0;
+            return packetAfterSeqNum.size();
+        }
+        numAudioSamples = _incomingCodec->getDecodedSamples(packetAfterSeqNum.size() - sizeof(quint8), MIXED_AUDIO_CHANNELS);
+        return sizeof(quint8);
+    }
+}
+
+bool InboundAudioStream::setIncomingCodec(quint8 codecType, int numChannels) {
+    if (codecType != _incomingCodec->getType()) {
+        std::unique_ptr<AudioCodec> codec = AudioCodec::create(codecType);
+        if (!codec) {
+            return false;
+        }
+        _incomingCodec = std::move(codec);
     }
+    _incomingCodecChannels = numChannels;
+    return true;
+}
+
+QByteArray InboundAudioStream::decodeAudioData(const QByteArray& audioData, int networkSamples) {
+    _codedBytesReceived += audioData.size();
+    _decodedBytesReceived += networkSamples * sizeof(int16_t);
+
+    if (_incomingCodec->getType() == AudioCodec::PCM) {
+        return audioData;
+    }
+    QByteArray decodedData(networkSamples * sizeof(int16_t), 0);
+    _incomingCodec->decode(audioData.constData(), audioData.size(), _incomingCodecChannels,
+                           reinterpret_cast<int16_t*>(decodedData.data()));
+    return decodedData;
 }
 
 int InboundAudioStream::parseAudioData(PacketType::Value type, const QByteArray& packetAfterStreamProperties, int numAudioSamples) {
@@ -276,10 +314,11 @@ void InboundAudioStream::popSamplesNoCheck(int samples) {
 }
 
 void InboundAudioStream::framesAvailableChanged() {
-    _framesAvailableStat.updateWithSample(_ringBuffer.framesAvailable());
+    quint64 now = _clock();
+    _framesAvailableStat.updateWithSample(_ringBuffer.framesAvailable(), now);
 
-    if (_framesAvailableStat.getElapsedUsecs() >= FRAMES_AVAILABLE_STAT_WINDOW_USECS) {
-        _currentJitterBufferFrames = (int)ceil(_framesAvailableStat.getAverage());
+    if (_framesAvailableStat.getElapsedUsecs(now) >= FRAMES_AVAILABLE_STAT_WINDOW_USECS) {
+        _currentJitterBufferFrames = (int)ceil(_framesAvailableStat.getAverage(now));
         _framesAvailableStat.reset();
     }
 }
@@ -292,7 +331,7 @@ void InboundAudioStream::setToStarved() {
     _isStarved = (_ringBuffer.framesAvailable() < _desiredJitterBufferFrames);
 
     // record the time of this starve in the starve history
-    quint64 now = usecTimestampNow();
+    quint64 now = _clock();
     _starveHistory.insert(now);
 
     if (_dynamicJitterBuffers) {
@@ -383,7 +422,7 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
     // update our timegap stats and desired jitter buffer frames if necessary
     // discard the first few packets we receive since they usually have gaps that aren't represensative of normal jitter
     const quint32 NUM_INITIAL_PACKETS_DISCARD = 3;
-    quint64 now = usecTimestampNow();
+    quint64 now = _clock();
     if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD) {
         quint64 gap = now - _lastPacketReceivedTime;
         _timeGapStatsForStatsPacket.update(gap);
@@ -462,13 +501,17 @@ AudioStreamStats InboundAudioStream::getAudioStreamStats() const {
     streamStats._timeGapWindowAverage = _timeGapStatsForStatsPacket.getWindowAverage();
 
     streamStats._framesAvailable = _ringBuffer.framesAvailable();
-    streamStats._framesAvailableAverage = _framesAvailableStat.getAverage();
+    streamStats._framesAvailableAverage = _framesAvailableStat.getAverage(_clock());
     streamStats._desiredJitterBufferFrames = _desiredJitterBufferFrames;
     streamStats._starveCount = _starveCount;
     streamStats._consecutiveNotMixedCount = _consecutiveNotMixedCount;
     streamStats._overflowCount = _ringBuffer.getOverflowCount();
     streamStats._framesDropped = _silentFramesDropped + _oldFramesDropped;    // TODO: add separate stat for old frames dropped
 
+    streamStats._codec = getIncomingCodecType();
+    streamStats._codedBytes = _codedBytesReceived;
+    streamStats._decodedBytes = _decodedBytesReceived;
+
     streamStats._packetStreamStats = _incomingSequenceNumberStats.getStats();
     streamStats._packetStreamWindowStats = _incomingSequenceNumberStats.getStatsForHistoryWindow();
 
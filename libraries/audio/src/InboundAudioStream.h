@@ -12,11 +12,14 @@
 #ifndef hifi_InboundAudioStream_h
 #define hifi_InboundAudioStream_h
 
+#include <functional>
+
 #include <NodeData.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <StDev.h>
 
+#include "AudioCodec.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -128,6 +131,9 @@ public:
     void setWindowSecondsForDesiredReduction(int windowSecondsForDesiredReduction);
     void setRepetitionWithFade(bool repetitionWithFade) { _repetitionWithFade = repetitionWithFade; }
 
+    /// the clock the timing stats and starve history are kept by, usecTimestampNow() unless a replay sets a virtual one
+    void setClock(std::function<quint64()> clock) { _clock = clock; }
+
     virtual AudioStreamStats getAudioStreamStats() const;
 
     /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
@@ -164,6 +170,9 @@ public:
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
+
+    /// the AudioCodec::Type the audio data of the last packet was encoded with
+    quint8 getIncomingCodecType() const { return _incomingCodec->getType(); }
     
     bool hasReverb() const { return _hasReverb; }
     float getRevebTime() const { return _reverbTime; }
@@ -186,6 +195,8 @@ private:
     void popSamplesNoCheck(int samples);
     void framesAvailableChanged();
 
+    QByteArray decodeAudioData(const QByteArray& audioData, int networkSamples);
+
 protected:
     // disallow copying of InboundAudioStream objects
     InboundAudioStream(const InboundAudioStream&);
@@ -196,8 +207,12 @@ protected:
     /// default implementation assumes no stream properties and raw audio samples after stream propertiess
     virtual int parseStreamProperties(PacketType::Value type, const QByteArray& packetAfterSeqNum, int& networkSamples);
 
-    /// parses the audio data in the network packet.
-    /// default implementation assumes packet contains raw audio samples after stream properties
+    /// selects the codec the audio data of the packet being parsed is decoded with, which parseStreamProperties reads
+    /// from the packet. Returns false for a codec this build does not know, the packet's audio can not be decoded then.
+    bool setIncomingCodec(quint8 codecType, int numChannels);
+
+    /// parses the audio data in the network packet, which has been decoded to raw audio samples by then.
+    /// default implementation writes the raw audio samples to the ring buffer
     virtual int parseAudioData(PacketType::Value type, const QByteArray& packetAfterStreamProperties, int networkSamples);
 
     /// writes silent samples to the buffer that may be dropped to reduce latency caused by the buffer
@@ -259,6 +274,13 @@ protected:
     MovingMinMaxAvg<quint64> _timeGapStatsForStatsPacket;
 
     bool _repetitionWithFade;
+
+    std::function<quint64()> _clock;
+
+    std::unique_ptr<AudioCodec> _incomingCodec;
+    int _incomingCodecChannels;
+    quint64 _codedBytesReceived;
+    quint64 _decodedBytesReceived;
     
     // Reverb properties
     bool _hasReverb;
@@ -589,7 +589,7 @@ void EntityTreeRenderer::renderElementProxy(EntityTreeElement* entityTreeElement
 void EntityTreeRenderer::renderProxies(EntityItemPointer entity, RenderArgs* args) {
     bool isShadowMode = args->_renderMode == RenderArgs::SHADOW_RENDER_MODE;
     if (!isShadowMode && _displayModelBounds) {
-        PerformanceTimer perfTimer("renderProxies");
+        PERFORMANCE_TIMER("renderProxies");
 
         AACube maxCube = entity->getMaximumAACube();
         AACube minCube = entity->getMinimumAACube();
@@ -833,7 +833,7 @@ void EntityTreeRenderer::mousePressEvent(QMouseEvent* event, unsigned int device
     if (!_tree || _shuttingDown) {
         return;
     }
-    PerformanceTimer perfTimer("EntityTreeRenderer::mousePressEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mousePressEvent");
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
 
     bool precisionPicking = !_dontDoPrecisionPicking;
@@ -872,7 +872,7 @@ void EntityTreeRenderer::mouseReleaseEvent(QMouseEvent* event, unsigned int devi
     if (!_tree || _shuttingDown) {
         return;
     }
-    PerformanceTimer perfTimer("EntityTreeRenderer::mouseReleaseEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mouseReleaseEvent");
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
     bool precisionPicking = !_dontDoPrecisionPicking;
     RayToEntityIntersectionResult rayPickResult = findRayIntersectionWorker(ray, Octree::Lock, precisionPicking);
@@ -911,7 +911,7 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event, unsigned int deviceI
     if (!_tree || _shuttingDown) {
         return;
     }
-    PerformanceTimer perfTimer("EntityTreeRenderer::mouseMoveEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mouseMoveEvent");
 
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
 
@@ -26,7 +26,7 @@ EntityItemPointer RenderableBoxEntityItem::factory(const EntityItemID& entityID,
 }
 
 void RenderableBoxEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableBoxEntityItem::render");
+    PERFORMANCE_TIMER("RenderableBoxEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Box);
     glm::vec4 cubeColor(toGlm(getXColor()), getLocalRenderAlpha());
     
@@ -24,7 +24,7 @@ EntityItemPointer RenderableLightEntityItem::factory(const EntityItemID& entityI
 }
 
 void RenderableLightEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableLightEntityItem::render");
+    PERFORMANCE_TIMER("RenderableLightEntityItem::render");
     assert(getType() == EntityTypes::Light);
     glm::vec3 position = getPosition();
     glm::vec3 dimensions = getDimensions();
@@ -113,7 +113,7 @@ void RenderableModelEntityItem::remapTextures() {
 bool RenderableModelEntityItem::readyToAddToScene(RenderArgs* renderArgs) {
     if (!_model && renderArgs) {
         // TODO: this getModel() appears to be about 3% of model render time. We should optimize
-        PerformanceTimer perfTimer("getModel");
+        PERFORMANCE_TIMER("getModel");
         EntityTreeRenderer* renderer = static_cast<EntityTreeRenderer*>(renderArgs->_renderer);
         getModel(renderer);
     }
@@ -125,7 +125,7 @@ bool RenderableModelEntityItem::readyToAddToScene(RenderArgs* renderArgs) {
     
         // make sure to simulate so everything gets set up correctly for rendering
         {
-            PerformanceTimer perfTimer("_model->simulate");
+            PERFORMANCE_TIMER("_model->simulate");
             _model->simulate(0.0f);
         }
         _needsInitialSimulation = false;
@@ -219,7 +219,7 @@ void RenderableModelEntityItem::removeFromScene(EntityItemPointer self, std::sha
 // NOTE: this only renders the "meta" portion of the Model, namely it renders debugging items, and it handles
 // the per frame simulation/update that might be required if the models properties changed.
 void RenderableModelEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RMEIrender");
+    PERFORMANCE_TIMER("RMEIrender");
     assert(getType() == EntityTypes::Model);
     
     glm::vec3 position = getPosition();
@@ -261,7 +261,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
 
             if (!_model || _needsModelReload) {
                 // TODO: this getModel() appears to be about 3% of model render time. We should optimize
-                PerformanceTimer perfTimer("getModel");
+                PERFORMANCE_TIMER("getModel");
                 EntityTreeRenderer* renderer = static_cast<EntityTreeRenderer*>(args->_renderer);
                 getModel(renderer);
             }
@@ -295,7 +295,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
                     
                     // make sure to simulate so everything gets set up correctly for rendering
                     {
-                        PerformanceTimer perfTimer("_model->simulate");
+                        PERFORMANCE_TIMER("_model->simulate");
                         _model->simulate(0.0f);
                     }
                     _needsInitialSimulation = false;
@@ -132,7 +132,7 @@ void RenderablePolyLineEntityItem::render(RenderArgs* args) {
         createPipeline();
     }
  
-    PerformanceTimer perfTimer("RenderablePolyLineEntityItem::render");
+    PERFORMANCE_TIMER("RenderablePolyLineEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::PolyLine);
     
     Q_ASSERT(args->_batch);
@@ -685,7 +685,7 @@ void RenderablePolyVoxEntityItem::getModel() {
 }
 
 void RenderablePolyVoxEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderablePolyVoxEntityItem::render");
+    PERFORMANCE_TIMER("RenderablePolyVoxEntityItem::render");
     assert(getType() == EntityTypes::PolyVox);
     Q_ASSERT(args->_batch);
 
@@ -26,7 +26,7 @@ EntityItemPointer RenderableSphereEntityItem::factory(const EntityItemID& entity
 }
 
 void RenderableSphereEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableSphereEntityItem::render");
+    PERFORMANCE_TIMER("RenderableSphereEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Sphere);
     glm::vec4 sphereColor(toGlm(getXColor()), getLocalRenderAlpha());
     
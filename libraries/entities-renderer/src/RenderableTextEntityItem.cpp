@@ -26,7 +26,7 @@ EntityItemPointer RenderableTextEntityItem::factory(const EntityItemID& entityID
 }
 
 void RenderableTextEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableTextEntityItem::render");
+    PERFORMANCE_TIMER("RenderableTextEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Text);
     
     static const float SLIGHTLY_BEHIND = -0.005f;
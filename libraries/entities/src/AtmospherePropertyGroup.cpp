@@ -120,6 +120,16 @@ void AtmospherePropertyGroup::markAllChanged() {
     _hasStarsChanged = true;
 }
 
+void AtmospherePropertyGroup::merge(const AtmospherePropertyGroup& other) {
+    MERGE_PROPERTY(center);
+    MERGE_PROPERTY(innerRadius);
+    MERGE_PROPERTY(outerRadius);
+    MERGE_PROPERTY(mieScattering);
+    MERGE_PROPERTY(rayleighScattering);
+    MERGE_PROPERTY(scatteringWavelengths);
+    MERGE_PROPERTY(hasStars);
+}
+
 EntityPropertyFlags AtmospherePropertyGroup::getChangedProperties() const {
     EntityPropertyFlags changedProperties;
     
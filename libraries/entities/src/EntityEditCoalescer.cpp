@@ -0,0 +1,128 @@
+//
+//  EntityEditCoalescer.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+
+#include <NumericalConstants.h>
+
+#include "EntityEditCoalescer.h"
+
+// a script that edits an entity every frame at 60Hz has every other edit merged into the next
+const quint64 EntityEditCoalescer::DEFAULT_USECS_BETWEEN_EDITS = USECS_PER_SECOND / 30;
+const int EntityEditCoalescer::DEFAULT_MAX_EDITS_PER_SECOND = 1000;
+
+EntityEditCoalescer::EntityEditCoalescer() :
+    _usecsBetweenEdits(DEFAULT_USECS_BETWEEN_EDITS),
+    _maxEditsPerSecond(DEFAULT_MAX_EDITS_PER_SECOND),
+    _editBudget(DEFAULT_MAX_EDITS_PER_SECOND),
+    _lastBudgetUpdate(0),
+    _hasSentSincePrune(false),
+    _editsCoalesced(0),
+    _editsHeld(0)
+{
+}
+
+void EntityEditCoalescer::setMaxEditsPerSecond(int maxEditsPerSecond) {
+    _maxEditsPerSecond = maxEditsPerSecond;
+    _editBudget = std::min(_editBudget, (float)maxEditsPerSecond);
+}
+
+bool EntityEditCoalescer::editQueued(const EntityItemID& entityID, const EntityItemProperties& properties, quint64 now) {
+    updateBudget(now);
+
+    EntityEdits& entityEdits = _entityEdits[entityID];
+    if (entityEdits.isHeld) {
+        entityEdits.heldProperties.merge(properties);
+        _editsCoalesced++;
+        return false;
+    }
+    bool isDue = entityEdits.lastSent == 0 || now >= entityEdits.lastSent + _usecsBetweenEdits;
+    if (isDue && (_maxEditsPerSecond <= 0 || _editBudget >= 1.0f)) {
+        editSent(entityEdits, now);
+        return true;
+    }
+    entityEdits.isHeld = true;
+    entityEdits.heldProperties = properties;
+    _heldEntities.push_back(entityID);
+    _editsHeld++;
+    return false;
+}
+
+void EntityEditCoalescer::entityErased(const EntityItemID& entityID) {
+    if (_entityEdits.remove(entityID) > 0) {
+        _heldEntities.removeOne(entityID);
+    }
+}
+
+void EntityEditCoalescer::takeDueEdits(quint64 now, QVector<Edit>& edits) {
+    updateBudget(now);
+
+    int kept = 0;
+    for (int i = 0; i < _heldEntities.size(); i++) {
+        EntityEdits& entityEdits = _entityEdits[_heldEntities[i]];
+        bool isDue = now >= entityEdits.lastSent + _usecsBetweenEdits;
+        if (isDue && (_maxEditsPerSecond <= 0 || _editBudget >= 1.0f)) {
+            edits.push_back(Edit(_heldEntities[i], entityEdits.heldProperties));
+            entityEdits.isHeld = false;
+            entityEdits.heldProperties = EntityItemProperties();
+            editSent(entityEdits, now);
+        } else {
+            _heldEntities[kept++] = _heldEntities[i];
+        }
+    }
+    _heldEntities.resize(kept);
+
+    // entities are only added by sends, so there is nothing new to prune until something is sent
+    if (!_hasSentSincePrune) {
+        return;
+    }
+    _hasSentSincePrune = false;
+
+    // an entity that was last sent long enough ago is no different from one that was never sent
+    QHash<EntityItemID, EntityEdits>::iterator entityEdits = _entityEdits.begin();
+    while (entityEdits != _entityEdits.end()) {
+        if (!entityEdits->isHeld && now >= entityEdits->lastSent + _usecsBetweenEdits) {
+            entityEdits = _entityEdits.erase(entityEdits);
+        } else {
+            ++entityEdits;
+        }
+    }
+}
+
+quint64 EntityEditCoalescer::getNextDueTime() const {
+    if (_heldEntities.isEmpty()) {
+        return 0;
+    }
+    quint64 nextDueTime = _entityEdits.value(_heldEntities[0]).lastSent + _usecsBetweenEdits;
+    foreach (const EntityItemID& entityID, _heldEntities) {
+        nextDueTime = std::min(nextDueTime, _entityEdits.value(entityID).lastSent + _usecsBetweenEdits);
+    }
+    if (_maxEditsPerSecond > 0 && _editBudget < 1.0f) {
+        quint64 budgetDueTime = _lastBudgetUpdate + (quint64)((1.0f - _editBudget) * USECS_PER_SECOND / _maxEditsPerSecond);
+        nextDueTime = std::max(nextDueTime, budgetDueTime);
+    }
+    return nextDueTime;
+}
+
+void EntityEditCoalescer::updateBudget(quint64 now) {
+    if (_maxEditsPerSecond > 0 && now > _lastBudgetUpdate) {
+        _editBudget += (float)(now - _lastBudgetUpdate) * _maxEditsPerSecond / USECS_PER_SECOND;
+        _editBudget = std::min(_editBudget, (float)_maxEditsPerSecond);
+    }
+    _lastBudgetUpdate = now;
+}
+
+void EntityEditCoalescer::editSent(EntityEdits& entityEdits, quint64 now) {
+    entityEdits.lastSent = now;
+    _hasSentSincePrune = true;
+    if (_maxEditsPerSecond > 0) {
+        _editBudget -= 1.0f;
+    }
+}
@@ -0,0 +1,84 @@
+//
+//  EntityEditCoalescer.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Holds back entity edits that come faster than they should be sent, merging them into one edit per entity
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEditCoalescer_h
+#define hifi_EntityEditCoalescer_h
+
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QVector>
+
+#include "EntityItemID.h"
+#include "EntityItemProperties.h"
+
+/// Rate limits the edits of an EntityEditPacketSender. An entity is edited at most once every usecsBetweenEdits, and
+/// no more than maxEditsPerSecond edits are sent in all, with up to a second's worth sent in a burst. An edit that
+/// comes too soon is held, and the edits that follow it before it is due are merged into it, so that only the latest
+/// value of each property is sent. Either limit is off when set to 0.
+///
+/// Not thread safe, the sender locks around it.
+class EntityEditCoalescer {
+public:
+    static const quint64 DEFAULT_USECS_BETWEEN_EDITS;
+    static const int DEFAULT_MAX_EDITS_PER_SECOND;
+
+    typedef QPair<EntityItemID, EntityItemProperties> Edit;
+
+    EntityEditCoalescer();
+
+    void setUsecsBetweenEdits(quint64 usecsBetweenEdits) { _usecsBetweenEdits = usecsBetweenEdits; }
+    quint64 getUsecsBetweenEdits() const { return _usecsBetweenEdits; }
+
+    void setMaxEditsPerSecond(int maxEditsPerSecond);
+    int getMaxEditsPerSecond() const { return _maxEditsPerSecond; }
+
+    /// returns true if the edit can be sent right away, otherwise it is held until takeDueEdits() hands it out
+    bool editQueued(const EntityItemID& entityID, const EntityItemProperties& properties, quint64 now);
+
+    /// drops the held edit of an entity that is being erased
+    void entityErased(const EntityItemID& entityID);
+
+    /// appends the held edits that can be sent at now to edits, in the order they were first held
+    void takeDueEdits(quint64 now, QVector<Edit>& edits);
+
+    /// the time the next held edit can be sent, 0 if there are none
+    quint64 getNextDueTime() const;
+
+    int getHeldEditCount() const { return _heldEntities.size(); }
+    quint64 getEditsCoalesced() const { return _editsCoalesced; }
+    quint64 getEditsHeld() const { return _editsHeld; }
+
+private:
+    struct EntityEdits {
+        EntityEdits() : lastSent(0), isHeld(false) { }
+        quint64 lastSent;
+        bool isHeld;
+        EntityItemProperties heldProperties;
+    };
+
+    void updateBudget(quint64 now);
+    void editSent(EntityEdits& entityEdits, quint64 now);
+
+    quint64 _usecsBetweenEdits;
+    int _maxEditsPerSecond;
+    float _editBudget;
+    quint64 _lastBudgetUpdate;
+
+    QHash<EntityItemID, EntityEdits> _entityEdits;
+    QVector<EntityItemID> _heldEntities; // in the order their edits were first held
+    bool _hasSentSincePrune;
+
+    quint64 _editsCoalesced;
+    quint64 _editsHeld;
+};
+
+#endif // hifi_EntityEditCoalescer_h
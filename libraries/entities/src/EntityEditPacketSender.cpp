@@ -10,6 +10,8 @@
 //
 
 #include <assert.h>
+#include <algorithm>
+#include <NumericalConstants.h>
 #include <PerfStat.h>
 #include <OctalCode.h>
 #include <udt/PacketHeaders.h>
@@ -40,15 +42,15 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType::Value type, Enti
         return; // bail early
     }
 
-    QByteArray bufferOut(NLPacket::maxPayloadSize(type), 0);
+    QMutexLocker locker(&_coalescerLock);
 
-    if (EntityItemProperties::encodeEntityEditPacket(type, modelID, properties, bufferOut)) {
-        #ifdef WANT_DEBUG
-            qCDebug(entities) << "calling queueOctreeEditMessage()...";
-            qCDebug(entities) << "    id:" << modelID;
-            qCDebug(entities) << "    properties:" << properties;
-        #endif
-        queueOctreeEditMessage(type, bufferOut);
+    // only edits are coalesced, an add has to go out before any edit of the new entity
+    int heldEditCount = _coalescer.getHeldEditCount();
+    if (type != PacketType::EntityEdit || _coalescer.editQueued(modelID, properties, usecTimestampNow())) {
+        encodeAndQueueEditEntityMessage(type, modelID, properties);
+    } else if (_coalescer.getHeldEditCount() > heldEditCount) {
+        // the sending thread may be waiting for longer than this edit has to be held
+        wakeSendingThread();
     }
 }
 
@@ -57,9 +59,76 @@ void EntityEditPacketSender::queueEraseEntityMessage(const EntityItemID& entityI
         return; // bail early
     }
 
+    QMutexLocker locker(&_coalescerLock);
+    _coalescer.entityErased(entityItemID);
+
     QByteArray bufferOut(NLPacket::maxPayloadSize(PacketType::EntityErase), 0);
 
     if (EntityItemProperties::encodeEraseEntityMessage(entityItemID, bufferOut)) {
         queueOctreeEditMessage(PacketType::EntityErase, bufferOut);
     }
 }
+
+void EntityEditPacketSender::setUsecsBetweenEntityEdits(quint64 usecsBetweenEdits) {
+    QMutexLocker locker(&_coalescerLock);
+    _coalescer.setUsecsBetweenEdits(usecsBetweenEdits);
+}
+
+void EntityEditPacketSender::setMaxEntityEditsPerSecond(int maxEditsPerSecond) {
+    QMutexLocker locker(&_coalescerLock);
+    _coalescer.setMaxEditsPerSecond(maxEditsPerSecond);
+}
+
+quint64 EntityEditPacketSender::getEntityEditsCoalesced() const {
+    QMutexLocker locker(&_coalescerLock);
+    return _coalescer.getEditsCoalesced();
+}
+
+quint64 EntityEditPacketSender::getEntityEditsHeld() const {
+    QMutexLocker locker(&_coalescerLock);
+    return _coalescer.getEditsHeld();
+}
+
+bool EntityEditPacketSender::process() {
+    releaseHeldEdits();
+    return OctreeEditPacketSender::process();
+}
+
+unsigned long EntityEditPacketSender::getMaxWaitForPacketsMsecs() const {
+    QMutexLocker locker(&_coalescerLock);
+    quint64 nextDueTime = _coalescer.getNextDueTime();
+    if (nextDueTime == 0) {
+        return OctreeEditPacketSender::getMaxWaitForPacketsMsecs();
+    }
+    quint64 now = usecTimestampNow();
+    quint64 usecsToWait = nextDueTime > now ? nextDueTime - now : 0;
+    return std::max((unsigned long)1, (unsigned long)((usecsToWait + USECS_PER_MSEC - 1) / USECS_PER_MSEC));
+}
+
+void EntityEditPacketSender::encodeAndQueueEditEntityMessage(PacketType::Value type, EntityItemID modelID,
+                                                             const EntityItemProperties& properties) {
+    QByteArray bufferOut(NLPacket::maxPayloadSize(type), 0);
+
+    if (EntityItemProperties::encodeEntityEditPacket(type, modelID, properties, bufferOut)) {
+        #ifdef WANT_DEBUG
+            qCDebug(entities) << "calling queueOctreeEditMessage()...";
+            qCDebug(entities) << "    id:" << modelID;
+            qCDebug(entities) << "    properties:" << properties;
+        #endif
+        queueOctreeEditMessage(type, bufferOut);
+    }
+}
+
+void EntityEditPacketSender::releaseHeldEdits() {
+    QMutexLocker locker(&_coalescerLock);
+    QVector<EntityEditCoalescer::Edit> edits;
+    _coalescer.takeDueEdits(usecTimestampNow(), edits);
+    if (edits.isEmpty()) {
+        return;
+    }
+    foreach (const EntityEditCoalescer::Edit& edit, edits) {
+        encodeAndQueueEditEntityMessage(PacketType::EntityEdit, edit.first, edit.second);
+    }
+    // these edits have waited their turn already, they don't also wait for a packet to fill up
+    releaseQueuedMessages();
+}
@@ -14,6 +14,7 @@
 
 #include <OctreeEditPacketSender.h>
 
+#include "EntityEditCoalescer.h"
 #include "EntityItem.h"
 
 /// Utility for processing, packing, queueing and sending of outbound edit voxel messages.
@@ -30,15 +31,35 @@ public:
 
     void queueEraseEntityMessage(const EntityItemID& entityItemID);
 
+    /// Edits of an entity that come within usecsBetweenEdits of its last edit are held and merged into one edit, and
+    /// no more than maxEditsPerSecond edits are sent in all. See EntityEditCoalescer. Either limit is off when 0.
+    void setUsecsBetweenEntityEdits(quint64 usecsBetweenEdits);
+    void setMaxEntityEditsPerSecond(int maxEditsPerSecond);
+
+    quint64 getEntityEditsCoalesced() const;
+    quint64 getEntityEditsHeld() const;
+
     // My server type is the model server
     virtual char getMyNodeType() const { return NodeType::EntityServer; }
     virtual void adjustEditPacketForClockSkew(PacketType::Value type, QByteArray& buffer, int clockSkew);
 
+    virtual bool process();
+
 public slots:
     void processEntityEditNackPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
     void toggleNackPackets() { _shouldProcessNack = !_shouldProcessNack; }
 
+protected:
+    virtual unsigned long getMaxWaitForPacketsMsecs() const;
+
 private:
+    void encodeAndQueueEditEntityMessage(PacketType::Value type, EntityItemID modelID,
+                                         const EntityItemProperties& properties);
+    void releaseHeldEdits();
+
     bool _shouldProcessNack = true;
+
+    mutable QMutex _coalescerLock; // also held while queueing, so that the edits of an entity go out in order
+    EntityEditCoalescer _coalescer;
 };
 #endif // hifi_EntityEditPacketSender_h
@@ -20,6 +20,7 @@
 #include <ByteCountCoding.h>
 #include <GLMHelpers.h>
 #include <Octree.h>
+#include <OctreeClientBaselines.h>
 #include <PhysicsHelpers.h>
 #include <RegisteredMetaTypes.h>
 #include <SharedUtil.h> // usecTimestampNow()
@@ -179,6 +180,17 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
     }
 
     LevelDetails entityLevel = packetData->startLevel();
+    int entityOffset = packetData->getUncompressedByteOffset();
+
+    // if the packet is for a client we sent this entity to before, only what differs from that is appended
+    OctreeClientBaselines* clientBaselines = packetData->getClientBaselines();
+    if (clientBaselines) {
+        clientBaselines->setCurrentItem(getEntityItemID());
+        if (!clientBaselines->getClientID().isNull() && _simulationOwner.getID() == clientBaselines->getClientID()) {
+            // the simulation owner ignores the transform and velocities we send it, so it may not have what it was sent
+            clientBaselines->forgetItem(getEntityItemID());
+        }
+    }
 
     quint64 lastEdited = getLastEdited();
 
@@ -240,6 +252,11 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
         //      PROP_CUSTOM_PROPERTIES_INCLUDED,
 
         APPEND_ENTITY_PROPERTY(PROP_SIMULATION_OWNER, _simulationOwner.toByteArray());
+        if (clientBaselines && propertyFlags.getHasProperty(PROP_SIMULATION_OWNER)) {
+            // a simulation owner ignores the transform and velocities we send it, so once the owner changes what we last
+            // sent may not be what the client has
+            clientBaselines->forgetItem(getEntityItemID());
+        }
         APPEND_ENTITY_PROPERTY(PROP_POSITION, getPosition());
         APPEND_ENTITY_PROPERTY(PROP_ROTATION, getRotation());
         APPEND_ENTITY_PROPERTY(PROP_VELOCITY, getVelocity());
@@ -294,17 +311,29 @@ OctreeElement::AppendState EntityItem::appendEntityData(OctreePacketData* packet
             packetData->updatePriorBytes(newEntityItemDataStart, modelItemData, modelItemDataLength);
             int newSize = oldSize - (oldPropertyFlagsLength - newPropertyFlagsLength);
             packetData->setUncompressedSize(newSize);
+            if (clientBaselines) {
+                clientBaselines->pendingMoved(startOfEntityItemData, newEntityItemDataStart);
+            }
 
         } else {
             assert(newPropertyFlagsLength == oldPropertyFlagsLength); // should not have grown
         }
 
         packetData->endLevel(entityLevel);
+    } else if (headerFits && clientBaselines && !propertiesDidntFit) {
+        // the client already has every property that was asked for, so there is nothing to send, and nothing left
+        // to send later either
+        clientBaselines->itemSkipped(startOfEntityItemData - entityOffset);
+        packetData->discardLevel(entityLevel);
     } else {
         packetData->discardLevel(entityLevel);
         appendState = OctreeElement::NONE; // if we got here, then we didn't include the item
     }
 
+    if (clientBaselines) {
+        clientBaselines->setCurrentItem(QUuid());
+    }
+
     // If any part of the model items didn't fit, then the element is considered partial
     if (appendState != OctreeElement::COMPLETED) {
         // add this item into our list for the next appendElementData() pass
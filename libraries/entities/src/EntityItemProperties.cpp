@@ -1249,6 +1249,100 @@ void EntityItemProperties::markAllChanged() {
     _zTextureURLChanged = true;
 }
 
+void EntityItemProperties::merge(const EntityItemProperties& other) {
+    if (other._type != EntityTypes::Unknown) {
+        _type = other._type;
+    }
+    _lastEdited = std::max(_lastEdited, other._lastEdited);
+
+    MERGE_PROPERTY(simulationOwner);
+    MERGE_PROPERTY(position);
+    MERGE_PROPERTY(dimensions);
+    MERGE_PROPERTY(rotation);
+    MERGE_PROPERTY(density);
+    MERGE_PROPERTY(velocity);
+    MERGE_PROPERTY(gravity);
+    MERGE_PROPERTY(acceleration);
+    MERGE_PROPERTY(damping);
+    MERGE_PROPERTY(restitution);
+    MERGE_PROPERTY(friction);
+    MERGE_PROPERTY(lifetime);
+    MERGE_PROPERTY(userData);
+    MERGE_PROPERTY(script);
+    MERGE_PROPERTY(scriptTimestamp);
+    MERGE_PROPERTY(collisionSoundURL);
+    MERGE_PROPERTY(registrationPoint);
+    MERGE_PROPERTY(angularVelocity);
+    MERGE_PROPERTY(angularDamping);
+    MERGE_PROPERTY(name);
+    MERGE_PROPERTY(visible);
+    MERGE_PROPERTY(color);
+    MERGE_PROPERTY(modelURL);
+    MERGE_PROPERTY(compoundShapeURL);
+    MERGE_PROPERTY(animationURL);
+    MERGE_PROPERTY(animationIsPlaying);
+    MERGE_PROPERTY(animationFrameIndex);
+    MERGE_PROPERTY(animationFPS);
+    MERGE_PROPERTY(animationSettings);
+    MERGE_PROPERTY(glowLevel);
+    MERGE_PROPERTY(localRenderAlpha);
+    MERGE_PROPERTY(isSpotlight);
+    MERGE_PROPERTY(ignoreForCollisions);
+    MERGE_PROPERTY(collisionsWillMove);
+
+    MERGE_PROPERTY(intensity);
+    MERGE_PROPERTY(exponent);
+    MERGE_PROPERTY(cutoff);
+    MERGE_PROPERTY(locked);
+    MERGE_PROPERTY(textures);
+
+    MERGE_PROPERTY(text);
+    MERGE_PROPERTY(lineHeight);
+    MERGE_PROPERTY(textColor);
+    MERGE_PROPERTY(backgroundColor);
+    MERGE_PROPERTY(shapeType);
+
+    MERGE_PROPERTY(maxParticles);
+    MERGE_PROPERTY(lifespan);
+    MERGE_PROPERTY(emitRate);
+    MERGE_PROPERTY(emitDirection);
+    MERGE_PROPERTY(emitStrength);
+    MERGE_PROPERTY(localGravity);
+    MERGE_PROPERTY(particleRadius);
+
+    MERGE_PROPERTY(marketplaceID);
+
+    MERGE_PROPERTY(keyLightColor);
+    MERGE_PROPERTY(keyLightIntensity);
+    MERGE_PROPERTY(keyLightAmbientIntensity);
+    MERGE_PROPERTY(keyLightDirection);
+
+    MERGE_PROPERTY(backgroundMode);
+    _stage.merge(other._stage);
+    _atmosphere.merge(other._atmosphere);
+    _skybox.merge(other._skybox);
+
+    MERGE_PROPERTY(sourceUrl);
+    MERGE_PROPERTY(voxelVolumeSize);
+    MERGE_PROPERTY(voxelData);
+    MERGE_PROPERTY(voxelSurfaceStyle);
+
+    MERGE_PROPERTY(lineWidth);
+    MERGE_PROPERTY(linePoints);
+
+    MERGE_PROPERTY(href);
+    MERGE_PROPERTY(description);
+    MERGE_PROPERTY(faceCamera);
+    MERGE_PROPERTY(actionData);
+
+    MERGE_PROPERTY(normals);
+    MERGE_PROPERTY(strokeWidths);
+
+    MERGE_PROPERTY(xTextureURL);
+    MERGE_PROPERTY(yTextureURL);
+    MERGE_PROPERTY(zTextureURL);
+}
+
 /// The maximum bounding cube for the entity, independent of it's rotation.
 /// This accounts for the registration point (upon which rotation occurs around).
 ///
@@ -194,6 +194,10 @@ public:
     void clearID() { _id = UNKNOWN_ENTITY_ID; _idSet = false; }
     void markAllChanged();
 
+    /// takes on the properties changed in other, which is a later edit of the same entity, so that both edits can be
+    /// sent as one
+    void merge(const EntityItemProperties& other);
+
     void setSittingPoints(const QVector<SittingPoint>& sittingPoints);
 
     const glm::vec3& getNaturalDimensions() const { return _naturalDimensions; }
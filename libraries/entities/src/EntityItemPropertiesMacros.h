@@ -17,8 +17,12 @@
 #define APPEND_ENTITY_PROPERTY(P,V) \
         if (requestedProperties.getHasProperty(P)) {                \
             LevelDetails propertyLevel = packetData->startLevel();  \
+            int propertyOffset = packetData->getUncompressedByteOffset(); \
             successPropertyFits = packetData->appendValue(V);       \
-            if (successPropertyFits) {                              \
+            if (successPropertyFits && packetData->isUnchangedForClient(P, propertyOffset)) { \
+                packetData->discardLevel(propertyLevel);            \
+                propertiesDidntFit -= P;                            \
+            } else if (successPropertyFits) {                       \
                 propertyFlags |= P;                                 \
                 propertiesDidntFit -= P;                            \
                 propertyCount++;                                    \
@@ -88,6 +92,12 @@
         changedProperties += P;    \
     }
 
+#define MERGE_PROPERTY(M)           \
+    if (other._##M##Changed) {      \
+        _##M = other._##M;          \
+        _##M##Changed = true;       \
+    }
+
 inline QScriptValue convertScriptValue(QScriptEngine* e, const glm::vec3& v) { return vec3toScriptValue(e, v); }
 inline QScriptValue convertScriptValue(QScriptEngine* e, float v) { return QScriptValue(v); }
 inline QScriptValue convertScriptValue(QScriptEngine* e, int v) { return QScriptValue(v); }
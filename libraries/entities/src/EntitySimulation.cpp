@@ -92,7 +92,7 @@ void EntitySimulation::expireMortalEntities(const quint64& now) {
 
 // protected
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
-    PerformanceTimer perfTimer("updatingEntities");
+    PERFORMANCE_TIMER("updatingEntities");
     SetOfEntities::iterator itemItr = _entitiesToUpdate.begin();
     while (itemItr != _entitiesToUpdate.end()) {
         EntityItemPointer entity = *itemItr;
@@ -111,7 +111,7 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
 void EntitySimulation::sortEntitiesThatMoved() {
     // NOTE: this is only for entities that have been moved by THIS EntitySimulation.
     // External changes to entity position/shape are expected to be sorted outside of the EntitySimulation.
-    PerformanceTimer perfTimer("sortingEntities");
+    PERFORMANCE_TIMER("sortingEntities");
     MovingEntitiesOperator moveOperator(_entityTree);
     AACube domainBounds(glm::vec3(0.0f,0.0f,0.0f), (float)TREE_SCALE);
     SetOfEntities::iterator itemItr = _entitiesToSort.begin();
@@ -133,11 +133,12 @@ void EntitySimulation::sortEntitiesThatMoved() {
             itemItr = _entitiesToSort.erase(itemItr);
         } else {
             moveOperator.addEntityToMoveList(entity, newCube);
+            _entityTree->trackPersistChange(entity->getEntityItemID());
             ++itemItr;
         }
     }
     if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
+        PERFORMANCE_TIMER("recurseTreeWithOperator");
         _entityTree->recurseTreeWithOperator(&moveOperator);
     }
 
@@ -9,7 +9,9 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <OctreePersistLog.h>
 #include <PerfStat.h>
+#include <QDataStream>
 #include <QDateTime>
 #include <QtScript/QScriptEngine>
 
@@ -54,6 +56,11 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         _simulation->clearEntities();
         _simulation->unlock();
     }
+    if (_trackPersistChanges) {
+        for (auto itr = _entityToElementMap.constBegin(); itr != _entityToElementMap.constEnd(); ++itr) {
+            trackPersistDelete(itr.key());
+        }
+    }
     foreach (EntityTreeElement* element, _entityToElementMap) {
         element->cleanupEntities();
     }
@@ -85,6 +92,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
         _simulation->unlock();
     }
     _isDirty = true;
+    trackPersistChange(entity->getEntityItemID());
     maybeNotifyNewCollisionSoundURL("", entity->getCollisionSoundURL());
     emit addingEntity(entity->getEntityItemID());
 }
@@ -124,6 +132,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
     } else {
         allowLockChange = senderNode->getCanAdjustLocks();
         senderID = senderNode->getUUID();
+        notifyEntityEdited(entity->getEntityItemID(), senderNode);
     }
 
     if (!allowLockChange && (entity->getLocked() != properties.getLocked())) {
@@ -142,6 +151,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
                 UpdateEntityOperator theOperator(this, containingElement, entity, tempProperties);
                 recurseTreeWithOperator(&theOperator);
                 _isDirty = true;
+                trackPersistChange(entity->getEntityItemID());
             }
         }
     } else {
@@ -204,6 +214,7 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         UpdateEntityOperator theOperator(this, containingElement, entity, properties);
         recurseTreeWithOperator(&theOperator);
         _isDirty = true;
+        trackPersistChange(entity->getEntityItemID());
 
         uint32_t newFlags = entity->getDirtyFlags() & ~preFlags;
         if (newFlags) {
@@ -282,6 +293,114 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
     return result;
 }
 
+QVector<EntityItemPointer> EntityTree::addEntities(const QVector<EntityItemID>& entityIDs,
+                                                  const QVector<EntityItemProperties>& properties) {
+    // NOTE: callers must lock the tree before using this method
+    QVector<EntityItemPointer> addedEntities;
+    assert(entityIDs.size() == properties.size());
+
+    if (getIsClient()) {
+        // if our Node isn't allowed to create entities in this domain, don't try.
+        auto nodeList = DependencyManager::get<NodeList>();
+        if (nodeList && !nodeList->getThisNodeCanRez()) {
+            return addedEntities;
+        }
+    }
+
+    QVector<EntityToAdd> entitiesToAdd;
+    QSet<EntityItemID> idsToAdd;
+    entitiesToAdd.reserve(entityIDs.size());
+    for (int i = 0; i < entityIDs.size(); i++) {
+        const EntityItemID& entityID = entityIDs[i];
+        if (getContainingElement(entityID) || idsToAdd.contains(entityID)) {
+            qCDebug(entities) << "UNEXPECTED!!! ----- don't call addEntities() on existing entity items. entityID="
+                        << entityID;
+            continue;
+        }
+
+        EntityItemPointer entity = EntityTypes::constructEntityItem(properties[i].getType(), entityID, properties[i]);
+        if (!entity) {
+            qCDebug(entities) << "adding Entity failed:" << entityID << properties[i].getType();
+            continue;
+        }
+        if (properties[i].getCreated() == UNKNOWN_CREATED_TIME) {
+            entity->recordCreationTime();
+        }
+        EntityToAdd entityToAdd = { entity, entity->getMaximumAACube().clamp(0.0f, (float)TREE_SCALE), CHILD_UNKNOWN };
+        entitiesToAdd.push_back(entityToAdd);
+        idsToAdd.insert(entityID);
+    }
+    if (entitiesToAdd.isEmpty()) {
+        return addedEntities;
+    }
+
+    // the same placement as AddEntityOperator. On the way down each element groups its entities by the child
+    // getMyChildContaining() picks for them, so that each element is reached once for all of its entities
+    QVector<int> order(entitiesToAdd.size());
+    QVector<int> sortedOrder(entitiesToAdd.size());
+    for (int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    addEntitiesToElement(getRoot(), entitiesToAdd, order, sortedOrder, 0, order.size());
+
+    addedEntities.reserve(entitiesToAdd.size());
+    foreach (const EntityToAdd& entityToAdd, entitiesToAdd) {
+        postAddEntity(entityToAdd.entity);
+        addedEntities.push_back(entityToAdd.entity);
+    }
+    return addedEntities;
+}
+
+// adds the entities order[begin, end) to element or below it
+void EntityTree::addEntitiesToElement(EntityTreeElement* element, QVector<EntityToAdd>& entitiesToAdd, QVector<int>& order,
+                                      QVector<int>& sortedOrder, int begin, int end) {
+    // the entities that stay in this element come first, then those for each child in child order. They are counted
+    // per child, scattered into sortedOrder by those counts, and copied back over their range of order
+    int childCounts[NUMBER_OF_CHILDREN + 1] = { 0 };
+    float childElementScale = element->getAACube().getScale() / 2.0f;
+
+    for (int i = begin; i < end; i++) {
+        EntityToAdd& entityToAdd = entitiesToAdd[order[i]];
+        entityToAdd.childIndex = CHILD_UNKNOWN;
+        if (!element->bestFitBounds(entityToAdd.bounds) && entityToAdd.bounds.getLargestDimension() <= childElementScale) {
+            entityToAdd.childIndex = element->getMyChildContaining(entityToAdd.bounds);
+        }
+        childCounts[entityToAdd.childIndex + 1]++; // CHILD_UNKNOWN is -1
+    }
+
+    int childStarts[NUMBER_OF_CHILDREN + 2];
+    childStarts[0] = begin;
+    for (int i = 0; i <= NUMBER_OF_CHILDREN; i++) {
+        childStarts[i + 1] = childStarts[i] + childCounts[i];
+    }
+    int nextPositions[NUMBER_OF_CHILDREN + 1];
+    memcpy(nextPositions, childStarts, sizeof(nextPositions));
+    for (int i = begin; i < end; i++) {
+        sortedOrder[nextPositions[entitiesToAdd[order[i]].childIndex + 1]++] = order[i];
+    }
+    memcpy(order.data() + begin, sortedOrder.constData() + begin, (end - begin) * sizeof(int));
+
+    for (int i = childStarts[0]; i < childStarts[1]; i++) {
+        const EntityToAdd& entityToAdd = entitiesToAdd[order[i]];
+        element->addEntityItem(entityToAdd.entity);
+        setContainingElement(entityToAdd.entity->getEntityItemID(), element);
+    }
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        int childBegin = childStarts[i + 1];
+        int childEnd = childStarts[i + 2];
+        if (childBegin < childEnd) {
+            OctreeElement* childElement = element->getChildAtIndex(i);
+            if (!childElement) {
+                childElement = element->addChildAtIndex(i);
+            }
+            addEntitiesToElement(static_cast<EntityTreeElement*>(childElement), entitiesToAdd, order, sortedOrder,
+                                 childBegin, childEnd);
+        }
+    }
+    element->markWithChangedTime();
+}
+
 void EntityTree::emitEntityScriptChanging(const EntityItemID& entityItemID, const bool reload) {
     emit entityScriptChanging(entityItemID, reload);
 }
@@ -401,6 +520,7 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
             theEntity->clearActions(_simulation);
             _simulation->removeEntity(theEntity);
         }
+        trackPersistDelete(theEntity->getEntityItemID());
     }
     if (_simulation) {
         _simulation->unlock();
@@ -587,90 +707,117 @@ int EntityTree::processEditPacketData(NLPacket& packet, const unsigned char* edi
 
         case PacketType::EntityAdd:
         case PacketType::EntityEdit: {
-            quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startLogging = 0, endLogging = 0;
-
-            _totalEditMessages++;
-
-            EntityItemID entityItemID;
-            EntityItemProperties properties;
-            startDecode = usecTimestampNow();
-           
-            bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
-                                                                                entityItemID, properties);
-            endDecode = usecTimestampNow();
-
-            // If we got a valid edit packet, then it could be a new entity or it could be an update to
-            // an existing entity... handle appropriately
-            if (validEditPacket) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (existingEntity && packet.getType() == PacketType::EntityEdit) {
-                    // if the EntityItem exists, then update it
+            OctreeDecodedEdit* edit = decodeEditPacketData(packet.getType(), editData, maxLength, processedBytes);
+            applyDecodedEdit(packet.getType(), *edit, senderNode);
+            delete edit;
+            break;
+        }
+
+        default:
+            processedBytes = 0;
+            break;
+    }
+    return processedBytes;
+}
+
+/// an add or edit message, decoded into the properties to apply
+class EntityDecodedEdit : public OctreeDecodedEdit {
+public:
+    EntityItemID entityItemID;
+    EntityItemProperties properties;
+    bool isValid;
+    quint64 decodeTime;
+};
+
+bool EntityTree::canDecodeEditPacketType(PacketType::Value packetType) const {
+    return packetType == PacketType::EntityAdd || packetType == PacketType::EntityEdit;
+}
+
+OctreeDecodedEdit* EntityTree::decodeEditPacketData(PacketType::Value packetType, const unsigned char* editData,
+                                                    int maxLength, int& processedBytes) const {
+    if (!canDecodeEditPacketType(packetType)) {
+        processedBytes = 0;
+        return NULL;
+    }
+    EntityDecodedEdit* edit = new EntityDecodedEdit();
+    quint64 startDecode = usecTimestampNow();
+    edit->isValid = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
+                                                                 edit->entityItemID, edit->properties);
+    edit->decodeTime = usecTimestampNow() - startDecode;
+    return edit;
+}
+
+void EntityTree::applyDecodedEdit(PacketType::Value packetType, OctreeDecodedEdit& decodedEdit,
+                                  const SharedNodePointer& senderNode) {
+    EntityDecodedEdit& edit = static_cast<EntityDecodedEdit&>(decodedEdit);
+    const EntityItemID& entityItemID = edit.entityItemID;
+    EntityItemProperties& properties = edit.properties;
+
+    quint64 startLookup = 0, endLookup = 0;
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startLogging = 0, endLogging = 0;
+
+    _totalEditMessages++;
+
+    // If we got a valid edit packet, then it could be a new entity or it could be an update to
+    // an existing entity... handle appropriately
+    if (edit.isValid) {
+        // search for the entity by EntityItemID
+        startLookup = usecTimestampNow();
+        EntityItemPointer existingEntity = findEntityByEntityItemID(entityItemID);
+        endLookup = usecTimestampNow();
+        if (existingEntity && packetType == PacketType::EntityEdit) {
+            // if the EntityItem exists, then update it
+            startLogging = usecTimestampNow();
+            if (wantEditLogging()) {
+                qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                qCDebug(entities) << "   properties:" << properties;
+            }
+            endLogging = usecTimestampNow();
+
+            startUpdate = usecTimestampNow();
+            updateEntity(entityItemID, properties, senderNode);
+            existingEntity->markAsChangedOnServer();
+            endUpdate = usecTimestampNow();
+            _totalUpdates++;
+        } else if (packetType == PacketType::EntityAdd) {
+            if (senderNode->getCanRez()) {
+                // this is a new entity... assign a new entityID
+                properties.setCreated(properties.getLastEdited());
+                startCreate = usecTimestampNow();
+                EntityItemPointer newEntity = addEntity(entityItemID, properties);
+                endCreate = usecTimestampNow();
+                _totalCreates++;
+                if (newEntity) {
+                    newEntity->markAsChangedOnServer();
+                    notifyNewlyCreatedEntity(*newEntity, senderNode);
+
                     startLogging = usecTimestampNow();
                     if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
+                                        << newEntity->getEntityItemID();
                         qCDebug(entities) << "   properties:" << properties;
                     }
                     endLogging = usecTimestampNow();
 
-                    startUpdate = usecTimestampNow();
-                    updateEntity(entityItemID, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (packet.getType() == PacketType::EntityAdd) {
-                    if (senderNode->getCanRez()) {
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            endLogging = usecTimestampNow();
-
-                        }
-                    } else {
-                        qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
-                                          << "] attempted to add an entity.";
-                    }
-                } else {
-                    static QString repeatedMessage =
-                        LogHandler::getInstance().addRepeatedMessageRegex("^Add or Edit failed.*");
-                    qCDebug(entities) << "Add or Edit failed." << packet.getType() << existingEntity.get();
                 }
+            } else {
+                qCDebug(entities) << "User without 'rez rights' [" << senderNode->getUUID()
+                                  << "] attempted to add an entity.";
             }
-
-
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
-
-            break;
+        } else {
+            static QString repeatedMessage =
+                LogHandler::getInstance().addRepeatedMessageRegex("^Add or Edit failed.*");
+            qCDebug(entities) << "Add or Edit failed." << packetType << existingEntity.get();
         }
-
-        default:
-            processedBytes = 0;
-            break;
     }
-    return processedBytes;
+
+    _totalDecodeTime += edit.decodeTime;
+    _totalLookupTime += endLookup - startLookup;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
 }
 
 
@@ -682,6 +829,14 @@ void EntityTree::notifyNewlyCreatedEntity(const EntityItem& newEntity, const Sha
     _newlyCreatedHooksLock.unlock();
 }
 
+void EntityTree::notifyEntityEdited(const EntityItemID& entityID, const SharedNodePointer& senderNode) {
+    _newlyCreatedHooksLock.lockForRead();
+    for (int i = 0; i < _newlyCreatedHooks.size(); i++) {
+        _newlyCreatedHooks[i]->entityEdited(entityID, senderNode);
+    }
+    _newlyCreatedHooksLock.unlock();
+}
+
 void EntityTree::addNewlyCreatedHook(NewlyCreatedEntityHook* hook) {
     _newlyCreatedHooksLock.lockForWrite();
     _newlyCreatedHooks.push_back(hook);
@@ -714,6 +869,7 @@ void EntityTree::entityChanged(EntityItemPointer entity) {
         _simulation->changeEntity(entity);
         _simulation->unlock();
     }
+    trackPersistChange(entity->getEntityItemID());
 }
 
 void EntityTree::update() {
@@ -756,6 +912,18 @@ bool EntityTree::hasEntitiesDeletedSince(quint64 sinceTime) {
     return hasSomethingNewer;
 }
 
+QVector<QUuid> EntityTree::getEntitiesDeletedSince(quint64 sinceTime) {
+    QVector<QUuid> entityIDs;
+    _recentlyDeletedEntitiesLock.lockForRead();
+    QMultiMap<quint64, QUuid>::const_iterator iterator = _recentlyDeletedEntityItemIDs.upperBound(sinceTime);
+    while (iterator != _recentlyDeletedEntityItemIDs.constEnd()) {
+        entityIDs.push_back(iterator.value());
+        ++iterator;
+    }
+    _recentlyDeletedEntitiesLock.unlock();
+    return entityIDs;
+}
+
 // sinceTime is an in/out parameter - it will be side effected with the last time sent out
 std::unique_ptr<NLPacket> EntityTree::encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumber, quint64& sinceTime,
                                                                  bool& hasMore) {
@@ -1020,9 +1188,18 @@ QVector<EntityItemID> EntityTree::sendEntities(EntityEditPacketSender* packetSen
     args.root = glm::vec3(x, y, z);
     QVector<EntityItemID> newEntityIDs;
     args.newEntityIDs = &newEntityIDs;
+    QVector<EntityItemProperties> newEntitiesProperties;
+    args.newEntitiesProperties = &newEntitiesProperties;
     recurseTreeWithOperation(sendEntitiesOperation, &args);
     packetSender->releaseQueuedMessages();
 
+    // also update the local tree instantly (note: this is not our tree, but an alternate tree)
+    if (localTree) {
+        localTree->lockForWrite();
+        localTree->addEntities(newEntityIDs, newEntitiesProperties);
+        localTree->unlock();
+    }
+
     return newEntityIDs;
 }
 
@@ -1041,12 +1218,8 @@ bool EntityTree::sendEntitiesOperation(OctreeElement* element, void* extraData)
         // queue the packet to send to the server
         args->packetSender->queueEditEntityMessage(PacketType::EntityAdd, newID, properties);
 
-        // also update the local tree instantly (note: this is not our tree, but an alternate tree)
-        if (args->localTree) {
-            args->localTree->lockForWrite();
-            args->localTree->addEntity(newID, properties);
-            args->localTree->unlock();
-        }
+        // the local tree gets them all at once when we're done
+        args->newEntitiesProperties->append(properties);
     }
 
     return true;
@@ -1067,6 +1240,10 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     // to add the new entity to the EnitytTree.
     QVariantList entitiesQList = map["Entities"].toList();
     QScriptEngine scriptEngine;
+    QVector<EntityItemID> entityItemIDs;
+    QVector<EntityItemProperties> entitiesProperties;
+    entityItemIDs.reserve(entitiesQList.size());
+    entitiesProperties.reserve(entitiesQList.size());
 
     foreach (QVariant entityVariant, entitiesQList) {
         // QVariantMap --> QScriptValue --> EntityItemProperties --> Entity
@@ -1081,14 +1258,151 @@ bool EntityTree::readFromMap(QVariantMap& map) {
         } else {
             entityItemID = EntityItemID(QUuid::createUuid());
         }
+        entityItemIDs.push_back(entityItemID);
+        entitiesProperties.push_back(properties);
+    }
 
-        EntityItemPointer entity = addEntity(entityItemID, properties);
-        if (!entity) {
+    addEntities(entityItemIDs, entitiesProperties);
+    return true;
+}
+
+// the records of a persist log, see OctreePersistLog
+const quint8 ENTITY_STATE_RECORD = 1; // the entity's non default properties as a QVariantMap, like the JSON persist file
+const quint8 ENTITY_DELETED_RECORD = 2; // the entity's id
+
+// how many entities a snapshot writes per read lock of the tree, so that edits are not held up for a whole snapshot
+const int ENTITIES_PER_SNAPSHOT_SLICE = 256;
+
+static QByteArray entityStateRecord(EntityItemPointer entity, QScriptEngine& scriptEngine) {
+    QVariantMap entityMap = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine,
+                                                                        entity->getProperties()).toVariant().toMap();
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << entityMap;
+    return payload;
+}
+
+void EntityTree::setTrackPersistChanges(bool trackPersistChanges) {
+    QMutexLocker locker(&_persistChangesMutex);
+    _trackPersistChanges = trackPersistChanges;
+    _persistChangedEntityIDs.clear();
+    _persistDeletedEntityIDs.clear();
+}
+
+void EntityTree::trackPersistChange(const EntityItemID& entityID) {
+    if (_trackPersistChanges) {
+        QMutexLocker locker(&_persistChangesMutex);
+        _persistDeletedEntityIDs.remove(entityID);
+        _persistChangedEntityIDs.insert(entityID);
+    }
+}
+
+void EntityTree::trackPersistDelete(const EntityItemID& entityID) {
+    if (_trackPersistChanges) {
+        QMutexLocker locker(&_persistChangesMutex);
+        _persistChangedEntityIDs.remove(entityID);
+        _persistDeletedEntityIDs.insert(entityID);
+    }
+}
+
+bool EntityTree::writePersistSnapshot(OctreePersistRecordWriter& writer) {
+    // anything that changes after the entities are listed here makes it into the log that follows the snapshot
+    QVector<EntityItemID> entityIDs;
+    lockForRead();
+    {
+        QMutexLocker locker(&_persistChangesMutex);
+        _persistChangedEntityIDs.clear();
+        _persistDeletedEntityIDs.clear();
+    }
+    entityIDs.reserve(_entityToElementMap.size());
+    for (auto itr = _entityToElementMap.constBegin(); itr != _entityToElementMap.constEnd(); ++itr) {
+        entityIDs.push_back(itr.key());
+    }
+    unlock();
+
+    QScriptEngine scriptEngine;
+    for (int i = 0; i < entityIDs.size() && !writer.hasFailed(); i += ENTITIES_PER_SNAPSHOT_SLICE) {
+        int sliceEnd = std::min(i + ENTITIES_PER_SNAPSHOT_SLICE, entityIDs.size());
+        lockForRead();
+        for (int j = i; j < sliceEnd; j++) {
+            // entities deleted since they were listed are left out, their delete records follow in the log
+            EntityItemPointer entity = findEntityByEntityItemID(entityIDs[j]);
+            if (entity) {
+                writer.writeRecord(ENTITY_STATE_RECORD, entityStateRecord(entity, scriptEngine));
+            }
+        }
+        unlock();
+    }
+    return !writer.hasFailed();
+}
+
+bool EntityTree::writePersistChanges(OctreePersistRecordWriter& writer) {
+    QSet<EntityItemID> changedEntityIDs;
+    QSet<EntityItemID> deletedEntityIDs;
+    {
+        QMutexLocker locker(&_persistChangesMutex);
+        changedEntityIDs.swap(_persistChangedEntityIDs);
+        deletedEntityIDs.swap(_persistDeletedEntityIDs);
+    }
+
+    // each entity is in only one of the sets, so the order of the records does not matter
+    QScriptEngine scriptEngine;
+    lockForRead();
+    foreach (const EntityItemID& entityID, deletedEntityIDs) {
+        writer.writeRecord(ENTITY_DELETED_RECORD, entityID.toRfc4122());
+    }
+    foreach (const EntityItemID& entityID, changedEntityIDs) {
+        EntityItemPointer entity = findEntityByEntityItemID(entityID);
+        if (entity) {
+            writer.writeRecord(ENTITY_STATE_RECORD, entityStateRecord(entity, scriptEngine));
+        }
+    }
+    unlock();
+    return !writer.hasFailed();
+}
+
+bool EntityTree::readPersistRecords(OctreePersistRecordReader& reader) {
+    // NOTE: callers must lock the tree before using this method
+    QScriptEngine scriptEngine;
+    quint8 recordType;
+    QByteArray payload;
+    int failedRecords = 0;
+
+    while (reader.readRecord(recordType, payload)) {
+        if (recordType == ENTITY_DELETED_RECORD) {
+            deleteEntity(EntityItemID(QUuid::fromRfc4122(payload)), true, true);
+            continue;
+        }
+        if (recordType != ENTITY_STATE_RECORD) {
+            failedRecords++;
+            continue;
+        }
+
+        QVariantMap entityMap;
+        QDataStream stream(payload);
+        stream >> entityMap;
+        if (stream.status() != QDataStream::Ok || !entityMap.contains("id")) {
+            failedRecords++;
+            continue;
+        }
+        QScriptValue entityScriptValue = variantMapToScriptValue(entityMap, scriptEngine);
+        EntityItemProperties properties;
+        EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, properties);
+
+        // a record holds all of the entity's state, so replacing the entity replays it exactly. Updating it would keep
+        // any property the record left out for being back at its default.
+        EntityItemID entityItemID(QUuid(entityMap["id"].toString()));
+        deleteEntity(entityItemID, true, true);
+        if (!addEntity(entityItemID, properties)) {
             qCDebug(entities) << "adding Entity failed:" << entityItemID << properties.getType();
+            failedRecords++;
         }
     }
 
-    return true;
+    if (failedRecords > 0) {
+        qCDebug(entities) << "unable to read" << failedRecords << "entity persist records";
+    }
+    return failedRecords == 0;
 }
 
 void EntityTree::resetClientEditStats() {
@@ -12,6 +12,9 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+
+#include <QMutex>
 #include <QSet>
 #include <QVector>
 
@@ -26,6 +29,9 @@ class EntitySimulation;
 class NewlyCreatedEntityHook {
 public:
     virtual void entityCreated(const EntityItem& newEntity, const SharedNodePointer& senderNode) = 0;
+
+    /// called with an edit from senderNode before it is applied
+    virtual void entityEdited(const EntityItemID& entityID, const SharedNodePointer& senderNode) { }
 };
 
 class EntityItemFBXService {
@@ -42,6 +48,7 @@ public:
     EntityTree* localTree;
     EntityEditPacketSender* packetSender;
     QVector<EntityItemID>* newEntityIDs;
+    QVector<EntityItemProperties>* newEntitiesProperties;
 };
 
 
@@ -68,6 +75,11 @@ public:
     virtual bool handlesEditPacketType(PacketType::Value packetType) const;
     virtual int processEditPacketData(NLPacket& packet, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode);
+    virtual bool canDecodeEditPacketType(PacketType::Value packetType) const;
+    virtual OctreeDecodedEdit* decodeEditPacketData(PacketType::Value packetType, const unsigned char* editData,
+                                                    int maxLength, int& processedBytes) const;
+    virtual void applyDecodedEdit(PacketType::Value packetType, OctreeDecodedEdit& edit,
+                                  const SharedNodePointer& senderNode);
 
     virtual bool rootElementHasData() const { return true; }
 
@@ -87,6 +99,10 @@ public:
 
     EntityItemPointer addEntity(const EntityItemID& entityID, const EntityItemProperties& properties);
 
+    /// adds many new entities with a single walk down the tree rather than one walk per entity, returns the ones added
+    QVector<EntityItemPointer> addEntities(const QVector<EntityItemID>& entityIDs,
+                                           const QVector<EntityItemProperties>& properties);
+
     // use this method if you only know the entityID
     bool updateEntity(const EntityItemID& entityID, const EntityItemProperties& properties, const SharedNodePointer& senderNode = SharedNodePointer(nullptr));
 
@@ -129,6 +145,7 @@ public:
 
     bool hasAnyDeletedEntities() const { return _recentlyDeletedEntityItemIDs.size() > 0; }
     bool hasEntitiesDeletedSince(quint64 sinceTime);
+    QVector<QUuid> getEntitiesDeletedSince(quint64 sinceTime);
     std::unique_ptr<NLPacket> encodeEntitiesDeletedSince(OCTREE_PACKET_SEQUENCE sequenceNumber, quint64& sinceTime,
                                                          bool& hasMore);
     void forgetEntitiesDeletedBefore(quint64 sinceTime);
@@ -166,6 +183,15 @@ public:
     bool writeToMap(QVariantMap& entityDescription, OctreeElement* element, bool skipDefaultValues);
     bool readFromMap(QVariantMap& entityDescription);
 
+    virtual bool canPersistLog() const { return true; }
+    virtual void setTrackPersistChanges(bool trackPersistChanges);
+    virtual bool writePersistSnapshot(OctreePersistRecordWriter& writer);
+    virtual bool writePersistChanges(OctreePersistRecordWriter& writer);
+    virtual bool readPersistRecords(OctreePersistRecordReader& reader);
+
+    /// records that an entity changed for the next writePersistChanges(), does nothing unless changes are tracked
+    void trackPersistChange(const EntityItemID& entityID);
+
     float getContentsLargestDimension();
 
     virtual void resetEditStats() {
@@ -202,6 +228,15 @@ signals:
 
 private:
 
+    class EntityToAdd {
+    public:
+        EntityItemPointer entity;
+        AABox bounds;
+        int childIndex; // the child of the element being filled that the entity goes down to, or CHILD_UNKNOWN
+    };
+
+    void addEntitiesToElement(EntityTreeElement* element, QVector<EntityToAdd>& entitiesToAdd, QVector<int>& order,
+                              QVector<int>& sortedOrder, int begin, int end);
     void processRemovedEntities(const DeleteEntityOperator& theOperator);
     bool updateEntityWithElement(EntityItemPointer entity, const EntityItemProperties& properties,
                                  EntityTreeElement* containingElement,
@@ -213,6 +248,7 @@ private:
     static bool sendEntitiesOperation(OctreeElement* element, void* extraData);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
+    void notifyEntityEdited(const EntityItemID& entityID, const SharedNodePointer& senderNode);
 
     QReadWriteLock _newlyCreatedHooksLock;
     QVector<NewlyCreatedEntityHook*> _newlyCreatedHooks;
@@ -223,6 +259,14 @@ private:
 
     QHash<EntityItemID, EntityTreeElement*> _entityToElementMap;
 
+    void trackPersistDelete(const EntityItemID& entityID);
+
+    // an entity is in at most one of these, whichever happened to it last
+    std::atomic<bool> _trackPersistChanges { false }; // read without the mutex on every edit
+    QMutex _persistChangesMutex;
+    QSet<EntityItemID> _persistChangedEntityIDs;
+    QSet<EntityItemID> _persistDeletedEntityIDs;
+
     EntitySimulation* _simulation;
 
     bool _wantEditLogging = false;
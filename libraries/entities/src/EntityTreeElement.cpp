@@ -322,12 +322,13 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
         foreach (uint16_t i, indexesOfEntitiesToInclude) {
             EntityItemPointer entity = (*_entityItems)[i];
             LevelDetails entityLevel = packetData->startLevel();
+            int entityOffset = packetData->getUncompressedByteOffset();
             OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData, 
                                                                         params, entityTreeElementExtraEncodeData);
 
-            // If none of this entity data was able to be appended, then discard it
-            // and don't include it in our entity count
-            if (appendEntityState == OctreeElement::NONE) {
+            // If none of this entity data was able to be appended, or the client already had all of it, then discard
+            // it and don't include it in our entity count
+            if (appendEntityState == OctreeElement::NONE || packetData->getUncompressedByteOffset() == entityOffset) {
                 packetData->discardLevel(entityLevel);
             } else {
                 // If either ALL or some of it got appended, then end the level (commit it)
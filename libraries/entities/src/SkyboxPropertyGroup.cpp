@@ -73,6 +73,11 @@ void SkyboxPropertyGroup::markAllChanged() {
     _urlChanged = true;
 }
 
+void SkyboxPropertyGroup::merge(const SkyboxPropertyGroup& other) {
+    MERGE_PROPERTY(color);
+    MERGE_PROPERTY(url);
+}
+
 EntityPropertyFlags SkyboxPropertyGroup::getChangedProperties() const {
     EntityPropertyFlags changedProperties;
     
@@ -47,6 +47,7 @@ public:
     virtual bool decodeFromEditPacket(EntityPropertyFlags& propertyFlags, const unsigned char*& dataAt , int& processedBytes);
     virtual void markAllChanged();
     virtual EntityPropertyFlags getChangedProperties() const;
+    void merge(const SkyboxPropertyGroup& other);
 
     // EntityItem related helpers
     // methods for getting/setting all properties of an entity
@@ -133,6 +133,16 @@ void StagePropertyGroup::markAllChanged() {
     _automaticHourDayChanged = true;
 }
 
+void StagePropertyGroup::merge(const StagePropertyGroup& other) {
+    MERGE_PROPERTY(sunModelEnabled);
+    MERGE_PROPERTY(latitude);
+    MERGE_PROPERTY(longitude);
+    MERGE_PROPERTY(altitude);
+    MERGE_PROPERTY(day);
+    MERGE_PROPERTY(hour);
+    MERGE_PROPERTY(automaticHourDay);
+}
+
 EntityPropertyFlags StagePropertyGroup::getChangedProperties() const {
     EntityPropertyFlags changedProperties;
     
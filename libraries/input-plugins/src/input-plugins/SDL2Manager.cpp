@@ -97,7 +97,7 @@ void SDL2Manager::pluginUpdate(float deltaTime, bool jointsCaptured) {
             joystick->update(deltaTime, jointsCaptured);
         }
         
-        PerformanceTimer perfTimer("SDL2Manager::update");
+        PERFORMANCE_TIMER("SDL2Manager::update");
         SDL_GameControllerUpdate();
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
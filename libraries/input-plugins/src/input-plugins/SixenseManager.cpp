@@ -175,7 +175,7 @@ void SixenseManager::update(float deltaTime, bool jointsCaptured) {
         return;
     }
 
-    PerformanceTimer perfTimer("sixense");
+    PERFORMANCE_TIMER("sixense");
     if (!_hydrasConnected) {
         _hydrasConnected = true;
         registerToUserInputMapper(*userInputMapper);
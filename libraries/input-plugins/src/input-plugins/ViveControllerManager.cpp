@@ -158,7 +158,7 @@ void ViveControllerManager::deactivate() {
 }
 
 void ViveControllerManager::updateRendering(RenderArgs* args, render::ScenePointer scene, render::PendingChanges pendingChanges) {
-    PerformanceTimer perfTimer("ViveControllerManager::updateRendering");
+    PERFORMANCE_TIMER("ViveControllerManager::updateRendering");
 
     if (_modelLoaded) {
         //auto controllerPayload = new render::Payload<ViveControllerManager>(this);
@@ -230,7 +230,7 @@ void ViveControllerManager::update(float deltaTime, bool jointsCaptured) {
 
     _buttonPressedMap.clear();
 
-    PerformanceTimer perfTimer("ViveControllerManager::update");
+    PERFORMANCE_TIMER("ViveControllerManager::update");
 
     int numTrackedControllers = 0;
 
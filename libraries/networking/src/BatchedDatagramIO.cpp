@@ -0,0 +1,163 @@
+//
+//  BatchedDatagramIO.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BatchedDatagramIO.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <sys/socket.h>
+#endif
+
+#include "NetworkLogging.h"
+
+namespace BatchedDatagramIO {
+
+#ifdef Q_OS_LINUX
+
+    bool isSupported() {
+        return true;
+    }
+
+    int readDatagrams(QUdpSocket& socket, char* const* buffers, qint64 bufferSize, qint64* datagramSizes,
+                      sockaddr_in* senders, int maxDatagrams) {
+        maxDatagrams = std::min(maxDatagrams, MAX_DATAGRAMS_PER_SYSCALL);
+
+        mmsghdr messages[MAX_DATAGRAMS_PER_SYSCALL];
+        iovec vectors[MAX_DATAGRAMS_PER_SYSCALL];
+        memset(messages, 0, sizeof(mmsghdr) * maxDatagrams);
+
+        for (int i = 0; i < maxDatagrams; ++i) {
+            vectors[i].iov_base = buffers[i];
+            vectors[i].iov_len = bufferSize;
+
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &senders[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+
+        int numRead;
+        do {
+            numRead = recvmmsg(socket.socketDescriptor(), messages, maxDatagrams, MSG_DONTWAIT, nullptr);
+        } while (numRead < 0 && errno == EINTR);
+
+        if (numRead < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+
+            qCDebug(networking) << "ERROR in recvmmsg:" << strerror(errno);
+            return -1;
+        }
+
+        for (int i = 0; i < numRead; ++i) {
+            datagramSizes[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : (qint64) messages[i].msg_len;
+        }
+
+        return numRead;
+    }
+
+    int SendQueue::flush(QUdpSocket& socket) {
+        mmsghdr messages[MAX_DATAGRAMS_PER_SYSCALL];
+        iovec vectors[MAX_DATAGRAMS_PER_SYSCALL];
+        sockaddr_in destinations[MAX_DATAGRAMS_PER_SYSCALL];
+
+        int numSyscalls = 0;
+        int numDatagrams = _datagrams.size();
+        int nextDatagram = 0;
+
+        while (nextDatagram < numDatagrams) {
+            int batchSize = std::min(numDatagrams - nextDatagram, MAX_DATAGRAMS_PER_SYSCALL);
+            memset(messages, 0, sizeof(mmsghdr) * batchSize);
+            memset(destinations, 0, sizeof(sockaddr_in) * batchSize);
+
+            for (int i = 0; i < batchSize; ++i) {
+                const QueuedDatagram& datagram = _datagrams[nextDatagram + i];
+
+                destinations[i].sin_family = AF_INET;
+                destinations[i].sin_addr.s_addr = htonl(datagram.address);
+                destinations[i].sin_port = htons(datagram.port);
+
+                vectors[i].iov_base = _data.data() + datagram.offset;
+                vectors[i].iov_len = datagram.size;
+
+                messages[i].msg_hdr.msg_iov = &vectors[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+                messages[i].msg_hdr.msg_name = &destinations[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            }
+
+            int numSent = sendmmsg(socket.socketDescriptor(), messages, batchSize, 0);
+            ++numSyscalls;
+
+            if (numSent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                // sendmmsg stops at the first datagram it can't send, skip it like a failed writeDatagram would
+                qCDebug(networking) << "ERROR in sendmmsg:" << strerror(errno);
+                numSent = 1;
+            }
+
+            nextDatagram += numSent;
+        }
+
+        _datagrams.clear();
+        _data.clear();
+
+        return numSyscalls;
+    }
+
+#else
+
+    bool isSupported() {
+        return false;
+    }
+
+    int readDatagrams(QUdpSocket& socket, char* const* buffers, qint64 bufferSize, qint64* datagramSizes,
+                      sockaddr_in* senders, int maxDatagrams) {
+        return -1;
+    }
+
+    int SendQueue::flush(QUdpSocket& socket) {
+        for (const QueuedDatagram& datagram : _datagrams) {
+            qint64 bytesWritten = socket.writeDatagram(_data.data() + datagram.offset, datagram.size,
+                                                       QHostAddress(datagram.address), datagram.port);
+            if (bytesWritten < 0) {
+                qCDebug(networking) << "ERROR in writeDatagram:" << socket.error() << "-" << socket.errorString();
+            }
+        }
+
+        int numSyscalls = _datagrams.size();
+
+        _datagrams.clear();
+        _data.clear();
+
+        return numSyscalls;
+    }
+
+#endif
+
+    void SendQueue::enqueue(const char* data, qint64 size, const HifiSockAddr& destination) {
+        // the node socket is bound to IPv4 only, so that is all we ever have to address
+        QueuedDatagram datagram;
+        datagram.offset = _data.size();
+        datagram.size = size;
+        datagram.address = destination.getAddress().toIPv4Address();
+        datagram.port = destination.getPort();
+
+        _data.insert(_data.end(), data, data + size);
+        _datagrams.push_back(datagram);
+    }
+}
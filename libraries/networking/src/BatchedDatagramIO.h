@@ -0,0 +1,61 @@
+//
+//  BatchedDatagramIO.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BatchedDatagramIO_h
+#define hifi_BatchedDatagramIO_h
+
+#include <vector>
+
+#include <QtNetwork/QUdpSocket>
+
+#include "HifiSockAddr.h"
+
+// Moves many datagrams through a bound IPv4 QUdpSocket per syscall. On Linux this uses recvmmsg and sendmmsg on the
+// socket's descriptor, everywhere else sends fall back to one QUdpSocket call per datagram and batched reads are
+// unavailable.
+namespace BatchedDatagramIO {
+
+    const int MAX_DATAGRAMS_PER_SYSCALL = 64;
+
+    /// whether readDatagrams can be used on this platform
+    bool isSupported();
+
+    /// reads up to maxDatagrams pending datagrams into the given buffers of bufferSize bytes with one syscall.
+    /// Returns the number read, 0 if nothing was pending, or -1 on error. A datagram that did not fit its buffer
+    /// gets a size of -1 and should be dropped.
+    int readDatagrams(QUdpSocket& socket, char* const* buffers, qint64 bufferSize, qint64* datagramSizes,
+                      sockaddr_in* senders, int maxDatagrams);
+
+    // Copies datagrams in as they are sent and writes them all out with as few syscalls as possible on flush.
+    // Not thread safe, it belongs to whichever thread is batching its sends.
+    class SendQueue {
+    public:
+        void enqueue(const char* data, qint64 size, const HifiSockAddr& destination);
+
+        int getNumQueuedDatagrams() const { return (int) _datagrams.size(); }
+
+        /// sends every queued datagram and returns the number of syscalls that took
+        int flush(QUdpSocket& socket);
+
+    private:
+        struct QueuedDatagram {
+            size_t offset;
+            qint64 size;
+            quint32 address;
+            quint16 port;
+        };
+
+        // the storage is kept between flushes so a steady stream of frames stops allocating
+        std::vector<char> _data;
+        std::vector<QueuedDatagram> _datagrams;
+    };
+}
+
+#endif // hifi_BatchedDatagramIO_h
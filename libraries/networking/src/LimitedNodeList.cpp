@@ -18,6 +18,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QThread>
 #include <QtCore/QUrl>
 #include <QtNetwork/QHostInfo>
 
@@ -186,8 +187,8 @@ bool LimitedNodeList::packetSourceAndHashMatch(const NLPacket& packet, SharedNod
         
         if (matchingNode) {
             if (!NON_VERIFIED_PACKETS.contains(packet.getType())) {
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packet.getVerificationHash() != packet.payloadHashWithConnectionUUID(matchingNode->getConnectionSecret())) {
+                // check if the hash in the header matches the hash we would expect for this connection
+                if (!packet.verificationHashMatches(matchingNode->getVerificationHashKey())) {
                     static QMultiMap<QUuid, PacketType::Value> hashDebugSuppressMap;
                     
                     const QUuid& senderID = packet.getSourceID();
@@ -229,19 +230,31 @@ qint64 LimitedNodeList::writePacket(const NLPacket& packet, const Node& destinat
 
     emit dataSent(destinationNode.getType(), packet.getDataSize());
     
-    return writePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getConnectionSecret());
+    return writePacket(packet, *destinationNode.getActiveSocket(), destinationNode.getVerificationHashKey());
 }
 
 qint64 LimitedNodeList::writePacket(const NLPacket& packet, const HifiSockAddr& destinationSockAddr,
                                     const QUuid& connectionSecret) {
+    // most packets sent without a node have no secret at all, so they share a key rather than deriving one each time
+    static const VerificationHash::Key NULL_KEY;
+    if (connectionSecret.isNull()) {
+        return writePacket(packet, destinationSockAddr, NULL_KEY);
+    }
+
+    // without a node we have nothing negotiated, so a bare connection secret always means MD5
+    return writePacket(packet, destinationSockAddr, VerificationHash::Key(connectionSecret));
+}
+
+qint64 LimitedNodeList::writePacket(const NLPacket& packet, const HifiSockAddr& destinationSockAddr,
+                                    const VerificationHash::Key& verificationHashKey) {
     if (!NON_SOURCED_PACKETS.contains(packet.getType())) {
         const_cast<NLPacket&>(packet).writeSourceID(getSessionUUID());
     }
     
-    if (!connectionSecret.isNull()
+    if (!verificationHashKey.isNull()
         && !NON_SOURCED_PACKETS.contains(packet.getType())
         && !NON_VERIFIED_PACKETS.contains(packet.getType())) {
-        const_cast<NLPacket&>(packet).writeVerificationHash(packet.payloadHashWithConnectionUUID(connectionSecret));
+        const_cast<NLPacket&>(packet).writeVerificationHash(verificationHashKey);
     }
 
     emit dataSent(NodeType::Unassigned, packet.getDataSize());
@@ -255,8 +268,15 @@ qint64 LimitedNodeList::writeDatagram(const QByteArray& datagram, const HifiSock
     ++_numCollectedPackets;
     _numCollectedBytes += datagram.size();
 
+    QThread* sendBatchingThread = _sendBatchingThread.load();
+    if (sendBatchingThread && sendBatchingThread == QThread::currentThread()) {
+        _sendQueue.enqueue(datagram.constData(), datagram.size(), destinationSockAddr);
+        return datagram.size();
+    }
+
     qint64 bytesWritten = _nodeSocket.writeDatagram(datagram,
                                                     destinationSockAddr.getAddress(), destinationSockAddr.getPort());
+    ++_numSendSyscalls;
 
     if (bytesWritten < 0) {
         qCDebug(networking) << "ERROR in writeDatagram:" << _nodeSocket.error() << "-" << _nodeSocket.errorString();
@@ -319,7 +339,7 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
     // use the node's active socket as the destination socket if there is no overriden socket address
     auto& destinationSockAddr = (overridenSockAddr.isNull()) ? *destinationNode.getActiveSocket()
                                                              : overridenSockAddr;
-    return sendPacket(std::move(packet), destinationSockAddr, destinationNode.getConnectionSecret());
+    return writePacket(*packet, destinationSockAddr, destinationNode.getVerificationHashKey());
 }
 
 PacketSequenceNumber LimitedNodeList::getNextSequenceNumberForPacket(const QUuid& nodeUUID, PacketType::Value packetType) {
@@ -412,7 +432,8 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    bool canAdjustLocks, bool canRez,
-                                                   const QUuid& connectionSecret) {
+                                                   const QUuid& connectionSecret,
+                                                   VerificationHash::Method verificationHashMethod) {
     NodeHash::const_iterator it = _nodeHash.find(uuid);
 
     if (it != _nodeHash.end()) {
@@ -423,11 +444,13 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         matchingNode->setCanAdjustLocks(canAdjustLocks);
         matchingNode->setCanRez(canRez);
         matchingNode->setConnectionSecret(connectionSecret);
+        matchingNode->setVerificationHashMethod(verificationHashMethod);
 
         return matchingNode;
     } else {
         // we didn't have this node, so add them
         Node* newNode = new Node(uuid, nodeType, publicSocket, localSocket, canAdjustLocks, canRez, connectionSecret, this);
+        newNode->setVerificationHashMethod(verificationHashMethod);
 
         if (nodeType == NodeType::AudioMixer) {
             LimitedNodeList::flagTimeForConnectionStep(LimitedNodeList::AddedAudioMixer);
@@ -524,9 +547,43 @@ void LimitedNodeList::getPacketStats(float& packetsPerSecond, float& bytesPerSec
 void LimitedNodeList::resetPacketStats() {
     _numCollectedPackets = 0;
     _numCollectedBytes = 0;
+    _numSendSyscalls = 0;
+    _numReceiveSyscalls = 0;
     _packetStatTimer.restart();
 }
 
+void LimitedNodeList::getSyscallStats(int& sendSyscalls, int& receiveSyscalls) const {
+    sendSyscalls = _numSendSyscalls;
+    receiveSyscalls = _numReceiveSyscalls;
+}
+
+void LimitedNodeList::setSendBatchingThread(QThread* thread) {
+    if (_sendBatchingThread.load() && !thread) {
+        // the thread that was batching is expected to be done sending by now
+        flushSendQueue();
+    }
+
+    _sendBatchingThread.store(thread);
+}
+
+void LimitedNodeList::flushSendQueue() {
+    if (_sendQueue.getNumQueuedDatagrams() > 0) {
+        _numSendSyscalls += _sendQueue.flush(_nodeSocket);
+    }
+}
+
+bool LimitedNodeList::claimSendBatching(QThread* thread) {
+    return _sendBatchingThread.testAndSetOrdered(nullptr, thread);
+}
+
+void LimitedNodeList::releaseSendBatching(QThread* thread) {
+    if (_sendBatchingThread.load() == thread) {
+        // flushed before letting go, so that no other thread can queue datagrams while these are sent
+        flushSendQueue();
+        _sendBatchingThread.testAndSetOrdered(thread, nullptr);
+    }
+}
+
 void LimitedNodeList::removeSilentNodes() {
 
     QSet<SharedNodePointer> killedNodes;
@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <unordered_map>
@@ -22,6 +23,7 @@
 #include <unistd.h> // not on windows, not needed for mac or windows
 #endif
 
+#include <QtCore/QAtomicPointer>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QPointer>
 #include <QtCore/QReadWriteLock>
@@ -34,6 +36,7 @@
 
 #include <DependencyManager.h>
 
+#include "BatchedDatagramIO.h"
 #include "DomainHandler.h"
 #include "Node.h"
 #include "NLPacket.h"
@@ -139,7 +142,8 @@ public:
     SharedNodePointer addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                       const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                       bool canAdjustLocks, bool canRez,
-                                      const QUuid& connectionSecret = QUuid());
+                                      const QUuid& connectionSecret = QUuid(),
+                                      VerificationHash::Method verificationHashMethod = VerificationHash::MD5);
 
     bool hasCompletedInitialSTUN() const { return _hasCompletedInitialSTUN; }
 
@@ -156,6 +160,21 @@ public:
     void getPacketStats(float &packetsPerSecond, float &bytesPerSecond);
     void resetPacketStats();
 
+    /// socket calls made on the node socket since the last resetPacketStats
+    void getSyscallStats(int& sendSyscalls, int& receiveSyscalls) const;
+    void addReceiveSyscalls(int numSyscalls) { _numReceiveSyscalls += numSyscalls; }
+
+    /// datagrams sent from the given thread are queued until it calls flushSendQueue, so that a mixer can send its
+    /// whole frame with a handful of syscalls. Pass nullptr to stop batching, anything still queued is sent then.
+    void setSendBatchingThread(QThread* thread);
+    QThread* getSendBatchingThread() const { return _sendBatchingThread.load(); }
+    void flushSendQueue();
+
+    /// has thread batch its sends unless another thread already does, returns true if thread is now batching
+    bool claimSendBatching(QThread* thread);
+    /// called from thread once it is done sending, sends what it queued and stops batching if thread is batching
+    void releaseSendBatching(QThread* thread);
+
     std::unique_ptr<NLPacket> constructPingPacket(PingType_t pingType = PingType::Agnostic);
     std::unique_ptr<NLPacket> constructPingReplyPacket(NLPacket& pingPacket);
 
@@ -252,6 +271,8 @@ protected:
     qint64 writePacket(const NLPacket& packet, const Node& destinationNode);
     qint64 writePacket(const NLPacket& packet, const HifiSockAddr& destinationSockAddr,
                        const QUuid& connectionSecret = QUuid());
+    qint64 writePacket(const NLPacket& packet, const HifiSockAddr& destinationSockAddr,
+                       const VerificationHash::Key& verificationHashKey);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& destinationSockAddr);
 
     PacketSequenceNumber getNextSequenceNumberForPacket(const QUuid& nodeUUID, PacketType::Value packetType);
@@ -283,6 +304,12 @@ protected:
     // XXX can BandwidthRecorder be used for this?
     int _numCollectedPackets;
     int _numCollectedBytes;
+    // counted on the sending and receiving threads, read and reset from the stats timer
+    std::atomic<int> _numSendSyscalls { 0 };
+    std::atomic<int> _numReceiveSyscalls { 0 };
+
+    QAtomicPointer<QThread> _sendBatchingThread;
+    BatchedDatagramIO::SendQueue _sendQueue;
 
     QElapsedTimer _packetStatTimer;
     bool _thisNodeCanAdjustLocks;
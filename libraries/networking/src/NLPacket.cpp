@@ -13,7 +13,8 @@
 
 qint64 NLPacket::localHeaderSize(PacketType::Value type) {
     qint64 size = ((NON_SOURCED_PACKETS.contains(type)) ? 0 : NUM_BYTES_RFC4122_UUID) +
-                    ((NON_SOURCED_PACKETS.contains(type) || NON_VERIFIED_PACKETS.contains(type)) ? 0 : NUM_BYTES_MD5_HASH);
+                    ((NON_SOURCED_PACKETS.contains(type) || NON_VERIFIED_PACKETS.contains(type))
+                        ? 0 : VerificationHash::NUM_BYTES_HASH);
     return size;
 }
 
@@ -92,7 +93,16 @@ NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr
     _payloadSize = _payloadCapacity;
     
     readSourceID();
-    readVerificationHash();
+}
+
+void NLPacket::resetForReceivedData(qint64 size, const HifiSockAddr& senderSockAddr) {
+    Packet::resetForReceivedData(size, senderSockAddr);
+
+    adjustPayloadStartAndCapacity();
+    _payloadSize = _payloadCapacity;
+
+    _sourceID = QUuid();
+    readSourceID();
 }
 
 void NLPacket::adjustPayloadStartAndCapacity() {
@@ -108,13 +118,6 @@ void NLPacket::readSourceID() {
     }
 }
 
-void NLPacket::readVerificationHash() {
-    if (!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type)) {
-        auto offset = Packet::localHeaderSize() + NUM_BYTES_RFC4122_UUID;
-        _verificationHash = QByteArray(_packet.get() + offset, NUM_BYTES_MD5_HASH);
-    }
-}
-
 void NLPacket::writeSourceID(const QUuid& sourceID) {
     Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type));
     
@@ -124,22 +127,17 @@ void NLPacket::writeSourceID(const QUuid& sourceID) {
     _sourceID = sourceID;
 }
 
-void NLPacket::writeVerificationHash(const QByteArray& verificationHash) {
+void NLPacket::writeVerificationHash(const VerificationHash::Key& key) {
     Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type));
 
-    auto offset = Packet::localHeaderSize() + NUM_BYTES_RFC4122_UUID;
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
-    
-    _verificationHash = verificationHash;
+    key.hash(_payloadStart, _payloadSize, verificationHashStart());
 }
 
-QByteArray NLPacket::payloadHashWithConnectionUUID(const QUuid& connectionUUID) const {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
-    // add the packet payload and the connection UUID
-    hash.addData(_payloadStart, _payloadSize);
-    hash.addData(connectionUUID.toRfc4122());
-    
-    // return the hash
-    return hash.result();
+bool NLPacket::verificationHashMatches(const VerificationHash::Key& key) const {
+    Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type));
+
+    char expectedHash[VerificationHash::NUM_BYTES_HASH];
+    key.hash(_payloadStart, _payloadSize, expectedHash);
+
+    return memcmp(expectedHash, verificationHashStart(), VerificationHash::NUM_BYTES_HASH) == 0;
 }
@@ -15,6 +15,7 @@
 #include <QtCore/QSharedPointer>
 
 #include "udt/Packet.h"
+#include "VerificationHash.h"
 
 class NLPacket : public Packet {
     Q_OBJECT
@@ -31,13 +32,18 @@ public:
     virtual qint64 totalHeadersSize() const; // Cumulated size of all the headers
     virtual qint64 localHeaderSize() const;  // Current level's header size
 
+    /// reads the headers of a datagram that was read straight into getData(), see ReceivedPacketPool
+    void resetForReceivedData(qint64 size, const HifiSockAddr& senderSockAddr);
+
     const QUuid& getSourceID() const { return _sourceID; }
-    const QByteArray& getVerificationHash() const { return _verificationHash; }
     
     void writeSourceID(const QUuid& sourceID);
-    void writeVerificationHash(const QByteArray& verificationHash);
 
-    QByteArray payloadHashWithConnectionUUID(const QUuid& connectionUUID) const;
+    /// hashes the payload with the given connection key straight into the verification hash in the header
+    void writeVerificationHash(const VerificationHash::Key& key);
+
+    /// checks the verification hash in the header against the one we would write with the given connection key
+    bool verificationHashMatches(const VerificationHash::Key& key) const;
 
 protected:
     
@@ -49,10 +55,10 @@ protected:
     NLPacket(const NLPacket& other);
 
     void readSourceID();
-    void readVerificationHash();
+
+    char* verificationHashStart() const { return _packet.get() + Packet::localHeaderSize() + NUM_BYTES_RFC4122_UUID; }
 
     QUuid _sourceID;
-    QByteArray _verificationHash;
 };
 
 #endif // hifi_NLPacket_h
@@ -45,7 +45,7 @@ Node::Node(const QUuid& uuid, NodeType_t type, const HifiSockAddr& publicSocket,
            QObject* parent) :
     NetworkPeer(uuid, publicSocket, localSocket, parent),
     _type(type),
-    _connectionSecret(connectionSecret),
+    _verificationHashKey(connectionSecret),
     _linkedData(NULL),
     _isAlive(true),
     _pingMs(-1),  // "Uninitialized"
@@ -62,6 +62,25 @@ Node::~Node() {
     delete _linkedData;
 }
 
+VerificationHash::Key Node::getVerificationHashKey() const {
+    QReadLocker readLocker(&_verificationHashKeyLock);
+    return _verificationHashKey;
+}
+
+void Node::setConnectionSecret(const QUuid& connectionSecret) {
+    QWriteLocker writeLocker(&_verificationHashKeyLock);
+    if (connectionSecret != _verificationHashKey.getConnectionSecret()) {
+        _verificationHashKey = VerificationHash::Key(connectionSecret, _verificationHashKey.getMethod());
+    }
+}
+
+void Node::setVerificationHashMethod(VerificationHash::Method method) {
+    QWriteLocker writeLocker(&_verificationHashKeyLock);
+    if (method != _verificationHashKey.getMethod()) {
+        _verificationHashKey = VerificationHash::Key(_verificationHashKey.getConnectionSecret(), method);
+    }
+}
+
 void Node::updateClockSkewUsec(int clockSkewSample) {
     _clockSkewMovingPercentile.updatePercentile((float)clockSkewSample);
     _clockSkewUsec = (int)_clockSkewMovingPercentile.getValueAtPercentile();
@@ -17,6 +17,7 @@
 
 #include <QtCore/QDebug>
 #include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QUuid>
 
@@ -26,6 +27,7 @@
 #include "NodeType.h"
 #include "udt/PacketHeaders.h"
 #include "SimpleMovingAverage.h"
+#include "VerificationHash.h"
 #include "MovingPercentile.h"
 
 class Node : public NetworkPeer {
@@ -43,8 +45,14 @@ public:
     char getType() const { return _type; }
     void setType(char type) { _type = type; }
 
-    const QUuid& getConnectionSecret() const { return _connectionSecret; }
-    void setConnectionSecret(const QUuid& connectionSecret) { _connectionSecret = connectionSecret; }
+    QUuid getConnectionSecret() const { return getVerificationHashKey().getConnectionSecret(); }
+    void setConnectionSecret(const QUuid& connectionSecret);
+
+    VerificationHash::Method getVerificationHashMethod() const { return getVerificationHashKey().getMethod(); }
+    void setVerificationHashMethod(VerificationHash::Method method);
+
+    /// a copy, since the secret and method can be set by the node list's thread while another thread is sending
+    VerificationHash::Key getVerificationHashKey() const;
 
     NodeData* getLinkedData() const { return _linkedData; }
     void setLinkedData(NodeData* linkedData) { _linkedData = linkedData; }
@@ -79,7 +87,8 @@ private:
 
     NodeType_t _type;
 
-    QUuid _connectionSecret;
+    VerificationHash::Key _verificationHashKey;
+    mutable QReadWriteLock _verificationHashKeyLock;
     NodeData* _linkedData;
     bool _isAlive;
     int _pingMs;
@@ -277,6 +277,9 @@ void NodeList::sendDomainServerCheckIn() {
         
         // if this is a connect request, and we can present a username signature, send it along
         if (!_domainHandler.isConnected() ) {
+
+            // let the domain-server know the newest packet verification hash we can use with other nodes
+            packetStream << (quint8) VerificationHash::BEST_METHOD;
             
             DataServerAccountInfo& accountInfo = AccountManager::getInstance().getAccountInfo();
             packetStream << accountInfo.getUsername();
@@ -534,11 +537,15 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
         nodePublicSocket.setAddress(_domainHandler.getIP());
     }
 
-    packetStream >> connectionUUID;
+    quint8 verificationHashMethod;
+    packetStream >> connectionUUID >> verificationHashMethod;
 
     SharedNodePointer node = addOrUpdateNode(nodeUUID, nodeType, nodePublicSocket,
                                              nodeLocalSocket, canAdjustLocks, canRez,
-                                             connectionUUID);
+                                             connectionUUID,
+                                             VerificationHash::methodForConnection(
+                                                 (VerificationHash::Method) verificationHashMethod,
+                                                 VerificationHash::BEST_METHOD));
 }
 
 void NodeList::sendAssignment(Assignment& assignment) {
@@ -12,6 +12,7 @@
 
 #include "PacketReceiver.h"
 
+#include "BatchedDatagramIO.h"
 #include "DependencyManager.h"
 #include "NetworkLogging.h"
 #include "NodeList.h"
@@ -171,9 +172,38 @@ void PacketReceiver::registerVerifiedListener(PacketType::Value type, QObject* o
 
 }
 
+bool PacketReceiver::registerDirectCallback(PacketType::Value type, QObject* owner, PacketCallback callback) {
+    Q_ASSERT(owner);
+    Q_ASSERT(callback);
+
+    _packetListenerLock.lock();
+
+    if (_directCallbackMap.contains(type) || _packetListenerMap.value(type).second.isValid()) {
+        qDebug() << "Warning: Registering a direct packet callback for packet type" << type
+            << "(" << qPrintable(nameForPacketType(type)) << ")"
+            << "that will take over from a previously registered listener";
+    }
+
+    _directCallbackMap[type] = ObjectCallbackPair(QPointer<QObject>(owner), callback);
+
+    _packetListenerLock.unlock();
+
+    return true;
+}
+
 void PacketReceiver::unregisterListener(QObject* listener) {
     _packetListenerLock.lock();
 
+    auto callbackIt = _directCallbackMap.begin();
+
+    while (callbackIt != _directCallbackMap.end()) {
+        if (callbackIt.value().first == listener) {
+            callbackIt = _directCallbackMap.erase(callbackIt);
+        } else {
+            ++callbackIt;
+        }
+    }
+
     auto it = _packetListenerMap.begin();
 
     while (it != _packetListenerMap.end()) {
@@ -234,149 +264,255 @@ bool PacketReceiver::packetVersionMatch(const NLPacket& packet) {
     }
 }
 
+void PacketReceiver::noteDeliveredPacket(const NLPacket& packet, const SharedNodePointer& sendingNode) {
+    if (sendingNode) {
+        // if this was a sequence numbered packet we should store the last seq number for
+        // a packet of this type for this node
+        if (SEQUENCE_NUMBERED_PACKETS.contains(packet.getType())) {
+            sendingNode->setLastSequenceNumberForPacketType(packet.readSequenceNumber(), packet.getType());
+        }
+
+        emit dataReceived(sendingNode->getType(), packet.getDataSize());
+    } else {
+        emit dataReceived(NodeType::Unassigned, packet.getDataSize());
+    }
+}
+
 void PacketReceiver::processDatagrams() {
     //PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                             //"PacketReceiver::processDatagrams()");
 
     auto nodeList = DependencyManager::get<LimitedNodeList>();
+    if (!nodeList) {
+        return;
+    }
+
+    QUdpSocket& nodeSocket = nodeList->getNodeSocket();
+
+    // QUdpSocket only re-arms its read notifier from readDatagram, so the first datagram always goes through it
+    bool hasReadThroughSocket = false;
+    bool useBatchedReads = BatchedDatagramIO::isSupported();
 
-    while (nodeList && nodeList->getNodeSocket().hasPendingDatagrams()) {
-        // setup a buffer to read the packet into
-        int packetSizeWithHeader = nodeList->getNodeSocket().pendingDatagramSize();
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+    // start with the hasPendingDatagrams call that ends the loop
+    int numSyscalls = 1;
+
+    while (nodeSocket.hasPendingDatagrams()) {
+        ++numSyscalls;
 
         // if we're supposed to drop this packet then break out here
         if (_shouldDropPackets) {
             break;
         }
 
+        if (hasReadThroughSocket && useBatchedReads) {
+            ++numSyscalls;
+
+            if (readDatagramBatch(*nodeList) >= 0) {
+                continue;
+            }
+
+            // something is wrong with batched reads, finish this call one datagram at a time
+            useBatchedReads = false;
+        }
+
+        int packetSizeWithHeader = nodeSocket.pendingDatagramSize();
+
         // setup a HifiSockAddr to read into
         HifiSockAddr senderSockAddr;
 
-        // pull the datagram
-        nodeList->getNodeSocket().readDatagram(buffer.get(), packetSizeWithHeader,
-                                               senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+        QSharedPointer<NLPacket> packet;
+
+        if (packetSizeWithHeader <= MAX_PACKET_SIZE) {
+            // pull the datagram straight into a recycled packet
+            packet = _packetPool.acquire();
+
+            nodeSocket.readDatagram(packet->getData(), packetSizeWithHeader,
+                                    senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+
+            packet->resetForReceivedData(packetSizeWithHeader, senderSockAddr);
+        } else {
+            // we never send datagrams this large, but still read it out so that it is dropped below like before
+            auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+
+            nodeSocket.readDatagram(buffer.get(), packetSizeWithHeader,
+                                    senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
+
+            packet = QSharedPointer<NLPacket>(NLPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader,
+                                                                           senderSockAddr).release());
+        }
+
+        numSyscalls += 2;
+        hasReadThroughSocket = true;
+
+        handleReceivedPacket(packet, *nodeList);
+    }
+
+    nodeList->addReceiveSyscalls(numSyscalls);
+}
+
+int PacketReceiver::readDatagramBatch(LimitedNodeList& nodeList) {
+    const int MAX_DATAGRAMS_PER_BATCH = BatchedDatagramIO::MAX_DATAGRAMS_PER_SYSCALL;
+
+    // packets stay in the batch until a datagram is read into them, so only the ones we hand on need replacing
+    _batchPackets.resize(MAX_DATAGRAMS_PER_BATCH);
+
+    char* buffers[MAX_DATAGRAMS_PER_BATCH];
+    qint64 datagramSizes[MAX_DATAGRAMS_PER_BATCH];
+    sockaddr_in senders[MAX_DATAGRAMS_PER_BATCH];
+
+    for (int i = 0; i < MAX_DATAGRAMS_PER_BATCH; ++i) {
+        if (!_batchPackets[i]) {
+            _batchPackets[i] = _packetPool.acquire();
+        }
+        buffers[i] = _batchPackets[i]->getData();
+    }
+
+    int numDatagrams = BatchedDatagramIO::readDatagrams(nodeList.getNodeSocket(), buffers, MAX_PACKET_SIZE,
+                                                        datagramSizes, senders, MAX_DATAGRAMS_PER_BATCH);
+
+    for (int i = 0; i < numDatagrams; ++i) {
+        if (datagramSizes[i] < 0) {
+            // larger than anything we send, leave the packet in the batch to be read into again
+            continue;
+        }
+
+        QSharedPointer<NLPacket> packet;
+        packet.swap(_batchPackets[i]);
+
+        packet->resetForReceivedData(datagramSizes[i], HifiSockAddr(reinterpret_cast<const sockaddr*>(&senders[i])));
+
+        handleReceivedPacket(packet, nodeList);
+    }
 
-        // setup an NLPacket from the data we just read
-        auto packet = NLPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+    return numDatagrams;
+}
+
+void PacketReceiver::handleReceivedPacket(const QSharedPointer<NLPacket>& packet, LimitedNodeList& nodeList) {
+    _inPacketCount++;
+    _inByteCount += packet->getDataSize();
+
+    if (packetVersionMatch(*packet)) {
         
-        _inPacketCount++;
-        _inByteCount += packetSizeWithHeader;
+        SharedNodePointer matchingNode;
+        if (nodeList.packetSourceAndHashMatch(*packet, matchingNode)) {
 
-        if (packetVersionMatch(*packet)) {
-            
-            SharedNodePointer matchingNode;
-            if (nodeList->packetSourceAndHashMatch(*packet, matchingNode)) {
+            if (matchingNode) {
+                // No matter if this packet is handled or not, we update the timestamp for the last time we heard
+                // from this sending node
+                matchingNode->setLastHeardMicrostamp(usecTimestampNow());
+            }
+
+            _packetListenerLock.lock();
 
-                if (matchingNode) {
-                    // No matter if this packet is handled or not, we update the timestamp for the last time we heard
-                    // from this sending node
-                    matchingNode->setLastHeardMicrostamp(usecTimestampNow());
+            PacketType::Value packetType = packet->getType();
+
+            // direct callbacks skip the QMetaMethod machinery below entirely
+            auto callbackIt = _directCallbackMap.find(packetType);
+
+            if (callbackIt != _directCallbackMap.end()) {
+                if (callbackIt.value().first) {
+                    noteDeliveredPacket(*packet, matchingNode);
+                    callbackIt.value().second(packet, matchingNode);
+
+                    _packetListenerLock.unlock();
+                    return;
                 }
 
-                _packetListenerLock.lock();
-                
-                bool listenerIsDead = false;
+                // the owner is gone, fall back to whatever listener there is for this type
+                qDebug().nospace() << "Owner of the direct callback for packet " << packetType
+                    << " (" << qPrintable(nameForPacketType(packetType)) << ")"
+                    << " has been destroyed. Removing from callback map.";
+                _directCallbackMap.erase(callbackIt);
+            }
+            
+            bool listenerIsDead = false;
 
-                auto it = _packetListenerMap.find(packet->getType());
+            auto it = _packetListenerMap.find(packetType);
 
-                if (it != _packetListenerMap.end() && it->second.isValid()) {
+            if (it != _packetListenerMap.end() && it->second.isValid()) {
 
-                    auto listener = it.value();
+                auto listener = it.value();
 
-                    if (listener.first) {
+                if (listener.first) {
 
-                        bool success = false;
-                        
-                        // check if this is a directly connected listener
-                        _directConnectSetMutex.lock();
-                        
-                        Qt::ConnectionType connectionType =
-                            _directlyConnectedObjects.contains(listener.first) ? Qt::DirectConnection : Qt::AutoConnection;
-                        
-                        _directConnectSetMutex.unlock();
-                        
-                        PacketType::Value packetType = packet->getType();
-                        
-                        if (matchingNode) {
-                            // if this was a sequence numbered packet we should store the last seq number for
-                            // a packet of this type for this node
-                            if (SEQUENCE_NUMBERED_PACKETS.contains(packet->getType())) {
-                                matchingNode->setLastSequenceNumberForPacketType(packet->readSequenceNumber(), packet->getType());
-                            }
+                    bool success = false;
+                    
+                    // check if this is a directly connected listener
+                    _directConnectSetMutex.lock();
+                    
+                    Qt::ConnectionType connectionType =
+                        _directlyConnectedObjects.contains(listener.first) ? Qt::DirectConnection : Qt::AutoConnection;
+                    
+                    _directConnectSetMutex.unlock();
+                    
+                    noteDeliveredPacket(*packet, matchingNode);
+
+                    if (matchingNode) {
+                        QMetaMethod metaMethod = listener.second;
 
-                            emit dataReceived(matchingNode->getType(), packet->getDataSize());
-                            QMetaMethod metaMethod = listener.second;
-
-                            static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
-                            static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
-                            
-                            // one final check on the QPointer before we go to invoke
-                            if (listener.first) {
-                                if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
-                                    success = metaMethod.invoke(listener.first,
-                                                                connectionType,
-                                                                Q_ARG(QSharedPointer<NLPacket>,
-                                                                      QSharedPointer<NLPacket>(packet.release())),
-                                                                Q_ARG(SharedNodePointer, matchingNode));
-                                    
-                                } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
-                                    success = metaMethod.invoke(listener.first,
-                                                                connectionType,
-                                                                Q_ARG(QSharedPointer<NLPacket>,
-                                                                      QSharedPointer<NLPacket>(packet.release())),
-                                                                Q_ARG(QSharedPointer<Node>, matchingNode));
-                                    
-                                } else {
-                                    success = metaMethod.invoke(listener.first,
-                                                                connectionType,
-                                                                Q_ARG(QSharedPointer<NLPacket>,
-                                                                      QSharedPointer<NLPacket>(packet.release())));
-                                }
+                        static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
+                        static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
+                        
+                        // one final check on the QPointer before we go to invoke
+                        if (listener.first) {
+                            if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
+                                success = metaMethod.invoke(listener.first,
+                                                            connectionType,
+                                                            Q_ARG(QSharedPointer<NLPacket>, packet),
+                                                            Q_ARG(SharedNodePointer, matchingNode));
+                                
+                            } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
+                                success = metaMethod.invoke(listener.first,
+                                                            connectionType,
+                                                            Q_ARG(QSharedPointer<NLPacket>, packet),
+                                                            Q_ARG(QSharedPointer<Node>, matchingNode));
+                                
                             } else {
-                                listenerIsDead = true;
+                                success = metaMethod.invoke(listener.first,
+                                                            connectionType,
+                                                            Q_ARG(QSharedPointer<NLPacket>, packet));
                             }
-                            
                         } else {
-                            emit dataReceived(NodeType::Unassigned, packet->getDataSize());
-
-                            success = listener.second.invoke(listener.first,
-                                Q_ARG(QSharedPointer<NLPacket>, QSharedPointer<NLPacket>(packet.release())));
+                            listenerIsDead = true;
                         }
-
-                        if (!success) {
-                            qDebug().nospace() << "Error delivering packet " << packetType
-                                << " (" << qPrintable(nameForPacketType(packetType)) << ") to listener "
-                                << listener.first << "::" << qPrintable(listener.second.methodSignature());
-                        }
-
+                        
                     } else {
-                        listenerIsDead = true;
+                        success = listener.second.invoke(listener.first,
+                            Q_ARG(QSharedPointer<NLPacket>, packet));
                     }
-                    
-                    if (listenerIsDead) {
-                        qDebug().nospace() << "Listener for packet" << packet->getType()
-                            << " (" << qPrintable(nameForPacketType(packet->getType())) << ")"
-                            << " has been destroyed. Removing from listener map.";
-                        it = _packetListenerMap.erase(it);
-                        
-                        // if it exists, remove the listener from _directlyConnectedObjects
-                        _directConnectSetMutex.lock();
-                        _directlyConnectedObjects.remove(listener.first);
-                        _directConnectSetMutex.unlock();
+
+                    if (!success) {
+                        qDebug().nospace() << "Error delivering packet " << packetType
+                            << " (" << qPrintable(nameForPacketType(packetType)) << ") to listener "
+                            << listener.first << "::" << qPrintable(listener.second.methodSignature());
                     }
-                    
+
                 } else {
-                    if (it == _packetListenerMap.end()) {
-                        qWarning() << "No listener found for packet type " << nameForPacketType(packet->getType());
-                        
-                        // insert a dummy listener so we don't print this again
-                        _packetListenerMap.insert(packet->getType(), { nullptr, QMetaMethod() });
-                    }
+                    listenerIsDead = true;
+                }
+                
+                if (listenerIsDead) {
+                    qDebug().nospace() << "Listener for packet" << packetType
+                        << " (" << qPrintable(nameForPacketType(packetType)) << ")"
+                        << " has been destroyed. Removing from listener map.";
+                    it = _packetListenerMap.erase(it);
+                    
+                    // if it exists, remove the listener from _directlyConnectedObjects
+                    _directConnectSetMutex.lock();
+                    _directlyConnectedObjects.remove(listener.first);
+                    _directConnectSetMutex.unlock();
+                }
+                
+            } else {
+                if (it == _packetListenerMap.end()) {
+                    qWarning() << "No listener found for packet type " << nameForPacketType(packetType);
+                    
+                    // insert a dummy listener so we don't print this again
+                    _packetListenerMap.insert(packetType, { nullptr, QMetaMethod() });
                 }
-
-                _packetListenerLock.unlock();
             }
+
+            _packetListenerLock.unlock();
         }
     }
 }
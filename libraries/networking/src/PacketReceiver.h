@@ -13,6 +13,9 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <functional>
+#include <vector>
+
 #include <QtCore/QMap>
 #include <QtCore/QMetaMethod>
 #include <QtCore/QMutex>
@@ -21,14 +24,19 @@
 #include <QtCore/QSet>
 
 #include "NLPacket.h"
+#include "Node.h"
+#include "ReceivedPacketPool.h"
 #include "udt/PacketHeaders.h"
 
 class EntityEditPacketSender;
+class LimitedNodeList;
 class OctreePacketProcessor;
 
 class PacketReceiver : public QObject {
     Q_OBJECT
 public:
+    using PacketCallback = std::function<void(QSharedPointer<NLPacket>, SharedNodePointer)>;
+
     PacketReceiver(QObject* parent = 0);
     PacketReceiver(const PacketReceiver&) = delete;
 
@@ -45,6 +53,17 @@ public:
     bool registerListener(PacketType::Value type, QObject* listener, const char* slot);
     void unregisterListener(QObject* listener);
 
+    // Direct callbacks are called straight from processDatagrams, on the thread that reads the node socket, without a
+    // QMetaMethod lookup or invoke. They are meant for hot packet types whose handlers are safe to run there.
+    // A callback for a type takes precedence over a listener for it and is dropped along with its owner.
+    template<typename T>
+    bool registerDirectCallback(PacketType::Value type, T* owner,
+                                void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer));
+    template<typename T>
+    bool registerDirectCallbackForTypes(const QSet<PacketType::Value>& types, T* owner,
+                                        void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer));
+    bool registerDirectCallback(PacketType::Value type, QObject* owner, PacketCallback callback);
+
 public slots:
     void processDatagrams();
 
@@ -60,13 +79,23 @@ private:
     
     bool packetVersionMatch(const NLPacket& packet);
 
+    void noteDeliveredPacket(const NLPacket& packet, const SharedNodePointer& sendingNode);
+    void handleReceivedPacket(const QSharedPointer<NLPacket>& packet, LimitedNodeList& nodeList);
+
+    // reads whatever is pending with one batched syscall, returns the number of datagrams read or -1 on error
+    int readDatagramBatch(LimitedNodeList& nodeList);
+
     QMetaMethod matchingMethodForListener(PacketType::Value type, QObject* object, const char* slot) const;
     void registerVerifiedListener(PacketType::Value type, QObject* listener, const QMetaMethod& slot);
     
     using ObjectMethodPair = std::pair<QPointer<QObject>, QMetaMethod>;
+    using ObjectCallbackPair = std::pair<QPointer<QObject>, PacketCallback>;
 
     QMutex _packetListenerLock;
     QHash<PacketType::Value, ObjectMethodPair> _packetListenerMap;
+    QHash<PacketType::Value, ObjectCallbackPair> _directCallbackMap;
+    ReceivedPacketPool _packetPool;
+    std::vector<QSharedPointer<NLPacket>> _batchPackets;
     int _inPacketCount = 0;
     int _inByteCount = 0;
     bool _shouldDropPackets = false;
@@ -77,4 +106,24 @@ private:
     friend class OctreePacketProcessor;
 };
 
+template<typename T>
+bool PacketReceiver::registerDirectCallback(PacketType::Value type, T* owner,
+                                            void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer)) {
+    return registerDirectCallback(type, owner, [owner, method](QSharedPointer<NLPacket> packet, SharedNodePointer node) {
+        (owner->*method)(packet, node);
+    });
+}
+
+template<typename T>
+bool PacketReceiver::registerDirectCallbackForTypes(const QSet<PacketType::Value>& types, T* owner,
+                                                    void (T::*method)(QSharedPointer<NLPacket>, SharedNodePointer)) {
+    foreach(PacketType::Value type, types) {
+        if (!registerDirectCallback(type, owner, method)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 #endif // hifi_PacketReceiver_h
@@ -40,7 +40,8 @@ PacketSender::PacketSender(int packetsPerSecond) :
     _totalPacketsSent(0),
     _totalBytesSent(0),
     _totalPacketsQueued(0),
-    _totalBytesQueued(0)
+    _totalBytesQueued(0),
+    _hasPendingWake(false)
 {
 }
 
@@ -57,7 +58,7 @@ void PacketSender::queuePacketForSending(const SharedNodePointer& destinationNod
     unlock();
 
     // Make sure to  wake our actual processing thread because we  now have packets for it to process.
-    _hasPackets.wakeAll();
+    wakeSendingThread();
 }
 
 void PacketSender::setPacketsPerSecond(int packetsPerSecond) {
@@ -73,12 +74,23 @@ bool PacketSender::process() {
 }
 
 void PacketSender::terminating() {
+    wakeSendingThread();
+}
+
+void PacketSender::wakeSendingThread() {
+    QMutexLocker locker(&_waitingOnPacketsMutex);
+    _hasPendingWake = true;
     _hasPackets.wakeAll();
 }
 
 bool PacketSender::threadedProcess() {
     bool hasSlept = false;
 
+    // a wake from here on, while we are still working out how long to wait, keeps us from waiting at all
+    _waitingOnPacketsMutex.lock();
+    _hasPendingWake = false;
+    _waitingOnPacketsMutex.unlock();
+
     if (_lastSendTime == 0) {
         _lastSendTime = usecTimestampNow();
     }
@@ -118,9 +130,13 @@ bool PacketSender::threadedProcess() {
 
     // if threaded and we haven't slept? We want to wait for our consumer to signal us with new packets
     if (!hasSlept) {
-        // wait till we have packets
+        // wait till we have packets. The wait time is worked out before taking the mutex, since a subclass may need
+        // its own lock for it, which it can hold while it wakes us.
+        unsigned long maxWaitMsecs = getMaxWaitForPacketsMsecs();
         _waitingOnPacketsMutex.lock();
-        _hasPackets.wait(&_waitingOnPacketsMutex);
+        if (!_hasPendingWake) {
+            _hasPackets.wait(&_waitingOnPacketsMutex, maxWaitMsecs);
+        }
         _waitingOnPacketsMutex.unlock();
     }
 
@@ -14,6 +14,8 @@
 #ifndef hifi_PacketSender_h
 #define hifi_PacketSender_h
 
+#include <climits>
+
 #include <QWaitCondition>
 
 #include "GenericThread.h"
@@ -93,6 +95,13 @@ public:
 signals:
     void packetSent(quint64);
 protected:
+    /// the longest the sending thread waits for packets to be queued before calling process() again, in msecs
+    virtual unsigned long getMaxWaitForPacketsMsecs() const { return ULONG_MAX; }
+
+    /// wakes the sending thread if it is waiting for packets, so that it calls process() again. If the thread is
+    /// about to wait, it calls process() again instead.
+    void wakeSendingThread();
+
     int _packetsPerSecond;
     int _usecsPerProcessCallHint;
     quint64 _lastProcessCallTime;
@@ -117,6 +126,7 @@ private:
 
     QWaitCondition _hasPackets;
     QMutex _waitingOnPacketsMutex;
+    bool _hasPendingWake; // guarded by _waitingOnPacketsMutex
 };
 
 #endif // hifi_PacketSender_h
@@ -0,0 +1,95 @@
+//
+//  ReceivedPacketPool.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedPacketPool.h"
+
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+class ReceivedPacketPool::Storage {
+public:
+    Storage(int maxFreePackets) : maxFreePackets(maxFreePackets) { }
+    ~Storage();
+
+    NLPacket* take();
+    void release(NLPacket* packet);
+
+    const int maxFreePackets;
+
+    mutable QMutex mutex;
+    std::vector<NLPacket*> freePackets;
+    int numAllocatedPackets = 0;
+};
+
+ReceivedPacketPool::Storage::~Storage() {
+    for (NLPacket* packet : freePackets) {
+        delete packet;
+    }
+}
+
+NLPacket* ReceivedPacketPool::Storage::take() {
+    {
+        QMutexLocker locker(&mutex);
+
+        if (!freePackets.empty()) {
+            NLPacket* packet = freePackets.back();
+            freePackets.pop_back();
+            return packet;
+        }
+
+        ++numAllocatedPackets;
+    }
+
+    // a packet created with the default size has a buffer of MAX_PACKET_SIZE
+    return NLPacket::create(PacketType::Unknown).release();
+}
+
+void ReceivedPacketPool::Storage::release(NLPacket* packet) {
+    {
+        QMutexLocker locker(&mutex);
+
+        if ((int) freePackets.size() < maxFreePackets) {
+            freePackets.push_back(packet);
+            return;
+        }
+
+        --numAllocatedPackets;
+    }
+
+    // a listener sat on more packets than we keep around, let this one go
+    delete packet;
+}
+
+ReceivedPacketPool::ReceivedPacketPool(int maxFreePackets) :
+    _storage(std::make_shared<Storage>(maxFreePackets))
+{
+    // reserve up front so returning a packet never allocates
+    _storage->freePackets.reserve(maxFreePackets);
+}
+
+QSharedPointer<NLPacket> ReceivedPacketPool::acquire() {
+    std::shared_ptr<Storage> storage = _storage;
+
+    return QSharedPointer<NLPacket>(storage->take(), [storage](NLPacket* packet) {
+        storage->release(packet);
+    });
+}
+
+int ReceivedPacketPool::getNumAllocatedPackets() const {
+    QMutexLocker locker(&_storage->mutex);
+    return _storage->numAllocatedPackets;
+}
+
+int ReceivedPacketPool::getNumFreePackets() const {
+    QMutexLocker locker(&_storage->mutex);
+    return _storage->freePackets.size();
+}
@@ -0,0 +1,48 @@
+//
+//  ReceivedPacketPool.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedPacketPool_h
+#define hifi_ReceivedPacketPool_h
+
+#include <memory>
+
+#include <QtCore/QSharedPointer>
+
+#include "NLPacket.h"
+
+// Recycles the packets PacketReceiver reads datagrams into. Every pooled packet owns a MAX_PACKET_SIZE buffer and goes
+// back to the pool when the last QSharedPointer to it is dropped, on whatever thread that happens.
+class ReceivedPacketPool {
+public:
+    static const int DEFAULT_MAX_FREE_PACKETS = 1024;
+
+    ReceivedPacketPool(int maxFreePackets = DEFAULT_MAX_FREE_PACKETS);
+    ReceivedPacketPool(const ReceivedPacketPool&) = delete;
+
+    ReceivedPacketPool& operator=(const ReceivedPacketPool&) = delete;
+
+    /// returns a packet that can hold any datagram up to MAX_PACKET_SIZE. Read the datagram into getData() and then
+    /// call NLPacket::resetForReceivedData before handing it on
+    QSharedPointer<NLPacket> acquire();
+
+    /// the number of packets the pool has allocated that have not been freed, in use or not
+    int getNumAllocatedPackets() const;
+
+    /// the number of packets waiting in the pool to be reused
+    int getNumFreePackets() const;
+
+private:
+    class Storage;
+
+    // shared with the deleter of every packet we hand out, so the pool can go away before its packets do
+    std::shared_ptr<Storage> _storage;
+};
+
+#endif // hifi_ReceivedPacketPool_h
@@ -69,6 +69,10 @@ protected:
     /// Override to do work before the packets processing loop. Default does nothing.
     virtual void preProcess() { }
 
+    /// Override to look at the whole batch of packets about to be processed, before processPacket() is called on each of
+    /// them in turn. Default does nothing.
+    virtual void prepareToProcess(const std::list<NodeSharedPacketPair>& packets) { }
+
     /// Override to do work inside the packet processing loop after a packet is processed. Default does nothing.
     virtual void midProcess() { }
 
@@ -0,0 +1,133 @@
+//
+//  VerificationHash.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "VerificationHash.h"
+
+#include <string.h>
+
+#include <QtCore/QCryptographicHash>
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// SipHash reads its input as little endian words regardless of the platform
+static inline uint64_t readLittleEndian(const unsigned char* bytes, int numBytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < numBytes; ++i) {
+        value |= (uint64_t) bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+static inline void writeLittleEndian(uint64_t value, char* bytes) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (char) (value >> (8 * i));
+    }
+}
+
+static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1;
+    v1 = rotateLeft(v1, 13);
+    v1 ^= v0;
+    v0 = rotateLeft(v0, 32);
+    v2 += v3;
+    v3 = rotateLeft(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotateLeft(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotateLeft(v1, 17);
+    v1 ^= v2;
+    v2 = rotateLeft(v2, 32);
+}
+
+namespace VerificationHash {
+
+    QString getMethodName(Method method) {
+        switch (method) {
+            case SipHash:
+                return "SipHash";
+            default:
+                return "MD5";
+        }
+    }
+
+    Key::Key(const QUuid& connectionSecret, Method method) :
+        _connectionSecret(connectionSecret),
+        _method(method)
+    {
+        // the RFC 4122 bytes of the secret, written out directly rather than through a QByteArray from toRfc4122()
+        for (int i = 0; i < 4; ++i) {
+            _rfcConnectionSecret[i] = (char) (connectionSecret.data1 >> (8 * (3 - i)));
+        }
+        for (int i = 0; i < 2; ++i) {
+            _rfcConnectionSecret[4 + i] = (char) (connectionSecret.data2 >> (8 * (1 - i)));
+            _rfcConnectionSecret[6 + i] = (char) (connectionSecret.data3 >> (8 * (1 - i)));
+        }
+        memcpy(_rfcConnectionSecret + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+
+        const unsigned char* secretBytes = reinterpret_cast<const unsigned char*>(_rfcConnectionSecret);
+        _sipHashKey[0] = readLittleEndian(secretBytes, 8);
+        _sipHashKey[1] = readLittleEndian(secretBytes + 8, 8);
+    }
+
+    void Key::hash(const char* data, int size, char* result) const {
+        if (_method == SipHash) {
+            sipHash128(_sipHashKey, data, size, result);
+        } else {
+            QCryptographicHash hash(QCryptographicHash::Md5);
+
+            // add the packet payload and the connection UUID
+            hash.addData(data, size);
+            hash.addData(_rfcConnectionSecret, NUM_BYTES_RFC4122_UUID);
+
+            memcpy(result, hash.result().constData(), NUM_BYTES_HASH);
+        }
+    }
+
+    void sipHash128(const uint64_t key[2], const char* data, int size, char* result) {
+        uint64_t v0 = 0x736f6d6570736575ULL ^ key[0];
+        uint64_t v1 = 0x646f72616e646f6dULL ^ key[1] ^ 0xee;
+        uint64_t v2 = 0x6c7967656e657261ULL ^ key[0];
+        uint64_t v3 = 0x7465646279746573ULL ^ key[1];
+
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        const unsigned char* wordsEnd = bytes + (size - (size % 8));
+
+        for (; bytes != wordsEnd; bytes += 8) {
+            uint64_t word = readLittleEndian(bytes, 8);
+            v3 ^= word;
+            sipRound(v0, v1, v2, v3);
+            sipRound(v0, v1, v2, v3);
+            v0 ^= word;
+        }
+
+        // the last word holds the leftover bytes and the low byte of the length
+        uint64_t lastWord = ((uint64_t) size << 56) | readLittleEndian(bytes, size % 8);
+        v3 ^= lastWord;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= lastWord;
+
+        v2 ^= 0xee;
+        for (int i = 0; i < 4; ++i) {
+            sipRound(v0, v1, v2, v3);
+        }
+        writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, result);
+
+        v1 ^= 0xdd;
+        for (int i = 0; i < 4; ++i) {
+            sipRound(v0, v1, v2, v3);
+        }
+        writeLittleEndian(v0 ^ v1 ^ v2 ^ v3, result + 8);
+    }
+}
@@ -0,0 +1,67 @@
+//
+//  VerificationHash.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_VerificationHash_h
+#define hifi_VerificationHash_h
+
+#include <stdint.h>
+
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include "UUID.h"
+
+// The keyed hashes that can fill the verification hash in the header of sourced packets. The method used between two
+// nodes is negotiated by the domain-server, which hands both of them the newest method they each support along with
+// their connection secret.
+namespace VerificationHash {
+
+    enum Method {
+        MD5,
+        SipHash
+    };
+
+    /// the newest method this build supports, sent to the domain-server when connecting
+    const Method BEST_METHOD = SipHash;
+
+    /// every method fills the same number of header bytes
+    const int NUM_BYTES_HASH = 16;
+
+    /// the method two nodes that support up to methodA and methodB should use with each other
+    inline Method methodForConnection(Method methodA, Method methodB) { return methodA < methodB ? methodA : methodB; }
+
+    QString getMethodName(Method method);
+
+    /// the state needed to hash packets for one connection, derived from its secret once rather than for every packet.
+    /// Not synchronized, a Node hands out copies of its key under a lock.
+    class Key {
+    public:
+        Key(const QUuid& connectionSecret = QUuid(), Method method = MD5);
+
+        bool isNull() const { return _connectionSecret.isNull(); }
+
+        const QUuid& getConnectionSecret() const { return _connectionSecret; }
+        Method getMethod() const { return _method; }
+
+        /// writes NUM_BYTES_HASH bytes of the keyed hash of data to result
+        void hash(const char* data, int size, char* result) const;
+
+    private:
+        QUuid _connectionSecret;
+        Method _method;
+        char _rfcConnectionSecret[NUM_BYTES_RFC4122_UUID];
+        uint64_t _sipHashKey[2];
+    };
+
+    /// SipHash-2-4 with a 128 bit output, see https://131002.net/siphash/
+    void sipHash128(const uint64_t key[2], const char* data, int size, char* result);
+}
+
+#endif // hifi_VerificationHash_h
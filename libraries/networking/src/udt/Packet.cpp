@@ -94,6 +94,23 @@ Packet::Packet(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& se
     _payloadStart = _packet.get() + (_packetSize - _payloadCapacity);
 }
 
+void Packet::resetForReceivedData(qint64 size, const HifiSockAddr& senderSockAddr) {
+    // _packetSize stays the size of the buffer, the datagram only has to fit in it
+    Q_ASSERT(size >= 0 && size <= _packetSize);
+
+    _senderSockAddr = senderSockAddr;
+
+    _type = readType();
+    _version = readVersion();
+    _payloadCapacity = size - localHeaderSize(_type);
+    _payloadSize = _payloadCapacity;
+    _payloadStart = _packet.get() + (size - _payloadCapacity);
+
+    // re-opening also drops anything QIODevice buffered while reading the last datagram
+    close();
+    open(QIODevice::ReadOnly);
+}
+
 Packet::Packet(const Packet& other) :
     QIODevice()
 {
@@ -94,6 +94,10 @@ protected:
     Packet(Packet&& other);
     Packet& operator=(Packet&& other);
 
+    // Points this packet at a datagram of the given size that was read straight into its buffer, so that a
+    // received packet can be reused for the next datagram instead of being reallocated
+    void resetForReceivedData(qint64 size, const HifiSockAddr& senderSockAddr);
+
     // Header readers
     PacketType::Value readType() const;
     PacketVersion readVersion() const;
@@ -70,6 +70,21 @@ PacketVersion versionForPacketType(PacketType::Value packetType) {
             return VERSION_ENTITIES_POLYLINE;
         case AvatarData:
             return 12;
+        case OctreeStats:
+            // carries the properties left out of a scene because the client already had them
+            return 12;
+        case DomainConnectRequest:
+        case DomainList:
+        case DomainServerAddedNode:
+            // carry the verification hash method negotiated between nodes
+            return 12;
+        case MicrophoneAudioNoEcho:
+        case MicrophoneAudioWithEcho:
+        case SilentAudioFrame:
+        case MixedAudio:
+        case AudioStreamStats:
+            // carry the codec their audio data is encoded with
+            return 12;
         default:
             return 11;
     }
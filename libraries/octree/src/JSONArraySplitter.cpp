@@ -0,0 +1,115 @@
+//
+//  JSONArraySplitter.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JSONArraySplitter.h"
+
+// the top level object is at depth 1, so the array is at 2 and its elements start there
+const int TOP_LEVEL_DEPTH = 1;
+const int ARRAY_DEPTH = 2;
+
+JSONArraySplitter::JSONArraySplitter(const QByteArray& arrayKey) :
+    _arrayKey(arrayKey),
+    _depth(0),
+    _inString(false),
+    _isEscaped(false),
+    _expectingKey(false),
+    _readingKey(false),
+    _inArray(false),
+    _inElement(false),
+    _hasFailed(false),
+    _isAtEnd(false)
+{
+}
+
+bool JSONArraySplitter::append(const QByteArray& data, QVector<QByteArray>& elements) {
+    if (_hasFailed) {
+        return false;
+    }
+    int elementStart = _inElement ? 0 : -1;
+    const char* bytes = data.constData();
+
+    for (int i = 0; i < data.size() && !_isAtEnd; i++) {
+        char c = bytes[i];
+
+        if (_inString) {
+            if (_isEscaped) {
+                _isEscaped = false;
+            } else if (c == '\\') {
+                _isEscaped = true;
+            } else if (c == '"') {
+                _inString = false;
+                _readingKey = false;
+                continue;
+            }
+            if (_readingKey) {
+                _key.append(c);
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"':
+                _inString = true;
+                if (_depth == TOP_LEVEL_DEPTH && _expectingKey) {
+                    _readingKey = true;
+                    _expectingKey = false;
+                    _key.clear();
+                }
+                break;
+
+            case '{':
+            case '[':
+                if (_depth == 0 && c != '{') {
+                    _hasFailed = true;
+                    return false;
+                }
+                if (_depth == TOP_LEVEL_DEPTH && c == '[' && _key == _arrayKey) {
+                    _inArray = true;
+                } else if (_inArray && _depth == ARRAY_DEPTH && c == '{') {
+                    _inElement = true;
+                    elementStart = i;
+                }
+                _depth++;
+                _expectingKey = (_depth == TOP_LEVEL_DEPTH);
+                break;
+
+            case '}':
+            case ']':
+                _depth--;
+                if (_depth < 0) {
+                    _hasFailed = true;
+                    return false;
+                }
+                if (_inElement && _depth == ARRAY_DEPTH) {
+                    _element.append(bytes + elementStart, i + 1 - elementStart);
+                    elements.push_back(_element);
+                    _element.clear();
+                    _inElement = false;
+                    elementStart = -1;
+                } else if (_inArray && _depth == TOP_LEVEL_DEPTH) {
+                    _inArray = false;
+                }
+                _isAtEnd = (_depth == 0);
+                break;
+
+            case ',':
+                _expectingKey = (_depth == TOP_LEVEL_DEPTH);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (_inElement) {
+        _element.append(bytes + elementStart, data.size() - elementStart);
+    }
+    return true;
+}
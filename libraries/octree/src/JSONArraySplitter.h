@@ -0,0 +1,46 @@
+//
+//  JSONArraySplitter.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_JSONArraySplitter_h
+#define hifi_JSONArraySplitter_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+/// Picks the object elements of one array member of a top level JSON object out of the document as it is read, so that
+/// a large document can be parsed an element at a time with QJsonDocument instead of all at once. Only the nesting and
+/// strings of the document are followed, the elements themselves are checked when they are parsed.
+class JSONArraySplitter {
+public:
+    JSONArraySplitter(const QByteArray& arrayKey);
+
+    /// feeds the next part of the document, appends the elements it completes to elements. Returns false once the
+    /// document turns out to be malformed.
+    bool append(const QByteArray& data, QVector<QByteArray>& elements);
+
+    /// true once the top level object was closed
+    bool isAtEnd() const { return _isAtEnd; }
+
+private:
+    QByteArray _arrayKey;
+    QByteArray _key; // the last key read at the top level
+    int _depth;
+    bool _inString;
+    bool _isEscaped;
+    bool _expectingKey;
+    bool _readingKey;
+    bool _inArray;
+    bool _inElement;
+    QByteArray _element; // the part of the current element that was in earlier data
+    bool _hasFailed;
+    bool _isAtEnd;
+};
+
+#endif // hifi_JSONArraySplitter_h
@@ -26,6 +26,7 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QNetworkAccessManager>
+#include <QVarLengthArray>
 #include <QVector>
 #include <QFile>
 #include <QJsonDocument>
@@ -35,6 +36,7 @@
 #include <GeometryUtil.h>
 #include <LogHandler.h>
 #include <NetworkAccessManager.h>
+#include <NumericalConstants.h>
 #include <OctalCode.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
@@ -42,14 +44,17 @@
 #include <Gzip.h>
 
 #include "CoverageMap.h"
+#include "JSONArraySplitter.h"
 #include "OctreeConstants.h"
 #include "OctreeElementBag.h"
 #include "Octree.h"
 #include "ViewFrustum.h"
 #include "OctreeLogging.h"
+#include "OctreePersistLog.h"
+#include "OctreeVisibleSet.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz", "bin"};
 
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale) {
     return voxelSizeScale / powf(2, renderLevel);
@@ -61,8 +66,11 @@ Octree::Octree(bool shouldReaverage) :
     _shouldReaverage(shouldReaverage),
     _stopImport(false),
     _lock(QReadWriteLock::Recursive),
+    _numWaitingReaders(0),
     _isViewing(false),
-    _isServer(false)
+    _isServer(false),
+    _lastJSONReadEntityCount(0),
+    _lastJSONReadEntitiesPerSecond(0.0f)
 {
 }
 
@@ -82,23 +90,55 @@ void Octree::recurseTreeWithPostOperation(RecurseOctreeOperation operation, void
     recurseElementWithPostOperation(_rootElement, operation, extraData);
 }
 
-// Recurses voxel element with an operation function
-void Octree::recurseElementWithOperation(OctreeElement* element, RecurseOctreeOperation operation, void* extraData,
-                        int recursionCount) {
-    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
+// an element waiting on the walk stack, and how far below the root of the walk it is
+class OctreeWalkEntry {
+public:
+    OctreeElement* element;
+    int recursionCount;
+};
+
+// most walks never hold more than a few children of each level on the stack at once
+const int EXPECTED_WALK_STACK_SIZE = 256;
+typedef QVarLengthArray<OctreeWalkEntry, EXPECTED_WALK_STACK_SIZE> OctreeWalkStack;
+
+static void pushWalkEntry(OctreeWalkStack& stack, OctreeElement* element, int recursionCount) {
+    OctreeWalkEntry entry;
+    entry.element = element;
+    entry.recursionCount = recursionCount;
+    stack.append(entry);
+}
+
+static bool isWalkTooDeep(const OctreeWalkEntry& entry, const char* walkName) {
+    if (entry.recursionCount > DANGEROUSLY_DEEP_RECURSION) {
         static QString repeatedMessage
             = LogHandler::getInstance().addRepeatedMessageRegex(
-                    "Octree::recurseElementWithOperation\\(\\) reached DANGEROUSLY_DEEP_RECURSION, bailing!");
+                    "Octree::recurseElementWith.*\\(\\) reached DANGEROUSLY_DEEP_RECURSION, bailing!");
 
-        qCDebug(octree) << "Octree::recurseElementWithOperation() reached DANGEROUSLY_DEEP_RECURSION, bailing!";
-        return;
+        qCDebug(octree, "Octree::%s() reached DANGEROUSLY_DEEP_RECURSION, bailing!", walkName);
+        return true;
     }
+    return false;
+}
 
-    if (operation(element, extraData)) {
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-            OctreeElement* child = element->getChildAtIndex(i);
-            if (child) {
-                recurseElementWithOperation(child, operation, extraData, recursionCount+1);
+// Walks the elements in pre-order with a stack instead of recursion. Children are pushed in reverse so that they come
+// off the stack in child index order, the same order a recursive walk visits them in.
+void Octree::recurseElementWithOperation(OctreeElement* element, RecurseOctreeOperation operation, void* extraData,
+                        int recursionCount) {
+    OctreeWalkStack stack;
+    pushWalkEntry(stack, element, recursionCount);
+
+    while (!stack.isEmpty()) {
+        OctreeWalkEntry entry = stack.last();
+        stack.removeLast();
+
+        if (isWalkTooDeep(entry, "recurseElementWithOperation")) {
+            continue;
+        }
+
+        if (operation(entry.element, extraData)) {
+            OctreeElement* const* children = entry.element->getChildren();
+            for (int i = entry.element->getChildCount() - 1; i >= 0; i--) {
+                pushWalkEntry(stack, children[i], entry.recursionCount + 1);
             }
         }
     }
@@ -133,41 +173,40 @@ void Octree::recurseTreeWithOperationDistanceSorted(RecurseOctreeOperation opera
     recurseElementWithOperationDistanceSorted(_rootElement, operation, point, extraData);
 }
 
-// Recurses voxel element with an operation function
+// Walks the elements with a stack like recurseElementWithOperation(), visiting the children of each element nearest first
 void Octree::recurseElementWithOperationDistanceSorted(OctreeElement* element, RecurseOctreeOperation operation,
                                                        const glm::vec3& point, void* extraData, int recursionCount) {
+    OctreeWalkStack stack;
+    pushWalkEntry(stack, element, recursionCount);
 
-    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
-        static QString repeatedMessage
-            = LogHandler::getInstance().addRepeatedMessageRegex(
-                    "Octree::recurseElementWithOperationDistanceSorted\\(\\) reached DANGEROUSLY_DEEP_RECURSION, bailing!");
+    while (!stack.isEmpty()) {
+        OctreeWalkEntry entry = stack.last();
+        stack.removeLast();
 
-        qCDebug(octree) << "Octree::recurseElementWithOperationDistanceSorted() reached DANGEROUSLY_DEEP_RECURSION, bailing!";
-        return;
-    }
+        if (isWalkTooDeep(entry, "recurseElementWithOperationDistanceSorted")) {
+            continue;
+        }
 
-    if (operation(element, extraData)) {
-        // determine the distance sorted order of our children
-        OctreeElement* sortedChildren[NUMBER_OF_CHILDREN] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
-        float distancesToChildren[NUMBER_OF_CHILDREN] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-        int indexOfChildren[NUMBER_OF_CHILDREN] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-        int currentCount = 0;
+        if (operation(entry.element, extraData)) {
+            // determine the distance sorted order of our children
+            OctreeElement* sortedChildren[NUMBER_OF_CHILDREN] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+            float distancesToChildren[NUMBER_OF_CHILDREN] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            int indexOfChildren[NUMBER_OF_CHILDREN] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            int currentCount = 0;
 
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-            OctreeElement* childElement = element->getChildAtIndex(i);
-            if (childElement) {
+            OctreeElement* const* children = entry.element->getChildren();
+            int childCount = entry.element->getChildCount();
+            for (int i = 0; i < childCount; i++) {
                 // chance to optimize, doesn't need to be actual distance!! Could be distance squared
-                float distanceSquared = childElement->distanceSquareToPoint(point);
-                currentCount = insertIntoSortedArrays((void*)childElement, distanceSquared, i,
+                float distanceSquared = children[i]->distanceSquareToPoint(point);
+                currentCount = insertIntoSortedArrays((void*)children[i], distanceSquared, i,
                                                       (void**)&sortedChildren, (float*)&distancesToChildren,
                                                       (int*)&indexOfChildren, currentCount, NUMBER_OF_CHILDREN);
             }
-        }
 
-        for (int i = 0; i < currentCount; i++) {
-            OctreeElement* childElement = sortedChildren[i];
-            if (childElement) {
-                recurseElementWithOperationDistanceSorted(childElement, operation, point, extraData);
+            // push the furthest first so the nearest is walked next
+            for (int i = currentCount - 1; i >= 0; i--) {
+                pushWalkEntry(stack, sortedChildren[i], entry.recursionCount + 1);
             }
         }
     }
@@ -962,9 +1001,16 @@ int Octree::encodeTreeBitstream(OctreeElement* element,
     }
 
     // If we're at a element that is out of view, then we can return, because no nodes below us will be in view!
-    if (params.viewFrustum && !element->isInView(*params.viewFrustum)) {
-        params.stopReason = EncodeBitstreamParams::OUT_OF_VIEW;
-        return bytesWritten;
+    if (params.viewFrustum) {
+        ViewFrustum::location location;
+        bool inLOD, shouldRender;
+        if (!(params.visibleSet && params.visibleSet->lookup(element, location, inLOD, shouldRender))) {
+            location = element->inFrustum(*params.viewFrustum);
+        }
+        if (location == ViewFrustum::OUTSIDE) {
+            params.stopReason = EncodeBitstreamParams::OUT_OF_VIEW;
+            return bytesWritten;
+        }
     }
 
     // write the octal code
@@ -1082,12 +1128,22 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
 
     // caller can pass NULL as viewFrustum if they want everything
     if (params.viewFrustum) {
-        float distance = element->distanceToCamera(*params.viewFrustum);
-        float boundaryDistance = boundaryDistanceForRenderLevel(element->getLevel() + params.boundaryLevelAdjust,
-                                        params.octreeElementSizeScale);
+        // if the client's visible set was worked out ahead of time, it already has the answers to the tests below
+        ViewFrustum::location visibleSetLocation = ViewFrustum::INTERSECT;
+        bool visibleSetInLOD = false;
+        bool visibleSetShouldRender = false;
+        bool inVisibleSet = params.visibleSet && params.visibleSet->lookup(element, visibleSetLocation, visibleSetInLOD,
+                                                                           visibleSetShouldRender);
+        bool inLOD = visibleSetInLOD;
+        if (!inVisibleSet) {
+            float distance = element->distanceToCamera(*params.viewFrustum);
+            float boundaryDistance = boundaryDistanceForRenderLevel(element->getLevel() + params.boundaryLevelAdjust,
+                                            params.octreeElementSizeScale);
+            inLOD = distance < boundaryDistance;
+        }
 
         // If we're too far away for our render level, then just return
-        if (distance >= boundaryDistance) {
+        if (!inLOD) {
             if (params.stats) {
                 params.stats->skippedDistance(element);
             }
@@ -1099,7 +1155,7 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
         // if we are INSIDE, INTERSECT, or OUTSIDE
         if (parentLocationThisView != ViewFrustum::INSIDE) {
             assert(parentLocationThisView != ViewFrustum::OUTSIDE); // we shouldn't be here if our parent was OUTSIDE!
-            nodeLocationThisView = element->inFrustum(*params.viewFrustum);
+            nodeLocationThisView = inVisibleSet ? visibleSetLocation : element->inFrustum(*params.viewFrustum);
         }
 
         // If we're at a element that is out of view, then we can return, because no nodes below us will be in view!
@@ -1233,6 +1289,11 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
     int indexOfChildren[NUMBER_OF_CHILDREN] = { 0, 0, 0, 0, 0, 0, 0, 0 };
     int currentCount = 0;
 
+    // the children's answers from the client's visible set, by original index
+    bool childInVisibleSet[NUMBER_OF_CHILDREN] = { false, false, false, false, false, false, false, false };
+    ViewFrustum::location childVisibleSetLocation[NUMBER_OF_CHILDREN];
+    bool childVisibleSetShouldRender[NUMBER_OF_CHILDREN];
+
     for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
         OctreeElement* childElement = element->getChildAtIndex(i);
 
@@ -1250,6 +1311,12 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
             }
         }
 
+        if (childElement && params.visibleSet) {
+            bool childInLOD;
+            childInVisibleSet[i] = params.visibleSet->lookup(childElement, childVisibleSetLocation[i], childInLOD,
+                                                             childVisibleSetShouldRender[i]);
+        }
+
         if (params.wantOcclusionCulling) {
             if (childElement) {
                 float distance = params.viewFrustum ? childElement->distanceToCamera(*params.viewFrustum) : 0;
@@ -1282,7 +1349,9 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
                 ( !params.viewFrustum || // no view frustum was given, everything is assumed in view
                   (nodeLocationThisView == ViewFrustum::INSIDE) || // parent was fully in view, we can assume ALL children are
                   (nodeLocationThisView == ViewFrustum::INTERSECT &&
-                        childElement->isInView(*params.viewFrustum)) // the parent intersects and the child is in view
+                        (childInVisibleSet[originalIndex]
+                            ? childVisibleSetLocation[originalIndex] != ViewFrustum::OUTSIDE
+                            : childElement->isInView(*params.viewFrustum))) // the parent intersects and the child is in view
                 ));
 
         if (!childIsInView) {
@@ -1346,8 +1415,10 @@ int Octree::encodeTreeBitstreamRecursion(OctreeElement* element,
 
                 bool shouldRender = !params.viewFrustum
                                     ? true
-                                    : childElement->calculateShouldRender(params.viewFrustum,
-                                                    params.octreeElementSizeScale, params.boundaryLevelAdjust);
+                                    : childInVisibleSet[originalIndex]
+                                        ? childVisibleSetShouldRender[originalIndex]
+                                        : childElement->calculateShouldRender(params.viewFrustum,
+                                                        params.octreeElementSizeScale, params.boundaryLevelAdjust);
 
                 // track some stats
                 if (params.stats) {
@@ -1808,6 +1879,11 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".bin")) {
+        OctreePersistLog persistLog(this, qFileName);
+        return persistLog.load();
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -1838,16 +1914,7 @@ bool Octree::readJSONFromGzippedFile(QString qFileName) {
         qCritical() << "Cannot open gzipped json file for reading: " << qFileName;
         return false;
     }
-    QByteArray compressedJsonData = file.readAll();
-    QByteArray jsonData;
-
-    if (!gunzip(compressedJsonData, jsonData)) {
-        qCritical() << "json File not in gzip format: " << qFileName;
-        return false;
-    }
-
-    QDataStream jsonStream(jsonData);
-    return readJSONFromStream(-1, jsonStream);
+    return readJSONFromDevice(file, true);
 }
 
 bool Octree::readFromURL(const QString& urlString) {
@@ -2028,33 +2095,96 @@ bool Octree::readSVOFromStream(unsigned long streamLength, QDataStream& inputStr
     return fileOk;
 }
 
-const int READ_JSON_BUFFER_SIZE = 2048;
+const int READ_JSON_BUFFER_SIZE = 64 * 1024;
+const int ENTITIES_PER_JSON_READ_BATCH = 1000;
 
 bool Octree::readJSONFromStream(unsigned long streamLength, QDataStream& inputStream) {
     // if the data is gzipped we may not have a useful bytesAvailable() result, so just keep reading until
     // we get an eof.  Leave streamLength parameter for consistency.
+    return readJSONFromDevice(*inputStream.device(), false);
+}
 
-    QByteArray jsonBuffer;
-    char* rawData = new char[READ_JSON_BUFFER_SIZE];
-    while (true) {
-        int got = inputStream.readRawData(rawData, READ_JSON_BUFFER_SIZE - 1);
-        if (got < 0) {
+// Rather than parsing the whole document into a QVariantMap, the entities are picked out of it as it is read and handed
+// to readFromMap() a batch at a time, so only a batch of them is ever held as variants.
+bool Octree::readJSONFromDevice(QIODevice& device, bool isGzipped) {
+    quint64 start = usecTimestampNow();
+    GunzipStream gunzipStream;
+    JSONArraySplitter splitter("Entities");
+    QVector<QByteArray> elements;
+    QVariantList batch;
+    int entityCount = 0;
+    int failedCount = 0;
+    bool success = true;
+
+    _lastJSONReadEntityCount = 0;
+    _lastJSONReadEntitiesPerSecond = 0.0f;
+
+    // the gzip trailer can come in a later chunk than the end of the entities, so the gzip stream is read to its end too
+    while (success && (!splitter.isAtEnd() || (isGzipped && !gunzipStream.isAtEnd()))) {
+        QByteArray data = device.read(READ_JSON_BUFFER_SIZE);
+        if (data.isEmpty()) {
+            break;
+        }
+        if (isGzipped) {
+            QByteArray inflatedData;
+            if (!gunzipStream.inflateChunk(data, inflatedData)) {
+                qCritical() << "json data not in gzip format";
+                success = false;
+                break;
+            }
+            data = inflatedData;
+        }
+        if (splitter.isAtEnd()) {
+            continue;
+        }
+        if (!splitter.append(data, elements)) {
             qCritical() << "error while reading from json stream";
-            delete[] rawData;
-            return false;
+            success = false;
         }
-        if (got == 0) {
-            break;
+
+        foreach (const QByteArray& element, elements) {
+            QJsonParseError error;
+            QJsonDocument elementDocument = QJsonDocument::fromJson(element, &error);
+            if (error.error != QJsonParseError::NoError) {
+                failedCount++;
+                continue;
+            }
+            batch << elementDocument.toVariant();
         }
-        jsonBuffer += QByteArray(rawData, got);
+        elements.clear();
+
+        if (batch.size() >= ENTITIES_PER_JSON_READ_BATCH) {
+            QVariantMap batchMap;
+            batchMap["Entities"] = batch;
+            readFromMap(batchMap);
+            entityCount += batch.size();
+            batch.clear();
+        }
+    }
+    if (!batch.isEmpty()) {
+        QVariantMap batchMap;
+        batchMap["Entities"] = batch;
+        readFromMap(batchMap);
+        entityCount += batch.size();
+    }
+    if (isGzipped && success && !gunzipStream.isAtEnd()) {
+        qCritical() << "gzipped json data ends early";
+        success = false;
+    }
+    if (success && !splitter.isAtEnd()) {
+        qCritical() << "json data ends early";
+        success = false;
+    }
+    if (failedCount > 0) {
+        qCritical() << "unable to parse" << failedCount << "entities of json data";
     }
 
-    QJsonDocument asDocument = QJsonDocument::fromJson(jsonBuffer);
-    QVariant asVariant = asDocument.toVariant();
-    QVariantMap asMap = asVariant.toMap();
-    readFromMap(asMap);
-    delete[] rawData;
-    return true;
+    float elapsedSeconds = (float)(usecTimestampNow() - start) / USECS_PER_SECOND;
+    _lastJSONReadEntityCount = entityCount;
+    _lastJSONReadEntitiesPerSecond = elapsedSeconds > 0.0f ? entityCount / elapsedSeconds : 0.0f;
+    qCDebug(octree) << "read" << entityCount << "entities from json in" << elapsedSeconds << "seconds,"
+                    << _lastJSONReadEntitiesPerSecond << "entities/sec";
+    return success;
 }
 
 void Octree::writeToFile(const char* fileName, OctreeElement* element, QString persistAsFileType) {
@@ -2069,6 +2199,9 @@ void Octree::writeToFile(const char* fileName, OctreeElement* element, QString p
         writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "bin" && !element && canPersistLog()) {
+        OctreePersistLog persistLog(this, qFileName);
+        persistLog.writeSnapshot();
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -12,6 +12,7 @@
 #ifndef hifi_Octree_h
 #define hifi_Octree_h
 
+#include <atomic>
 #include <set>
 #include <SimpleMovingAverage.h>
 
@@ -21,6 +22,10 @@ class Octree;
 class OctreeElement;
 class OctreeElementBag;
 class OctreePacketData;
+class OctreePersistRecordReader;
+class OctreePersistRecordWriter;
+class OctreeVisibleSet;
+class QIODevice;
 class Shape;
 
 
@@ -46,6 +51,12 @@ public:
     virtual OctreeElement* possiblyCreateChildAt(OctreeElement* element, int childIndex) { return NULL; }
 };
 
+/// derive from this class to hold an edit message your tree decoded with Octree::decodeEditPacketData()
+class OctreeDecodedEdit {
+public:
+    virtual ~OctreeDecodedEdit() { }
+};
+
 // Callback function, for recuseTreeWithOperation
 typedef bool (*RecurseOctreeOperation)(OctreeElement* element, void* extraData);
 typedef enum {GRADIENT, RANDOM, NATURAL} creationMode;
@@ -89,6 +100,7 @@ public:
     CoverageMap* map;
     JurisdictionMap* jurisdictionMap;
     OctreeElementExtraEncodeData* extraEncodeData;
+    const OctreeVisibleSet* visibleSet; // view and LOD results worked out ahead of time for viewFrustum, may be NULL
 
     // output hints from the encode process
     typedef enum {
@@ -121,7 +133,8 @@ public:
         bool forceSendScene = true,
         OctreeSceneStats* stats = IGNORE_SCENE_STATS,
         JurisdictionMap* jurisdictionMap = IGNORE_JURISDICTION_MAP,
-        OctreeElementExtraEncodeData* extraEncodeData = NULL) :
+        OctreeElementExtraEncodeData* extraEncodeData = NULL,
+        const OctreeVisibleSet* visibleSet = NULL) :
             maxEncodeLevel(maxEncodeLevel),
             maxLevelReached(0),
             viewFrustum(viewFrustum),
@@ -139,6 +152,7 @@ public:
             map(map),
             jurisdictionMap(jurisdictionMap),
             extraEncodeData(extraEncodeData),
+            visibleSet(visibleSet),
             stopReason(UNKNOWN)
     {}
 
@@ -235,6 +249,20 @@ public:
     virtual bool handlesEditPacketType(PacketType::Value packetType) const { return false; }
     virtual int processEditPacketData(NLPacket& packet, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Trees whose edit messages can be decoded without the tree implement these as well, so that the server can decode
+    // the edits of several packets on other threads and only apply them under the tree's write lock.
+    virtual bool canDecodeEditPacketType(PacketType::Value packetType) const { return false; }
+    /// decodes one edit message without touching the tree, so it may be called from any thread without the tree's lock.
+    /// Returns NULL if the message was not decoded, processedBytes is the size of the message either way.
+    virtual OctreeDecodedEdit* decodeEditPacketData(PacketType::Value packetType, const unsigned char* editData,
+                                                    int maxLength, int& processedBytes) const {
+        processedBytes = 0;
+        return NULL;
+    }
+    /// applies an edit decoded by decodeEditPacketData(), the caller holds the tree's write lock
+    virtual void applyDecodedEdit(PacketType::Value packetType, OctreeDecodedEdit& edit,
+                                  const SharedNodePointer& sourceNode) { }
                     
     virtual bool recurseChildrenWithData() const { return true; }
     virtual bool rootElementHasData() const { return false; }
@@ -271,9 +299,12 @@ public:
     OctreeElement* getOrCreateChildElementAt(float x, float y, float z, float s);
     OctreeElement* getOrCreateChildElementContaining(const AACube& box);
 
+    /// Calls operation on each element in pre-order, skipping the children of elements it returns false for. The walk
+    /// keeps its own stack of elements to visit, so operation must not add or remove elements of this tree.
     void recurseTreeWithOperation(RecurseOctreeOperation operation, void* extraData = NULL);
     void recurseTreeWithPostOperation(RecurseOctreeOperation operation, void* extraData = NULL);
 
+    /// Like recurseTreeWithOperation(), but the children of each element are visited nearest to point first.
     /// \param operation type of operation
     /// \param point point in world-frame (meters)
     /// \param extraData hook for user data to be interpreted by special context
@@ -290,11 +321,15 @@ public:
     void setDirtyBit() { _isDirty = true; }
 
     // Octree does not currently handle its own locking, caller must use these to lock/unlock
-    void lockForRead() { _lock.lockForRead(); }
+    void lockForRead() { _numWaitingReaders++; _lock.lockForRead(); _numWaitingReaders--; }
     bool tryLockForRead() { return _lock.tryLockForRead(); }
     void lockForWrite() { _lock.lockForWrite(); }
     bool tryLockForWrite() { return _lock.tryLockForWrite(); }
     void unlock() { _lock.unlock(); }
+
+    /// true while some thread is blocked in lockForRead(), so that a writer holding the lock across many edits can
+    /// let it in early
+    bool hasWaitingReaders() const { return _numWaitingReaders.load(std::memory_order_relaxed) > 0; }
     // output hints from the encode process
     typedef enum {
         Lock,
@@ -343,6 +378,18 @@ public:
     bool readJSONFromGzippedFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
+    /// how many entities the last JSON read added, and how fast
+    int getLastJSONReadEntityCount() const { return _lastJSONReadEntityCount; }
+    float getLastJSONReadEntitiesPerSecond() const { return _lastJSONReadEntitiesPerSecond; }
+
+    // Incremental persistence, see OctreePersistLog. A tree that supports it tracks the changes made to it once
+    // setTrackPersistChanges(true) is called, and hands them over on each writePersistChanges().
+    virtual bool canPersistLog() const { return false; }
+    virtual void setTrackPersistChanges(bool trackPersistChanges) { }
+    virtual bool writePersistSnapshot(OctreePersistRecordWriter& writer) { return false; } /// also drops tracked changes
+    virtual bool writePersistChanges(OctreePersistRecordWriter& writer) { return false; }
+    virtual bool readPersistRecords(OctreePersistRecordReader& reader) { return false; }
+
     unsigned long getOctreeElementsCount();
 
     bool getShouldReaverage() const { return _shouldReaverage; }
@@ -403,6 +450,8 @@ protected:
     int readElementData(OctreeElement *destinationElement, const unsigned char* nodeData,
                 int bufferSizeBytes, ReadBitstreamToTreeParams& args);
 
+    bool readJSONFromDevice(QIODevice& device, bool isGzipped);
+
     OctreeElement* _rootElement;
 
     bool _isDirty;
@@ -410,9 +459,13 @@ protected:
     bool _stopImport;
 
     QReadWriteLock _lock;
+    std::atomic<int> _numWaitingReaders;
     
     bool _isViewing;
     bool _isServer;
+
+    int _lastJSONReadEntityCount;
+    float _lastJSONReadEntitiesPerSecond;
 };
 
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale);
@@ -0,0 +1,146 @@
+//
+//  OctreeClientBaselines.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include <SharedUtil.h>
+
+#include "OctreePacketData.h"
+#include "OctreeSceneStats.h"
+
+#include "OctreeClientBaselines.h"
+
+OctreeClientBaselines::OctreeClientBaselines() :
+    _recordOnly(false),
+    _lastResetTime(usecTimestampNow()),
+    _hasForgetQueue(false),
+    _pendingPropertiesSkipped(0),
+    _pendingBytesSaved(0),
+    _totalPropertiesSkipped(0),
+    _totalBytesSaved(0)
+{
+}
+
+void OctreeClientBaselines::setCurrentItem(const QUuid& itemID) {
+    if (_hasForgetQueue) {
+        forgetQueuedItems();
+    }
+    _currentItemID = itemID;
+}
+
+bool OctreeClientBaselines::isUnchanged(OctreePacketData& packetData, int property, int offset) {
+    if (_currentItemID.isNull()) {
+        return false;
+    }
+    int length = packetData.getUncompressedSize() - offset;
+    const unsigned char* encoded = packetData.getUncompressedData(offset);
+
+    if (!_recordOnly) {
+        QHash<QUuid, ItemBaselines>::const_iterator item = _items.constFind(_currentItemID);
+        if (item != _items.constEnd()) {
+            ItemBaselines::const_iterator baseline = std::lower_bound(item->constBegin(), item->constEnd(), property,
+                                                                      propertyLessThan);
+            if (baseline != item->constEnd() && baseline->property == property && baseline->encoded.size() == length &&
+                memcmp(baseline->encoded.constData(), encoded, length) == 0) {
+                _pendingPropertiesSkipped++;
+                _pendingBytesSaved += length;
+                return true;
+            }
+        }
+    }
+
+    PendingBaseline pending;
+    pending.itemID = _currentItemID;
+    pending.property = property;
+    pending.offset = offset;
+    pending.length = length;
+    pending.discardCount = packetData.getDiscardCount();
+    _pending.push_back(pending);
+    return false;
+}
+
+void OctreeClientBaselines::pendingMoved(int fromOffset, int toOffset) {
+    for (int i = _pending.size() - 1; i >= 0 && _pending[i].offset >= fromOffset; i--) {
+        _pending[i].offset += toOffset - fromOffset;
+    }
+}
+
+void OctreeClientBaselines::itemSkipped(int headerBytes) {
+    _pendingBytesSaved += headerBytes;
+}
+
+void OctreeClientBaselines::commitPending(OctreePacketData& packetData, OctreeSceneStats* stats) {
+    foreach (const PendingBaseline& pending, _pending) {
+        if (packetData.wasDiscardedSince(pending.discardCount, pending.offset)) {
+            continue;
+        }
+        // copied only now, so that nothing is copied of what was discarded from the packet
+        QByteArray encoded(reinterpret_cast<const char*>(packetData.getUncompressedData(pending.offset)), pending.length);
+        ItemBaselines& item = _items[pending.itemID];
+        ItemBaselines::iterator baseline = std::lower_bound(item.begin(), item.end(), pending.property, propertyLessThan);
+        if (baseline != item.end() && baseline->property == pending.property) {
+            baseline->encoded = encoded;
+        } else {
+            PropertyBaseline newBaseline = { pending.property, encoded };
+            item.insert(baseline, newBaseline);
+        }
+    }
+    if (stats) {
+        stats->unchangedPropertiesSkipped(_pendingPropertiesSkipped, _pendingBytesSaved);
+    }
+    _totalPropertiesSkipped += _pendingPropertiesSkipped;
+    _totalBytesSaved += _pendingBytesSaved;
+    dropPending();
+}
+
+bool OctreeClientBaselines::propertyLessThan(const PropertyBaseline& baseline, int property) {
+    return baseline.property < property;
+}
+
+void OctreeClientBaselines::dropPending() {
+    _pending.clear();
+    _pendingPropertiesSkipped = 0;
+    _pendingBytesSaved = 0;
+}
+
+void OctreeClientBaselines::forgetItem(const QUuid& itemID) {
+    _items.remove(itemID);
+}
+
+void OctreeClientBaselines::forgetItemLater(const QUuid& itemID) {
+    QMutexLocker locker(&_forgetQueueMutex);
+    _forgetQueue.push_back(itemID);
+    _hasForgetQueue = true;
+}
+
+void OctreeClientBaselines::forgetQueuedItems() {
+    QVector<QUuid> forgetQueue;
+    {
+        QMutexLocker locker(&_forgetQueueMutex);
+        forgetQueue.swap(_forgetQueue);
+        _hasForgetQueue = false;
+    }
+    foreach (const QUuid& itemID, forgetQueue) {
+        _items.remove(itemID);
+        // what is pending of the item may have been encoded before the client's edit reached us
+        for (int i = _pending.size() - 1; i >= 0; i--) {
+            if (_pending[i].itemID == itemID) {
+                _pending.remove(i);
+            }
+        }
+    }
+}
+
+void OctreeClientBaselines::reset() {
+    _items.clear();
+    dropPending();
+    _lastResetTime = usecTimestampNow();
+}
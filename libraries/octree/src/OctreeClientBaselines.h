@@ -0,0 +1,126 @@
+//
+//  OctreeClientBaselines.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  What one client was last sent of each item's properties, so that only the properties that differ are sent again
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeClientBaselines_h
+#define hifi_OctreeClientBaselines_h
+
+#include <atomic>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+class OctreePacketData;
+class OctreeSceneStats;
+
+/// Remembers the encoded form of every property of every item sent to one client, so that an item which
+/// changed is sent with only the properties that encode differently from what the client has. Comparing the encoded
+/// bytes means that a change the wire format can not carry, such as a rotation below the precision of a packed
+/// quaternion, is not sent either.
+///
+/// Properties are noted down as they are encoded, but only become the client's baselines once the packet they were
+/// encoded into is written out, and only if they were not discarded from it in the meantime. A packet that is lost is
+/// resent from the sent packet history when the client nacks it, so a packet that was written out counts as received,
+/// and the owner of the baselines must reset() them if it can no longer resend a packet the client missed. A client
+/// that does not nack can not say what it missed, so the owner should also reset() them every so often.
+///
+/// A client ignores what it is sent of an item it edited more recently than the server, or whose simulation it owns,
+/// so such an item must be forgotten. Other threads do that with forgetItemLater().
+///
+/// Not thread safe other than forgetItemLater(), the baselines belong to the one thread encoding for the client.
+class OctreeClientBaselines {
+public:
+    OctreeClientBaselines();
+
+    /// while recording only, every property is sent and just noted down. Used for scenes whose encoding must not depend
+    /// on the client, such as full scenes that are shared with other clients.
+    void setRecordOnly(bool recordOnly) { _recordOnly = recordOnly; }
+    bool isRecordOnly() const { return _recordOnly; }
+
+    /// the client the baselines are for, items whose simulation it owns are always sent whole
+    void setClientID(const QUuid& clientID) { _clientID = clientID; }
+    const QUuid& getClientID() const { return _clientID; }
+
+    /// the item whose properties are being encoded, a null ID while encoding anything else
+    void setCurrentItem(const QUuid& itemID);
+    const QUuid& getCurrentItem() const { return _currentItemID; }
+
+    /// called with one of the current item's properties, which was just appended to packetData at offset. Returns true
+    /// if the client already has exactly that encoding, otherwise notes it down to commit with the packet.
+    bool isUnchanged(OctreePacketData& packetData, int property, int offset);
+
+    /// the encoder moved the current item's properties from fromOffset to toOffset after they were appended
+    void pendingMoved(int fromOffset, int toOffset);
+
+    /// the whole current item was left out, since the client already had every property that was asked for
+    void itemSkipped(int headerBytes);
+
+    /// packetData is being written out to the client, what was noted down while encoding it and is still in it becomes
+    /// the client's baselines. What was saved is added to stats, if given.
+    void commitPending(OctreePacketData& packetData, OctreeSceneStats* stats);
+
+    /// drops what was noted down since the last commit, call before resetting a packet that is not written out
+    void dropPending();
+
+    /// the item is gone, or the client may no longer have what it was sent of it
+    void forgetItem(const QUuid& itemID);
+
+    /// like forgetItem(), but may be called from any thread. Takes effect before the next item is encoded.
+    void forgetItemLater(const QUuid& itemID);
+
+    /// forgets everything, the client is sent every property again
+    void reset();
+    quint64 getLastResetTime() const { return _lastResetTime; }
+
+    int getItemCount() const { return _items.size(); }
+    quint64 getTotalPropertiesSkipped() const { return _totalPropertiesSkipped; }
+    quint64 getTotalBytesSaved() const { return _totalBytesSaved; }
+
+private:
+    struct PropertyBaseline {
+        int property;
+        QByteArray encoded;
+    };
+    typedef QVector<PropertyBaseline> ItemBaselines; // sorted by property
+
+    static bool propertyLessThan(const PropertyBaseline& baseline, int property);
+
+    struct PendingBaseline {
+        QUuid itemID;
+        int property;
+        int offset;
+        int length;
+        int discardCount;
+    };
+
+    void forgetQueuedItems();
+
+    QHash<QUuid, ItemBaselines> _items;
+    QVector<PendingBaseline> _pending;
+    QUuid _currentItemID;
+    QUuid _clientID;
+    bool _recordOnly;
+    quint64 _lastResetTime;
+
+    QMutex _forgetQueueMutex;
+    QVector<QUuid> _forgetQueue;
+    std::atomic<bool> _hasForgetQueue;
+
+    int _pendingPropertiesSkipped;
+    int _pendingBytesSaved;
+    quint64 _totalPropertiesSkipped;
+    quint64 _totalBytesSaved;
+};
+
+#endif // hifi_OctreeClientBaselines_h
@@ -0,0 +1,139 @@
+//
+//  OctreeEditDecoder.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
+
+#include "Octree.h"
+
+#include "OctreeEditDecoder.h"
+
+/// the packets of one decode(), shared with the pool threads helping out. A helper that only starts once every packet
+/// was taken finds nothing to do, so the decoder may already have moved on by then.
+class EditDecodeWalk {
+public:
+    class Packet {
+    public:
+        PacketType::Value packetType;
+        const unsigned char* data;
+        int size;
+        QVector<OctreeDecodedEdit*> edits;
+        int decodedBytes;
+    };
+
+    EditDecodeWalk(const Octree* tree) : _tree(tree), _nextPacket(0) { }
+    ~EditDecodeWalk() {
+        for (size_t i = 0; i < _packets.size(); i++) {
+            qDeleteAll(_packets[i].edits);
+        }
+    }
+
+    int addPacket(PacketType::Value packetType, const unsigned char* data, int size) {
+        Packet packet = { packetType, data, size, QVector<OctreeDecodedEdit*>(), 0 };
+        _packets.push_back(packet);
+        return (int)_packets.size() - 1;
+    }
+
+    int getPacketCount() const { return (int)_packets.size(); }
+    Packet& getPacket(int index) { return _packets[index]; }
+
+    /// takes packets until there are none left
+    void decodePackets() {
+        int index;
+        while ((index = _nextPacket.fetch_add(1)) < (int)_packets.size()) {
+            decodePacket(_packets[index]);
+            _packetsDone.release();
+        }
+    }
+
+    void waitForPackets() { _packetsDone.acquire((int)_packets.size()); }
+
+private:
+    void decodePacket(Packet& packet) {
+        while (packet.decodedBytes < packet.size) {
+            int processedBytes = 0;
+            OctreeDecodedEdit* edit = _tree->decodeEditPacketData(packet.packetType, packet.data + packet.decodedBytes,
+                                                                  packet.size - packet.decodedBytes, processedBytes);
+            if (!edit) {
+                return; // the rest of the packet is processed as usual
+            }
+            packet.edits.push_back(edit);
+            packet.decodedBytes += processedBytes;
+            if (processedBytes <= 0) {
+                return;
+            }
+        }
+    }
+
+    const Octree* _tree;
+    std::vector<Packet> _packets; // not resized once the helpers are started
+    std::atomic<int> _nextPacket;
+    QSemaphore _packetsDone;
+};
+
+class EditDecodeHelper : public QRunnable {
+public:
+    EditDecodeHelper(const QSharedPointer<EditDecodeWalk>& walk) : _walk(walk) { }
+    virtual void run() { _walk->decodePackets(); }
+
+private:
+    QSharedPointer<EditDecodeWalk> _walk;
+};
+
+OctreeEditDecoder::OctreeEditDecoder(const Octree* tree) :
+    _tree(tree),
+    _walk(new EditDecodeWalk(tree)),
+    _totalPacketsDecoded(0),
+    _totalEditsDecoded(0)
+{
+}
+
+OctreeEditDecoder::~OctreeEditDecoder() {
+}
+
+int OctreeEditDecoder::addPacket(PacketType::Value packetType, const unsigned char* data, int size) {
+    return _walk->addPacket(packetType, data, size);
+}
+
+int OctreeEditDecoder::getPacketCount() const {
+    return _walk->getPacketCount();
+}
+
+void OctreeEditDecoder::decode() {
+    int helpers = std::min(QThreadPool::globalInstance()->maxThreadCount(), _walk->getPacketCount() - 1);
+    for (int i = 0; i < helpers; i++) {
+        QThreadPool::globalInstance()->start(new EditDecodeHelper(_walk));
+    }
+    _walk->decodePackets();
+    _walk->waitForPackets();
+
+    for (int i = 0; i < _walk->getPacketCount(); i++) {
+        _totalEditsDecoded += _walk->getPacket(i).edits.size();
+    }
+    _totalPacketsDecoded += _walk->getPacketCount();
+}
+
+QVector<OctreeDecodedEdit*> OctreeEditDecoder::takeEdits(int packet, int& decodedBytes) {
+    EditDecodeWalk::Packet& decodedPacket = _walk->getPacket(packet);
+    QVector<OctreeDecodedEdit*> edits;
+    edits.swap(decodedPacket.edits);
+    decodedBytes = decodedPacket.decodedBytes;
+    return edits;
+}
+
+void OctreeEditDecoder::clear() {
+    // a helper that has yet to start keeps the old walk alive, so the next batch gets a new one
+    _walk = QSharedPointer<EditDecodeWalk>(new EditDecodeWalk(_tree));
+}
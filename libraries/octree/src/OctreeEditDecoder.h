@@ -0,0 +1,56 @@
+//
+//  OctreeEditDecoder.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditDecoder_h
+#define hifi_OctreeEditDecoder_h
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+
+#include <udt/PacketHeaders.h>
+
+class EditDecodeWalk;
+class Octree;
+class OctreeDecodedEdit;
+
+/// Decodes the edit messages of a batch of edit packets with Octree::decodeEditPacketData(), so that the server only has
+/// to apply them under the tree's write lock. The messages of a packet have to be decoded in order to find where the
+/// next one starts, so the packets are handed out to the thread pool one at a time.
+class OctreeEditDecoder {
+public:
+    OctreeEditDecoder(const Octree* tree);
+    ~OctreeEditDecoder();
+
+    /// adds the edit messages of a packet to the batch, data must stay valid until decode() returns. Returns the index to
+    /// take the packet's edits with.
+    int addPacket(PacketType::Value packetType, const unsigned char* data, int size);
+    int getPacketCount() const;
+
+    /// decodes every packet added since the last clear(). Blocks until done, the calling thread decodes packets too.
+    void decode();
+
+    /// hands over the edits decoded from a packet, in the order of its messages. decodedBytes is how much of the packet
+    /// they cover, the rest of it could not be decoded ahead and has to be processed as usual.
+    QVector<OctreeDecodedEdit*> takeEdits(int packet, int& decodedBytes);
+
+    /// deletes the edits that were not taken and empties the batch
+    void clear();
+
+    quint64 getTotalPacketsDecoded() const { return _totalPacketsDecoded; }
+    quint64 getTotalEditsDecoded() const { return _totalEditsDecoded; }
+
+private:
+    const Octree* _tree;
+    QSharedPointer<EditDecodeWalk> _walk;
+    quint64 _totalPacketsDecoded;
+    quint64 _totalEditsDecoded;
+};
+
+#endif // hifi_OctreeEditDecoder_h
@@ -19,6 +19,7 @@
 #include <LogHandler.h>
 #include <NodeList.h>
 #include <PerfStat.h>
+#include <SlabAllocator.h>
 
 #include "AACube.h"
 #include "OctalCode.h"
@@ -39,6 +40,63 @@ void OctreeElement::resetPopulationStatistics() {
     _voxelNodeLeafCount = 0;
 }
 
+// elements, octal codes too long to keep inline and external child arrays share one pool per size, rounded up to
+// SlabAllocator::BLOCK_ALIGNMENT. Anything larger than this goes to the heap.
+const size_t MAX_POOLED_SIZE = 1024;
+const int NUMBER_OF_POOLS = MAX_POOLED_SIZE / SlabAllocator::BLOCK_ALIGNMENT;
+
+static SlabAllocator** createPools() {
+    // never destroyed, since trees held by other static objects may still be deleting elements at exit
+    SlabAllocator** pools = new SlabAllocator*[NUMBER_OF_POOLS];
+    for (int i = 0; i < NUMBER_OF_POOLS; i++) {
+        pools[i] = new SlabAllocator((i + 1) * SlabAllocator::BLOCK_ALIGNMENT);
+    }
+    return pools;
+}
+
+static SlabAllocator* getPool(size_t size) {
+    static SlabAllocator** pools = createPools();
+    return (size > 0 && size <= MAX_POOLED_SIZE) ? pools[(size - 1) / SlabAllocator::BLOCK_ALIGNMENT] : NULL;
+}
+
+// create the pools during static initialization, before there are threads that could race to create them
+static SlabAllocator* smallestPool = getPool(1);
+
+static void* allocatePooled(size_t size) {
+    SlabAllocator* pool = getPool(size);
+    return pool ? pool->allocate() : ::operator new(size);
+}
+
+static void deallocatePooled(void* block, size_t size) {
+    SlabAllocator* pool = getPool(size);
+    if (pool) {
+        pool->deallocate(block);
+    } else {
+        ::operator delete(block);
+    }
+}
+
+static size_t getPooledSize(size_t size) {
+    SlabAllocator* pool = getPool(size);
+    return pool ? pool->getBlockSize() : size;
+}
+
+void* OctreeElement::operator new(size_t size) {
+    return allocatePooled(size);
+}
+
+void OctreeElement::operator delete(void* element, size_t size) {
+    deallocatePooled(element, size);
+}
+
+quint64 OctreeElement::getPooledMemoryReserved() {
+    quint64 reserved = 0;
+    for (size_t size = smallestPool->getBlockSize(); size <= MAX_POOLED_SIZE; size += SlabAllocator::BLOCK_ALIGNMENT) {
+        reserved += getPool(size)->getBytesReserved();
+    }
+    return reserved;
+}
+
 OctreeElement::OctreeElement() {
     // Note: you must call init() from your subclass, otherwise the OctreeElement will not be properly
     // initialized. You will see DEADBEEF in your memory debugger if you have not properly called init()
@@ -46,9 +104,9 @@ OctreeElement::OctreeElement() {
 }
 
 void OctreeElement::init(unsigned char * octalCode) {
+    unsigned char rootOctalCode = 0;
     if (!octalCode) {
-        octalCode = new unsigned char[1];
-        *octalCode = 0;
+        octalCode = &rootOctalCode;
     }
     _voxelNodeCount++;
     _voxelNodeLeafCount++; // all nodes start as leaf nodes
@@ -56,13 +114,13 @@ void OctreeElement::init(unsigned char * octalCode) {
 
     size_t octalCodeLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(octalCode));
     if (octalCodeLength > sizeof(_octalCode)) {
-        _octalCode.pointer = octalCode;
+        _octalCode.pointer = static_cast<unsigned char*>(allocatePooled(octalCodeLength));
+        memcpy(_octalCode.pointer, octalCode, octalCodeLength);
         _octcodePointer = true;
-        _octcodeMemoryUsage += octalCodeLength;
+        _octcodeMemoryUsage += getPooledSize(octalCodeLength);
     } else {
         _octcodePointer = false;
         memcpy(_octalCode.buffer, octalCode, octalCodeLength);
-        delete[] octalCode;
     }
 
     // set up the _children union
@@ -73,15 +131,7 @@ void OctreeElement::init(unsigned char * octalCode) {
     _childrenCount[0]++;
 
     // default pointers to child nodes to NULL
-#ifdef SIMPLE_CHILD_ARRAY
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        _simpleChildArray[i] = NULL;
-    }
-#endif
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
     _children.single = NULL;
-#endif
 
     _isDirty = true;
     _shouldRender = false;
@@ -98,8 +148,9 @@ OctreeElement::~OctreeElement() {
     }
 
     if (_octcodePointer) {
-        _octcodeMemoryUsage -= bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(getOctalCode()));
-        delete[] _octalCode.pointer;
+        size_t octalCodeLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(getOctalCode()));
+        _octcodeMemoryUsage -= getPooledSize(octalCodeLength);
+        deallocatePooled(_octalCode.pointer, octalCodeLength);
     }
 
     // delete all of this node's children, this also takes care of all population tracking data
@@ -245,78 +296,57 @@ quint64 OctreeElement::_setChildAtIndexCalls = 0;
 quint64 OctreeElement::_externalChildrenCount = 0;
 quint64 OctreeElement::_childrenCount[NUMBER_OF_CHILDREN + 1] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
-OctreeElement* OctreeElement::getChildAtIndex(int childIndex) const {
-#ifdef SIMPLE_CHILD_ARRAY
-    return _simpleChildArray[childIndex];
-#endif // SIMPLE_CHILD_ARRAY
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-    int childCount = getChildCount();
+// external child arrays grow and shrink two pointers at a time, which keeps them in the smallest pool that fits
+static size_t getExternalChildrenSize(int childCount) {
+    return ((childCount + 1) & ~1) * sizeof(OctreeElement*);
+}
 
-    switch (childCount) {
-        case 0: {
-            return NULL;
-        } break;
-
-        case 1: {
-            // if our single child is the one being requested, return it, otherwise
-            // return null
-            int firstIndex = getNthBit(_childBitmask, 1);
-            if (firstIndex == childIndex) {
-                return _children.single;
-            } else {
-                return NULL;
-            }
-        } break;
+int OctreeElement::getChildSlot(int childIndex) const {
+    // children are packed in child index order, and lower child indexes are kept in the higher bits of the mask
+    return numberOfOnes(_childBitmask & (0xFF00 >> childIndex));
+}
 
-        default : {
-            return _children.external[childIndex];
-        } break;
+OctreeElement* OctreeElement::getChildAtIndex(int childIndex) const {
+    if (!oneAtBit(_childBitmask, childIndex)) {
+        return NULL;
     }
-#endif // def SIMPLE_EXTERNAL_CHILDREN
+    return _childrenExternal ? _children.external[getChildSlot(childIndex)] : _children.single;
 }
 
 void OctreeElement::deleteAllChildren() {
     // first delete all the OctreeElement objects...
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        OctreeElement* childAt = getChildAtIndex(i);
-        if (childAt) {
-            delete childAt;
-        }
+    int childCount = getChildCount();
+    OctreeElement* const* children = getChildren();
+    for (int i = 0; i < childCount; i++) {
+        delete children[i];
     }
 
     if (_childrenExternal) {
         // if the children_t union represents _children.external we need to delete it here
-        delete[] _children.external;
+        deallocatePooled(_children.external, getExternalChildrenSize(childCount));
+        _externalChildrenMemoryUsage -= getPooledSize(getExternalChildrenSize(childCount));
     }
 }
 
 void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
-#ifdef SIMPLE_CHILD_ARRAY
-    int previousChildCount = getChildCount();
-    if (child) {
-        setAtBit(_childBitmask, childIndex);
-    } else {
-        clearAtBit(_childBitmask, childIndex);
-    }
-    int newChildCount = getChildCount();
+    bool hadChild = oneAtBit(_childBitmask, childIndex);
 
-    // store the child in our child array
-    _simpleChildArray[childIndex] = child;
-
-    // track our population data
-    if (previousChildCount != newChildCount) {
-        _childrenCount[previousChildCount]--;
-        _childrenCount[newChildCount]++;
+    if (hadChild && child) {
+        // replacing a child doesn't change the layout
+        if (_childrenExternal) {
+            _children.external[getChildSlot(childIndex)] = child;
+        } else {
+            _children.single = child;
+        }
+        return;
     }
-#endif
 
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-
-    int firstIndex = getNthBit(_childBitmask, 1);
-    int secondIndex = getNthBit(_childBitmask, 2);
+    if (!hadChild && !child) {
+        return;
+    }
 
     int previousChildCount = getChildCount();
+    int slot = getChildSlot(childIndex);
     if (child) {
         setAtBit(_childBitmask, childIndex);
     } else {
@@ -325,45 +355,54 @@ void OctreeElement::setChildAtIndex(int childIndex, OctreeElement* child) {
     int newChildCount = getChildCount();
 
     // track our population data
-    if (previousChildCount != newChildCount) {
-        _childrenCount[previousChildCount]--;
-        _childrenCount[newChildCount]++;
-    }
+    _childrenCount[previousChildCount]--;
+    _childrenCount[newChildCount]++;
 
-    if ((previousChildCount == 0 || previousChildCount == 1) && newChildCount == 0) {
+    if (newChildCount == 0) {
         _children.single = NULL;
-    } else if (previousChildCount == 0 && newChildCount == 1) {
+    } else if (previousChildCount == 0) {
         _children.single = child;
-    } else if (previousChildCount == 1 && newChildCount == 2) {
-        OctreeElement* previousChild = _children.single;
-        _children.external = new OctreeElement*[NUMBER_OF_CHILDREN];
-        memset(_children.external, 0, sizeof(OctreeElement*) * NUMBER_OF_CHILDREN);
-        _children.external[firstIndex] = previousChild;
-        _children.external[childIndex] = child;
-
-        _childrenExternal = true;
-
-        _externalChildrenMemoryUsage += NUMBER_OF_CHILDREN * sizeof(OctreeElement*);
-
-    } else if (previousChildCount == 2 && newChildCount == 1) {
-        assert(!child); // we are removing a child, so this must be true!
-        OctreeElement* previousFirstChild = _children.external[firstIndex];
-        OctreeElement* previousSecondChild = _children.external[secondIndex];
-
-        delete[] _children.external;
+    } else if (newChildCount == 1) {
+        // going from two children to one, keep the one that is left inline
+        OctreeElement* remainingChild = _children.external[1 - slot];
+        deallocatePooled(_children.external, getExternalChildrenSize(previousChildCount));
         _childrenExternal = false;
+        _externalChildrenMemoryUsage -= getPooledSize(getExternalChildrenSize(previousChildCount));
+        _children.single = remainingChild;
+    } else {
+        OctreeElement** previousChildren = _childrenExternal ? _children.external : &_children.single;
+        OctreeElement** children = previousChildren;
+
+        size_t previousSize = _childrenExternal ? getExternalChildrenSize(previousChildCount) : 0;
+        size_t newSize = getExternalChildrenSize(newChildCount);
+        if (newSize != previousSize) {
+            children = static_cast<OctreeElement**>(allocatePooled(newSize));
+            _externalChildrenMemoryUsage += getPooledSize(newSize);
+        }
 
-        _externalChildrenMemoryUsage -= NUMBER_OF_CHILDREN * sizeof(OctreeElement*);
-        if (childIndex == firstIndex) {
-            _children.single = previousSecondChild;
+        // keep the children packed in child index order, moving the ones after the changed slot along by one
+        if (child) {
+            memmove(children + slot + 1, previousChildren + slot, (previousChildCount - slot) * sizeof(OctreeElement*));
+            if (children != previousChildren) {
+                memcpy(children, previousChildren, slot * sizeof(OctreeElement*));
+            }
+            children[slot] = child;
         } else {
-            _children.single = previousFirstChild;
+            if (children != previousChildren) {
+                memcpy(children, previousChildren, slot * sizeof(OctreeElement*));
+            }
+            memmove(children + slot, previousChildren + slot + 1, (newChildCount - slot) * sizeof(OctreeElement*));
         }
-    } else {
-        _children.external[childIndex] = child;
-    }
 
-#endif // def SIMPLE_EXTERNAL_CHILDREN
+        if (children != previousChildren) {
+            if (_childrenExternal) {
+                deallocatePooled(previousChildren, previousSize);
+                _externalChildrenMemoryUsage -= getPooledSize(previousSize);
+            }
+            _children.external = children;
+            _childrenExternal = true;
+        }
+    }
 }
 
 
@@ -375,7 +414,8 @@ OctreeElement* OctreeElement::addChildAtIndex(int childIndex) {
             _voxelNodeLeafCount--;
         }
 
-        unsigned char* newChildCode = childOctalCode(getOctalCode(), childIndex);
+        unsigned char newChildCode[MAX_OCTAL_CODE_BYTES];
+        childOctalCode(getOctalCode(), childIndex, newChildCode);
         childAt = createNewElement(newChildCode);
         setChildAtIndex(childIndex, childAt);
 
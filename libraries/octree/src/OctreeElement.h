@@ -12,9 +12,6 @@
 #ifndef hifi_OctreeElement_h
 #define hifi_OctreeElement_h
 
-//#define SIMPLE_CHILD_ARRAY
-#define SIMPLE_EXTERNAL_CHILDREN
-
 #include <QReadWriteLock>
 
 #include <OctalCode.h>
@@ -56,9 +53,14 @@ protected:
     virtual OctreeElement* createNewElement(unsigned char * octalCode = NULL) = 0;
     
 public:
-    virtual void init(unsigned char * octalCode); /// Your subclass must call init on construction.
+    virtual void init(unsigned char * octalCode); /// Your subclass must call init on construction. The code is copied.
     virtual ~OctreeElement();
 
+    /// Elements of every tree are carved out of shared slabs rather than allocated one by one, which keeps large trees
+    /// from costing millions of heap allocations and keeps elements created together close together in memory.
+    static void* operator new(size_t size);
+    static void operator delete(void* element, size_t size);
+
     // methods you can and should override to implement your tree functionality
     
     /// Adds a child to the current element. Override this if there is additional child initialization your class needs.
@@ -133,6 +135,11 @@ public:
     // Base class methods you don't need to implement
     const unsigned char* getOctalCode() const { return (_octcodePointer) ? _octalCode.pointer : &_octalCode.buffer[0]; }
     OctreeElement* getChildAtIndex(int childIndex) const;
+
+    /// The children in child index order, getChildCount() of them. Walking these is cheaper than asking for each
+    /// index, but the pointer is only good until a child is added or removed.
+    OctreeElement* const* getChildren() const { return _childrenExternal ? _children.external : &_children.single; }
+
     void deleteChildAtIndex(int childIndex);
     OctreeElement* removeChildAtIndex(int childIndex);
     bool isParentOf(OctreeElement* possibleChild) const;
@@ -197,6 +204,9 @@ public:
     static quint64 getExternalChildrenMemoryUsage() { return _externalChildrenMemoryUsage; }
     static quint64 getTotalMemoryUsage() { return _octreeMemoryUsage + _octcodeMemoryUsage + _externalChildrenMemoryUsage; }
 
+    /// what the slabs behind elements, long octal codes and external children take, including freed blocks kept for reuse
+    static quint64 getPooledMemoryReserved();
+
     static quint64 getGetChildAtIndexTime() { return _getChildAtIndexTime; }
     static quint64 getGetChildAtIndexCalls() { return _getChildAtIndexCalls; }
     static quint64 getSetChildAtIndexTime() { return _setChildAtIndexTime; }
@@ -242,6 +252,7 @@ protected:
 
     void deleteAllChildren();
     void setChildAtIndex(int childIndex, OctreeElement* child);
+    int getChildSlot(int childIndex) const;
 
     void calculateAACube();
     void notifyDeleteHooks();
@@ -257,17 +268,12 @@ protected:
 
     quint64 _lastChanged; /// Client and server, timestamp this node was last changed, 8 bytes
 
-    /// Client and server, pointers to child nodes, various encodings
-#ifdef SIMPLE_CHILD_ARRAY
-    OctreeElement* _simpleChildArray[8]; /// Only used when SIMPLE_CHILD_ARRAY is enabled
-#endif
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
+    /// Client and server, pointers to child nodes. A lone child is kept inline, otherwise the children are packed into
+    /// an array in child index order, so the slot of a child is the number of children before it in _childBitmask.
     union children_t {
       OctreeElement* single;
       OctreeElement** external;
     } _children;
-#endif
     
     uint16_t _sourceUUIDKey; /// Client only, stores node id of voxel server that sent his voxel, 2 bytes
 
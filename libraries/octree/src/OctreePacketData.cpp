@@ -12,6 +12,7 @@
 #include <GLMHelpers.h>
 #include <PerfStat.h>
 
+#include "OctreeClientBaselines.h"
 #include "OctreeLogging.h"
 #include "OctreePacketData.h"
 
@@ -25,7 +26,9 @@ quint64 OctreePacketData::_totalBytesOfRawData = 0;
 
 
 
-OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
+OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) :
+    _clientBaselines(NULL)
+{
     changeSettings(enableCompression, targetSize); // does reset...
 }
 
@@ -48,6 +51,8 @@ void OctreePacketData::reset() {
     _bytesOfBitMasks = 0;
     _bytesOfColor = 0;
     _bytesOfOctalCodesCurrentSubTree = 0;
+
+    _discardedTo.clear();
 }
 
 OctreePacketData::~OctreePacketData() {
@@ -210,6 +215,7 @@ void OctreePacketData::discardSubTree() {
     _bytesAvailable += bytesInSubTree; 
     _subTreeAt = _bytesInUse; // should be the same actually...
     _dirty = true;
+    _discardedTo.push_back(_bytesInUse);
 
     // rewind to start of this subtree, other items rewound by endLevel()
     int reduceBytesOfOctalCodes = _bytesOfOctalCodes - _bytesOfOctalCodesCurrentSubTree;
@@ -220,6 +226,19 @@ void OctreePacketData::discardSubTree() {
     _bytesReserved = _subTreeBytesReserved;
 }
 
+bool OctreePacketData::wasDiscardedSince(int discardCount, int offset) const {
+    for (int i = discardCount; i < _discardedTo.size(); i++) {
+        if (_discardedTo[i] <= offset) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OctreePacketData::isUnchangedForClient(int property, int offset) {
+    return _clientBaselines && _clientBaselines->isUnchanged(*this, property, offset);
+}
+
 LevelDetails OctreePacketData::startLevel() {
     LevelDetails key(_bytesInUse, _bytesOfOctalCodes, _bytesOfBitMasks, _bytesOfColor, _bytesReserved);
     return key;
@@ -249,6 +268,7 @@ void OctreePacketData::discardLevel(LevelDetails key) {
     _bytesInUse -= bytesInLevel;
     _bytesAvailable += bytesInLevel; 
     _dirty = true;
+    _discardedTo.push_back(_bytesInUse);
     
     // reserved bytes are reset to the value when the level started
     _bytesReserved = key._bytesReservedAtStart;
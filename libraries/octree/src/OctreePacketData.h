@@ -25,6 +25,7 @@
 #include <QByteArray>
 #include <QString>
 #include <QUuid>
+#include <QVector>
 
 #include <LimitedNodeList.h> // for MAX_PACKET_SIZE
 #include <udt/PacketHeaders.h> // for MAX_PACKET_HEADER_BYTES
@@ -35,6 +36,8 @@
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
 
+class OctreeClientBaselines;
+
 typedef unsigned char OCTREE_PACKET_FLAGS;
 typedef uint16_t OCTREE_PACKET_SEQUENCE;
 const uint16_t MAX_OCTREE_PACKET_SEQUENCE = 65535;
@@ -209,6 +212,22 @@ public:
     /// update the size of the packet in uncompressed form
     void setUncompressedSize(int newSize) { _bytesInUse = newSize; }
 
+    /// the number of discards since the last reset(), to pass to wasDiscardedSince() for bytes written before now
+    int getDiscardCount() const { return _discardedTo.size(); }
+
+    /// true if the bytes at offset, which were written before getDiscardCount() returned discardCount, have been
+    /// discarded since
+    bool wasDiscardedSince(int discardCount, int offset) const;
+
+    /// what the client this packet is for already has, so that encoders can leave out what has not changed. Not
+    /// changed by reset(), NULL when the packet is not for one particular client.
+    void setClientBaselines(OctreeClientBaselines* clientBaselines) { _clientBaselines = clientBaselines; }
+    OctreeClientBaselines* getClientBaselines() const { return _clientBaselines; }
+
+    /// called with a property that was just appended at offset, returns true if the client already has exactly that
+    /// and it should be discarded again
+    bool isUnchangedForClient(int property, int offset);
+
     /// has some content been written to the packet
     bool hasContent() const { return (_bytesInUse > 0); }
 
@@ -285,6 +304,9 @@ private:
 
     int _bytesOfOctalCodesCurrentSubTree;
 
+    QVector<int> _discardedTo; // the size each discard since the last reset() cut the uncompressed stream back to
+    OctreeClientBaselines* _clientBaselines;
+
     static bool _debug;
 
     static quint64 _compressContentTime;
@@ -0,0 +1,280 @@
+//
+//  OctreePersistLog.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <SharedUtil.h>
+#include <udt/PacketHeaders.h>
+
+#include "Octree.h"
+#include "OctreeLogging.h"
+
+#include "OctreePersistLog.h"
+
+const quint32 PERSIST_LOG_MAGIC = 0x48464f50; // "HFOP"
+const quint8 PERSIST_LOG_FORMAT_VERSION = 1;
+
+// QFile::flush() only hands the data to the OS, this also has it written to the disk
+static bool syncToDisk(QFile& file) {
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(file.handle()) == 0;
+#else
+    return fsync(file.handle()) == 0;
+#endif
+}
+
+// quint32 payload size and quint8 record type, then the payload, then a quint16 checksum of all of that
+const int RECORD_HEADER_SIZE = sizeof(quint32) + sizeof(quint8);
+const int RECORD_CHECKSUM_SIZE = sizeof(quint16);
+
+bool OctreePersistRecordWriter::writeRecord(quint8 recordType, const QByteArray& payload) {
+    if (_hasFailed) {
+        return false;
+    }
+    QByteArray record(RECORD_HEADER_SIZE, 0);
+    qToBigEndian<quint32>(payload.size(), reinterpret_cast<uchar*>(record.data()));
+    record[sizeof(quint32)] = (char)recordType;
+    record.append(payload);
+
+    QByteArray checksum(RECORD_CHECKSUM_SIZE, 0);
+    qToBigEndian<quint16>(qChecksum(record.constData(), record.size()), reinterpret_cast<uchar*>(checksum.data()));
+    record.append(checksum);
+
+    if (_device.write(record) != record.size()) {
+        _hasFailed = true;
+        return false;
+    }
+    _recordCount++;
+    return true;
+}
+
+OctreePersistRecordReader::OctreePersistRecordReader(QIODevice& device) :
+    _device(device),
+    _recordCount(0),
+    _goodSize(device.pos()),
+    _hasReachedEndRecord(false),
+    _isTorn(false)
+{
+}
+
+bool OctreePersistRecordReader::readRecord(quint8& recordType, QByteArray& payload) {
+    if (_hasReachedEndRecord || _isTorn) {
+        return false;
+    }
+    QByteArray record = _device.read(RECORD_HEADER_SIZE);
+    if (record.size() < RECORD_HEADER_SIZE) {
+        _isTorn = !record.isEmpty();
+        return false;
+    }
+    quint32 payloadSize = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(record.constData()));
+    if (payloadSize > MAX_RECORD_SIZE) {
+        _isTorn = true;
+        return false;
+    }
+    record.append(_device.read(payloadSize + RECORD_CHECKSUM_SIZE));
+    if (record.size() < (int)(RECORD_HEADER_SIZE + payloadSize + RECORD_CHECKSUM_SIZE)) {
+        _isTorn = true;
+        return false;
+    }
+    int checksumOffset = RECORD_HEADER_SIZE + payloadSize;
+    quint16 checksum = qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(record.constData() + checksumOffset));
+    if (checksum != qChecksum(record.constData(), checksumOffset)) {
+        _isTorn = true;
+        return false;
+    }
+
+    _goodSize = _device.pos();
+    recordType = (quint8)record[sizeof(quint32)];
+    if (recordType == OctreePersistLog::END_RECORD) {
+        _hasReachedEndRecord = true;
+        return false;
+    }
+    payload = record.mid(RECORD_HEADER_SIZE, payloadSize);
+    _recordCount++;
+    return true;
+}
+
+OctreePersistLog::OctreePersistLog(Octree* tree, const QString& snapshotFileName) :
+    _tree(tree),
+    _snapshotFileName(snapshotFileName),
+    _logFileName(snapshotFileName + ".log"),
+    _generation(0),
+    _snapshotSize(0),
+    _logSize(0),
+    _logRecordCount(0),
+    _logIsCurrent(false),
+    _needsSnapshot(false)
+{
+}
+
+bool OctreePersistLog::hasSnapshot() const {
+    return QFileInfo(_snapshotFileName).exists();
+}
+
+bool OctreePersistLog::load() {
+    QFile snapshotFile(_snapshotFileName);
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        qCDebug(octree) << "unable to open persist snapshot for reading:" << _snapshotFileName;
+        return false;
+    }
+    quint64 generation;
+    if (!readHeader(snapshotFile, SNAPSHOT_FILE, generation)) {
+        qCDebug(octree) << "not a persist snapshot:" << _snapshotFileName;
+        return false;
+    }
+
+    OctreePersistRecordReader snapshotReader(snapshotFile);
+    bool success = _tree->readPersistRecords(snapshotReader);
+    if (!snapshotReader.hasReachedEndRecord()) {
+        // snapshots are only ever renamed into place once complete, so this is damage rather than a crash
+        qCDebug(octree) << "persist snapshot" << _snapshotFileName << "is incomplete, loaded"
+                        << snapshotReader.getRecordCount() << "records";
+        success = false;
+    }
+    _generation = generation;
+    _snapshotSize = snapshotFile.size();
+    _logSize = 0;
+    _logRecordCount = 0;
+    _logIsCurrent = false;
+
+    QFile logFile(_logFileName);
+    quint64 logGeneration;
+    if (!logFile.open(QIODevice::ReadOnly)) {
+        return success;
+    }
+    if (!readHeader(logFile, LOG_FILE, logGeneration) || logGeneration != _generation) {
+        qCDebug(octree) << "ignoring persist log" << _logFileName << "of an older snapshot";
+        return success;
+    }
+
+    OctreePersistRecordReader logReader(logFile);
+    if (!_tree->readPersistRecords(logReader)) {
+        success = false;
+    }
+    if (logReader.isTorn()) {
+        qCDebug(octree) << "dropping" << (logFile.size() - logReader.getGoodSize())
+                        << "bytes of a torn record at the end of" << _logFileName;
+    }
+    _logSize = logReader.getGoodSize();
+    _logRecordCount = logReader.getRecordCount();
+    _logIsCurrent = true;
+
+    qCDebug(octree) << "replayed" << _logRecordCount << "persist log records over snapshot" << _snapshotFileName;
+    return success;
+}
+
+bool OctreePersistLog::appendChanges() {
+    if (_generation == 0 || _needsSnapshot) {
+        return writeSnapshot();
+    }
+    if (!_logIsCurrent && !resetLog()) {
+        return false;
+    }
+
+    QFile logFile(_logFileName);
+    if (!logFile.open(QIODevice::ReadWrite)) {
+        qCDebug(octree) << "unable to open persist log for appending:" << _logFileName;
+        return false;
+    }
+    if (logFile.size() != _logSize) {
+        logFile.resize(_logSize); // a torn record from a crash while appending
+    }
+    logFile.seek(_logSize);
+
+    OctreePersistRecordWriter writer(logFile);
+    bool success = _tree->writePersistChanges(writer) && !writer.hasFailed() && logFile.flush();
+    if (!success) {
+        // what the tree handed over is lost from the log, only a snapshot has it now
+        qCDebug(octree) << "unable to append to persist log:" << _logFileName;
+        _needsSnapshot = true;
+        return false;
+    }
+    _logSize = logFile.pos();
+    _logRecordCount += writer.getRecordCount();
+    return true;
+}
+
+bool OctreePersistLog::writeSnapshot() {
+    // the generation only has to differ from the previous snapshot's, even across restarts
+    quint64 generation = std::max(usecTimestampNow(), _generation + 1);
+
+    QSaveFile snapshotFile(_snapshotFileName);
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qCDebug(octree) << "unable to open persist snapshot for writing:" << _snapshotFileName;
+        _needsSnapshot = true;
+        return false;
+    }
+    OctreePersistRecordWriter writer(snapshotFile);
+    bool success = writeHeader(snapshotFile, SNAPSHOT_FILE, generation) && _tree->writePersistSnapshot(writer)
+        && writer.writeRecord(END_RECORD, QByteArray());
+    if (!success || !snapshotFile.commit()) {
+        qCDebug(octree) << "unable to write persist snapshot:" << _snapshotFileName;
+        snapshotFile.cancelWriting();
+        _needsSnapshot = true;
+        return false;
+    }
+    _generation = generation;
+    _snapshotSize = QFileInfo(_snapshotFileName).size();
+    _needsSnapshot = false;
+
+    qCDebug(octree) << "wrote persist snapshot" << _snapshotFileName << "of" << (writer.getRecordCount() - 1) << "records";
+
+    // the old log only has changes the snapshot already has. If this fails the old log is ignored on load, since it
+    // belongs to the previous generation, and the next append tries again
+    resetLog();
+    return true;
+}
+
+bool OctreePersistLog::wantsSnapshot() const {
+    return _needsSnapshot || _generation == 0 || (_logSize > MIN_SIZE_TO_COMPACT && _logSize > _snapshotSize);
+}
+
+bool OctreePersistLog::writeHeader(QIODevice& device, FileKind fileKind, quint64 generation) {
+    QDataStream stream(&device);
+    stream << PERSIST_LOG_MAGIC << PERSIST_LOG_FORMAT_VERSION << (quint8)fileKind
+           << (quint8)versionForPacketType(_tree->expectedDataPacketType()) << generation;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool OctreePersistLog::readHeader(QIODevice& device, FileKind fileKind, quint64& generation) {
+    QDataStream stream(&device);
+    quint32 magic;
+    quint8 formatVersion, kind, packetVersion;
+    stream >> magic >> formatVersion >> kind >> packetVersion >> generation;
+    // the records are keyed by property names rather than packet versions, so older trees still load
+    return stream.status() == QDataStream::Ok && magic == PERSIST_LOG_MAGIC
+        && formatVersion == PERSIST_LOG_FORMAT_VERSION && kind == fileKind;
+}
+
+bool OctreePersistLog::resetLog() {
+    QFile logFile(_logFileName);
+    _logIsCurrent = logFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        && writeHeader(logFile, LOG_FILE, _generation) && syncToDisk(logFile);
+    if (!_logIsCurrent) {
+        qCDebug(octree) << "unable to start persist log:" << _logFileName;
+        return false;
+    }
+    _logSize = logFile.pos();
+    _logRecordCount = 0;
+    return true;
+}
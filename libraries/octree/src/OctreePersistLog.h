@@ -0,0 +1,123 @@
+//
+//  OctreePersistLog.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Binary octree persistence as a compacted snapshot plus an append-only log of the changes made since
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePersistLog_h
+#define hifi_OctreePersistLog_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+class Octree;
+class QIODevice;
+
+/// Writes length prefixed, checksummed records. What a record holds is up to the tree, record type 0 is reserved for
+/// the end of a snapshot.
+class OctreePersistRecordWriter {
+public:
+    OctreePersistRecordWriter(QIODevice& device) : _device(device), _recordCount(0), _hasFailed(false) { }
+
+    /// returns false once a write to the device has failed, every later write fails too
+    bool writeRecord(quint8 recordType, const QByteArray& payload);
+
+    int getRecordCount() const { return _recordCount; }
+    bool hasFailed() const { return _hasFailed; }
+
+private:
+    QIODevice& _device;
+    int _recordCount;
+    bool _hasFailed;
+};
+
+/// Reads the records of an OctreePersistRecordWriter back. A record that was cut short by a crash, or does not match its
+/// checksum, ends the reading just like the end of the device does.
+class OctreePersistRecordReader {
+public:
+    static const quint32 MAX_RECORD_SIZE = 16 * 1024 * 1024;
+
+    OctreePersistRecordReader(QIODevice& device);
+
+    /// returns false at the end of the records
+    bool readRecord(quint8& recordType, QByteArray& payload);
+
+    int getRecordCount() const { return _recordCount; }
+    qint64 getGoodSize() const { return _goodSize; } /// the device offset just past the last good record
+    bool hasReachedEndRecord() const { return _hasReachedEndRecord; }
+    bool isTorn() const { return _isTorn; } /// true if there was anything but a clean end after the last good record
+
+private:
+    QIODevice& _device;
+    int _recordCount;
+    qint64 _goodSize;
+    bool _hasReachedEndRecord;
+    bool _isTorn;
+};
+
+/// Persists a tree that supports it (see Octree::canPersistLog()) as a snapshot file and a log file next to it named
+/// snapshot + ".log". Persisting appends only what the tree tracked as changed since the last persist, and every so
+/// often the log is compacted into a new snapshot, which is streamed out of the tree a few entities at a time rather
+/// than built in memory first. Loading reads the snapshot and replays the log over it.
+///
+/// Both files carry the generation of the snapshot they belong to. A new snapshot is committed to disk before the log
+/// is reset, so a crash in between leaves a log of the previous generation, which is ignored on load since the new
+/// snapshot already has all of its changes. A crash while appending leaves a torn last record, which is dropped.
+///
+/// Snapshots and the start of each new log are synced to the disk. Appends are only flushed to the OS, so they survive
+/// the server crashing but the last of them can be lost to a power failure or OS crash.
+class OctreePersistLog {
+public:
+    static const quint8 END_RECORD = 0;
+    static const qint64 MIN_SIZE_TO_COMPACT = 1024 * 1024;
+
+    OctreePersistLog(Octree* tree, const QString& snapshotFileName);
+
+    const QString& getSnapshotFileName() const { return _snapshotFileName; }
+    const QString& getLogFileName() const { return _logFileName; }
+    bool hasSnapshot() const;
+
+    /// reads the snapshot and replays the log, the caller must write lock the tree. Does not change the files, a torn
+    /// record at the end of the log is only cut off by the next appendChanges().
+    bool load();
+
+    /// appends what changed since the last persist to the log, or writes a snapshot if there is no snapshot to log
+    /// against yet. Locks the tree itself.
+    bool appendChanges();
+
+    /// writes a new snapshot and starts an empty log for it. Locks the tree itself.
+    bool writeSnapshot();
+
+    /// true once the log has grown larger than the snapshot it would be compacted into
+    bool wantsSnapshot() const;
+
+    qint64 getSnapshotSize() const { return _snapshotSize; }
+    qint64 getLogSize() const { return _logSize; }
+    int getLogRecordCount() const { return _logRecordCount; }
+
+private:
+    enum FileKind { SNAPSHOT_FILE = 1, LOG_FILE = 2 };
+
+    bool writeHeader(QIODevice& device, FileKind fileKind, quint64 generation);
+    bool readHeader(QIODevice& device, FileKind fileKind, quint64& generation);
+    bool resetLog();
+
+    Octree* _tree;
+    QString _snapshotFileName;
+    QString _logFileName;
+
+    quint64 _generation; // 0 until there is a snapshot
+    qint64 _snapshotSize;
+    qint64 _logSize; // up to the last good record, only meaningful while _logIsCurrent
+    int _logRecordCount;
+    bool _logIsCurrent; // false if the log on disk is missing or belongs to another generation
+    bool _needsSnapshot; // set when an append failed, the changes it took are only in the tree now
+};
+
+#endif // hifi_OctreePersistLog_h
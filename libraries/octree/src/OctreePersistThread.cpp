@@ -49,7 +49,15 @@ OctreePersistThread::OctreePersistThread(Octree* tree, const QString& filename,
 
     // in case the persist filename has an extension that doesn't match the file type
     QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
+    if (_persistAsFileType == "bin" && !_tree->canPersistLog()) {
+        qCDebug(octree) << "this tree can not persist as bin, persisting as svo instead";
+        _persistAsFileType = "svo";
+    }
     _filename = sansExt + "." + _persistAsFileType;
+
+    if (_persistAsFileType == "bin") {
+        _persistLog.reset(new OctreePersistLog(_tree, _filename));
+    }
 }
 
 void OctreePersistThread::parseSettings(const QJsonObject& settings) {
@@ -149,8 +157,18 @@ bool OctreePersistThread::process() {
                 qCDebug(octree) << "Loading Octree... lock file removed:" << lockFileName;
             }
 
-            persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            if (_persistLog && _persistLog->hasSnapshot()) {
+                persistantFileRead = _persistLog->load();
+            } else {
+                // when first switching to bin this picks up the most recent file of the other types
+                persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+            }
             _tree->pruneTree();
+
+            if (_persistLog) {
+                // from here on the tree collects its changes for the log
+                _tree->setTrackPersistChanges(true);
+            }
         }
         _tree->unlock();
 
@@ -232,7 +250,13 @@ void OctreePersistThread::aboutToFinish() {
 }
 
 void OctreePersistThread::persist() {
+    if (_persistLog) {
+        persistToLog();
+        return;
+    }
+
     if (_tree->isDirty()) {
+        TRACE_SCOPE("OctreePersistThread::persist");
         _tree->lockForWrite();
         {
             qCDebug(octree) << "pruning Octree before saving...";
@@ -265,6 +289,47 @@ void OctreePersistThread::persist() {
     }
 }
 
+void OctreePersistThread::persistToLog() {
+    TRACE_SCOPE("OctreePersistThread::persistToLog");
+    bool wasDirty = _tree->isDirty();
+    if (wasDirty) {
+        // cleared first, so that an edit made while appending leaves the tree dirty for the next persist
+        _tree->clearDirtyBit();
+        _persistLog->appendChanges();
+        time(&_lastPersistTime);
+    }
+
+    // backups are copies of the snapshot, so one is written first to have everything in it
+    bool backupDue = wasDirty && isBackupDue();
+    if (_persistLog->wantsSnapshot() || backupDue) {
+        qCDebug(octree) << "compacting persist log of" << _persistLog->getLogRecordCount() << "records,"
+                        << _persistLog->getLogSize() << "bytes, into a snapshot...";
+        _tree->lockForWrite();
+        _tree->pruneTree();
+        _tree->unlock();
+
+        if (_persistLog->writeSnapshot()) {
+            time(&_lastPersistTime);
+        }
+    }
+    if (backupDue) {
+        backup();
+    }
+}
+
+bool OctreePersistThread::isBackupDue() const {
+    if (!_wantBackup) {
+        return false;
+    }
+    quint64 now = usecTimestampNow();
+    foreach (const BackupRule& rule, _backupRules) {
+        if (rule.maxBackupVersions > 0 && now - rule.lastBackup > (quint64)rule.interval * USECS_PER_SECOND) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void OctreePersistThread::restoreFromMostRecentBackup() {
     qCDebug(octree) << "Restoring from most recent backup...";
     
@@ -14,9 +14,11 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <QScopedPointer>
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreePersistLog.h"
 
 /// Generalized threaded processor for handling received inbound packets.
 class OctreePersistThread : public GenericThread {
@@ -50,6 +52,8 @@ protected:
     virtual bool process();
     
     void persist();
+    void persistToLog();
+    bool isBackupDue() const;
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
@@ -74,6 +78,7 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+    QScopedPointer<OctreePersistLog> _persistLog; // only when persisting as "bin"
 };
 
 #endif // hifi_OctreePersistThread_h
@@ -109,6 +109,9 @@ void OctreeSceneStats::copyFromOther(const OctreeSceneStats& other) {
     _existsInPacketBitsWritten = other._existsInPacketBitsWritten;
     _treesRemoved = other._treesRemoved;
 
+    _unchangedPropertiesSkipped = other._unchangedPropertiesSkipped;
+    _unchangedPropertyBytesSaved = other._unchangedPropertyBytesSaved;
+
     // before copying the jurisdictions, delete any current values...
     if (_jurisdictionRoot) {
         delete[] _jurisdictionRoot;
@@ -269,6 +272,9 @@ void OctreeSceneStats::reset() {
     _existsInPacketBitsWritten = 0;
     _treesRemoved = 0;
 
+    _unchangedPropertiesSkipped = 0;
+    _unchangedPropertyBytesSaved = 0;
+
     if (_jurisdictionRoot) {
         delete[] _jurisdictionRoot;
         _jurisdictionRoot = NULL;
@@ -381,6 +387,11 @@ void OctreeSceneStats::childBitsRemoved(bool includesExistsBits, bool includesCo
     _treesRemoved++;
 }
 
+void OctreeSceneStats::unchangedPropertiesSkipped(int properties, int bytesSaved) {
+    _unchangedPropertiesSkipped += properties;
+    _unchangedPropertyBytesSaved += bytesSaved;
+}
+
 int OctreeSceneStats::packIntoPacket() {
     _statsPacket->reset();
 
@@ -415,6 +426,8 @@ int OctreeSceneStats::packIntoPacket() {
     _statsPacket->writePrimitive(_existsBitsWritten);
     _statsPacket->writePrimitive(_existsInPacketBitsWritten);
     _statsPacket->writePrimitive(_treesRemoved);
+    _statsPacket->writePrimitive(_unchangedPropertiesSkipped);
+    _statsPacket->writePrimitive(_unchangedPropertyBytesSaved);
 
     // add the root jurisdiction
     if (_jurisdictionRoot) {
@@ -500,6 +513,8 @@ int OctreeSceneStats::unpackFromPacket(NLPacket& packet) {
     packet.readPrimitive(&_existsBitsWritten);
     packet.readPrimitive(&_existsInPacketBitsWritten);
     packet.readPrimitive(&_treesRemoved);
+    packet.readPrimitive(&_unchangedPropertiesSkipped);
+    packet.readPrimitive(&_unchangedPropertyBytesSaved);
     // before allocating new juridiction, clean up existing ones
     if (_jurisdictionRoot) {
         delete[] _jurisdictionRoot;
@@ -599,6 +614,8 @@ void OctreeSceneStats::printDebugDetails() {
     qCDebug(octree) << "exists bits: " << _existsBitsWritten;
     qCDebug(octree) << "in packet bit: " << _existsInPacketBitsWritten;
     qCDebug(octree) << "trees removed: " << _treesRemoved;
+    qCDebug(octree) << "unchanged properties skipped: " << _unchangedPropertiesSkipped;
+    qCDebug(octree) << "bytes saved: " << _unchangedPropertyBytesSaved;
 }
 
 OctreeSceneStats::ItemInfo OctreeSceneStats::_ITEMS[] = {
@@ -617,6 +634,7 @@ OctreeSceneStats::ItemInfo OctreeSceneStats::_ITEMS[] = {
     { "Skipped - No Change", GREENISH, 3, "Total,Internal,Leaves" },
     { "Skipped - Occluded", YELLOWISH, 3, "Total,Internal,Leaves" },
     { "Didn't fit in packet", GREYISH, 4, "Total,Internal,Leaves,Removed" },
+    { "Unchanged Properties", YELLOWISH, 2, "Skipped,Bytes Saved" },
     { "Mode", GREENISH, 4, "Moving,Stationary,Partial,Full" },
 };
 
@@ -729,6 +747,12 @@ const char* OctreeSceneStats::getItemValue(Item item) {
                     (long unsigned int)_treesRemoved);
             break;
         }
+        case ITEM_UNCHANGED_PROPERTIES: {
+            sprintf(_itemValueBuffer, "%lu skipped %lu bytes saved",
+                    (long unsigned int)_unchangedPropertiesSkipped,
+                    (long unsigned int)_unchangedPropertyBytesSaved);
+            break;
+        }
         case ITEM_BITS: {
             sprintf(_itemValueBuffer, "colors: %lu, exists: %lu, in packets: %lu",
                     (long unsigned int)_colorBitsWritten,
@@ -90,6 +90,9 @@ public:
     /// Fix up tracking statistics in case where bitmasks were removed for some reason
     void childBitsRemoved(bool includesExistsBits, bool includesColors);
 
+    /// Track properties that were left out of the scene because the client already had them
+    void unchangedPropertiesSkipped(int properties, int bytesSaved);
+
     /// Pack the details of the statistics into a buffer for sending as a network packet
     int packIntoPacket();
 
@@ -121,6 +124,7 @@ public:
         ITEM_SKIPPED_NO_CHANGE,
         ITEM_SKIPPED_OCCLUDED,
         ITEM_DIDNT_FIT,
+        ITEM_UNCHANGED_PROPERTIES,
         ITEM_MODE,
         ITEM_COUNT
     };
@@ -159,6 +163,9 @@ public:
     quint32 getLastFullTotalPackets() const { return _lastFullTotalPackets; }
     quint64 getLastFullTotalBytes() const { return _lastFullTotalBytes; }
 
+    quint64 getUnchangedPropertiesSkipped() const { return _unchangedPropertiesSkipped; }
+    quint64 getUnchangedPropertyBytesSaved() const { return _unchangedPropertyBytesSaved; }
+
     // Used in client implementations to track individual octree packets
     void trackIncomingOctreePacket(NLPacket& packet, bool wasStatsPacket, int nodeClockSkewUsec);
 
@@ -237,6 +244,9 @@ private:
     quint64 _existsInPacketBitsWritten;
     quint64 _treesRemoved;
 
+    quint64 _unchangedPropertiesSkipped;
+    quint64 _unchangedPropertyBytesSaved;
+
     // Accounting Notes:
     //
     // 1) number of octrees sent can be calculated as _colorSent + _colorBitsWritten. This works because each internal
@@ -0,0 +1,205 @@
+//
+//  OctreeVisibleSet.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <atomic>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <SharedUtil.h>
+
+#include "Octree.h"
+#include "OctreeElement.h"
+
+#include "OctreeVisibleSet.h"
+
+// the low bits hold the ViewFrustum::location
+const quint8 LOCATION_MASK = 0x03;
+const quint8 IN_LOD = 0x04;
+const quint8 SHOULD_RENDER = 0x08;
+
+/// the subtrees of one compute(), shared with the pool threads helping out. A helper that only starts once every
+/// subtree was taken finds nothing to do, so the set itself may already be gone by then.
+class VisibleSetWalk {
+public:
+    class Subtree {
+    public:
+        OctreeElement* element;
+        ViewFrustum::location parentLocation;
+    };
+
+    VisibleSetWalk(OctreeVisibleSet* visibleSet) : _visibleSet(visibleSet), _nextSubtree(0) { }
+
+    void addSubtree(OctreeElement* element, ViewFrustum::location parentLocation) {
+        Subtree subtree = { element, parentLocation };
+        _subtrees.push_back(subtree);
+    }
+
+    int getSubtreeCount() const { return _subtrees.size(); }
+
+    /// takes subtrees until there are none left
+    void walkSubtrees() {
+        int index;
+        while ((index = _nextSubtree.fetch_add(1)) < _subtrees.size()) {
+            const Subtree& subtree = _subtrees[index];
+            _visibleSet->computeSubtree(subtree.element, subtree.parentLocation,
+                                        _visibleSet->_subtreeResults[OctreeVisibleSet::subtreeIndex(subtree.element)]);
+            _subtreesDone.release();
+        }
+    }
+
+    void waitForSubtrees() { _subtreesDone.acquire(_subtrees.size()); }
+
+private:
+    OctreeVisibleSet* _visibleSet;
+    QVector<Subtree> _subtrees; // not changed once the helpers are started
+    std::atomic<int> _nextSubtree;
+    QSemaphore _subtreesDone;
+};
+
+class VisibleSetHelper : public QRunnable {
+public:
+    VisibleSetHelper(const QSharedPointer<VisibleSetWalk>& walk) : _walk(walk) { }
+    virtual void run() { _walk->walkSubtrees(); }
+
+private:
+    QSharedPointer<VisibleSetWalk> _walk;
+};
+
+OctreeVisibleSet::OctreeVisibleSet(const ViewFrustum& viewFrustum, int boundaryLevelAdjust, float octreeElementSizeScale) :
+    _viewFrustum(viewFrustum),
+    _boundaryLevelAdjust(boundaryLevelAdjust),
+    _octreeElementSizeScale(octreeElementSizeScale),
+    _rootLastChanged(0),
+    _subtreeCount(0),
+    _computeTime(0.0f)
+{
+}
+
+void OctreeVisibleSet::compute(OctreeElement* root) {
+    quint64 start = usecTimestampNow();
+
+    _topResults.clear();
+    for (int i = 0; i < MAX_SUBTREES; i++) {
+        _subtreeResults[i].clear();
+    }
+    _rootLastChanged = root->getLastChanged();
+
+    // the few elements above the subtrees are done here, the encoder passes INTERSECT for the root
+    QSharedPointer<VisibleSetWalk> walk(new VisibleSetWalk(this));
+    computeTop(root, ViewFrustum::INTERSECT, *walk);
+    _subtreeCount = walk->getSubtreeCount();
+
+    // subtrees vary a lot in size, so rather than splitting them up front every thread takes the next one as it finishes
+    int helpers = std::min(QThreadPool::globalInstance()->maxThreadCount(), _subtreeCount - 1);
+    for (int i = 0; i < helpers; i++) {
+        QThreadPool::globalInstance()->start(new VisibleSetHelper(walk));
+    }
+    walk->walkSubtrees();
+    walk->waitForSubtrees();
+
+    _computeTime = (float)(usecTimestampNow() - start);
+}
+
+bool OctreeVisibleSet::matches(quint64 rootLastChanged, const ViewFrustum& viewFrustum, int boundaryLevelAdjust,
+                               float octreeElementSizeScale) const {
+    return rootLastChanged == _rootLastChanged && boundaryLevelAdjust == _boundaryLevelAdjust
+        && octreeElementSizeScale == _octreeElementSizeScale && _viewFrustum.matches(viewFrustum);
+}
+
+bool OctreeVisibleSet::lookup(const OctreeElement* element, ViewFrustum::location& location, bool& inLOD,
+                              bool& shouldRender) const {
+    const ElementResults& results = element->getLevel() < SUBTREE_LEVEL
+        ? _topResults : _subtreeResults[subtreeIndex(element)];
+
+    ElementResults::const_iterator found = results.constFind(element);
+    if (found == results.constEnd()) {
+        return false;
+    }
+    location = (ViewFrustum::location)(found.value() & LOCATION_MASK);
+    inLOD = (found.value() & IN_LOD) != 0;
+    shouldRender = (found.value() & SHOULD_RENDER) != 0;
+    return true;
+}
+
+int OctreeVisibleSet::getElementCount() const {
+    int count = _topResults.size();
+    for (int i = 0; i < MAX_SUBTREES; i++) {
+        count += _subtreeResults[i].size();
+    }
+    return count;
+}
+
+void OctreeVisibleSet::computeTop(OctreeElement* element, ViewFrustum::location parentLocation, VisibleSetWalk& walk) {
+    quint8 result = computeElement(element, parentLocation);
+    _topResults.insert(element, result);
+
+    ViewFrustum::location location = (ViewFrustum::location)(result & LOCATION_MASK);
+    if (location == ViewFrustum::OUTSIDE || !(result & IN_LOD)) {
+        return;
+    }
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElement* childElement = element->getChildAtIndex(i);
+        if (!childElement) {
+            continue;
+        }
+        if (childElement->getLevel() == SUBTREE_LEVEL) {
+            walk.addSubtree(childElement, location);
+        } else {
+            computeTop(childElement, location, walk);
+        }
+    }
+}
+
+// mirrors the order of the tests in Octree::encodeTreeBitstreamRecursion(): the children of an element in view and in LOD
+// are all tested, but only the ones that are themselves in view and in LOD are descended into
+void OctreeVisibleSet::computeSubtree(OctreeElement* element, ViewFrustum::location parentLocation,
+                                      ElementResults& results) const {
+    quint8 result = computeElement(element, parentLocation);
+    results.insert(element, result);
+
+    ViewFrustum::location location = (ViewFrustum::location)(result & LOCATION_MASK);
+    if (location == ViewFrustum::OUTSIDE || !(result & IN_LOD)) {
+        return;
+    }
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElement* childElement = element->getChildAtIndex(i);
+        if (childElement) {
+            computeSubtree(childElement, location, results);
+        }
+    }
+}
+
+quint8 OctreeVisibleSet::computeElement(const OctreeElement* element, ViewFrustum::location parentLocation) const {
+    // a child of an element fully in view is fully in view too
+    ViewFrustum::location location = (parentLocation == ViewFrustum::INSIDE)
+        ? ViewFrustum::INSIDE : element->inFrustum(_viewFrustum);
+
+    quint8 result = (quint8)location;
+    if (location != ViewFrustum::OUTSIDE) {
+        float boundaryDistance = boundaryDistanceForRenderLevel(element->getLevel() + _boundaryLevelAdjust,
+                                                                _octreeElementSizeScale);
+        if (element->distanceToCamera(_viewFrustum) < boundaryDistance) {
+            result |= IN_LOD;
+        }
+        if (element->calculateShouldRender(&_viewFrustum, _octreeElementSizeScale, _boundaryLevelAdjust)) {
+            result |= SHOULD_RENDER;
+        }
+    }
+    return result;
+}
+
+int OctreeVisibleSet::subtreeIndex(const OctreeElement* element) {
+    // the first two three bit sections of the octal code are the child indexes below the root and below that child
+    return element->getOctalCode()[1] >> 2;
+}
@@ -0,0 +1,74 @@
+//
+//  OctreeVisibleSet.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  The view frustum and LOD answers for a client's view, worked out in parallel ahead of encoding a scene
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeVisibleSet_h
+#define hifi_OctreeVisibleSet_h
+
+#include <QtCore/QHash>
+
+#include "ViewFrustum.h"
+
+class OctreeElement;
+class VisibleSetWalk;
+
+/// Walks the part of the tree that Octree::encodeTreeBitstream() would visit for a view and records, for each element,
+/// the frustum location, LOD and should-render results the encoder asks for. The walk is split into the subtrees two
+/// levels below the root, which are handed out to the thread pool one at a time, so that a client's first full scene
+/// does not pay for these tests one element at a time on its send thread.
+///
+/// The recorded results are only valid while the tree is read locked and has not changed since compute(), the caller is
+/// responsible for dropping the set once matches() fails. Elements the walk did not reach are simply not in the set.
+class OctreeVisibleSet {
+public:
+    static const int SUBTREE_LEVEL = 3; // the root is level 1, so up to 64 subtrees
+    static const int MAX_SUBTREES = NUMBER_OF_CHILDREN * NUMBER_OF_CHILDREN;
+
+    OctreeVisibleSet(const ViewFrustum& viewFrustum, int boundaryLevelAdjust, float octreeElementSizeScale);
+
+    /// walks the tree below root, which must be read locked until the set is dropped. Blocks until the walk is done, the
+    /// calling thread takes subtrees too.
+    void compute(OctreeElement* root);
+
+    /// true if the set was computed for this version of the tree and these encode settings
+    bool matches(quint64 rootLastChanged, const ViewFrustum& viewFrustum, int boundaryLevelAdjust,
+                 float octreeElementSizeScale) const;
+
+    /// what the walk found for an element, returns false if the walk did not reach it
+    bool lookup(const OctreeElement* element, ViewFrustum::location& location, bool& inLOD, bool& shouldRender) const;
+
+    int getElementCount() const;
+    int getSubtreeCount() const { return _subtreeCount; }
+    float getComputeTime() const { return _computeTime; } /// in usecs
+
+private:
+    friend class VisibleSetWalk;
+
+    typedef QHash<const OctreeElement*, quint8> ElementResults;
+
+    void computeTop(OctreeElement* element, ViewFrustum::location parentLocation, VisibleSetWalk& walk);
+    void computeSubtree(OctreeElement* element, ViewFrustum::location parentLocation, ElementResults& results) const;
+    quint8 computeElement(const OctreeElement* element, ViewFrustum::location parentLocation) const;
+
+    static int subtreeIndex(const OctreeElement* element);
+
+    ViewFrustum _viewFrustum;
+    int _boundaryLevelAdjust;
+    float _octreeElementSizeScale;
+    quint64 _rootLastChanged;
+
+    ElementResults _topResults; // the elements above SUBTREE_LEVEL
+    ElementResults _subtreeResults[MAX_SUBTREES]; // each written by a single thread, indexed by subtreeIndex()
+    int _subtreeCount;
+    float _computeTime;
+};
+
+#endif // hifi_OctreeVisibleSet_h
@@ -1532,7 +1532,7 @@ AABox Model::getPartBounds(int meshIndex, int partIndex) {
 
 void Model::renderPart(RenderArgs* args, int meshIndex, int partIndex, bool translucent) {
  //   PROFILE_RANGE(__FUNCTION__);
-    PerformanceTimer perfTimer("Model::renderPart");
+    PERFORMANCE_TIMER("Model::renderPart");
     if (!_readyWhenAdded) {
         return; // bail asap
     }
@@ -247,7 +247,7 @@ QObject* OffscreenQmlSurface::finishQmlLoad(std::function<void(QQmlContext*, QOb
 
 
 void OffscreenQmlSurface::updateQuick() {
-    PerformanceTimer perfTimer("qmlUpdate");
+    PERFORMANCE_TIMER("qmlUpdate");
     if (_paused) {
         return;
     }
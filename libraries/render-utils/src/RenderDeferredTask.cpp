@@ -58,7 +58,7 @@ void RenderDeferred::run(const SceneContextPointer& sceneContext, const RenderCo
 }
 
 void ResolveDeferred::run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
-    PerformanceTimer perfTimer("ResolveDeferred");
+    PERFORMANCE_TIMER("ResolveDeferred");
     DependencyManager::get<DeferredLightingEffect>()->copyBack(renderContext->args);
 }
 
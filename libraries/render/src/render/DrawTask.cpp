@@ -72,13 +72,13 @@ void render::cullItems(const SceneContextPointer& sceneContext, const RenderCont
         // when they are outside of the view frustum...
         bool outOfView;
         {
-            PerformanceTimer perfTimer("boxInFrustum");
+            PERFORMANCE_TIMER("boxInFrustum");
             outOfView = args->_viewFrustum->boxInFrustum(item.bounds) == ViewFrustum::OUTSIDE;
         }
         if (!outOfView) {
             bool bigEnoughToRender;
             {
-                PerformanceTimer perfTimer("shouldRender");
+                PERFORMANCE_TIMER("shouldRender");
                 bigEnoughToRender = (args->_shouldRender) ? args->_shouldRender(args, item.bounds) : true;
             }
             if (bigEnoughToRender) {
@@ -85,7 +85,7 @@ public:
     const Varying getOutput() const { return _concept->getOutput(); }
 
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
-        PerformanceTimer perfTimer(getName().c_str());
+        PerformanceTimer perfTimer(getName().c_str(), _concept->getTraceScopeID());
         PROFILE_RANGE(getName().c_str());
         _concept->run(sceneContext, renderContext);
     }
@@ -96,14 +96,18 @@ public:
     class Concept {
         std::string _name;
         bool _isEnabled = true;
+        std::atomic<int> _traceScopeID { Trace::UNINTERNED_SCOPE_ID };
     public:
         Concept() : _name() {}
         Concept(const std::string& name) : _name(name) {}
         virtual ~Concept() = default;
         
-        void setName(const std::string& name) { _name = name; }
+        void setName(const std::string& name) { _name = name; _traceScopeID = Trace::UNINTERNED_SCOPE_ID; }
         const std::string& getName() const { return _name; }
 
+        /// the trace id of the job's name, for its PerformanceTimer
+        std::atomic<int>& getTraceScopeID() { return _traceScopeID; }
+
         bool isEnabled() const { return _isEnabled; }
         void setEnabled(bool isEnabled) { _isEnabled = isEnabled; }
 
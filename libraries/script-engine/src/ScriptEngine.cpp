@@ -17,6 +17,7 @@
 #include <QtNetwork/QNetworkReply>
 #include <QScriptEngine>
 
+#include <AudioCodec.h>
 #include <AudioConstants.h>
 #include <AudioEffectOptions.h>
 #include <AvatarData.h>
@@ -651,6 +652,9 @@ void ScriptEngine::run() {
                     // write the number of silent samples so the audio-mixer can uphold timing
                     audioPacket->writePrimitive(SCRIPT_AUDIO_BUFFER_SAMPLES);
 
+                    // scripted avatar audio is sent raw, and so is what the audio-mixer sends back
+                    audioPacket->writePrimitive((quint8) AudioCodec::PCM);
+
                     // use the orientation and position of this avatar for the source of this audio
                     audioPacket->writePrimitive(_avatarData->getPosition());
                     glm::quat headOrientation = _avatarData->getHeadOrientation();
@@ -660,6 +664,9 @@ void ScriptEngine::run() {
                     // assume scripted avatar audio is mono and set channel flag to zero
                     audioPacket->writePrimitive((quint8) 0);
 
+                    // scripted avatar audio is sent raw
+                    audioPacket->writePrimitive((quint8) AudioCodec::PCM);
+
                     // use the orientation and position of this avatar for the source of this audio
                     audioPacket->writePrimitive(_avatarData->getPosition());
                     glm::quat headOrientation = _avatarData->getHeadOrientation();
@@ -86,6 +86,72 @@ bool gunzip(QByteArray source, QByteArray &destination) {
     return status == Z_STREAM_END;
 }
 
+GunzipStream::GunzipStream() :
+    _stream(new z_stream),
+    _hasFailed(false),
+    _isAtEnd(false)
+{
+    _stream->zalloc = Z_NULL;
+    _stream->zfree = Z_NULL;
+    _stream->opaque = Z_NULL;
+    _stream->avail_in = 0;
+    _stream->next_in = Z_NULL;
+
+    _hasFailed = inflateInit2(_stream, GZIP_WINDOWS_BIT) != Z_OK;
+}
+
+GunzipStream::~GunzipStream() {
+    if (!_hasFailed) {
+        inflateEnd(_stream);
+    }
+    delete _stream;
+}
+
+bool GunzipStream::inflateChunk(const QByteArray& source, QByteArray& destination) {
+    if (_hasFailed) {
+        return false;
+    }
+    if (_isAtEnd || source.isEmpty()) {
+        return true;
+    }
+
+    _stream->next_in = (unsigned char*)source.constData();
+    _stream->avail_in = source.length();
+
+    for (;;) {
+        char out[GZIP_CHUNK_SIZE];
+
+        _stream->next_out = (unsigned char*)out;
+        _stream->avail_out = GZIP_CHUNK_SIZE;
+
+        int status = inflate(_stream, Z_NO_FLUSH);
+
+        switch (status) {
+            case Z_NEED_DICT:
+            case Z_DATA_ERROR:
+            case Z_MEM_ERROR:
+            case Z_STREAM_ERROR:
+                inflateEnd(_stream);
+                _hasFailed = true;
+                return false;
+        }
+
+        int available = (GZIP_CHUNK_SIZE - _stream->avail_out);
+        if (available > 0) {
+            destination.append((char*)out, available);
+        }
+
+        if (status == Z_STREAM_END) {
+            _isAtEnd = true;
+            break;
+        }
+        if (_stream->avail_out != 0) {
+            break;
+        }
+    }
+    return true;
+}
+
 bool gzip(QByteArray source, QByteArray &destination, int compressionLevel) {
     destination.clear();
     if (source.length() == 0) {
@@ -24,4 +24,26 @@ bool gzip(QByteArray source, QByteArray &destination, int compressionLevel = -1)
 
 bool gunzip(QByteArray source, QByteArray &destination);
 
+struct z_stream_s;
+
+// Inflates gzipped data a chunk at a time, for data too large to hold both compressed and inflated at once.
+class GunzipStream {
+public:
+    GunzipStream();
+    ~GunzipStream();
+
+    // appends what source inflates to onto destination, returns false once the data turns out not to be gzipped
+    bool inflateChunk(const QByteArray& source, QByteArray& destination);
+
+    // true once the end of the gzipped data was inflated, anything after it is ignored
+    bool isAtEnd() const { return _isAtEnd; }
+
+private:
+    Q_DISABLE_COPY(GunzipStream)
+
+    z_stream_s* _stream;
+    bool _hasFailed;
+    bool _isAtEnd;
+};
+
 #endif
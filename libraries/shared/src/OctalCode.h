@@ -27,6 +27,12 @@ size_t bytesRequiredForCodeLength(unsigned char threeBitCodes);
 int branchIndexWithDescendant(const unsigned char* ancestorOctalCode, const unsigned char* descendantOctalCode);
 unsigned char* childOctalCode(const unsigned char* parentOctalCode, char childNumber);
 
+/// the length of an octal code is kept in its first byte, so no code is longer than this
+const int MAX_OCTAL_CODE_BYTES = 1 + (255 * BITS_IN_OCTAL + 7) / 8;
+
+/// writes the child's octal code into newCode, which must hold bytesRequiredForCodeLength() of the parent's length + 1
+void childOctalCode(const unsigned char* parentOctalCode, char childNumber, unsigned char* newCode);
+
 const int OVERFLOWED_OCTCODE_BUFFER = -1;
 const int UNKNOWN_OCTCODE_LENGTH = -2;
 
@@ -84,7 +84,7 @@ QHash<QThread*, QString> PerformanceTimer::_fullNames;
 QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
 
-PerformanceTimer::PerformanceTimer(const QString& name) {
+PerformanceTimer::PerformanceTimer(const char* name, std::atomic<int>& traceScopeID) {
     if (_isActive) {
         _name = name;
         QString& fullName = _fullNames[QThread::currentThread()];
@@ -92,6 +92,14 @@ PerformanceTimer::PerformanceTimer(const QString& name) {
         fullName.append(_name);
         _start = usecTimestampNow();
     }
+    if (Trace::isEnabled()) {
+        _traceScopeID = traceScopeID.load(std::memory_order_relaxed);
+        if (_traceScopeID == Trace::UNINTERNED_SCOPE_ID) {
+            _traceScopeID = Trace::internScopeName(name);
+            traceScopeID.store(_traceScopeID, std::memory_order_relaxed);
+        }
+        _traceStart = Trace::now();
+    }
 }
 
 PerformanceTimer::~PerformanceTimer() {
@@ -102,6 +110,9 @@ PerformanceTimer::~PerformanceTimer() {
         namedRecord.accumulateResult(elapsedusec);
         fullName.resize(fullName.size() - (_name.size() + 1));
     }
+    if (_traceStart != 0) {
+        Trace::recordEvent(_traceScopeID, _traceStart, Trace::now());
+    }
 }
 
 // static
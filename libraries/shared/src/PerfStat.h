@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include "SharedUtil.h"
 #include "SimpleMovingAverage.h"
+#include "Trace.h"
 
 #include <atomic>
 #include <cstring>
@@ -71,10 +72,14 @@ private:
     SimpleMovingAverage _movingAverage;
 };
 
+/// Averages named timings for the interface stats display, keyed by the full path of nested timer names. Only meant for
+/// the interface main thread; use TRACE_SCOPE() to time code on other threads. When tracing is enabled each timer is
+/// recorded into the trace as well, under the id kept in traceScopeID, which is interned the first time it is needed.
+/// Use PERFORMANCE_TIMER() rather than making these directly, unless the name can change from one run to the next.
 class PerformanceTimer {
 public:
 
-    PerformanceTimer(const QString& name);
+    PerformanceTimer(const char* name, std::atomic<int>& traceScopeID);
     ~PerformanceTimer();
     
     static bool isActive();
@@ -88,10 +93,16 @@ public:
 private:
     quint64 _start = 0;
     QString _name;
+    quint64 _traceStart = 0;
+    int _traceScopeID = Trace::UNINTERNED_SCOPE_ID;
     static std::atomic<bool> _isActive;
     static QHash<QThread*, QString> _fullNames;
     static QMap<QString, PerformanceTimerRecord> _records;
 };
 
+/// times the rest of the enclosing scope, keeping the trace id of the name for this line like TRACE_SCOPE() does
+#define PERFORMANCE_TIMER(name) \
+    static std::atomic<int> TRACE_CONCAT(perfTimerScopeID, __LINE__)(Trace::UNINTERNED_SCOPE_ID); \
+    PerformanceTimer TRACE_CONCAT(perfTimer, __LINE__)(name, TRACE_CONCAT(perfTimerScopeID, __LINE__))
 
 #endif // hifi_PerfStat_h
@@ -0,0 +1,83 @@
+//
+//  SlabAllocator.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QMutexLocker>
+
+#include "SlabAllocator.h"
+
+SlabAllocator::SlabAllocator(size_t blockSize, size_t slabSize) :
+    _blockSize((qMax(blockSize, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1)),
+    _blocksPerSlab(qMax(slabSize / _blockSize, (size_t)1)),
+    _freeBlocks(NULL),
+    _nextUnusedBlock(NULL),
+    _slabEnd(NULL),
+    _blocksInUse(0)
+{
+}
+
+SlabAllocator::~SlabAllocator() {
+    for (size_t i = 0; i < _slabs.size(); i++) {
+        delete[] _slabs[i];
+    }
+}
+
+void* SlabAllocator::allocate() {
+    QMutexLocker locker(&_mutex);
+
+    _blocksInUse++;
+
+    if (_freeBlocks) {
+        FreeBlock* block = _freeBlocks;
+        _freeBlocks = block->next;
+        return block;
+    }
+
+    if (_nextUnusedBlock == _slabEnd) {
+        // new[] aligns the slab for any fundamental type and block sizes are multiples of BLOCK_ALIGNMENT, so every
+        // block in the slab keeps that alignment
+        char* slab = new char[_blocksPerSlab * _blockSize];
+        _slabs.push_back(slab);
+        _nextUnusedBlock = slab;
+        _slabEnd = slab + _blocksPerSlab * _blockSize;
+    }
+
+    void* block = _nextUnusedBlock;
+    _nextUnusedBlock += _blockSize;
+    return block;
+}
+
+void SlabAllocator::deallocate(void* block) {
+    if (!block) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = _freeBlocks;
+    _freeBlocks = freeBlock;
+
+    _blocksInUse--;
+}
+
+quint64 SlabAllocator::getBlocksInUse() {
+    QMutexLocker locker(&_mutex);
+    return _blocksInUse;
+}
+
+quint64 SlabAllocator::getBytesInUse() {
+    QMutexLocker locker(&_mutex);
+    return _blocksInUse * _blockSize;
+}
+
+quint64 SlabAllocator::getBytesReserved() {
+    QMutexLocker locker(&_mutex);
+    return (quint64)_slabs.size() * _blocksPerSlab * _blockSize;
+}
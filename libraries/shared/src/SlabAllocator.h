@@ -0,0 +1,62 @@
+//
+//  SlabAllocator.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Hands out fixed size blocks carved from large slabs
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SlabAllocator_h
+#define hifi_SlabAllocator_h
+
+#include <vector>
+
+#include <QtCore/QMutex>
+
+/// Millions of small objects of the same size cost a handful of large allocations this way, and objects allocated
+/// together sit next to each other in memory. Freed blocks are reused for the next allocation, but slabs are only
+/// returned to the heap when the allocator is destroyed. Safe to use from any thread.
+class SlabAllocator {
+public:
+    static const size_t BLOCK_ALIGNMENT = 16;
+    static const size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+
+    SlabAllocator(size_t blockSize, size_t slabSize = DEFAULT_SLAB_SIZE);
+    ~SlabAllocator();
+
+    void* allocate();
+    void deallocate(void* block);
+
+    /// the requested size rounded up to BLOCK_ALIGNMENT
+    size_t getBlockSize() const { return _blockSize; }
+
+    quint64 getBlocksInUse();
+    quint64 getBytesInUse();
+    quint64 getBytesReserved();
+
+private:
+    // disallow copying, the blocks belong to exactly one allocator
+    SlabAllocator(const SlabAllocator&);
+    SlabAllocator& operator= (const SlabAllocator&);
+
+    class FreeBlock {
+    public:
+        FreeBlock* next;
+    };
+
+    size_t _blockSize;
+    size_t _blocksPerSlab;
+
+    QMutex _mutex;
+    FreeBlock* _freeBlocks;
+    char* _nextUnusedBlock; // blocks past this in the newest slab have never been handed out
+    char* _slabEnd;
+    std::vector<char*> _slabs;
+    quint64 _blocksInUse;
+};
+
+#endif // hifi_SlabAllocator_h
@@ -32,9 +32,10 @@ public:
         _weightedSampleSumExcludingLastSample = 0.0;
     }
 
-    void  updateWithSample(T sample) {
-        quint64 now = usecTimestampNow();
+    void  updateWithSample(T sample) { updateWithSample(sample, usecTimestampNow()); }
 
+    /// the same, at a time of the caller's clock. Use one clock for every call.
+    void updateWithSample(T sample, quint64 now) {
         if (_firstSampleTime == 0) {
             _firstSampleTime = now;
         } else {
@@ -45,20 +46,23 @@ public:
         _lastSampleTime = now;
     }
 
-    double getAverage() const {
+    double getAverage() const { return getAverage(usecTimestampNow()); }
+
+    double getAverage(quint64 now) const {
         if (_firstSampleTime == 0) {
             return 0.0;
         }
-        quint64 now = usecTimestampNow();
         quint64 elapsed = now - _firstSampleTime;
         return getWeightedSampleSum(now) / (double)elapsed;
     }
 
-    quint64 getElapsedUsecs() const {
+    quint64 getElapsedUsecs() const { return getElapsedUsecs(usecTimestampNow()); }
+
+    quint64 getElapsedUsecs(quint64 now) const {
         if (_firstSampleTime == 0) {
             return 0;
         }
-        return usecTimestampNow() - _firstSampleTime;
+        return now - _firstSampleTime;
     }
 
 private:
@@ -0,0 +1,273 @@
+//
+//  Trace.cpp
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QProcessEnvironment>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
+
+#include "SharedLogging.h"
+
+#include "Trace.h"
+
+// a few of the oldest events in a buffer may be getting overwritten while we read it, leave them out of the trace
+const quint64 EXPORT_MARGIN_EVENTS = 64;
+
+class TraceEvent {
+public:
+    quint64 start;
+    quint64 end;
+    int scopeID;
+};
+
+/// written only by the thread that owns it, read by the exporter
+class TraceThreadBuffer {
+public:
+    TraceThreadBuffer(int threadID, const QString& threadName) :
+        _threadID(threadID),
+        _threadName(threadName),
+        _events(Trace::EVENTS_PER_THREAD),
+        _head(0),
+        _tail(0)
+    {
+    }
+
+    void record(int scopeID, quint64 start, quint64 end) {
+        quint64 head = _head.load(std::memory_order_relaxed);
+        TraceEvent& event = _events[head & (Trace::EVENTS_PER_THREAD - 1)];
+        event.start = start;
+        event.end = end;
+        event.scopeID = scopeID;
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    void clear() { _tail.store(_head.load(std::memory_order_acquire), std::memory_order_relaxed); }
+
+    quint64 getEventCount() const {
+        return qMin(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed),
+                    (quint64)Trace::EVENTS_PER_THREAD);
+    }
+
+    /// copies out the events that were not overwritten while they were being read
+    QVector<TraceEvent> readEvents() const {
+        const quint64 capacity = Trace::EVENTS_PER_THREAD;
+        quint64 head = _head.load(std::memory_order_acquire);
+        quint64 first = qMax(_tail.load(std::memory_order_relaxed),
+                             head > capacity - EXPORT_MARGIN_EVENTS ? head - (capacity - EXPORT_MARGIN_EVENTS) : 0);
+
+        QVector<TraceEvent> events;
+        events.reserve(head - first);
+        for (quint64 i = first; i < head; i++) {
+            events.push_back(_events[i & (capacity - 1)]);
+        }
+
+        // the writer may have lapped us, anything it could have reached since is unreliable
+        quint64 headAfterRead = _head.load(std::memory_order_acquire);
+        if (headAfterRead >= first + capacity) {
+            int overwritten = qMin((quint64)events.size(), headAfterRead - capacity + 1 - first);
+            events.remove(0, overwritten);
+        }
+        return events;
+    }
+
+    int getThreadID() const { return _threadID; }
+    const QString& getThreadName() const { return _threadName; }
+
+private:
+    int _threadID;
+    QString _threadName;
+    QVector<TraceEvent> _events;
+    std::atomic<quint64> _head;
+    std::atomic<quint64> _tail;
+};
+
+typedef QSharedPointer<TraceThreadBuffer> TraceThreadBufferPointer;
+
+// the registry keeps buffers alive after their threads exit so that their events still make it into the trace
+static QMutex traceMutex;
+static QList<TraceThreadBufferPointer> threadBuffers;
+static QVector<QByteArray> scopeNames;
+static QHash<QByteArray, int> scopeIDs;
+static QElapsedTimer traceTimer;
+static QString traceFilePath;
+
+static QThreadStorage<TraceThreadBufferPointer> localThreadBuffer;
+
+std::atomic<bool> Trace::_isEnabled(false);
+
+static TraceThreadBuffer* getLocalThreadBuffer() {
+    if (!localThreadBuffer.hasLocalData()) {
+        QMutexLocker locker(&traceMutex);
+        QString threadName = QThread::currentThread()->objectName();
+        if (threadName.isEmpty()) {
+            threadName = QString("thread %1").arg(threadBuffers.size());
+        }
+        TraceThreadBufferPointer buffer(new TraceThreadBuffer(threadBuffers.size(), threadName));
+        threadBuffers.push_back(buffer);
+        localThreadBuffer.setLocalData(buffer);
+    }
+    return localThreadBuffer.localData().data();
+}
+
+void Trace::setEnabled(bool enabled) {
+    if (enabled != _isEnabled) {
+        {
+            QMutexLocker locker(&traceMutex);
+            if (!traceTimer.isValid()) {
+                traceTimer.start();
+            }
+        }
+        _isEnabled.store(enabled);
+        qCDebug(shared) << "Tracing has been turned" << (enabled ? "on" : "off");
+    }
+}
+
+static void writeTraceOnExit() {
+    Trace::setEnabled(false);
+    Trace::writeChromeTrace(traceFilePath);
+}
+
+void Trace::startFromEnvironment() {
+    QString filePath = QProcessEnvironment::systemEnvironment().value(HIFI_TRACE_FILE_ENV);
+    if (filePath.isEmpty() || !traceFilePath.isEmpty()) {
+        return;
+    }
+
+    QFileInfo fileInfo(filePath);
+    QString pidSuffix = QString("-%1").arg(QCoreApplication::applicationPid());
+    traceFilePath = fileInfo.suffix().isEmpty()
+        ? filePath + pidSuffix
+        : fileInfo.path() + "/" + fileInfo.completeBaseName() + pidSuffix + "." + fileInfo.suffix();
+
+    setEnabled(true);
+    qAddPostRoutine(writeTraceOnExit);
+    qCDebug(shared) << "Tracing to" << traceFilePath;
+}
+
+int Trace::internScopeName(const char* name) {
+    QByteArray utf8Name(name);
+
+    QMutexLocker locker(&traceMutex);
+    QHash<QByteArray, int>::const_iterator existing = scopeIDs.constFind(utf8Name);
+    if (existing != scopeIDs.constEnd()) {
+        return existing.value();
+    }
+    int scopeID = scopeNames.size();
+    scopeNames.push_back(utf8Name);
+    scopeIDs.insert(utf8Name, scopeID);
+    return scopeID;
+}
+
+quint64 Trace::now() {
+    return traceTimer.nsecsElapsed() + 1;
+}
+
+void Trace::recordEvent(int scopeID, quint64 start, quint64 end) {
+    getLocalThreadBuffer()->record(scopeID, start, end);
+}
+
+void Trace::clear() {
+    QMutexLocker locker(&traceMutex);
+    foreach (const TraceThreadBufferPointer& buffer, threadBuffers) {
+        buffer->clear();
+    }
+}
+
+quint64 Trace::getRecordedEventCount() {
+    QMutexLocker locker(&traceMutex);
+    quint64 count = 0;
+    foreach (const TraceThreadBufferPointer& buffer, threadBuffers) {
+        count += buffer->getEventCount();
+    }
+    return count;
+}
+
+static void appendJSONString(QByteArray& json, const QByteArray& string) {
+    json.append('"');
+    foreach (char character, string) {
+        if (character == '"' || character == '\\') {
+            json.append('\\');
+            json.append(character);
+        } else if ((unsigned char)character < 0x20) {
+            json.append(QString().sprintf("\\u%04x", character).toLatin1());
+        } else {
+            json.append(character);
+        }
+    }
+    json.append('"');
+}
+
+static void appendMicroseconds(QByteArray& json, quint64 nsecs) {
+    json.append(QByteArray::number(nsecs / 1000));
+    json.append('.');
+    json.append(QString().sprintf("%03d", (int)(nsecs % 1000)).toLatin1());
+}
+
+QByteArray Trace::toChromeTraceJSON() {
+    QList<TraceThreadBufferPointer> buffers;
+    QVector<QByteArray> names;
+    {
+        QMutexLocker locker(&traceMutex);
+        buffers = threadBuffers;
+        names = scopeNames;
+    }
+
+    QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool firstEvent = true;
+
+    foreach (const TraceThreadBufferPointer& buffer, buffers) {
+        QByteArray tid = QByteArray::number(buffer->getThreadID());
+
+        if (!firstEvent) {
+            json.append(',');
+        }
+        firstEvent = false;
+        json.append("\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":");
+        appendJSONString(json, buffer->getThreadName().toUtf8());
+        json.append("}}");
+
+        foreach (const TraceEvent& event, buffer->readEvents()) {
+            if (event.scopeID < 0 || event.scopeID >= names.size()) {
+                continue;
+            }
+            json.append(",\n{\"name\":");
+            appendJSONString(json, names[event.scopeID]);
+            json.append(",\"ph\":\"X\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":");
+            appendMicroseconds(json, event.start);
+            json.append(",\"dur\":");
+            appendMicroseconds(json, event.end - event.start);
+            json.append('}');
+        }
+    }
+
+    json.append("\n]}\n");
+    return json;
+}
+
+bool Trace::writeChromeTrace(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(shared) << "Could not open" << filePath << "to write the trace";
+        return false;
+    }
+    quint64 eventCount = getRecordedEventCount();
+    file.write(toChromeTraceJSON());
+    qCDebug(shared) << "Wrote" << eventCount << "trace events to" << filePath;
+    return true;
+}
@@ -0,0 +1,91 @@
+//
+//  Trace.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Records timed scopes from any thread into per-thread ring buffers and writes them out as Chrome trace-event JSON
+//  (load the file in chrome://tracing).
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Trace_h
+#define hifi_Trace_h
+
+#include <atomic>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+/// set this environment variable to a file path to trace a process from start to exit. The process id is added to the
+/// file name so that the children of an assignment-client monitor do not overwrite each other's traces.
+const char HIFI_TRACE_FILE_ENV[] = "HIFI_TRACE_FILE";
+
+class Trace {
+public:
+    static const int UNINTERNED_SCOPE_ID = -1;
+    static const int EVENTS_PER_THREAD = 1 << 16; // per thread, the oldest events are overwritten first
+
+    /// a scope timed into the trace, use TRACE_SCOPE() rather than making these directly
+    class Scope {
+    public:
+        Scope(std::atomic<int>& scopeID, const char* name) : _start(0), _scopeID(UNINTERNED_SCOPE_ID) {
+            if (Trace::isEnabled()) {
+                _scopeID = scopeID.load(std::memory_order_relaxed);
+                if (_scopeID == UNINTERNED_SCOPE_ID) {
+                    _scopeID = Trace::internScopeName(name);
+                    scopeID.store(_scopeID, std::memory_order_relaxed);
+                }
+                _start = Trace::now();
+            }
+        }
+
+        ~Scope() {
+            if (_start != 0) {
+                Trace::recordEvent(_scopeID, _start, Trace::now());
+            }
+        }
+
+    private:
+        quint64 _start;
+        int _scopeID;
+    };
+
+    static bool isEnabled() { return _isEnabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    /// enables tracing and writes the trace on exit if HIFI_TRACE_FILE is set
+    static void startFromEnvironment();
+
+    /// returns the id for a UTF-8 scope name, interning it on first use. Callers keep the id, see TRACE_SCOPE().
+    static int internScopeName(const char* name);
+
+    /// nsecs since tracing was first enabled, never 0
+    static quint64 now();
+
+    static void recordEvent(int scopeID, quint64 start, quint64 end);
+
+    /// drops every recorded event, the interned names and thread buffers are kept
+    static void clear();
+
+    static quint64 getRecordedEventCount();
+
+    static QByteArray toChromeTraceJSON();
+    static bool writeChromeTrace(const QString& filePath);
+
+private:
+    static std::atomic<bool> _isEnabled;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/// times the rest of the enclosing scope. The name is interned the first time tracing reaches this line, after which
+/// a disabled trace costs one relaxed atomic load and an enabled one two clock reads and a write into the thread's buffer.
+#define TRACE_SCOPE(name) \
+    static std::atomic<int> TRACE_CONCAT(traceScopeID, __LINE__)(Trace::UNINTERNED_SCOPE_ID); \
+    Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(TRACE_CONCAT(traceScopeID, __LINE__), name)
+
+#endif // hifi_Trace_h
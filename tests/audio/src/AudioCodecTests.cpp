@@ -0,0 +1,162 @@
+//
+//  AudioCodecTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioCodecTests.h"
+
+#include <cmath>
+
+#include <AudioCodec.h>
+#include <AudioConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioCodecTests)
+
+const int STEREO = 2;
+const int FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+
+// interleaved stereo sine, the right channel a quarter turn ahead of the left
+static void fillSine(int16_t* samples, int firstFrameSample, float amplitude) {
+    const float FREQUENCY = 440.0f;
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        int t = firstFrameSample + i / STEREO;
+        float phase = 2.0f * (float)M_PI * FREQUENCY * t / AudioConstants::SAMPLE_RATE + (i % STEREO) * (float)M_PI_2;
+        samples[i] = (int16_t)(amplitude * sinf(phase));
+    }
+}
+
+static int maxError(const int16_t* expected, const int16_t* actual, int numSamples) {
+    int error = 0;
+    for (int i = 0; i < numSamples; i++) {
+        error = std::max(error, abs((int)expected[i] - (int)actual[i]));
+    }
+    return error;
+}
+
+void AudioCodecTests::pcmRoundTrip() {
+    auto codec = AudioCodec::create(AudioCodec::PCM);
+    QVERIFY(codec);
+    QCOMPARE((int)codec->getType(), (int)AudioCodec::PCM);
+
+    int16_t samples[FRAME_SAMPLES];
+    fillSine(samples, 0, 10000.0f);
+
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+    QCOMPARE(codec->getEncodedSize(FRAME_SAMPLES, STEREO), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+    int numBytes = codec->encode(samples, FRAME_SAMPLES, STEREO, encoded);
+    QCOMPARE(numBytes, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    int16_t decoded[FRAME_SAMPLES];
+    QCOMPARE(codec->decode(encoded, numBytes, STEREO, decoded), FRAME_SAMPLES);
+    QCOMPARE(memcmp(samples, decoded, sizeof(samples)), 0);
+}
+
+void AudioCodecTests::adpcmRoundTrip() {
+    auto encoder = AudioCodec::create(AudioCodec::IMA_ADPCM);
+    auto decoder = AudioCodec::create(AudioCodec::IMA_ADPCM);
+    QVERIFY(encoder && decoder);
+
+    // four bits a sample and a four byte header a channel
+    int encodedSize = encoder->getEncodedSize(FRAME_SAMPLES, STEREO);
+    QCOMPARE(encodedSize, 2 * 4 + FRAME_SAMPLES / 2);
+    QVERIFY(encodedSize * 3 < AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    int16_t samples[FRAME_SAMPLES];
+    int16_t decoded[FRAME_SAMPLES];
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+
+    const int NUM_FRAMES = 10;
+    const float AMPLITUDE = 10000.0f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        fillSine(samples, frame * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, AMPLITUDE);
+        int numBytes = encoder->encode(samples, FRAME_SAMPLES, STEREO, encoded);
+        QCOMPARE(numBytes, encodedSize);
+        QCOMPARE(decoder->getDecodedSamples(numBytes, STEREO), FRAME_SAMPLES);
+        QCOMPARE(decoder->decode(encoded, numBytes, STEREO, decoded), FRAME_SAMPLES);
+
+        // the step size needs the first frame to adapt to the signal, after that it tracks it closely
+        if (frame > 0) {
+            QVERIFY(maxError(samples, decoded, FRAME_SAMPLES) < AMPLITUDE / 20);
+        }
+    }
+}
+
+void AudioCodecTests::adpcmFramesDecodeOnTheirOwn() {
+    auto encoder = AudioCodec::create(AudioCodec::IMA_ADPCM);
+    int encodedSize = encoder->getEncodedSize(FRAME_SAMPLES, STEREO);
+
+    int16_t samples[FRAME_SAMPLES];
+    QVector<QByteArray> frames;
+    const int NUM_FRAMES = 4;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        fillSine(samples, frame * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, 10000.0f);
+        QByteArray encoded(encodedSize, 0);
+        encoder->encode(samples, FRAME_SAMPLES, STEREO, encoded.data());
+        frames.push_back(encoded);
+    }
+
+    // the last frame decodes the same with a fresh decoder as after every frame before it, as if those were lost
+    int16_t inOrder[FRAME_SAMPLES];
+    auto decoder = AudioCodec::create(AudioCodec::IMA_ADPCM);
+    foreach (const QByteArray& frame, frames) {
+        decoder->decode(frame.constData(), frame.size(), STEREO, inOrder);
+    }
+
+    int16_t alone[FRAME_SAMPLES];
+    auto freshDecoder = AudioCodec::create(AudioCodec::IMA_ADPCM);
+    freshDecoder->decode(frames.last().constData(), frames.last().size(), STEREO, alone);
+
+    QCOMPARE(memcmp(inOrder, alone, sizeof(alone)), 0);
+}
+
+void AudioCodecTests::adpcmFrameSizes() {
+    auto codec = AudioCodec::create(AudioCodec::IMA_ADPCM);
+    QVERIFY(codec);
+
+    // a four byte header a channel, then a nibble a sample
+    QCOMPARE(codec->getEncodedSize(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, 1), 132);
+    QCOMPARE(codec->getEncodedSize(FRAME_SAMPLES, STEREO), 264);
+    QCOMPARE(codec->getDecodedSamples(132, 1), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    QCOMPARE(codec->getDecodedSamples(264, STEREO), FRAME_SAMPLES);
+}
+
+void AudioCodecTests::unknownTypeHasNoCodec() {
+    QVERIFY(!AudioCodec::isKnownType(AudioCodec::NUM_TYPES));
+    QVERIFY(!AudioCodec::create(AudioCodec::NUM_TYPES));
+    QVERIFY(AudioCodec::isKnownType(AudioCodec::DEFAULT_TYPE));
+}
+
+void AudioCodecTests::benchmarkCodecs() {
+    const int NUM_FRAMES = 10000;
+
+    int16_t samples[FRAME_SAMPLES];
+    int16_t decoded[FRAME_SAMPLES];
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+    fillSine(samples, 0, 10000.0f);
+
+    for (quint8 type = 0; type < AudioCodec::NUM_TYPES; type++) {
+        auto encoder = AudioCodec::create(type);
+        auto decoder = AudioCodec::create(type);
+
+        int numBytes = 0;
+        quint64 start = usecTimestampNow();
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            numBytes = encoder->encode(samples, FRAME_SAMPLES, STEREO, encoded);
+        }
+        quint64 encodeEnd = usecTimestampNow();
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            decoder->decode(encoded, numBytes, STEREO, decoded);
+        }
+        quint64 decodeEnd = usecTimestampNow();
+
+        qDebug() << "TIME -" << AudioCodec::getTypeName(type) << "stereo frame:" << numBytes << "bytes,"
+            << (float)(encodeEnd - start) / NUM_FRAMES << "usecs to encode,"
+            << (float)(decodeEnd - encodeEnd) / NUM_FRAMES << "usecs to decode";
+    }
+}
@@ -0,0 +1,29 @@
+//
+//  AudioCodecTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodecTests_h
+#define hifi_AudioCodecTests_h
+
+#include <QtTest/QtTest>
+
+class AudioCodecTests : public QObject {
+    Q_OBJECT
+private slots:
+    void pcmRoundTrip();
+    void adpcmRoundTrip();
+    void adpcmFramesDecodeOnTheirOwn();
+    void adpcmFrameSizes();
+    void unknownTypeHasNoCodec();
+
+    // not a pass/fail test, prints encode and decode time and bytes a frame for each codec
+    void benchmarkCodecs();
+};
+
+#endif // hifi_AudioCodecTests_h
@@ -0,0 +1,150 @@
+//
+//  AudioInjectorManagerTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioInjectorManagerTests.h"
+
+#include <ctime>
+
+#include <AudioConstants.h>
+#include <AudioInjector.h>
+#include <AudioInjectorManager.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioInjectorManagerTests)
+
+// there is no NodeList in these tests, so the injectors step through their audio without sending it anywhere
+
+static QByteArray monoFrames(int numFrames) {
+    return QByteArray(numFrames * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL, 1);
+}
+
+static int processThreadCount() {
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        foreach (const QByteArray& line, status.readAll().split('\n')) {
+            if (line.startsWith("Threads:")) {
+                return line.mid(sizeof("Threads:") - 1).trimmed().toInt();
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+// what each injector used to do on a thread of its own: copy out one frame at a time, sleeping until the next is due
+class ThreadPerInjector : public QThread {
+public:
+    ThreadPerInjector(const QByteArray& audioData) : _audioData(audioData) { }
+
+protected:
+    virtual void run() override {
+        QByteArray frame(AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL, 0);
+        QElapsedTimer timer;
+        timer.start();
+        int nextFrame = 0;
+        for (int position = 0; position < _audioData.size(); position += frame.size()) {
+            memcpy(frame.data(), _audioData.constData() + position, std::min(frame.size(), _audioData.size() - position));
+            int usecToSleep = (++nextFrame * AudioConstants::NETWORK_FRAME_USECS) - timer.nsecsElapsed() / 1000;
+            if (usecToSleep > 0) {
+                usleep(usecToSleep);
+            }
+        }
+    }
+
+private:
+    QByteArray _audioData;
+};
+
+void AudioInjectorManagerTests::injectorIsPacedByItsAudio() {
+    const int NUM_FRAMES = 30;
+    AudioInjectorManager* manager = AudioInjectorManager::getInstance();
+    quint64 framesBefore = manager->getTotalFramesInjected();
+
+    QElapsedTimer timer;
+    timer.start();
+    AudioInjector* injector = AudioInjector::playSound(monoFrames(NUM_FRAMES), AudioInjectorOptions(), NULL);
+    QCOMPARE(injector->thread(), manager->getThread());
+
+    QTRY_VERIFY_WITH_TIMEOUT(injector->isFinished(), 5000);
+    quint64 usecsElapsed = timer.nsecsElapsed() / 1000;
+
+    QCOMPARE(manager->getTotalFramesInjected() - framesBefore, (quint64)NUM_FRAMES);
+    QCOMPARE(injector->getCurrentSendPosition(), NUM_FRAMES * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL);
+
+    // the first two frames go out at once, then one per frame
+    QVERIFY(usecsElapsed >= (quint64)(NUM_FRAMES - 2) * AudioConstants::NETWORK_FRAME_USECS);
+    QTRY_COMPARE(manager->getInjectorCount(), 0);
+
+    injector->deleteLater();
+}
+
+void AudioInjectorManagerTests::stoppedLoopingInjectorFinishes() {
+    AudioInjectorOptions options;
+    options.loop = true;
+    AudioInjector* injector = AudioInjector::playSound(monoFrames(3), options, NULL);
+
+    QTest::qWait(100);
+    QVERIFY(!injector->isFinished());
+    QCOMPARE(AudioInjectorManager::getInstance()->getInjectorCount(), 1);
+
+    injector->stop();
+    QTRY_VERIFY_WITH_TIMEOUT(injector->isFinished(), 1000);
+    QTRY_COMPARE(AudioInjectorManager::getInstance()->getInjectorCount(), 0);
+
+    injector->deleteLater();
+}
+
+void AudioInjectorManagerTests::benchmarkConcurrentInjectors() {
+    const int NUM_INJECTORS = 200;
+    const int NUM_FRAMES = 100; // about a second of audio
+    QByteArray audioData = monoFrames(NUM_FRAMES);
+
+    AudioInjectorManager* manager = AudioInjectorManager::getInstance();
+    std::clock_t cpuStart = std::clock();
+    quint64 start = usecTimestampNow();
+    QVector<AudioInjector*> injectors;
+    for (int i = 0; i < NUM_INJECTORS; i++) {
+        injectors.push_back(AudioInjector::playSound(audioData, AudioInjectorOptions(), NULL));
+    }
+    QTest::qWait(NUM_FRAMES * AudioConstants::NETWORK_FRAME_MSECS / 2);
+    int managerThreads = processThreadCount();
+    QTRY_COMPARE_WITH_TIMEOUT(manager->getInjectorCount(), 0, 10000);
+    quint64 managerTime = usecTimestampNow() - start;
+    float managerCPUMsecs = (float)(std::clock() - cpuStart) * MSECS_PER_SECOND / CLOCKS_PER_SEC;
+    foreach (AudioInjector* injector, injectors) {
+        QVERIFY(injector->isFinished());
+        injector->deleteLater();
+    }
+
+    cpuStart = std::clock();
+    start = usecTimestampNow();
+    QVector<ThreadPerInjector*> threads;
+    for (int i = 0; i < NUM_INJECTORS; i++) {
+        threads.push_back(new ThreadPerInjector(audioData));
+        threads.last()->start();
+    }
+    QTest::qWait(NUM_FRAMES * AudioConstants::NETWORK_FRAME_MSECS / 2);
+    int perInjectorThreads = processThreadCount();
+    foreach (ThreadPerInjector* thread, threads) {
+        thread->wait();
+        delete thread;
+    }
+    quint64 perInjectorTime = usecTimestampNow() - start;
+    float perInjectorCPUMsecs = (float)(std::clock() - cpuStart) * MSECS_PER_SECOND / CLOCKS_PER_SEC;
+
+    qDebug() << "TIME -" << NUM_INJECTORS << "injectors of" << NUM_FRAMES << "frames on the injector thread:"
+             << (float)managerTime / USECS_PER_MSEC << "msecs," << managerCPUMsecs << "msecs CPU,"
+             << managerThreads << "threads in the process";
+    qDebug() << "TIME -" << NUM_INJECTORS << "injectors of" << NUM_FRAMES << "frames with a thread each:"
+             << (float)perInjectorTime / USECS_PER_MSEC << "msecs," << perInjectorCPUMsecs << "msecs CPU,"
+             << perInjectorThreads << "threads in the process";
+}
@@ -0,0 +1,27 @@
+//
+//  AudioInjectorManagerTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioInjectorManagerTests_h
+#define hifi_AudioInjectorManagerTests_h
+
+#include <QtTest/QtTest>
+
+class AudioInjectorManagerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void injectorIsPacedByItsAudio();
+    void stoppedLoopingInjectorFinishes();
+
+    // not a pass/fail test, prints CPU time and thread count while playing many injectors at once, on the injector
+    // thread and with a thread per injector as they used to be played
+    void benchmarkConcurrentInjectors();
+};
+
+#endif // hifi_AudioInjectorManagerTests_h
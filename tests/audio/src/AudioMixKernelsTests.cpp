@@ -0,0 +1,261 @@
+//
+//  AudioMixKernelsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixKernelsTests.h"
+
+#include <glm/glm.hpp>
+
+#include <AudioConstants.h>
+#include <AudioMixKernels.h>
+#include <AudioRingBuffer.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioMixKernelsTests)
+
+const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+const int HISTORY_SAMPLES = 20;
+
+// odd lengths so that the scalar tails of the SIMD kernels get exercised too
+const int ODD_NUM_FRAMES = NUM_FRAMES - 3;
+const int ODD_NUM_SAMPLES = NUM_SAMPLES - 5;
+
+static void fillWithNoise(int16_t* samples, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        samples[i] = (int16_t)randIntInRange(AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+    }
+}
+
+static QList<AudioMixKernels::InstructionSet> supportedInstructionSets() {
+    QList<AudioMixKernels::InstructionSet> instructionSets;
+    for (int i = AudioMixKernels::Scalar; i <= AudioMixKernels::getBestInstructionSet(); ++i) {
+        instructionSets << (AudioMixKernels::InstructionSet)i;
+    }
+    return instructionSets;
+}
+
+void AudioMixKernelsTests::init() {
+    // seed the random number generator so that our tests are reproducible
+    srand(0xFEEDBEEF);
+}
+
+void AudioMixKernelsTests::cleanup() {
+    AudioMixKernels::setInstructionSet(AudioMixKernels::getBestInstructionSet());
+}
+
+void AudioMixKernelsTests::mixMonoToStereoMatchesScalar() {
+    int16_t input[HISTORY_SAMPLES + NUM_FRAMES];
+    fillWithNoise(input, HISTORY_SAMPLES + NUM_FRAMES);
+
+    const int16_t* frameStart = input + HISTORY_SAMPLES;
+    const int DELAY = 13;
+    const float STRONG_GAIN = 0.7f;
+    const float WEAK_GAIN = 0.35f;
+
+    float expected[NUM_SAMPLES];
+    memset(expected, 0, sizeof(expected));
+    AudioMixKernels::setInstructionSet(AudioMixKernels::Scalar);
+    AudioMixKernels::mixMonoToStereo(expected, frameStart, frameStart - DELAY, ODD_NUM_FRAMES, STRONG_GAIN, WEAK_GAIN);
+
+    // the delayed right channel reads back into the history
+    QCOMPARE(expected[1], input[HISTORY_SAMPLES - DELAY] * WEAK_GAIN);
+    QCOMPARE(expected[0], frameStart[0] * STRONG_GAIN);
+
+    foreach (AudioMixKernels::InstructionSet instructionSet, supportedInstructionSets()) {
+        QCOMPARE(AudioMixKernels::setInstructionSet(instructionSet), instructionSet);
+
+        float actual[NUM_SAMPLES];
+        memset(actual, 0, sizeof(actual));
+        AudioMixKernels::mixMonoToStereo(actual, frameStart, frameStart - DELAY, ODD_NUM_FRAMES, STRONG_GAIN, WEAK_GAIN);
+
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            QCOMPARE(actual[i], expected[i]);
+        }
+    }
+}
+
+void AudioMixKernelsTests::mixSamplesMatchesScalar() {
+    int16_t input[NUM_SAMPLES];
+    fillWithNoise(input, NUM_SAMPLES);
+
+    const float GAIN = 0.42f;
+
+    float expected[NUM_SAMPLES];
+    memset(expected, 0, sizeof(expected));
+    AudioMixKernels::setInstructionSet(AudioMixKernels::Scalar);
+    AudioMixKernels::mixSamples(expected, input, ODD_NUM_SAMPLES, GAIN);
+    AudioMixKernels::accumulate(expected, expected, ODD_NUM_SAMPLES);
+
+    foreach (AudioMixKernels::InstructionSet instructionSet, supportedInstructionSets()) {
+        AudioMixKernels::setInstructionSet(instructionSet);
+
+        float actual[NUM_SAMPLES];
+        memset(actual, 0, sizeof(actual));
+        AudioMixKernels::mixSamples(actual, input, ODD_NUM_SAMPLES, GAIN);
+        AudioMixKernels::accumulate(actual, actual, ODD_NUM_SAMPLES);
+
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            QCOMPARE(actual[i], expected[i]);
+        }
+    }
+}
+
+void AudioMixKernelsTests::floatInputMatchesInt16Input() {
+    int16_t input[HISTORY_SAMPLES + NUM_SAMPLES];
+    fillWithNoise(input, HISTORY_SAMPLES + NUM_SAMPLES);
+
+    // the mixer prepares sources by converting them to float once, which must not change what gets mixed
+    float floatInput[HISTORY_SAMPLES + NUM_SAMPLES];
+    for (int i = 0; i < HISTORY_SAMPLES + NUM_SAMPLES; ++i) {
+        floatInput[i] = input[i];
+    }
+
+    const int DELAY = 13;
+    const float STRONG_GAIN = 0.7f;
+    const float WEAK_GAIN = 0.35f;
+
+    foreach (AudioMixKernels::InstructionSet instructionSet, supportedInstructionSets()) {
+        AudioMixKernels::setInstructionSet(instructionSet);
+
+        float expected[NUM_SAMPLES];
+        float actual[NUM_SAMPLES];
+
+        memset(expected, 0, sizeof(expected));
+        memset(actual, 0, sizeof(actual));
+        AudioMixKernels::mixMonoToStereo(expected, input + HISTORY_SAMPLES - DELAY, input + HISTORY_SAMPLES,
+                                         ODD_NUM_FRAMES, WEAK_GAIN, STRONG_GAIN);
+        AudioMixKernels::mixMonoToStereo(actual, floatInput + HISTORY_SAMPLES - DELAY, floatInput + HISTORY_SAMPLES,
+                                         ODD_NUM_FRAMES, WEAK_GAIN, STRONG_GAIN);
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            QCOMPARE(actual[i], expected[i]);
+        }
+
+        memset(expected, 0, sizeof(expected));
+        memset(actual, 0, sizeof(actual));
+        AudioMixKernels::mixSamples(expected, input, ODD_NUM_SAMPLES, STRONG_GAIN);
+        AudioMixKernels::mixSamples(actual, floatInput, ODD_NUM_SAMPLES, STRONG_GAIN);
+        for (int i = 0; i < NUM_SAMPLES; ++i) {
+            QCOMPARE(actual[i], expected[i]);
+        }
+    }
+}
+
+void AudioMixKernelsTests::convertToInt16Saturates() {
+    float mix[NUM_SAMPLES];
+    for (int i = 0; i < NUM_SAMPLES; ++i) {
+        // sweep well past both ends of the int16_t range
+        mix[i] = (i - NUM_SAMPLES / 2) * 300.25f;
+    }
+
+    // end with exact halves that are not clamped, so that the scalar tails of the SIMD conversions round them too
+    const int NUM_TAIL_SAMPLES = 16;
+    for (int i = 0; i < NUM_TAIL_SAMPLES; ++i) {
+        mix[ODD_NUM_SAMPLES - NUM_TAIL_SAMPLES + i] = (i - NUM_TAIL_SAMPLES / 2) + 0.5f;
+    }
+
+    foreach (AudioMixKernels::InstructionSet instructionSet, supportedInstructionSets()) {
+        AudioMixKernels::setInstructionSet(instructionSet);
+
+        int16_t output[NUM_SAMPLES];
+        AudioMixKernels::convertToInt16(output, mix, ODD_NUM_SAMPLES);
+
+        for (int i = 0; i < ODD_NUM_SAMPLES; ++i) {
+            float clamped = glm::clamp(mix[i], (float)AudioConstants::MIN_SAMPLE_VALUE,
+                                       (float)AudioConstants::MAX_SAMPLE_VALUE);
+            // every instruction set rounds half to even, the sweep hits a half every fourth sample and the tail every one
+            QCOMPARE((int)output[i], (int)nearbyintf(clamped));
+        }
+        QCOMPARE((int)output[0], AudioConstants::MIN_SAMPLE_VALUE);
+        QCOMPARE((int)output[ODD_NUM_SAMPLES - NUM_TAIL_SAMPLES - 1], AudioConstants::MAX_SAMPLE_VALUE);
+        QCOMPARE((int)output[ODD_NUM_SAMPLES - 1], 8); // 7.5 rounds up to even
+        QCOMPARE((int)output[ODD_NUM_SAMPLES - 2], 6); // 6.5 rounds down to even
+    }
+}
+
+void AudioMixKernelsTests::benchmarkMixPaths() {
+    const int STREAMS_PER_LISTENER = 32;
+    const int TEST_ITERATIONS = 2000;
+    const int DELAY = 13;
+    const float GAIN = 0.5f;
+
+    // leave the popped frame straddling the end of the ring buffer so the old path pays for its wraparound
+    AudioRingBuffer ringBuffer(NUM_FRAMES, false, 4);
+    int16_t frame[NUM_FRAMES];
+    fillWithNoise(frame, NUM_FRAMES);
+    ringBuffer.writeSamples(frame, NUM_FRAMES / 2);
+    ringBuffer.readSamples(frame, NUM_FRAMES / 2);
+    for (int i = 0; i < 3; ++i) {
+        ringBuffer.writeSamples(frame, NUM_FRAMES);
+    }
+    ringBuffer.shiftReadPosition(NUM_FRAMES);
+
+    int16_t mixSamples[NUM_SAMPLES];
+
+    // the mixer's int16_t path: per sample ring buffer iteration and a clamp per stream
+    {
+        int16_t preMixSamples[NUM_SAMPLES + HISTORY_SAMPLES * 2];
+
+        quint64 start = usecTimestampNow();
+        for (int iteration = 0; iteration < TEST_ITERATIONS; ++iteration) {
+            memset(mixSamples, 0, sizeof(mixSamples));
+            for (int stream = 0; stream < STREAMS_PER_LISTENER; ++stream) {
+                memset(preMixSamples, 0, sizeof(preMixSamples));
+                AudioRingBuffer::ConstIterator popOutput = ringBuffer.nextOutput();
+
+                AudioRingBuffer::ConstIterator delayed = popOutput - DELAY;
+                for (int i = 0; i < DELAY; ++i) {
+                    preMixSamples[2 * i + 1] += *delayed * GAIN;
+                    ++delayed;
+                }
+                for (int i = 0; i < NUM_FRAMES; ++i) {
+                    int16_t sample = popOutput[i];
+                    preMixSamples[2 * i] += (int16_t)(sample * GAIN);
+                    if (2 * (i + DELAY) + 1 <= NUM_SAMPLES) {
+                        preMixSamples[2 * (i + DELAY) + 1] += (int16_t)(sample * GAIN);
+                    }
+                }
+                for (int s = 0; s < NUM_SAMPLES; ++s) {
+                    mixSamples[s] = glm::clamp(mixSamples[s] + preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
+                                               AudioConstants::MAX_SAMPLE_VALUE);
+                }
+            }
+        }
+        quint64 end = usecTimestampNow();
+
+        float samplesPerSecond = (float)TEST_ITERATIONS * STREAMS_PER_LISTENER * NUM_SAMPLES
+            / ((float)(end - start) / USECS_PER_SECOND);
+        qDebug() << "TIME - int16_t ring buffer path:" << samplesPerSecond << "samples/sec";
+    }
+
+    foreach (AudioMixKernels::InstructionSet instructionSet, supportedInstructionSets()) {
+        AudioMixKernels::setInstructionSet(instructionSet);
+
+        int16_t streamSamples[HISTORY_SAMPLES + NUM_FRAMES];
+        float floatMixSamples[NUM_SAMPLES];
+
+        quint64 start = usecTimestampNow();
+        for (int iteration = 0; iteration < TEST_ITERATIONS; ++iteration) {
+            memset(floatMixSamples, 0, sizeof(floatMixSamples));
+            for (int stream = 0; stream < STREAMS_PER_LISTENER; ++stream) {
+                (ringBuffer.nextOutput() - HISTORY_SAMPLES).readSamples(streamSamples, HISTORY_SAMPLES + NUM_FRAMES);
+                const int16_t* frameStart = streamSamples + HISTORY_SAMPLES;
+                AudioMixKernels::mixMonoToStereo(floatMixSamples, frameStart, frameStart - DELAY, NUM_FRAMES, GAIN, GAIN);
+            }
+            AudioMixKernels::convertToInt16(mixSamples, floatMixSamples, NUM_SAMPLES);
+        }
+        quint64 end = usecTimestampNow();
+
+        float samplesPerSecond = (float)TEST_ITERATIONS * STREAMS_PER_LISTENER * NUM_SAMPLES
+            / ((float)(end - start) / USECS_PER_SECOND);
+        qDebug() << "TIME -" << AudioMixKernels::getInstructionSetName(instructionSet) << "float kernel path:"
+                 << samplesPerSecond << "samples/sec";
+    }
+}
@@ -0,0 +1,32 @@
+//
+//  AudioMixKernelsTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernelsTests_h
+#define hifi_AudioMixKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioMixKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void mixMonoToStereoMatchesScalar();
+    void mixSamplesMatchesScalar();
+    void floatInputMatchesInt16Input();
+    void convertToInt16Saturates();
+
+    // not a pass/fail test, prints samples/sec for the ring buffer int16_t path the mixer used to take
+    // and for each kernel instruction set this CPU supports
+    void benchmarkMixPaths();
+};
+
+#endif // hifi_AudioMixKernelsTests_h
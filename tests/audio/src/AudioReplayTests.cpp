@@ -0,0 +1,570 @@
+//
+//  AudioReplayTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioReplayTests.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+#include <AudioConstants.h>
+#include <AudioMixerThrottle.h>
+#include <AudioSpatializer.h>
+#include <InjectedAudioStream.h>
+#include <NLPacket.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioReplayTests)
+
+struct AudioPacketTraceEntry {
+    quint64 arrivalUsecs; // since the trace started
+    quint16 sequence;
+};
+
+/// The packets of one sender in the order they reached the mixer. Lost packets are missing from it, reordered packets
+/// arrive after packets with later sequence numbers.
+class AudioPacketTrace {
+public:
+    QVector<AudioPacketTraceEntry> entries;
+
+    /// one packet a line, "<arrival usecs> <sequence number>". Lines starting with # are comments.
+    static AudioPacketTrace fromText(const QByteArray& text) {
+        AudioPacketTrace trace;
+        foreach (const QByteArray& line, text.split('\n')) {
+            QList<QByteArray> fields = line.simplified().split(' ');
+            if (fields.size() < 2 || fields[0].startsWith('#')) {
+                continue;
+            }
+            AudioPacketTraceEntry entry;
+            entry.arrivalUsecs = fields[0].toULongLong();
+            entry.sequence = (quint16)fields[1].toUInt();
+            trace.entries.push_back(entry);
+        }
+        return trace;
+    }
+
+    static AudioPacketTrace load(const QString& path) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return AudioPacketTrace();
+        }
+        return fromText(file.readAll());
+    }
+
+    QByteArray toText() const {
+        QByteArray text("# arrival_usecs sequence\n");
+        foreach (const AudioPacketTraceEntry& entry, entries) {
+            text += QByteArray::number(entry.arrivalUsecs) + ' ' + QByteArray::number(entry.sequence) + '\n';
+        }
+        return text;
+    }
+
+    /// a sender that sends a packet every frame, each delayed on the way by up to jitterUsecs. A share of the packets
+    /// is lost, and a share arrives after the packet sent after it. The same seed gives the same trace.
+    static AudioPacketTrace generate(int numPackets, int jitterUsecs, float lossRate, float reorderRate, quint32 seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+        std::uniform_int_distribution<int> jitter(0, std::max(jitterUsecs, 0));
+
+        AudioPacketTrace trace;
+        for (int i = 0; i < numPackets; ++i) {
+            bool isLost = chance(random) < lossRate;
+            int delay = jitter(random);
+            if (!isLost) {
+                AudioPacketTraceEntry entry;
+                entry.arrivalUsecs = (quint64)i * AudioConstants::NETWORK_FRAME_USECS + delay;
+                entry.sequence = (quint16)i;
+                trace.entries.push_back(entry);
+            }
+        }
+
+        for (int i = 0; i + 1 < trace.entries.size(); ++i) {
+            if (chance(random) < reorderRate) {
+                // the later arrival time is the later packet's, so after sorting the two swap places
+                trace.entries[i].arrivalUsecs = trace.entries[i + 1].arrivalUsecs + 1;
+                ++i;
+            }
+        }
+
+        std::stable_sort(trace.entries.begin(), trace.entries.end(),
+                         [](const AudioPacketTraceEntry& a, const AudioPacketTraceEntry& b) {
+            return a.arrivalUsecs < b.arrivalUsecs;
+        });
+        return trace;
+    }
+};
+
+struct AudioReplayFrame {
+    int streamsPopped;
+    int streamsStarved; // streams that starved on this frame
+    int mixes; // sources mixed into a listener's mix
+    quint64 mixUsecs; // wall clock time spent mixing, unlike everything else in a replay
+};
+
+struct AudioReplayResults {
+    QVector<AudioReplayFrame> frames;
+
+    // totals over every sender's stream
+    int starveCount;
+    int overflowCount;
+    int framesDropped;
+    quint32 packetsLost;
+    quint32 packetsLate;
+
+    int maxDesiredJitterBufferFrames;
+    float maxThrottlingRatio;
+
+    quint64 getMaxMixUsecs() const {
+        quint64 maxUsecs = 0;
+        foreach (const AudioReplayFrame& frame, frames) {
+            maxUsecs = std::max(maxUsecs, frame.mixUsecs);
+        }
+        return maxUsecs;
+    }
+
+    float getAverageMixUsecs() const {
+        quint64 totalUsecs = 0;
+        foreach (const AudioReplayFrame& frame, frames) {
+            totalUsecs += frame.mixUsecs;
+        }
+        return frames.isEmpty() ? 0.0f : (float)totalUsecs / frames.size();
+    }
+};
+
+/// a listener of a replay, which hears from a stream positioned by a single packet
+class AudioReplayListener : public AudioMixListener {
+public:
+    AudioReplayListener(std::unique_ptr<InjectedAudioStream> stream) :
+        _stream(std::move(stream)),
+        _streamsMixed(0)
+    {
+        memset(_mixSamples, 0, sizeof(_mixSamples));
+    }
+
+    ~AudioReplayListener() {
+        qDeleteAll(_listenerSourcePairData);
+    }
+
+    virtual PositionalAudioStream* getListenerStream() const { return _stream.get(); }
+
+    virtual PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID) {
+        PerListenerSourcePairData*& pairData = _listenerSourcePairData[sourceUUID];
+        if (!pairData) {
+            pairData = new PerListenerSourcePairData();
+        }
+        return pairData;
+    }
+
+    virtual int16_t* getMixSamples() { return _mixSamples; }
+    virtual void mixFinished(int streamsMixed) { _streamsMixed = streamsMixed; }
+
+    int getStreamsMixed() const { return _streamsMixed; }
+
+private:
+    std::unique_ptr<InjectedAudioStream> _stream;
+    QHash<QUuid, PerListenerSourcePairData*> _listenerSourcePairData;
+    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int _streamsMixed;
+};
+
+/// Feeds the packets of each sender's trace to its own InjectedAudioStream as they arrive on a virtual clock, and pops
+/// a frame from every stream and has the audio mixer's AudioSpatializer mix them for every listener each frame, the way
+/// the audio mixer does. The cost of the mix drives the mixer's real throttle.
+///
+/// The streams are given the virtual clock, so that their timing stats see the arrival times of the trace, not how long
+/// the replay took. The throttle and the spatializer do not read a clock, the throttle is told how long each frame slept.
+class AudioReplayHarness {
+public:
+    AudioReplayHarness(const InboundAudioStream::Settings& settings = InboundAudioStream::Settings()) :
+        _settings(settings),
+        _simulatedUsecsPerMix(-1)
+    {
+        _spatializer.setRepetitionWithFade(settings._repetitionWithFade);
+    }
+
+    /// the spatializer the replay mixes with, to set up mix threads and shared mixes the way the mixer's settings would
+    AudioSpatializer& getSpatializer() { return _spatializer; }
+
+    /// a sender sending a mono tone from position as the trace recorded
+    void addSender(const AudioPacketTrace& trace, const glm::vec3& position) {
+        Sender sender;
+        sender.trace = trace;
+        sender.position = position;
+        sender.streamIdentifier = QUuid::createUuid();
+        _senders.push_back(sender);
+    }
+
+    void addListener(const glm::vec3& position) { _listenerPositions.push_back(position); }
+
+    /// charges the throttle this many usecs a mix instead of the time the mix really took, so that replays of
+    /// throttling do not depend on the machine. -1 charges the real time.
+    void setSimulatedUsecsPerMix(int usecs) { _simulatedUsecsPerMix = usecs; }
+
+    AudioReplayResults run(int numFrames) {
+        // the stats treat a time of 0 as never
+        const quint64 START_USECS = USECS_PER_SECOND;
+        quint64 virtualUsecs = START_USECS;
+        auto virtualClock = [&virtualUsecs] { return virtualUsecs; };
+
+        std::vector<std::unique_ptr<InjectedAudioStream>> streams;
+        for (const Sender& sender : _senders) {
+            streams.emplace_back(new InjectedAudioStream(sender.streamIdentifier, false, _settings));
+            streams.back()->setClock(virtualClock);
+        }
+        std::vector<int> nextEntries(_senders.size(), 0);
+
+        std::vector<std::unique_ptr<AudioReplayListener>> listeners;
+        foreach (const glm::vec3& position, _listenerPositions) {
+            QUuid streamIdentifier = QUuid::createUuid();
+            std::unique_ptr<InjectedAudioStream> stream(new InjectedAudioStream(streamIdentifier, false, _settings));
+            stream->setClock(virtualClock);
+            stream->parseData(*createPacket(streamIdentifier, position, 0));
+            listeners.emplace_back(new AudioReplayListener(std::move(stream)));
+        }
+
+        AudioMixerThrottle throttle;
+        int usecSlept = AudioConstants::NETWORK_FRAME_USECS;
+        quint64 nextPerSecondCallback = START_USECS + USECS_PER_SECOND;
+
+        AudioReplayResults results;
+        results.maxDesiredJitterBufferFrames = 0;
+        results.maxThrottlingRatio = 0.0f;
+
+        for (int frameIndex = 0; frameIndex < numFrames; ++frameIndex) {
+            quint64 frameUsecs = START_USECS + (quint64)frameIndex * AudioConstants::NETWORK_FRAME_USECS;
+
+            // hand over the packets that arrived since the last frame, in the order they arrived across senders
+            forever {
+                int nextSender = -1;
+                quint64 nextArrival = 0;
+                for (size_t i = 0; i < _senders.size(); ++i) {
+                    const QVector<AudioPacketTraceEntry>& entries = _senders[i].trace.entries;
+                    if (nextEntries[i] < entries.size()) {
+                        quint64 arrival = START_USECS + entries[nextEntries[i]].arrivalUsecs;
+                        if (arrival <= frameUsecs && (nextSender == -1 || arrival < nextArrival)) {
+                            nextSender = (int)i;
+                            nextArrival = arrival;
+                        }
+                    }
+                }
+                if (nextSender == -1) {
+                    break;
+                }
+
+                virtualUsecs = nextArrival;
+                const Sender& sender = _senders[nextSender];
+                auto packet = createPacket(sender.streamIdentifier, sender.position,
+                                           sender.trace.entries[nextEntries[nextSender]].sequence);
+                streams[nextSender]->parseData(*packet);
+                ++nextEntries[nextSender];
+            }
+
+            virtualUsecs = frameUsecs;
+            if (frameUsecs >= nextPerSecondCallback) {
+                for (auto& stream : streams) {
+                    stream->perSecondCallbackForUpdatingStats();
+                }
+                nextPerSecondCallback += USECS_PER_SECOND;
+            }
+
+            throttle.frameStarted(usecSlept);
+
+            AudioReplayFrame frame = { 0, 0, 0, 0 };
+            for (auto& stream : streams) {
+                int starveCount = stream->getStarveCount();
+                if (stream->popFrames(1, true) > 0) {
+                    stream->updateLastPopOutputLoudnessAndTrailingLoudness();
+                    ++frame.streamsPopped;
+                }
+                frame.streamsStarved += stream->getStarveCount() - starveCount;
+                results.maxDesiredJitterBufferFrames = std::max(results.maxDesiredJitterBufferFrames,
+                                                                stream->getDesiredJitterBufferFrames());
+            }
+
+            QElapsedTimer mixTimer;
+            mixTimer.start();
+
+            _spatializer.setMinAudibilityThreshold(throttle.getMinAudibilityThreshold());
+            for (size_t i = 0; i < streams.size(); ++i) {
+                _spatializer.addSource(streams[i].get(), nullptr, _senders[i].streamIdentifier);
+            }
+            for (auto& listener : listeners) {
+                _spatializer.addListener(listener.get());
+            }
+            _spatializer.mixFrame();
+            _spatializer.endFrame();
+
+            frame.mixUsecs = mixTimer.nsecsElapsed() / 1000; // ns to us
+
+            for (auto& listener : listeners) {
+                frame.mixes += listener->getStreamsMixed();
+            }
+
+            quint64 frameCostUsecs = (_simulatedUsecsPerMix >= 0) ? (quint64)_simulatedUsecsPerMix * frame.mixes
+                                                                  : frame.mixUsecs;
+            usecSlept = AudioConstants::NETWORK_FRAME_USECS - (int)std::min(frameCostUsecs,
+                                                                            (quint64)AudioConstants::NETWORK_FRAME_USECS);
+            results.maxThrottlingRatio = std::max(results.maxThrottlingRatio, throttle.getPerformanceThrottlingRatio());
+
+            results.frames.push_back(frame);
+        }
+
+        results.starveCount = 0;
+        results.overflowCount = 0;
+        results.framesDropped = 0;
+        results.packetsLost = 0;
+        results.packetsLate = 0;
+        for (auto& stream : streams) {
+            AudioStreamStats stats = stream->getAudioStreamStats();
+            results.starveCount += stats._starveCount;
+            results.overflowCount += stats._overflowCount;
+            results.framesDropped += stats._framesDropped;
+            results.packetsLost += stats._packetStreamStats._lost;
+            results.packetsLate += stats._packetStreamStats._late;
+        }
+
+        return results;
+    }
+
+private:
+    struct Sender {
+        AudioPacketTrace trace;
+        glm::vec3 position;
+        QUuid streamIdentifier;
+    };
+
+    // an injected audio packet as AudioInjector packs it, carrying a frame of a tone
+    static std::unique_ptr<NLPacket> createPacket(const QUuid& streamIdentifier, const glm::vec3& position,
+                                                  quint16 sequence) {
+        const int NUM_FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        const float TONE_AMPLITUDE = 8000.0f;
+        const int TONE_PERIOD_SAMPLES = 48;
+
+        auto packet = NLPacket::create(PacketType::InjectAudio);
+        packet->writePrimitive(sequence);
+
+        QDataStream packetStream(packet.get());
+        packetStream << streamIdentifier;
+        packetStream << false; // mono
+        packetStream << (uchar)0; // no loopback
+        glm::quat orientation;
+        packetStream.writeRawData(reinterpret_cast<const char*>(&position), sizeof(position));
+        packetStream.writeRawData(reinterpret_cast<const char*>(&orientation), sizeof(orientation));
+        packetStream << 0.0f; // radius
+        packetStream << (quint8)255; // full volume
+        packetStream << false; // ignore penumbra
+
+        int16_t samples[NUM_FRAME_SAMPLES];
+        for (int i = 0; i < NUM_FRAME_SAMPLES; ++i) {
+            int t = (int)sequence * NUM_FRAME_SAMPLES + i;
+            samples[i] = (int16_t)(TONE_AMPLITUDE * sinf(TWO_PI * (t % TONE_PERIOD_SAMPLES) / TONE_PERIOD_SAMPLES));
+        }
+        packet->write(reinterpret_cast<const char*>(samples), sizeof(samples));
+
+        packet->seek(0);
+        return packet;
+    }
+
+    InboundAudioStream::Settings _settings;
+    int _simulatedUsecsPerMix;
+    AudioSpatializer _spatializer;
+    std::vector<Sender> _senders;
+    QVector<glm::vec3> _listenerPositions;
+};
+
+const quint32 TRACE_SEED = 0xFEEDBEEF;
+
+// senders and listeners spread over a few meters, so that every sender is audible to every listener
+static glm::vec3 positionInCrowd(int index) {
+    const int ROW_LENGTH = 8;
+    return glm::vec3((float)(index % ROW_LENGTH), 0.0f, (float)(index / ROW_LENGTH));
+}
+
+void AudioReplayTests::traceTextRoundTrip() {
+    AudioPacketTrace trace = AudioPacketTrace::generate(200, 5000, 0.05f, 0.05f, TRACE_SEED);
+    AudioPacketTrace replayed = AudioPacketTrace::fromText(trace.toText());
+
+    QCOMPARE(replayed.entries.size(), trace.entries.size());
+    for (int i = 0; i < trace.entries.size(); ++i) {
+        QCOMPARE(replayed.entries[i].arrivalUsecs, trace.entries[i].arrivalUsecs);
+        QCOMPARE(replayed.entries[i].sequence, trace.entries[i].sequence);
+    }
+
+    // the same seed gives the same trace
+    QCOMPARE(AudioPacketTrace::generate(200, 5000, 0.05f, 0.05f, TRACE_SEED).toText(), trace.toText());
+}
+
+void AudioReplayTests::steadyTraceNeverStarves() {
+    const int NUM_FRAMES = 500;
+
+    AudioReplayHarness harness;
+    harness.addSender(AudioPacketTrace::generate(NUM_FRAMES, 0, 0.0f, 0.0f, TRACE_SEED), glm::vec3(0.0f));
+    harness.addListener(glm::vec3(2.0f, 0.0f, 0.0f));
+
+    AudioReplayResults results = harness.run(NUM_FRAMES);
+
+    QCOMPARE(results.frames.size(), NUM_FRAMES);
+    QCOMPARE(results.starveCount, 0);
+    QCOMPARE(results.overflowCount, 0);
+    QCOMPARE(results.packetsLost, (quint32)0);
+    QCOMPARE(results.maxDesiredJitterBufferFrames, 1);
+    foreach (const AudioReplayFrame& frame, results.frames) {
+        QCOMPARE(frame.streamsPopped, 1);
+        QCOMPARE(frame.mixes, 1);
+    }
+}
+
+void AudioReplayTests::lostPacketsAreCountedAndStarve() {
+    const int NUM_FRAMES = 500;
+    AudioPacketTrace trace = AudioPacketTrace::generate(NUM_FRAMES, 0, 0.05f, 0.0f, TRACE_SEED);
+
+    // a loss is only noticed once a later packet arrives
+    quint32 expectedLost = trace.entries.last().sequence + 1 - trace.entries.size();
+    QVERIFY(expectedLost > 0);
+
+    AudioReplayHarness harness;
+    harness.addSender(trace, glm::vec3(0.0f));
+    harness.addListener(glm::vec3(2.0f, 0.0f, 0.0f));
+
+    AudioReplayResults results = harness.run(NUM_FRAMES);
+
+    QCOMPARE(results.packetsLost, expectedLost);
+    QVERIFY(results.starveCount > 0);
+}
+
+void AudioReplayTests::reorderedPacketsArriveLate() {
+    const int NUM_FRAMES = 500;
+    AudioPacketTrace trace = AudioPacketTrace::generate(NUM_FRAMES, 0, 0.0f, 0.05f, TRACE_SEED);
+
+    quint32 expectedLate = 0;
+    for (int i = 0; i + 1 < trace.entries.size(); ++i) {
+        if (trace.entries[i].sequence > trace.entries[i + 1].sequence) {
+            ++expectedLate;
+        }
+    }
+    QVERIFY(expectedLate > 0);
+
+    AudioReplayHarness harness;
+    harness.addSender(trace, glm::vec3(0.0f));
+    harness.addListener(glm::vec3(2.0f, 0.0f, 0.0f));
+
+    AudioReplayResults results = harness.run(NUM_FRAMES);
+
+    // every reordered packet shows up eventually, so none of them stay lost
+    QCOMPARE(results.packetsLate, expectedLate);
+    QCOMPARE(results.packetsLost, (quint32)0);
+}
+
+void AudioReplayTests::jitterGrowsDynamicJitterBuffer() {
+    const int NUM_FRAMES = 1000;
+    const int JITTER_USECS = 30000;
+    AudioPacketTrace trace = AudioPacketTrace::generate(NUM_FRAMES, JITTER_USECS, 0.0f, 0.0f, TRACE_SEED);
+
+    InboundAudioStream::Settings dynamicSettings;
+    dynamicSettings._dynamicJitterBuffers = true;
+
+    AudioReplayHarness dynamicHarness(dynamicSettings);
+    dynamicHarness.addSender(trace, glm::vec3(0.0f));
+    dynamicHarness.addListener(glm::vec3(2.0f, 0.0f, 0.0f));
+    AudioReplayResults dynamicResults = dynamicHarness.run(NUM_FRAMES);
+
+    InboundAudioStream::Settings staticSettings;
+    staticSettings._dynamicJitterBuffers = false;
+    staticSettings._staticDesiredJitterBufferFrames = 1;
+
+    AudioReplayHarness staticHarness(staticSettings);
+    staticHarness.addSender(trace, glm::vec3(0.0f));
+    staticHarness.addListener(glm::vec3(2.0f, 0.0f, 0.0f));
+    AudioReplayResults staticResults = staticHarness.run(NUM_FRAMES);
+
+    QVERIFY(dynamicResults.maxDesiredJitterBufferFrames > 1);
+    QCOMPARE(staticResults.maxDesiredJitterBufferFrames, 1);
+    QVERIFY(staticResults.starveCount > 0);
+}
+
+void AudioReplayTests::throttleFollowsMixCost() {
+    const int NUM_FRAMES = 600;
+    const int NUM_NODES = 8;
+
+    // 64 mixes a frame at 200 usecs each overrun the frame, at 10 usecs each they leave most of it to sleep
+    const int EXPENSIVE_MIX_USECS = 200;
+    const int CHEAP_MIX_USECS = 10;
+
+    AudioReplayHarness expensiveHarness;
+    AudioReplayHarness cheapHarness;
+    for (int i = 0; i < NUM_NODES; ++i) {
+        AudioPacketTrace trace = AudioPacketTrace::generate(NUM_FRAMES, 0, 0.0f, 0.0f, TRACE_SEED + i);
+        expensiveHarness.addSender(trace, positionInCrowd(i));
+        expensiveHarness.addListener(positionInCrowd(i) + glm::vec3(0.5f, 0.0f, 0.0f));
+        cheapHarness.addSender(trace, positionInCrowd(i));
+        cheapHarness.addListener(positionInCrowd(i) + glm::vec3(0.5f, 0.0f, 0.0f));
+    }
+    expensiveHarness.setSimulatedUsecsPerMix(EXPENSIVE_MIX_USECS);
+    cheapHarness.setSimulatedUsecsPerMix(CHEAP_MIX_USECS);
+
+    AudioReplayResults expensiveResults = expensiveHarness.run(NUM_FRAMES);
+    AudioReplayResults cheapResults = cheapHarness.run(NUM_FRAMES);
+
+    QCOMPARE(expensiveResults.frames.last().mixes, NUM_NODES * NUM_NODES);
+    QVERIFY(expensiveResults.maxThrottlingRatio > 0.0f);
+    QCOMPARE(cheapResults.maxThrottlingRatio, 0.0f);
+}
+
+void AudioReplayTests::benchmarkMixerCapacity() {
+    const int NUM_FRAMES = 300;
+    const int JITTER_USECS = 5000;
+    const float LOSS_RATE = 0.01f;
+    const float REORDER_RATE = 0.01f;
+
+    QList<int> nodeCounts;
+    nodeCounts << 10 << 25 << 50 << 100;
+
+    // one mix thread, one per core, and one per core with mixes shared between listeners, as the mixer can be set up
+    QList<int> mixThreadCounts;
+    mixThreadCounts << 1 << 0 << 0;
+    QList<bool> sharedMixes;
+    sharedMixes << false << false << true;
+
+    foreach (int numNodes, nodeCounts) {
+        for (int setup = 0; setup < mixThreadCounts.size(); ++setup) {
+            AudioReplayHarness harness;
+            harness.getSpatializer().setNumMixThreads(mixThreadCounts[setup]);
+            harness.getSpatializer().setSharedMixes(sharedMixes[setup], DEFAULT_SHARED_MIX_POSITION_TOLERANCE,
+                                                    DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE,
+                                                    DEFAULT_SHARED_MIX_NEAR_DISTANCE);
+            for (int i = 0; i < numNodes; ++i) {
+                harness.addSender(AudioPacketTrace::generate(NUM_FRAMES, JITTER_USECS, LOSS_RATE, REORDER_RATE,
+                                                             TRACE_SEED + i),
+                                  positionInCrowd(i));
+                harness.addListener(positionInCrowd(i) + glm::vec3(0.5f, 0.0f, 0.0f));
+            }
+
+            AudioReplayResults results = harness.run(NUM_FRAMES);
+
+            qDebug() << "TIME -" << numNodes << "senders and listeners on"
+                << harness.getSpatializer().getNumMixThreads() << "mix thread(s),"
+                << (sharedMixes[setup] ? "shared mixes:" : "own mixes:") << results.getAverageMixUsecs()
+                << "usecs a frame on average," << results.getMaxMixUsecs() << "usecs at most,"
+                << results.starveCount << "starves," << results.overflowCount << "overflows,"
+                << "throttling ratio up to" << results.maxThrottlingRatio;
+        }
+    }
+}
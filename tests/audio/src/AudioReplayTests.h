@@ -0,0 +1,31 @@
+//
+//  AudioReplayTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioReplayTests_h
+#define hifi_AudioReplayTests_h
+
+#include <QtTest/QtTest>
+
+class AudioReplayTests : public QObject {
+    Q_OBJECT
+private slots:
+    void traceTextRoundTrip();
+    void steadyTraceNeverStarves();
+    void lostPacketsAreCountedAndStarve();
+    void reorderedPacketsArriveLate();
+    void jitterGrowsDynamicJitterBuffer();
+    void throttleFollowsMixCost();
+
+    // not a pass/fail test, prints per frame mix time and starve/overflow counts for growing numbers of senders and
+    // listeners replaying jittery, lossy traces
+    void benchmarkMixerCapacity();
+};
+
+#endif // hifi_AudioReplayTests_h
@@ -0,0 +1,134 @@
+//
+//  BatchedDatagramIOTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BatchedDatagramIOTests.h"
+#include "../QTestExtensions.h"
+
+#include <BatchedDatagramIO.h>
+#include <udt/PacketHeaders.h>
+
+QTEST_MAIN(BatchedDatagramIOTests)
+
+const int WAIT_FOR_DATAGRAMS_MSECS = 1000;
+
+// reads numDatagrams datagrams from the socket, in batches where we can
+static QList<QByteArray> readDatagrams(QUdpSocket& socket, int numDatagrams, int& numReads) {
+    QList<QByteArray> datagrams;
+    numReads = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (datagrams.size() < numDatagrams && timer.elapsed() < WAIT_FOR_DATAGRAMS_MSECS) {
+        if (!socket.waitForReadyRead(WAIT_FOR_DATAGRAMS_MSECS) && !socket.hasPendingDatagrams()) {
+            continue;
+        }
+
+        if (BatchedDatagramIO::isSupported()) {
+            const int MAX_DATAGRAMS = BatchedDatagramIO::MAX_DATAGRAMS_PER_SYSCALL;
+            static char storage[MAX_DATAGRAMS][MAX_PACKET_SIZE];
+            char* buffers[MAX_DATAGRAMS];
+            qint64 sizes[MAX_DATAGRAMS];
+            sockaddr_in senders[MAX_DATAGRAMS];
+
+            for (int i = 0; i < MAX_DATAGRAMS; ++i) {
+                buffers[i] = storage[i];
+            }
+
+            int numRead = BatchedDatagramIO::readDatagrams(socket, buffers, MAX_PACKET_SIZE, sizes, senders, MAX_DATAGRAMS);
+            ++numReads;
+
+            for (int i = 0; i < numRead; ++i) {
+                datagrams << (sizes[i] < 0 ? QByteArray() : QByteArray(buffers[i], sizes[i]));
+            }
+        } else {
+            while (socket.hasPendingDatagrams()) {
+                QByteArray datagram(socket.pendingDatagramSize(), 0);
+                socket.readDatagram(datagram.data(), datagram.size());
+                ++numReads;
+                datagrams << datagram;
+            }
+        }
+    }
+
+    return datagrams;
+}
+
+void BatchedDatagramIOTests::sendQueueRoundTripTest() {
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    HifiSockAddr destination(QHostAddress::LocalHost, receiver.localPort());
+
+    // more than fit in one syscall, like a mixer frame with a lot of listeners
+    const int NUM_DATAGRAMS = BatchedDatagramIO::MAX_DATAGRAMS_PER_SYSCALL + 10;
+
+    BatchedDatagramIO::SendQueue queue;
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        QByteArray datagram = QByteArray::number(i).repeated(i + 1);
+        queue.enqueue(datagram.constData(), datagram.size(), destination);
+    }
+    QCOMPARE(queue.getNumQueuedDatagrams(), NUM_DATAGRAMS);
+
+    int numSyscalls = queue.flush(sender);
+    QCOMPARE(queue.getNumQueuedDatagrams(), 0);
+
+    if (BatchedDatagramIO::isSupported()) {
+        QCOMPARE(numSyscalls, 2);
+    } else {
+        QCOMPARE(numSyscalls, NUM_DATAGRAMS);
+    }
+
+    int numReads = 0;
+    QList<QByteArray> datagrams = readDatagrams(receiver, NUM_DATAGRAMS, numReads);
+
+    QCOMPARE(datagrams.size(), NUM_DATAGRAMS);
+    for (int i = 0; i < NUM_DATAGRAMS; ++i) {
+        QCOMPARE(datagrams[i], QByteArray::number(i).repeated(i + 1));
+    }
+
+    if (BatchedDatagramIO::isSupported()) {
+        QVERIFY(numReads < NUM_DATAGRAMS);
+    }
+
+    // the queue is reusable once flushed
+    queue.enqueue("again", 5, destination);
+    queue.flush(sender);
+
+    datagrams = readDatagrams(receiver, 1, numReads);
+    QCOMPARE(datagrams.size(), 1);
+    QCOMPARE(datagrams[0], QByteArray("again"));
+}
+
+void BatchedDatagramIOTests::truncatedDatagramTest() {
+    if (!BatchedDatagramIO::isSupported()) {
+        QSKIP("Batched reads are not supported on this platform");
+    }
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    QByteArray oversized(MAX_PACKET_SIZE + 1, 'x');
+    sender.writeDatagram(oversized, QHostAddress::LocalHost, receiver.localPort());
+    sender.writeDatagram(QByteArray("fits"), QHostAddress::LocalHost, receiver.localPort());
+
+    int numReads = 0;
+    QList<QByteArray> datagrams = readDatagrams(receiver, 2, numReads);
+
+    QCOMPARE(datagrams.size(), 2);
+    QVERIFY(datagrams[0].isEmpty());
+    QCOMPARE(datagrams[1], QByteArray("fits"));
+}
@@ -0,0 +1,28 @@
+//
+//  BatchedDatagramIOTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BatchedDatagramIOTests_h
+#define hifi_BatchedDatagramIOTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class BatchedDatagramIOTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a flushed queue arrives intact and in order over loopback, with batched reads where supported
+    void sendQueueRoundTripTest();
+
+    // Test that a datagram too large for its buffer is flagged instead of handed on truncated
+    void truncatedDatagramTest();
+};
+
+#endif // hifi_BatchedDatagramIOTests_h
@@ -0,0 +1,162 @@
+//
+//  ReceivedPacketPoolTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedPacketPoolTests.h"
+#include "../QTestExtensions.h"
+
+#include <NumericalConstants.h>
+#include <ReceivedPacketPool.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(ReceivedPacketPoolTests)
+
+// writes a datagram as it would come off the wire into the given buffer, returns its size
+static qint64 writeDatagram(char* buffer, PacketType::Value type, const QUuid& sourceID, const QByteArray& payload) {
+    auto packet = NLPacket::create(type);
+    if (!NON_SOURCED_PACKETS.contains(type)) {
+        packet->writeSourceID(sourceID);
+    }
+    packet->write(payload);
+
+    memcpy(buffer, packet->getData(), packet->getDataSize());
+    return packet->getDataSize();
+}
+
+void ReceivedPacketPoolTests::recycleTest() {
+    ReceivedPacketPool pool;
+
+    NLPacket* firstPacket = nullptr;
+    {
+        auto packet = pool.acquire();
+        firstPacket = packet.data();
+
+        auto otherReference = packet;
+        packet.clear();
+
+        // still referenced, so it can't be back in the pool yet
+        QCOMPARE(pool.getNumFreePackets(), 0);
+    }
+
+    QCOMPARE(pool.getNumFreePackets(), 1);
+    QCOMPARE(pool.getNumAllocatedPackets(), 1);
+
+    auto packet = pool.acquire();
+    QCOMPARE(packet.data(), firstPacket);
+    QCOMPARE(pool.getNumFreePackets(), 0);
+    QCOMPARE(pool.getNumAllocatedPackets(), 1);
+}
+
+void ReceivedPacketPoolTests::resetForReceivedDataTest() {
+    ReceivedPacketPool pool;
+    QUuid sourceID = QUuid::createUuid();
+
+    // a big sourced datagram followed by a small non sourced one in the same packet
+    QByteArray bigPayload(NLPacket::maxPayloadSize(PacketType::AvatarData), 'a');
+    QByteArray smallPayload("small");
+
+    auto packet = pool.acquire();
+    qint64 size = writeDatagram(packet->getData(), PacketType::AvatarData, sourceID, bigPayload);
+    packet->resetForReceivedData(size, HifiSockAddr());
+
+    QCOMPARE(packet->getType(), PacketType::AvatarData);
+    QCOMPARE(packet->getSourceID(), sourceID);
+    QCOMPARE(packet->getPayloadSize(), (qint64) bigPayload.size());
+    QCOMPARE(packet->getDataSize(), size);
+
+    // read part of it so there is a position to forget
+    packet->read(10);
+
+    NLPacket* recycledPacket = packet.data();
+    packet.clear();
+
+    packet = pool.acquire();
+    QCOMPARE(packet.data(), recycledPacket);
+
+    size = writeDatagram(packet->getData(), PacketType::ICEPing, QUuid(), smallPayload);
+    packet->resetForReceivedData(size, HifiSockAddr());
+
+    QCOMPARE(packet->getType(), PacketType::ICEPing);
+    QCOMPARE(packet->getSourceID(), QUuid());
+    QCOMPARE(packet->getPayloadSize(), (qint64) smallPayload.size());
+    QCOMPARE(packet->getDataSize(), size);
+    QCOMPARE(packet->pos(), (qint64) 0);
+    QCOMPARE(packet->bytesLeftToRead(), (qint64) smallPayload.size());
+    COMPARE_DATA(packet->getPayload(), smallPayload.constData(), smallPayload.size());
+}
+
+void ReceivedPacketPoolTests::maxFreePacketsTest() {
+    const int MAX_FREE_PACKETS = 2;
+    QList<QSharedPointer<NLPacket>> packets;
+
+    {
+        ReceivedPacketPool pool(MAX_FREE_PACKETS);
+
+        for (int i = 0; i < MAX_FREE_PACKETS + 2; ++i) {
+            packets << pool.acquire();
+        }
+        QCOMPARE(pool.getNumAllocatedPackets(), MAX_FREE_PACKETS + 2);
+
+        packets.removeFirst();
+        packets.removeFirst();
+        packets.removeFirst();
+
+        QCOMPARE(pool.getNumFreePackets(), MAX_FREE_PACKETS);
+        QCOMPARE(pool.getNumAllocatedPackets(), MAX_FREE_PACKETS + 1);
+    }
+
+    // the pool is gone but the packet we still hold has to be safe to drop
+    QCOMPARE(packets.size(), 1);
+    packets.clear();
+}
+
+void ReceivedPacketPoolTests::receiveBenchmark() {
+    const int TEST_ITERATIONS = 1000000;
+    const int NUM_PACKETS_IN_FLIGHT = 64;
+
+    char datagram[MAX_PACKET_SIZE];
+    qint64 size = writeDatagram(datagram, PacketType::AvatarData, QUuid::createUuid(), QByteArray(200, 'a'));
+
+    // hold on to a window of packets like a listener that is a little behind would
+    QVector<QSharedPointer<NLPacket>> inFlight(NUM_PACKETS_IN_FLIGHT);
+
+    {
+        quint64 start = usecTimestampNow();
+        for (int i = 0; i < TEST_ITERATIONS; ++i) {
+            auto buffer = std::unique_ptr<char[]>(new char[size]);
+            memcpy(buffer.get(), datagram, size);
+            inFlight[i % NUM_PACKETS_IN_FLIGHT] =
+                QSharedPointer<NLPacket>(NLPacket::fromReceivedPacket(std::move(buffer), size, HifiSockAddr()).release());
+        }
+        quint64 end = usecTimestampNow();
+
+        float packetsPerSecond = (float)TEST_ITERATIONS / ((float)(end - start) / USECS_PER_SECOND);
+        qDebug() << "TIME - allocated packets:" << packetsPerSecond << "packets/sec";
+    }
+
+    inFlight.fill(QSharedPointer<NLPacket>());
+
+    {
+        ReceivedPacketPool pool;
+
+        quint64 start = usecTimestampNow();
+        for (int i = 0; i < TEST_ITERATIONS; ++i) {
+            auto packet = pool.acquire();
+            memcpy(packet->getData(), datagram, size);
+            packet->resetForReceivedData(size, HifiSockAddr());
+            inFlight[i % NUM_PACKETS_IN_FLIGHT] = packet;
+        }
+        quint64 end = usecTimestampNow();
+
+        float packetsPerSecond = (float)TEST_ITERATIONS / ((float)(end - start) / USECS_PER_SECOND);
+        qDebug() << "TIME - pooled packets:" << packetsPerSecond << "packets/sec";
+
+        QCOMPARE(pool.getNumAllocatedPackets(), NUM_PACKETS_IN_FLIGHT + 1);
+    }
+}
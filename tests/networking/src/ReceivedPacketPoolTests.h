@@ -0,0 +1,34 @@
+//
+//  ReceivedPacketPoolTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedPacketPoolTests_h
+#define hifi_ReceivedPacketPoolTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceivedPacketPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a packet goes back to the pool when the last reference drops
+    void recycleTest();
+
+    // Test that a recycled packet reads the headers and payload of the next datagram
+    void resetForReceivedDataTest();
+
+    // Test that the pool frees what it can't keep and that packets can outlive it
+    void maxFreePacketsTest();
+
+    // Measure packets/sec for allocating versus pooling received packets
+    void receiveBenchmark();
+};
+
+#endif // hifi_ReceivedPacketPoolTests_h
@@ -0,0 +1,164 @@
+//
+//  VerificationHashTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "VerificationHashTests.h"
+#include "../QTestExtensions.h"
+
+#include <QtCore/QCryptographicHash>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <VerificationHash.h>
+
+QTEST_MAIN(VerificationHashTests)
+
+// a verified packet type with a typical audio sized payload
+const PacketType::Value TEST_PACKET_TYPE = PacketType::MicrophoneAudioNoEcho;
+const int TEST_PAYLOAD_BYTES = 512;
+
+static std::unique_ptr<NLPacket> createSignedPacket(const QUuid& sourceID, const VerificationHash::Key& key) {
+    auto packet = NLPacket::create(TEST_PACKET_TYPE);
+
+    char payload[TEST_PAYLOAD_BYTES];
+    for (int i = 0; i < TEST_PAYLOAD_BYTES; ++i) {
+        payload[i] = (char) i;
+    }
+    packet->write(payload, TEST_PAYLOAD_BYTES);
+
+    packet->writeSourceID(sourceID);
+    packet->writeVerificationHash(key);
+
+    return packet;
+}
+
+static std::unique_ptr<NLPacket> copyToReceivedPacket(const NLPacket& packet) {
+    auto size = packet.getDataSize();
+    auto data = std::unique_ptr<char[]>(new char[size]);
+    memcpy(data.get(), packet.getData(), size);
+    return NLPacket::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+}
+
+void VerificationHashTests::sipHashReferenceVectorsTest() {
+    // key 00 01 02 ... 0f read as little endian words, message 00 01 02 ... (length - 1)
+    const uint64_t key[2] = { 0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL };
+
+    char message[16];
+    for (int i = 0; i < 16; ++i) {
+        message[i] = (char) i;
+    }
+
+    char result[VerificationHash::NUM_BYTES_HASH];
+
+    VerificationHash::sipHash128(key, message, 0, result);
+    COMPARE_DATA(result, "\xa3\x81\x7f\x04\xba\x25\xa8\xe6\x6d\xf6\x72\x14\xc7\x55\x02\x93", 16);
+
+    VerificationHash::sipHash128(key, message, 1, result);
+    COMPARE_DATA(result, "\xda\x87\xc1\xd8\x6b\x99\xaf\x44\x34\x76\x59\x11\x9b\x22\xfc\x45", 16);
+}
+
+void VerificationHashTests::md5SecretByteOrderTest() {
+    QUuid connectionSecret = QUuid::createUuid();
+    VerificationHash::Key key(connectionSecret, VerificationHash::MD5);
+
+    char payload[TEST_PAYLOAD_BYTES];
+    for (int i = 0; i < TEST_PAYLOAD_BYTES; ++i) {
+        payload[i] = (char) i;
+    }
+
+    QCryptographicHash expectedHash(QCryptographicHash::Md5);
+    expectedHash.addData(payload, TEST_PAYLOAD_BYTES);
+    expectedHash.addData(connectionSecret.toRfc4122());
+
+    char result[VerificationHash::NUM_BYTES_HASH];
+    key.hash(payload, TEST_PAYLOAD_BYTES, result);
+    COMPARE_DATA(result, expectedHash.result().constData(), VerificationHash::NUM_BYTES_HASH);
+}
+
+void VerificationHashTests::verifyRoundTripTest() {
+    QUuid sourceID = QUuid::createUuid();
+    QUuid connectionSecret = QUuid::createUuid();
+
+    for (int method = VerificationHash::MD5; method <= VerificationHash::BEST_METHOD; ++method) {
+        VerificationHash::Key key(connectionSecret, (VerificationHash::Method) method);
+
+        auto sentPacket = createSignedPacket(sourceID, key);
+        auto receivedPacket = copyToReceivedPacket(*sentPacket);
+
+        QCOMPARE(receivedPacket->getSourceID(), sourceID);
+        QVERIFY(receivedPacket->verificationHashMatches(key));
+    }
+}
+
+void VerificationHashTests::verifyMismatchTest() {
+    QUuid sourceID = QUuid::createUuid();
+    QUuid connectionSecret = QUuid::createUuid();
+
+    VerificationHash::Key md5Key(connectionSecret, VerificationHash::MD5);
+    VerificationHash::Key sipHashKey(connectionSecret, VerificationHash::SipHash);
+
+    auto receivedPacket = copyToReceivedPacket(*createSignedPacket(sourceID, sipHashKey));
+
+    QVERIFY(!receivedPacket->verificationHashMatches(md5Key));
+    QVERIFY(!receivedPacket->verificationHashMatches(VerificationHash::Key(QUuid::createUuid(),
+                                                                           VerificationHash::SipHash)));
+
+    // flip a payload bit after the hash was written
+    receivedPacket->getPayload()[TEST_PAYLOAD_BYTES / 2] ^= 0x1;
+    QVERIFY(!receivedPacket->verificationHashMatches(sipHashKey));
+}
+
+void VerificationHashTests::methodForConnectionTest() {
+    QCOMPARE(VerificationHash::methodForConnection(VerificationHash::SipHash, VerificationHash::SipHash),
+             VerificationHash::SipHash);
+    QCOMPARE(VerificationHash::methodForConnection(VerificationHash::SipHash, VerificationHash::MD5),
+             VerificationHash::MD5);
+    QCOMPARE(VerificationHash::methodForConnection(VerificationHash::MD5, VerificationHash::SipHash),
+             VerificationHash::MD5);
+}
+
+void VerificationHashTests::verifyAndDispatchBenchmark() {
+    const int TEST_PACKETS = 100000;
+
+    VerificationHashTestListener listener;
+    int handlerIndex = listener.metaObject()->indexOfSlot(
+        QMetaObject::normalizedSignature("handlePacket(QSharedPointer<NLPacket>,SharedNodePointer)"));
+    QVERIFY(handlerIndex >= 0);
+    QMetaMethod handler = listener.metaObject()->method(handlerIndex);
+
+    QUuid connectionSecret = QUuid::createUuid();
+
+    for (int method = VerificationHash::MD5; method <= VerificationHash::BEST_METHOD; ++method) {
+        SharedNodePointer sendingNode(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr(),
+                                               false, false, connectionSecret));
+        sendingNode->setVerificationHashMethod((VerificationHash::Method) method);
+
+        auto sentPacket = createSignedPacket(sendingNode->getUUID(), sendingNode->getVerificationHashKey());
+        int numPacketsHandledBefore = listener.getNumPacketsHandled();
+
+        quint64 start = usecTimestampNow();
+        for (int i = 0; i < TEST_PACKETS; ++i) {
+            // the same steps PacketReceiver takes for each datagram once it is off the socket
+            auto packet = copyToReceivedPacket(*sentPacket);
+
+            if (packet->verificationHashMatches(sendingNode->getVerificationHashKey())) {
+                handler.invoke(&listener, Qt::DirectConnection,
+                               Q_ARG(QSharedPointer<NLPacket>, QSharedPointer<NLPacket>(packet.release())),
+                               Q_ARG(SharedNodePointer, sendingNode));
+            }
+        }
+        quint64 end = usecTimestampNow();
+
+        QCOMPARE(listener.getNumPacketsHandled() - numPacketsHandledBefore, TEST_PACKETS);
+
+        float packetsPerSecond = (float) TEST_PACKETS / ((float) (end - start) / USECS_PER_SECOND);
+        qDebug() << "TIME -" << VerificationHash::getMethodName((VerificationHash::Method) method)
+                 << "verify and dispatch:" << packetsPerSecond << "packets/sec";
+    }
+}
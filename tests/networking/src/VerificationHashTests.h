@@ -0,0 +1,56 @@
+//
+//  VerificationHashTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_VerificationHashTests_h
+#define hifi_VerificationHashTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+#include <NLPacket.h>
+#include <Node.h>
+
+// stands in for a packet listener so the benchmark pays for the same QMetaMethod dispatch PacketReceiver does
+class VerificationHashTestListener : public QObject {
+    Q_OBJECT
+public:
+    int getNumPacketsHandled() const { return _numPacketsHandled; }
+
+public slots:
+    void handlePacket(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) { ++_numPacketsHandled; }
+
+private:
+    int _numPacketsHandled = 0;
+};
+
+class VerificationHashTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test SipHash against the reference implementation's test vectors
+    void sipHashReferenceVectorsTest();
+
+    // Test that an MD5 key hashes the secret in its RFC 4122 byte order, as older nodes do
+    void md5SecretByteOrderTest();
+
+    // Test that a written hash verifies with the same key, for every method
+    void verifyRoundTripTest();
+
+    // Test that a different secret, method or payload fails verification
+    void verifyMismatchTest();
+
+    // Test the method two nodes end up with
+    void methodForConnectionTest();
+
+    // Measure packets/sec through parse, verify and dispatch for every method
+    void verifyAndDispatchBenchmark();
+};
+
+#endif // hifi_VerificationHashTests_h
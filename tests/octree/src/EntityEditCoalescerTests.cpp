@@ -0,0 +1,180 @@
+//
+//  EntityEditCoalescerTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityEditCoalescerTests.h"
+
+#include <EntityEditCoalescer.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityEditCoalescerTests)
+
+// far enough from 0 that no entity looks like it was never sent
+const quint64 START = 100 * USECS_PER_SECOND;
+
+static EntityItemProperties positionEdit(const glm::vec3& position) {
+    EntityItemProperties properties;
+    properties.setPosition(position);
+    return properties;
+}
+
+void EntityEditCoalescerTests::mergeTakesLaterProperties() {
+    EntityItemProperties properties;
+    properties.setPosition(glm::vec3(1.0f));
+    properties.setName("first");
+    properties.setLastEdited(START);
+
+    EntityItemProperties later;
+    later.setPosition(glm::vec3(2.0f));
+    later.setUserData("later");
+    later.getStage().setLatitude(45.0f);
+    later.setLastEdited(START + 1);
+
+    properties.merge(later);
+    QCOMPARE(properties.getPosition(), glm::vec3(2.0f));
+    QCOMPARE(properties.getName(), QString("first"));
+    QCOMPARE(properties.getUserData(), QString("later"));
+    QCOMPARE(properties.getStage().getLatitude(), 45.0f);
+    QCOMPARE(properties.getLastEdited(), START + 1);
+
+    EntityPropertyFlags changedProperties = properties.getChangedProperties();
+    QVERIFY(changedProperties.getHasProperty(PROP_POSITION));
+    QVERIFY(changedProperties.getHasProperty(PROP_NAME));
+    QVERIFY(changedProperties.getHasProperty(PROP_USER_DATA));
+    QVERIFY(changedProperties.getHasProperty(PROP_STAGE_LATITUDE));
+    QVERIFY(!changedProperties.getHasProperty(PROP_ROTATION));
+}
+
+void EntityEditCoalescerTests::editsWithinIntervalAreMerged() {
+    EntityEditCoalescer coalescer;
+    coalescer.setUsecsBetweenEdits(USECS_PER_SECOND / 10);
+    EntityItemID entityID(QUuid::createUuid());
+    EntityItemID otherEntityID(QUuid::createUuid());
+
+    // the first edit goes out right away, the next ones wait for the interval to pass
+    QVERIFY(coalescer.editQueued(entityID, positionEdit(glm::vec3(1.0f)), START));
+    QVERIFY(!coalescer.editQueued(entityID, positionEdit(glm::vec3(2.0f)), START + 1));
+    EntityItemProperties nameEdit;
+    nameEdit.setName("renamed");
+    QVERIFY(!coalescer.editQueued(entityID, nameEdit, START + 2));
+    QVERIFY(!coalescer.editQueued(entityID, positionEdit(glm::vec3(3.0f)), START + 3));
+
+    // other entities are not held up by it
+    QVERIFY(coalescer.editQueued(otherEntityID, positionEdit(glm::vec3(1.0f)), START + 4));
+
+    QCOMPARE(coalescer.getHeldEditCount(), 1);
+    QCOMPARE(coalescer.getEditsHeld(), (quint64)1);
+    QCOMPARE(coalescer.getEditsCoalesced(), (quint64)2);
+    QCOMPARE(coalescer.getNextDueTime(), START + USECS_PER_SECOND / 10);
+
+    QVector<EntityEditCoalescer::Edit> edits;
+    coalescer.takeDueEdits(START + USECS_PER_SECOND / 10 - 1, edits);
+    QVERIFY(edits.isEmpty());
+
+    coalescer.takeDueEdits(START + USECS_PER_SECOND / 10, edits);
+    QCOMPARE(edits.size(), 1);
+    QCOMPARE(edits[0].first, entityID);
+    QCOMPARE(edits[0].second.getPosition(), glm::vec3(3.0f));
+    QCOMPARE(edits[0].second.getName(), QString("renamed"));
+    QCOMPARE(coalescer.getHeldEditCount(), 0);
+    QCOMPARE(coalescer.getNextDueTime(), (quint64)0);
+
+    // the released edit counts as the last one sent
+    QVERIFY(!coalescer.editQueued(entityID, positionEdit(glm::vec3(4.0f)), START + USECS_PER_SECOND / 10 + 1));
+
+    // and with the interval off every edit goes out
+    coalescer.setUsecsBetweenEdits(0);
+    edits.clear();
+    coalescer.takeDueEdits(START + USECS_PER_SECOND / 10 + 2, edits);
+    QCOMPARE(edits.size(), 1);
+    QVERIFY(coalescer.editQueued(entityID, positionEdit(glm::vec3(5.0f)), START + USECS_PER_SECOND / 10 + 3));
+    QVERIFY(coalescer.editQueued(entityID, positionEdit(glm::vec3(6.0f)), START + USECS_PER_SECOND / 10 + 4));
+}
+
+void EntityEditCoalescerTests::erasedEntityEditIsDropped() {
+    EntityEditCoalescer coalescer;
+    EntityItemID entityID(QUuid::createUuid());
+
+    QVERIFY(coalescer.editQueued(entityID, positionEdit(glm::vec3(1.0f)), START));
+    QVERIFY(!coalescer.editQueued(entityID, positionEdit(glm::vec3(2.0f)), START + 1));
+    coalescer.entityErased(entityID);
+    QCOMPARE(coalescer.getHeldEditCount(), 0);
+
+    QVector<EntityEditCoalescer::Edit> edits;
+    coalescer.takeDueEdits(START + USECS_PER_SECOND, edits);
+    QVERIFY(edits.isEmpty());
+}
+
+void EntityEditCoalescerTests::editsPerSecondAreCapped() {
+    const int MAX_EDITS_PER_SECOND = 10;
+    const int ENTITIES = 2 * MAX_EDITS_PER_SECOND;
+
+    EntityEditCoalescer coalescer;
+    coalescer.setMaxEditsPerSecond(MAX_EDITS_PER_SECOND);
+    QVector<EntityItemID> entityIDs;
+    for (int i = 0; i < ENTITIES; i++) {
+        entityIDs.push_back(EntityItemID(QUuid::createUuid()));
+    }
+
+    // a second's worth goes out in a burst, the rest is held
+    int sent = 0;
+    foreach (const EntityItemID& entityID, entityIDs) {
+        if (coalescer.editQueued(entityID, positionEdit(glm::vec3(1.0f)), START)) {
+            sent++;
+        }
+    }
+    QCOMPARE(sent, MAX_EDITS_PER_SECOND);
+    QCOMPARE(coalescer.getHeldEditCount(), ENTITIES - MAX_EDITS_PER_SECOND);
+    QVERIFY(coalescer.getNextDueTime() > START);
+
+    // and then goes out at the capped rate, oldest first
+    QVector<EntityEditCoalescer::Edit> edits;
+    coalescer.takeDueEdits(START + USECS_PER_SECOND / 2, edits);
+    QCOMPARE(edits.size(), MAX_EDITS_PER_SECOND / 2);
+    QCOMPARE(edits[0].first, entityIDs[MAX_EDITS_PER_SECOND]);
+
+    coalescer.takeDueEdits(START + USECS_PER_SECOND, edits);
+    QCOMPARE(edits.size(), MAX_EDITS_PER_SECOND);
+    QCOMPARE(coalescer.getHeldEditCount(), 0);
+}
+
+void EntityEditCoalescerTests::benchmarkScriptedEdits() {
+    const int ENTITIES = 100;
+    const int FRAMES = 600;
+    const quint64 USECS_PER_FRAME = USECS_PER_SECOND / 60;
+
+    EntityEditCoalescer coalescer;
+    QVector<EntityItemID> entityIDs;
+    for (int i = 0; i < ENTITIES; i++) {
+        entityIDs.push_back(EntityItemID(QUuid::createUuid()));
+    }
+
+    // every entity is moved every frame, as a script animating them would
+    int sent = 0;
+    QVector<EntityEditCoalescer::Edit> edits;
+    quint64 start = usecTimestampNow();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        quint64 now = START + frame * USECS_PER_FRAME;
+        foreach (const EntityItemID& entityID, entityIDs) {
+            if (coalescer.editQueued(entityID, positionEdit(glm::vec3((float)frame)), now)) {
+                sent++;
+            }
+        }
+        edits.clear();
+        coalescer.takeDueEdits(now, edits);
+        sent += edits.size();
+    }
+    quint64 elapsed = usecTimestampNow() - start;
+
+    QVERIFY(sent < ENTITIES * FRAMES);
+    qDebug() << "TIME - coalescing" << ENTITIES * FRAMES << "edits of" << ENTITIES << "entities over" << FRAMES
+             << "frames:" << (float)elapsed / USECS_PER_MSEC << "msecs," << sent << "edits sent,"
+             << coalescer.getEditsCoalesced() << "coalesced";
+}
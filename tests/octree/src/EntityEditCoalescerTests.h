@@ -0,0 +1,27 @@
+//
+//  EntityEditCoalescerTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityEditCoalescerTests_h
+#define hifi_EntityEditCoalescerTests_h
+
+#include <QtTest/QtTest>
+
+class EntityEditCoalescerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void mergeTakesLaterProperties();
+    void editsWithinIntervalAreMerged();
+    void erasedEntityEditIsDropped();
+    void editsPerSecondAreCapped();
+    void benchmarkScriptedEdits();
+};
+
+#endif // hifi_EntityEditCoalescerTests_h
@@ -0,0 +1,100 @@
+//
+//  EntityTreeBulkAddTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityTreeBulkAddTests.h"
+
+#include <EntityTree.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityTreeBulkAddTests)
+
+// entities from a few centimeters to a few hundred meters across, so that they end up at every level of the tree
+static void makeEntities(int count, QVector<EntityItemID>& entityIDs, QVector<EntityItemProperties>& entitiesProperties) {
+    for (int i = 0; i < count; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3(randFloat(), randFloat(), randFloat()) * (float)TREE_SCALE);
+        properties.setDimensions(glm::vec3(powf(2.0f, randFloatInRange(-5.0f, 8.0f))));
+        entityIDs << EntityItemID(QUuid::createUuid());
+        entitiesProperties << properties;
+    }
+}
+
+void EntityTreeBulkAddTests::initTestCase() {
+    // seed the random number generator so that our tests are reproducible
+    srand(0xFEEDBEEF);
+}
+
+void EntityTreeBulkAddTests::placementMatchesAddEntity() {
+    const int ENTITIES = 5000;
+
+    QVector<EntityItemID> entityIDs;
+    QVector<EntityItemProperties> entitiesProperties;
+    makeEntities(ENTITIES, entityIDs, entitiesProperties);
+
+    EntityTree tree;
+    for (int i = 0; i < ENTITIES; i++) {
+        QVERIFY(tree.addEntity(entityIDs[i], entitiesProperties[i]));
+    }
+
+    EntityTree bulkTree;
+    QCOMPARE(bulkTree.addEntities(entityIDs, entitiesProperties).size(), ENTITIES);
+
+    for (int i = 0; i < ENTITIES; i++) {
+        EntityTreeElement* element = tree.getContainingElement(entityIDs[i]);
+        EntityTreeElement* bulkElement = bulkTree.getContainingElement(entityIDs[i]);
+        QVERIFY(bulkElement);
+        QCOMPARE(bulkElement->getAACube(), element->getAACube());
+        QVERIFY(bulkElement->getEntityWithEntityItemID(entityIDs[i]));
+    }
+    QCOMPARE(bulkTree.getOctreeElementsCount(), tree.getOctreeElementsCount());
+}
+
+void EntityTreeBulkAddTests::existingEntitiesAreSkipped() {
+    QVector<EntityItemID> entityIDs;
+    QVector<EntityItemProperties> entitiesProperties;
+    makeEntities(10, entityIDs, entitiesProperties);
+
+    EntityTree tree;
+    QVERIFY(tree.addEntity(entityIDs[0], entitiesProperties[0]));
+
+    // the one already in the tree, and the repeat of the last one, are left out
+    entityIDs << entityIDs.last();
+    entitiesProperties << entitiesProperties.last();
+    QCOMPARE(tree.addEntities(entityIDs, entitiesProperties).size(), 9);
+}
+
+void EntityTreeBulkAddTests::benchmarkBulkAdd() {
+    const int ENTITIES = 100000;
+
+    QVector<EntityItemID> entityIDs;
+    QVector<EntityItemProperties> entitiesProperties;
+    makeEntities(ENTITIES, entityIDs, entitiesProperties);
+
+    quint64 start = usecTimestampNow();
+    {
+        EntityTree tree;
+        for (int i = 0; i < ENTITIES; i++) {
+            tree.addEntity(entityIDs[i], entitiesProperties[i]);
+        }
+    }
+    quint64 addEntityTime = usecTimestampNow() - start;
+
+    start = usecTimestampNow();
+    {
+        EntityTree tree;
+        tree.addEntities(entityIDs, entitiesProperties);
+    }
+    quint64 addEntitiesTime = usecTimestampNow() - start;
+
+    qDebug() << "TIME - adding" << ENTITIES << "entities one at a time:" << (float)addEntityTime / USECS_PER_MSEC << "msecs";
+    qDebug() << "TIME - adding" << ENTITIES << "entities in bulk:" << (float)addEntitiesTime / USECS_PER_MSEC << "msecs";
+}
@@ -0,0 +1,27 @@
+//
+//  EntityTreeBulkAddTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityTreeBulkAddTests_h
+#define hifi_EntityTreeBulkAddTests_h
+
+#include <QtTest/QtTest>
+
+class EntityTreeBulkAddTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void placementMatchesAddEntity();
+    void existingEntitiesAreSkipped();
+    void benchmarkBulkAdd();
+};
+
+#endif // hifi_EntityTreeBulkAddTests_h
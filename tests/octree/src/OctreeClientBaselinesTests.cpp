@@ -0,0 +1,229 @@
+//
+//  OctreeClientBaselinesTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeClientBaselinesTests.h"
+
+#include <EntityTree.h>
+#include <NumericalConstants.h>
+#include <OctreeClientBaselines.h>
+#include <OctreeSceneStats.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(OctreeClientBaselinesTests)
+
+// large entities, of which a move only changes a small part
+static QVector<EntityItemPointer> addEntities(EntityTree& tree, int count) {
+    QVector<EntityItemPointer> entities;
+    for (int i = 0; i < count; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setName(QString("entity %1").arg(i));
+        properties.setUserData(QString(200, QChar('x')));
+        properties.setPosition(glm::vec3(randFloat(), randFloat(), randFloat()) * (TREE_SCALE / 2.0f) + TREE_SCALE / 4.0f);
+        entities.push_back(tree.addEntity(EntityItemID(QUuid::createUuid()), properties));
+    }
+    return entities;
+}
+
+// encodes every entity in the tree the way a send thread does, committing each packet's worth of baselines as if it
+// was sent unless told to drop them, and returns the number of bytes encoded
+static int encodeScene(EntityTree& tree, OctreeClientBaselines* baselines, OctreeSceneStats* stats = NULL,
+                       bool commit = true) {
+    OctreeElementBag bag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData;
+    packetData.setClientBaselines(baselines);
+    int bytes = 0;
+
+    bag.insert(tree.getRoot());
+    while (!bag.isEmpty()) {
+        OctreeElement* subTree = bag.extract();
+        EncodeBitstreamParams params(INT_MAX, IGNORE_VIEW_FRUSTUM, WANT_COLOR, WANT_EXISTS_BITS, DONT_CHOP, false,
+                                     IGNORE_VIEW_FRUSTUM, NO_OCCLUSION_CULLING, IGNORE_COVERAGE_MAP, NO_BOUNDARY_ADJUST,
+                                     DEFAULT_OCTREE_SIZE_SCALE, IGNORE_LAST_SENT, true, IGNORE_SCENE_STATS,
+                                     IGNORE_JURISDICTION_MAP, &extraEncodeData);
+        packetData.reset();
+        tree.encodeTreeBitstream(subTree, &packetData, bag, params);
+        bytes += packetData.getUncompressedSize();
+        if (baselines) {
+            if (commit) {
+                baselines->commitPending(packetData, stats);
+            } else {
+                baselines->dropPending();
+            }
+        }
+    }
+    tree.releaseSceneEncodeData(&extraEncodeData);
+    return bytes;
+}
+
+void OctreeClientBaselinesTests::initTestCase() {
+    // seed the random number generator so that our tests are reproducible
+    srand(0xFEEDBEEF);
+}
+
+void OctreeClientBaselinesTests::discardedBytesAreTracked() {
+    OctreePacketData packetData;
+    packetData.appendValue(1.0f);
+
+    LevelDetails level = packetData.startLevel();
+    int offset = packetData.getUncompressedByteOffset();
+    packetData.appendValue(2.0f);
+    int discardCount = packetData.getDiscardCount();
+    QVERIFY(!packetData.wasDiscardedSince(discardCount, offset));
+
+    // what is written over the discarded bytes does not bring them back
+    packetData.discardLevel(level);
+    packetData.appendValue(3.0f);
+    packetData.appendValue(4.0f);
+    QVERIFY(packetData.wasDiscardedSince(discardCount, offset));
+    QVERIFY(!packetData.wasDiscardedSince(discardCount, 0));
+
+    // neither does a discard of bytes that were written later
+    LevelDetails laterLevel = packetData.startLevel();
+    int laterOffset = packetData.getUncompressedByteOffset();
+    packetData.appendValue(5.0f);
+    int laterDiscardCount = packetData.getDiscardCount();
+    packetData.discardLevel(laterLevel);
+    QVERIFY(packetData.wasDiscardedSince(laterDiscardCount, laterOffset));
+    QVERIFY(!packetData.wasDiscardedSince(laterDiscardCount, offset));
+}
+
+void OctreeClientBaselinesTests::unchangedPropertiesAreLeftOut() {
+    const int ENTITIES = 100;
+
+    EntityTree tree;
+    QVector<EntityItemPointer> entities = addEntities(tree, ENTITIES);
+    OctreeClientBaselines baselines;
+
+    int withoutBaselines = encodeScene(tree, NULL);
+    int firstScene = encodeScene(tree, &baselines);
+    QCOMPARE(firstScene, withoutBaselines);
+    QCOMPARE(baselines.getItemCount(), ENTITIES);
+    QCOMPARE(baselines.getTotalBytesSaved(), (quint64)0);
+
+    // nothing changed, so none of the entities are sent again
+    OctreeSceneStats unchangedStats;
+    int unchangedScene = encodeScene(tree, &baselines, &unchangedStats);
+    QVERIFY(unchangedScene < firstScene / 10);
+    QVERIFY(unchangedStats.getUnchangedPropertiesSkipped() > 0);
+    QVERIFY(unchangedStats.getUnchangedPropertyBytesSaved() > (quint64)(firstScene - unchangedScene) / 2);
+
+    // a moved entity is sent with its new position only
+    entities[0]->setPosition(entities[0]->getPosition() + glm::vec3(1.0f, 0.0f, 0.0f));
+    OctreeSceneStats movedStats;
+    int movedScene = encodeScene(tree, &baselines, &movedStats);
+    QVERIFY(movedScene > unchangedScene);
+    QVERIFY(movedScene < unchangedScene + (firstScene - unchangedScene) / ENTITIES);
+    QCOMPARE(movedStats.getUnchangedPropertiesSkipped(), unchangedStats.getUnchangedPropertiesSkipped() - 1);
+
+    // once it was sent, the new position is the baseline
+    QCOMPARE(encodeScene(tree, &baselines), unchangedScene);
+
+    // after a change of simulation owner everything is sent again
+    SimulationOwner owner(QUuid::createUuid(), VOLUNTEER_SIMULATION_PRIORITY);
+    entities[1]->setSimulationOwner(owner);
+    int ownerScene = encodeScene(tree, &baselines);
+    QVERIFY(ownerScene > unchangedScene + (firstScene - unchangedScene) / ENTITIES);
+
+    // and a forgotten entity is sent whole
+    baselines.forgetItem(entities[2]->getEntityItemID());
+    QVERIFY(encodeScene(tree, &baselines) > unchangedScene + (firstScene - unchangedScene) / ENTITIES);
+}
+
+void OctreeClientBaselinesTests::uncommittedPropertiesAreResent() {
+    EntityTree tree;
+    QVector<EntityItemPointer> entities = addEntities(tree, 100);
+    OctreeClientBaselines baselines;
+
+    // packets that were never written out to the client don't count
+    int firstScene = encodeScene(tree, &baselines, NULL, false);
+    QCOMPARE(baselines.getItemCount(), 0);
+    QCOMPARE(encodeScene(tree, &baselines), firstScene);
+    QVERIFY(encodeScene(tree, &baselines) < firstScene);
+
+    baselines.reset();
+    QCOMPARE(encodeScene(tree, &baselines), firstScene);
+}
+
+void OctreeClientBaselinesTests::recordOnlyEncodesEverything() {
+    EntityTree tree;
+    QVector<EntityItemPointer> entities = addEntities(tree, 100);
+    OctreeClientBaselines baselines;
+
+    int firstScene = encodeScene(tree, &baselines);
+    baselines.setRecordOnly(true);
+    QCOMPARE(encodeScene(tree, &baselines), firstScene);
+
+    // but what was sent while recording is still a baseline
+    baselines.setRecordOnly(false);
+    QVERIFY(encodeScene(tree, &baselines) < firstScene / 10);
+}
+
+void OctreeClientBaselinesTests::editedAndOwnedItemsAreSentWhole() {
+    const int ENTITIES = 100;
+
+    EntityTree tree;
+    QVector<EntityItemPointer> entities = addEntities(tree, ENTITIES);
+    OctreeClientBaselines baselines;
+    baselines.setClientID(QUuid::createUuid());
+
+    int firstScene = encodeScene(tree, &baselines);
+    int unchangedScene = encodeScene(tree, &baselines);
+    int wholeEntity = (firstScene - unchangedScene) / ENTITIES;
+
+    // an item the client edited is forgotten before the next item is encoded
+    baselines.forgetItemLater(entities[0]->getEntityItemID());
+    QVERIFY(encodeScene(tree, &baselines) > unchangedScene + wholeEntity);
+    QCOMPARE(encodeScene(tree, &baselines), unchangedScene);
+
+    // while the client owns an entity's simulation, the entity is sent whole every time
+    SimulationOwner owner(baselines.getClientID(), VOLUNTEER_SIMULATION_PRIORITY);
+    entities[1]->setSimulationOwner(owner);
+    encodeScene(tree, &baselines);
+    QVERIFY(encodeScene(tree, &baselines) > unchangedScene + wholeEntity);
+    QVERIFY(encodeScene(tree, &baselines) > unchangedScene + wholeEntity);
+}
+
+void OctreeClientBaselinesTests::benchmarkMovingEntities() {
+    const int ENTITIES = 5000;
+    const int SCENES = 10;
+    const int MOVING_ENTITIES = ENTITIES / 10;
+
+    EntityTree tree;
+    QVector<EntityItemPointer> entities = addEntities(tree, ENTITIES);
+    OctreeClientBaselines baselines;
+    encodeScene(tree, &baselines);
+
+    int bytesWithoutBaselines = 0;
+    int bytesWithBaselines = 0;
+    quint64 timeWithoutBaselines = 0;
+    quint64 timeWithBaselines = 0;
+    for (int i = 0; i < SCENES; i++) {
+        for (int j = 0; j < MOVING_ENTITIES; j++) {
+            EntityItemPointer entity = entities[(i * MOVING_ENTITIES + j) % ENTITIES];
+            entity->setPosition(entity->getPosition() + glm::vec3(0.01f, 0.0f, 0.0f));
+        }
+        quint64 start = usecTimestampNow();
+        bytesWithoutBaselines += encodeScene(tree, NULL);
+        timeWithoutBaselines += usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        bytesWithBaselines += encodeScene(tree, &baselines);
+        timeWithBaselines += usecTimestampNow() - start;
+    }
+
+    qDebug() << "TIME - encoding" << ENTITIES << "entities with" << MOVING_ENTITIES << "moving, without baselines:"
+             << (float)timeWithoutBaselines / SCENES / USECS_PER_MSEC << "msecs," << bytesWithoutBaselines / SCENES
+             << "bytes per scene";
+    qDebug() << "TIME - encoding" << ENTITIES << "entities with" << MOVING_ENTITIES << "moving, with baselines:"
+             << (float)timeWithBaselines / SCENES / USECS_PER_MSEC << "msecs," << bytesWithBaselines / SCENES
+             << "bytes per scene," << baselines.getTotalBytesSaved() << "bytes saved in all";
+}
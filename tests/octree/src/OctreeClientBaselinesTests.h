@@ -0,0 +1,30 @@
+//
+//  OctreeClientBaselinesTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeClientBaselinesTests_h
+#define hifi_OctreeClientBaselinesTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeClientBaselinesTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void discardedBytesAreTracked();
+    void unchangedPropertiesAreLeftOut();
+    void uncommittedPropertiesAreResent();
+    void recordOnlyEncodesEverything();
+    void editedAndOwnedItemsAreSentWhole();
+    void benchmarkMovingEntities();
+};
+
+#endif // hifi_OctreeClientBaselinesTests_h
@@ -0,0 +1,162 @@
+//
+//  OctreeEditDecoderTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEditDecoderTests.h"
+
+#include <EntityTree.h>
+#include <NumericalConstants.h>
+#include <OctreeEditDecoder.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(OctreeEditDecoderTests)
+
+const int EDITS_PER_PACKET = 10;
+
+static QVector<EntityItemID> addBoxes(EntityTree& tree, int count) {
+    QVector<EntityItemID> entityIDs;
+    for (int i = 0; i < count; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(glm::vec3(randFloat(), randFloat(), randFloat()) * (TREE_SCALE / 2.0f) + TREE_SCALE / 4.0f);
+        EntityItemID entityID(QUuid::createUuid());
+        tree.addEntity(entityID, properties);
+        entityIDs.push_back(entityID);
+    }
+    return entityIDs;
+}
+
+// the edit messages of one edit packet, each renaming a random entity
+static QByteArray renamePacket(const QVector<EntityItemID>& entityIDs, int packet, QHash<EntityItemID, QString>& names) {
+    QByteArray editData;
+    for (int i = 0; i < EDITS_PER_PACKET; i++) {
+        EntityItemID entityID = entityIDs[randIntInRange(0, entityIDs.size() - 1)];
+        QString name = QString("packet %1 edit %2").arg(packet).arg(i);
+        EntityItemProperties properties;
+        properties.setName(name);
+        properties.setLastEdited(usecTimestampNow());
+
+        QByteArray message(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+        if (EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, entityID, properties, message)) {
+            editData.append(message);
+            names[entityID] = name;
+        }
+    }
+    return editData;
+}
+
+void OctreeEditDecoderTests::initTestCase() {
+    // seed the random number generator so that our tests are reproducible
+    srand(0xFEEDBEEF);
+}
+
+void OctreeEditDecoderTests::decodedEditsApplyLikeMessages() {
+    const int PACKETS = 16;
+
+    EntityTree tree;
+    QVector<EntityItemID> entityIDs = addBoxes(tree, 50);
+
+    QHash<EntityItemID, QString> names;
+    QVector<QByteArray> packets;
+    for (int i = 0; i < PACKETS; i++) {
+        packets.push_back(renamePacket(entityIDs, i, names));
+    }
+
+    OctreeEditDecoder decoder(&tree);
+    for (int i = 0; i < PACKETS; i++) {
+        QCOMPARE(decoder.addPacket(PacketType::EntityEdit, reinterpret_cast<const unsigned char*>(packets[i].constData()),
+                                   packets[i].size()), i);
+    }
+    decoder.decode();
+    QCOMPARE(decoder.getTotalPacketsDecoded(), (quint64)PACKETS);
+    QCOMPARE(decoder.getTotalEditsDecoded(), (quint64)(PACKETS * EDITS_PER_PACKET));
+
+    // applied in packet order, the last rename of each entity wins
+    tree.lockForWrite();
+    for (int i = 0; i < PACKETS; i++) {
+        int decodedBytes;
+        QVector<OctreeDecodedEdit*> edits = decoder.takeEdits(i, decodedBytes);
+        QCOMPARE(edits.size(), EDITS_PER_PACKET);
+        QCOMPARE(decodedBytes, packets[i].size());
+        foreach (OctreeDecodedEdit* edit, edits) {
+            tree.applyDecodedEdit(PacketType::EntityEdit, *edit, SharedNodePointer());
+            delete edit;
+        }
+    }
+    tree.unlock();
+
+    foreach (const EntityItemID& entityID, names.keys()) {
+        QCOMPARE(tree.findEntityByEntityItemID(entityID)->getName(), names[entityID]);
+    }
+
+    // what was not taken is dropped with the batch
+    decoder.clear();
+    QCOMPARE(decoder.getPacketCount(), 0);
+}
+
+void OctreeEditDecoderTests::undecodablePacketsAreLeft() {
+    EntityTree tree;
+    QVector<EntityItemID> entityIDs = addBoxes(tree, 1);
+
+    QByteArray eraseMessage(NLPacket::maxPayloadSize(PacketType::EntityErase), 0);
+    QVERIFY(EntityItemProperties::encodeEraseEntityMessage(entityIDs[0], eraseMessage));
+
+    OctreeEditDecoder decoder(&tree);
+    int packet = decoder.addPacket(PacketType::EntityErase, reinterpret_cast<const unsigned char*>(eraseMessage.constData()),
+                                   eraseMessage.size());
+    decoder.decode();
+
+    int decodedBytes = -1;
+    QVERIFY(decoder.takeEdits(packet, decodedBytes).isEmpty());
+    QCOMPARE(decodedBytes, 0);
+    QVERIFY(tree.findEntityByEntityItemID(entityIDs[0]));
+}
+
+void OctreeEditDecoderTests::benchmarkEditDecoding() {
+    const int PACKETS = 256;
+
+    EntityTree tree;
+    QVector<EntityItemID> entityIDs = addBoxes(tree, 1000);
+    QHash<EntityItemID, QString> names;
+    QVector<QByteArray> packets;
+    for (int i = 0; i < PACKETS; i++) {
+        packets.push_back(renamePacket(entityIDs, i, names));
+    }
+
+    // one message after the other on this thread, as the server used to
+    quint64 start = usecTimestampNow();
+    int serialEdits = 0;
+    foreach (const QByteArray& packet, packets) {
+        int offset = 0;
+        while (offset < packet.size()) {
+            int processedBytes;
+            OctreeDecodedEdit* edit = tree.decodeEditPacketData(PacketType::EntityEdit,
+                reinterpret_cast<const unsigned char*>(packet.constData()) + offset, packet.size() - offset, processedBytes);
+            delete edit;
+            offset += processedBytes;
+            serialEdits++;
+        }
+    }
+    quint64 serialTime = usecTimestampNow() - start;
+
+    OctreeEditDecoder decoder(&tree);
+    start = usecTimestampNow();
+    foreach (const QByteArray& packet, packets) {
+        decoder.addPacket(PacketType::EntityEdit, reinterpret_cast<const unsigned char*>(packet.constData()), packet.size());
+    }
+    decoder.decode();
+    quint64 parallelTime = usecTimestampNow() - start;
+    QCOMPARE(decoder.getTotalEditsDecoded(), (quint64)serialEdits);
+
+    qDebug() << "TIME - decoding" << serialEdits << "edits in" << PACKETS << "packets one at a time:"
+             << (float)serialTime / USECS_PER_MSEC << "msecs";
+    qDebug() << "TIME - decoding" << serialEdits << "edits in" << PACKETS << "packets on"
+             << QThreadPool::globalInstance()->maxThreadCount() << "threads:" << (float)parallelTime / USECS_PER_MSEC
+             << "msecs";
+}
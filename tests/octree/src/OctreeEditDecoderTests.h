@@ -0,0 +1,27 @@
+//
+//  OctreeEditDecoderTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditDecoderTests_h
+#define hifi_OctreeEditDecoderTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeEditDecoderTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void decodedEditsApplyLikeMessages();
+    void undecodablePacketsAreLeft();
+    void benchmarkEditDecoding();
+};
+
+#endif // hifi_OctreeEditDecoderTests_h
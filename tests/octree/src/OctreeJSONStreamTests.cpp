@@ -0,0 +1,142 @@
+//
+//  OctreeJSONStreamTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeJSONStreamTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <AACube.h>
+#include <EntityTree.h>
+#include <Gzip.h>
+#include <JSONArraySplitter.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(OctreeJSONStreamTests)
+
+static void populateTree(EntityTree& tree, int entityCount) {
+    for (int i = 0; i < entityCount; i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setName(QString("entity %1").arg(i));
+        properties.setPosition(glm::vec3(randFloat(), randFloat(), randFloat()) * (TREE_SCALE / 2.0f) + TREE_SCALE / 4.0f);
+        tree.addEntity(EntityItemID(QUuid::createUuid()), properties);
+    }
+}
+
+static QMap<QUuid, QString> entityNames(EntityTree& tree) {
+    QVector<EntityItemPointer> entities;
+    tree.findEntities(AACube(glm::vec3(0.0f), (float)TREE_SCALE), entities);
+    QMap<QUuid, QString> names;
+    foreach (EntityItemPointer entity, entities) {
+        names.insert(entity->getEntityItemID(), entity->getName());
+    }
+    return names;
+}
+
+void OctreeJSONStreamTests::splitterFollowsStringsAcrossChunks() {
+    QByteArray document = "{ \"Other\": [ { \"a\": 1 } ], \"Entities\": [ { \"name\": \"} ] \\\" {\", \"list\": [ {}, [] ] },"
+                          "{ \"id\": 2 } ], \"Version\": 3 }";
+
+    // one byte at a time, so that every element spans many appends
+    JSONArraySplitter splitter("Entities");
+    QVector<QByteArray> elements;
+    for (int i = 0; i < document.size(); i++) {
+        QVERIFY(splitter.append(document.mid(i, 1), elements));
+    }
+    QVERIFY(splitter.isAtEnd());
+    QCOMPARE(elements.size(), 2);
+    QCOMPARE(elements[0], QByteArray("{ \"name\": \"} ] \\\" {\", \"list\": [ {}, [] ] }"));
+    QCOMPARE(elements[1], QByteArray("{ \"id\": 2 }"));
+
+    JSONArraySplitter malformedSplitter("Entities");
+    QVERIFY(!malformedSplitter.append("[ { \"id\": 1 } ]", elements));
+}
+
+void OctreeJSONStreamTests::gzippedJSONRoundTrip() {
+    const int ENTITIES = 2500; // more than one batch
+
+    QTemporaryDir directory;
+    QString fileName = directory.path() + "/models.json.gz";
+
+    EntityTree tree;
+    populateTree(tree, ENTITIES);
+    tree.writeToFile(qPrintable(fileName), NULL, "json.gz");
+
+    EntityTree loadedTree;
+    QVERIFY(loadedTree.readFromFile(qPrintable(fileName)));
+    QCOMPARE(loadedTree.getLastJSONReadEntityCount(), ENTITIES);
+    QCOMPARE(entityNames(loadedTree), entityNames(tree));
+
+    // every entity lands in the element addEntity() would have put it in
+    QVector<EntityItemPointer> loadedEntities;
+    loadedTree.findEntities(AACube(glm::vec3(0.0f), (float)TREE_SCALE), loadedEntities);
+    foreach (EntityItemPointer entity, loadedEntities) {
+        QCOMPARE(loadedTree.getContainingElement(entity->getEntityItemID())->getAACube(),
+                 tree.getContainingElement(entity->getEntityItemID())->getAACube());
+    }
+}
+
+void OctreeJSONStreamTests::gzipTrailerInLaterChunk() {
+    // random data after the entities barely compresses, so the gzip stream goes on for chunks after the array ends
+    QByteArray padding;
+    for (int i = 0; i < 256 * 1024; i++) {
+        padding.append((char)('a' + randIntInRange(0, 25)));
+    }
+    QByteArray document = "{ \"Entities\": [ { \"type\": \"Box\", \"name\": \"entity\" } ], \"Padding\": \"" +
+                          padding + "\" }";
+    QByteArray gzippedDocument;
+    QVERIFY(gzip(document, gzippedDocument));
+
+    QTemporaryDir directory;
+    QString fileName = directory.path() + "/models.json.gz";
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(gzippedDocument);
+    file.close();
+
+    EntityTree loadedTree;
+    QVERIFY(loadedTree.readFromFile(qPrintable(fileName)));
+    QCOMPARE(loadedTree.getLastJSONReadEntityCount(), 1);
+}
+
+void OctreeJSONStreamTests::truncatedJSONFails() {
+    // the file stops after a complete entity, before the array and the top level object are closed
+    QByteArray document = "{ \"Entities\": [ { \"type\": \"Box\", \"name\": \"entity\" }, { \"type\": \"Sph";
+
+    QTemporaryDir directory;
+    QString fileName = directory.path() + "/models.json";
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(document);
+    file.close();
+
+    EntityTree loadedTree;
+    QVERIFY(!loadedTree.readFromFile(qPrintable(fileName)));
+}
+
+void OctreeJSONStreamTests::benchmarkJSONLoad() {
+    const int ENTITIES = 20000;
+
+    QTemporaryDir directory;
+    QString fileName = directory.path() + "/models.json.gz";
+
+    EntityTree tree;
+    populateTree(tree, ENTITIES);
+    tree.writeToFile(qPrintable(fileName), NULL, "json.gz");
+
+    EntityTree loadedTree;
+    quint64 start = usecTimestampNow();
+    QVERIFY(loadedTree.readFromFile(qPrintable(fileName)));
+    quint64 elapsed = usecTimestampNow() - start;
+
+    qDebug() << "TIME - loading" << ENTITIES << "entities from json.gz:" << (float)elapsed / USECS_PER_MSEC << "msecs,"
+             << loadedTree.getLastJSONReadEntitiesPerSecond() << "entities/sec";
+}
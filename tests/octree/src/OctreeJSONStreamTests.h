@@ -0,0 +1,27 @@
+//
+//  OctreeJSONStreamTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeJSONStreamTests_h
+#define hifi_OctreeJSONStreamTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeJSONStreamTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void splitterFollowsStringsAcrossChunks();
+    void gzippedJSONRoundTrip();
+    void gzipTrailerInLaterChunk();
+    void truncatedJSONFails();
+    void benchmarkJSONLoad();
+};
+
+#endif // hifi_OctreeJSONStreamTests_h
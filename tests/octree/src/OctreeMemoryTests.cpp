@@ -0,0 +1,223 @@
+//
+//  OctreeMemoryTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeMemoryTests.h"
+
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <NumericalConstants.h>
+#include <OctreeConstants.h>
+#include <SharedUtil.h>
+#include <SlabAllocator.h>
+
+QTEST_MAIN(OctreeMemoryTests)
+
+// deep enough that most octal codes no longer fit inline in the element
+const float ELEMENT_SCALE = 0.02f;
+const float POPULATED_REGION_SCALE = 100.0f;
+const int NUM_POINTS = 50000;
+
+static bool countElementsOperation(OctreeElement* element, void* extraData) {
+    (*static_cast<int*>(extraData))++;
+    return true;
+}
+
+static void populateTree(EntityTree& tree) {
+    const float REGION_CORNER = TREE_SCALE / 2.0f;
+    for (int i = 0; i < NUM_POINTS; i++) {
+        tree.getOrCreateChildElementAt(REGION_CORNER + randFloat() * POPULATED_REGION_SCALE,
+                                       REGION_CORNER + randFloat() * POPULATED_REGION_SCALE,
+                                       REGION_CORNER + randFloat() * POPULATED_REGION_SCALE, ELEMENT_SCALE);
+    }
+}
+
+static bool collectElementsOperation(OctreeElement* element, void* extraData) {
+    static_cast<QVector<OctreeElement*>*>(extraData)->push_back(element);
+    return true;
+}
+
+static void collectElementsRecursively(OctreeElement* element, QVector<OctreeElement*>& elements) {
+    elements.push_back(element);
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElement* child = element->getChildAtIndex(i);
+        if (child) {
+            collectElementsRecursively(child, elements);
+        }
+    }
+}
+
+void OctreeMemoryTests::initTestCase() {
+    // seed the random number generator so that our tests are reproducible
+    srand(0xFEEDBEEF);
+}
+
+void OctreeMemoryTests::slabAllocatorReusesBlocks() {
+    const int NUM_BLOCKS = 1000;
+    const size_t REQUESTED_SIZE = 40;
+
+    SlabAllocator allocator(REQUESTED_SIZE);
+    QCOMPARE(allocator.getBlockSize(), (size_t)48);
+
+    QSet<void*> blocks;
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        void* block = allocator.allocate();
+        QVERIFY(((size_t)block % SlabAllocator::BLOCK_ALIGNMENT) == 0);
+        blocks.insert(block);
+    }
+    QCOMPARE(blocks.size(), NUM_BLOCKS);
+    QCOMPARE(allocator.getBlocksInUse(), (quint64)NUM_BLOCKS);
+    QCOMPARE(allocator.getBytesInUse(), (quint64)NUM_BLOCKS * allocator.getBlockSize());
+
+    quint64 reserved = allocator.getBytesReserved();
+    QVERIFY(reserved >= allocator.getBytesInUse());
+
+    foreach (void* block, blocks) {
+        allocator.deallocate(block);
+    }
+    QCOMPARE(allocator.getBlocksInUse(), (quint64)0);
+
+    // freed blocks are handed out again before any new slab is taken
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        QVERIFY(blocks.contains(allocator.allocate()));
+    }
+    QCOMPARE(allocator.getBytesReserved(), reserved);
+}
+
+void OctreeMemoryTests::memoryUsageReturnsToBaseline() {
+    quint64 baseNodeCount = OctreeElement::getNodeCount();
+    quint64 baseOctreeMemory = OctreeElement::getOctreeMemoryUsage();
+    quint64 baseOctcodeMemory = OctreeElement::getOctcodeMemoryUsage();
+    quint64 baseExternalChildrenMemory = OctreeElement::getExternalChildrenMemoryUsage();
+
+    {
+        EntityTree tree;
+        populateTree(tree);
+
+        QVERIFY(OctreeElement::getNodeCount() > baseNodeCount + NUM_POINTS);
+        QVERIFY(OctreeElement::getOctcodeMemoryUsage() > baseOctcodeMemory);
+        QVERIFY(OctreeElement::getExternalChildrenMemoryUsage() > baseExternalChildrenMemory);
+        QVERIFY(OctreeElement::getPooledMemoryReserved() >= OctreeElement::getTotalMemoryUsage()
+                - baseOctreeMemory - baseOctcodeMemory - baseExternalChildrenMemory);
+
+        // the elements can be found again where they were created
+        OctreeElement* element = tree.getOrCreateChildElementAt(TREE_SCALE / 2.0f, TREE_SCALE / 2.0f, TREE_SCALE / 2.0f,
+                                                                ELEMENT_SCALE);
+        QVERIFY(element->getScale() <= ELEMENT_SCALE);
+        QVERIFY(element->getAACube().contains(glm::vec3(TREE_SCALE / 2.0f)));
+    }
+
+    QCOMPARE((quint64)OctreeElement::getNodeCount(), baseNodeCount);
+    QCOMPARE(OctreeElement::getOctreeMemoryUsage(), baseOctreeMemory);
+    QCOMPARE(OctreeElement::getOctcodeMemoryUsage(), baseOctcodeMemory);
+    QCOMPARE(OctreeElement::getExternalChildrenMemoryUsage(), baseExternalChildrenMemory);
+}
+
+void OctreeMemoryTests::packedChildrenMatchIndexes() {
+    const int NUM_EDITS = 2000;
+
+    EntityTree tree;
+    OctreeElement* root = tree.getRoot();
+    OctreeElement* expected[NUMBER_OF_CHILDREN] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+
+    // add and remove children in random order so that every growing and shrinking case of the packed array gets hit
+    for (int edit = 0; edit < NUM_EDITS; edit++) {
+        int childIndex = randIntInRange(0, NUMBER_OF_CHILDREN - 1);
+        if (expected[childIndex]) {
+            root->deleteChildAtIndex(childIndex);
+            expected[childIndex] = NULL;
+        } else {
+            expected[childIndex] = root->addChildAtIndex(childIndex);
+        }
+
+        int expectedCount = 0;
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            QCOMPARE(root->getChildAtIndex(i), expected[i]);
+            if (expected[i]) {
+                QCOMPARE(root->getChildren()[expectedCount], expected[i]);
+                expectedCount++;
+            }
+        }
+        QCOMPARE(root->getChildCount(), expectedCount);
+    }
+}
+
+void OctreeMemoryTests::walkMatchesRecursiveOrder() {
+    EntityTree tree;
+    populateTree(tree);
+
+    QVector<OctreeElement*> walked;
+    tree.recurseTreeWithOperation(collectElementsOperation, &walked);
+
+    QVector<OctreeElement*> recursed;
+    collectElementsRecursively(tree.getRoot(), recursed);
+
+    QCOMPARE(walked.size(), recursed.size());
+    QVERIFY(walked == recursed);
+}
+
+void OctreeMemoryTests::benchmarkAllocators() {
+    const int NUM_BLOCKS = 1000000;
+    const size_t BLOCK_SIZE = sizeof(EntityTreeElement);
+
+    QVector<void*> blocks(NUM_BLOCKS);
+
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        blocks[i] = ::operator new(BLOCK_SIZE);
+    }
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        ::operator delete(blocks[i]);
+    }
+    quint64 heapTime = usecTimestampNow() - start;
+
+    SlabAllocator allocator(BLOCK_SIZE);
+    start = usecTimestampNow();
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        blocks[i] = allocator.allocate();
+    }
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        allocator.deallocate(blocks[i]);
+    }
+    quint64 slabTime = usecTimestampNow() - start;
+
+    qDebug() << "TIME - heap allocate/free of" << NUM_BLOCKS << BLOCK_SIZE << "byte blocks:"
+             << (float)heapTime / USECS_PER_MSEC << "msecs";
+    qDebug() << "TIME - slab allocate/free of" << NUM_BLOCKS << BLOCK_SIZE << "byte blocks:"
+             << (float)slabTime / USECS_PER_MSEC << "msecs";
+}
+
+void OctreeMemoryTests::benchmarkLoadAndTraversal() {
+    const int TRAVERSALS = 10;
+
+    EntityTree tree;
+
+    quint64 start = usecTimestampNow();
+    populateTree(tree);
+    quint64 loadTime = usecTimestampNow() - start;
+
+    int elementCount = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < TRAVERSALS; i++) {
+        tree.recurseTreeWithOperation(countElementsOperation, &elementCount);
+    }
+    quint64 traversalTime = usecTimestampNow() - start;
+    elementCount /= TRAVERSALS;
+
+    start = usecTimestampNow();
+    tree.eraseAllOctreeElements();
+    quint64 eraseTime = usecTimestampNow() - start;
+
+    qDebug() << "TIME - created" << elementCount << "elements in" << (float)loadTime / USECS_PER_MSEC << "msecs,"
+             << (float)elementCount / ((float)loadTime / USECS_PER_SECOND) << "elements/sec";
+    qDebug() << "TIME - traversed" << elementCount << "elements in"
+             << (float)traversalTime / TRAVERSALS / USECS_PER_MSEC << "msecs";
+    qDebug() << "TIME - erased" << elementCount << "elements in" << (float)eraseTime / USECS_PER_MSEC << "msecs";
+    qDebug() << "pooled memory reserved:" << OctreeElement::getPooledMemoryReserved() << "bytes";
+}
@@ -0,0 +1,30 @@
+//
+//  OctreeMemoryTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeMemoryTests_h
+#define hifi_OctreeMemoryTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeMemoryTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void slabAllocatorReusesBlocks();
+    void memoryUsageReturnsToBaseline();
+    void packedChildrenMatchIndexes();
+    void walkMatchesRecursiveOrder();
+    void benchmarkAllocators();
+    void benchmarkLoadAndTraversal();
+};
+
+#endif // hifi_OctreeMemoryTests_h
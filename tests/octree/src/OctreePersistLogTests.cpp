@@ -0,0 +1,186 @@
+//
+//  OctreePersistLogTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreePersistLogTests.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+
+#include <AACube.h>
+#include <EntityTree.h>
+#include <NumericalConstants.h>
+#include <OctreePersistLog.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(OctreePersistLogTests)
+
+static EntityItemPointer addBox(EntityTree& tree, const QString& name) {
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setName(name);
+    properties.setPosition(glm::vec3(randFloat(), randFloat(), randFloat()) * (TREE_SCALE / 2.0f) + TREE_SCALE / 4.0f);
+    return tree.addEntity(EntityItemID(QUuid::createUuid()), properties);
+}
+
+static void renameEntity(EntityTree& tree, EntityItemPointer entity, const QString& name) {
+    entity->setName(name);
+    tree.entityChanged(entity);
+}
+
+// the names of the entities in the tree by id, enough to tell the state of the tree apart in these tests
+static QMap<QUuid, QString> entityNames(EntityTree& tree) {
+    QVector<EntityItemPointer> entities;
+    tree.findEntities(AACube(glm::vec3(0.0f), (float)TREE_SCALE), entities);
+    QMap<QUuid, QString> names;
+    foreach (EntityItemPointer entity, entities) {
+        names.insert(entity->getEntityItemID(), entity->getName());
+    }
+    return names;
+}
+
+void OctreePersistLogTests::snapshotAndLogRoundTrip() {
+    QTemporaryDir directory;
+    QString snapshotFileName = directory.path() + "/models.bin";
+
+    EntityTree tree;
+    EntityItemPointer kept = addBox(tree, "kept");
+    EntityItemPointer renamed = addBox(tree, "renamed");
+    EntityItemPointer deleted = addBox(tree, "deleted");
+    tree.setTrackPersistChanges(true);
+
+    OctreePersistLog persistLog(&tree, snapshotFileName);
+    QVERIFY(persistLog.writeSnapshot());
+    QCOMPARE(persistLog.getLogRecordCount(), 0);
+
+    renameEntity(tree, renamed, "renamed again");
+    tree.deleteEntity(deleted->getEntityItemID(), true);
+    addBox(tree, "added");
+    QVERIFY(persistLog.appendChanges());
+    QCOMPARE(persistLog.getLogRecordCount(), 3);
+
+    // nothing changed, so nothing is appended
+    QVERIFY(persistLog.appendChanges());
+    QCOMPARE(persistLog.getLogRecordCount(), 3);
+
+    EntityTree loadedTree;
+    OctreePersistLog loadedPersistLog(&loadedTree, snapshotFileName);
+    QVERIFY(loadedPersistLog.load());
+    QCOMPARE(loadedPersistLog.getLogRecordCount(), 3);
+    QCOMPARE(entityNames(loadedTree), entityNames(tree));
+    QCOMPARE(entityNames(loadedTree).size(), 3);
+
+    // readFromFile() goes through the same load for bin files
+    EntityTree readTree;
+    QVERIFY(readTree.readFromFile(qPrintable(snapshotFileName)));
+    QCOMPARE(entityNames(readTree), entityNames(tree));
+}
+
+void OctreePersistLogTests::tornLogRecordIsDropped() {
+    QTemporaryDir directory;
+    QString snapshotFileName = directory.path() + "/models.bin";
+
+    EntityTree tree;
+    EntityItemPointer entity = addBox(tree, "before");
+    tree.setTrackPersistChanges(true);
+
+    OctreePersistLog persistLog(&tree, snapshotFileName);
+    QVERIFY(persistLog.writeSnapshot());
+    renameEntity(tree, entity, "after");
+    QVERIFY(persistLog.appendChanges());
+    qint64 goodLogSize = persistLog.getLogSize();
+
+    // a crash part way through appending the next record
+    {
+        QFile logFile(persistLog.getLogFileName());
+        QVERIFY(logFile.open(QIODevice::Append));
+        logFile.write(QByteArray("\x00\x00\x01\x00\x01partial", 12));
+    }
+
+    EntityTree loadedTree;
+    OctreePersistLog loadedPersistLog(&loadedTree, snapshotFileName);
+    QVERIFY(loadedPersistLog.load());
+    QCOMPARE(loadedPersistLog.getLogSize(), goodLogSize);
+    QCOMPARE(entityNames(loadedTree), entityNames(tree));
+
+    // the next append writes over the torn record, so that the log reads back whole again
+    loadedTree.setTrackPersistChanges(true);
+    addBox(loadedTree, "appended after the crash");
+    QVERIFY(loadedPersistLog.appendChanges());
+    QCOMPARE(loadedPersistLog.getLogRecordCount(), 2);
+
+    EntityTree reloadedTree;
+    OctreePersistLog reloadedPersistLog(&reloadedTree, snapshotFileName);
+    QVERIFY(reloadedPersistLog.load());
+    QCOMPARE(reloadedPersistLog.getLogSize(), QFileInfo(persistLog.getLogFileName()).size());
+    QCOMPARE(entityNames(reloadedTree), entityNames(loadedTree));
+}
+
+void OctreePersistLogTests::logOfOlderSnapshotIsIgnored() {
+    QTemporaryDir directory;
+    QString snapshotFileName = directory.path() + "/models.bin";
+
+    EntityTree tree;
+    EntityItemPointer entity = addBox(tree, "first");
+    tree.setTrackPersistChanges(true);
+
+    OctreePersistLog persistLog(&tree, snapshotFileName);
+    QVERIFY(persistLog.writeSnapshot());
+    renameEntity(tree, entity, "second");
+    QVERIFY(persistLog.appendChanges());
+    QString olderLogFileName = persistLog.getLogFileName() + ".older";
+    QVERIFY(QFile::copy(persistLog.getLogFileName(), olderLogFileName));
+
+    // a crash after the new snapshot was written but before its log was started
+    renameEntity(tree, entity, "third");
+    QVERIFY(persistLog.writeSnapshot());
+    QVERIFY(QFile::remove(persistLog.getLogFileName()));
+    QVERIFY(QFile::rename(olderLogFileName, persistLog.getLogFileName()));
+
+    EntityTree loadedTree;
+    OctreePersistLog loadedPersistLog(&loadedTree, snapshotFileName);
+    QVERIFY(loadedPersistLog.load());
+    QCOMPARE(loadedPersistLog.getLogRecordCount(), 0);
+    QCOMPARE(entityNames(loadedTree).value(entity->getEntityItemID()), QString("third"));
+}
+
+void OctreePersistLogTests::benchmarkPersist() {
+    const int ENTITIES = 5000;
+    const int CHANGED_ENTITIES = 50;
+
+    QTemporaryDir directory;
+    EntityTree tree;
+    QVector<EntityItemPointer> entities;
+    for (int i = 0; i < ENTITIES; i++) {
+        entities.push_back(addBox(tree, QString("entity %1").arg(i)));
+    }
+    tree.setTrackPersistChanges(true);
+
+    quint64 start = usecTimestampNow();
+    tree.writeToFile(qPrintable(directory.path() + "/models.json.gz"), NULL, "json.gz");
+    quint64 jsonTime = usecTimestampNow() - start;
+
+    OctreePersistLog persistLog(&tree, directory.path() + "/models.bin");
+    start = usecTimestampNow();
+    QVERIFY(persistLog.writeSnapshot());
+    quint64 snapshotTime = usecTimestampNow() - start;
+
+    for (int i = 0; i < CHANGED_ENTITIES; i++) {
+        renameEntity(tree, entities[i], "changed");
+    }
+    start = usecTimestampNow();
+    QVERIFY(persistLog.appendChanges());
+    quint64 appendTime = usecTimestampNow() - start;
+
+    qDebug() << "TIME - persisting" << ENTITIES << "entities as json.gz:" << (float)jsonTime / USECS_PER_MSEC << "msecs";
+    qDebug() << "TIME - writing a snapshot of" << ENTITIES << "entities:" << (float)snapshotTime / USECS_PER_MSEC
+             << "msecs," << persistLog.getSnapshotSize() << "bytes";
+    qDebug() << "TIME - appending" << CHANGED_ENTITIES << "changed entities to the log:"
+             << (float)appendTime / USECS_PER_MSEC << "msecs," << persistLog.getLogSize() << "bytes";
+}
@@ -0,0 +1,26 @@
+//
+//  OctreePersistLogTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreePersistLogTests_h
+#define hifi_OctreePersistLogTests_h
+
+#include <QtTest/QtTest>
+
+class OctreePersistLogTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void snapshotAndLogRoundTrip();
+    void tornLogRecordIsDropped();
+    void logOfOlderSnapshotIsIgnored();
+    void benchmarkPersist();
+};
+
+#endif // hifi_OctreePersistLogTests_h
@@ -0,0 +1,184 @@
+//
+//  OctreeVisibleSetTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeVisibleSetTests.h"
+
+#include <QtCore/QThreadPool>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <EntityTree.h>
+#include <NumericalConstants.h>
+#include <Octree.h>
+#include <OctreeConstants.h>
+#include <OctreeVisibleSet.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+QTEST_MAIN(OctreeVisibleSetTests)
+
+const float ELEMENT_SCALE = 0.02f;
+const float POPULATED_REGION_SCALE = 100.0f;
+const float REGION_CORNER = (TREE_SCALE - POPULATED_REGION_SCALE) / 2.0f; // around the center, under every root child
+const int NUM_POINTS = 50000;
+
+static void populateTree(EntityTree& tree) {
+    for (int i = 0; i < NUM_POINTS; i++) {
+        tree.getOrCreateChildElementAt(REGION_CORNER + randFloat() * POPULATED_REGION_SCALE,
+                                       REGION_CORNER + randFloat() * POPULATED_REGION_SCALE,
+                                       REGION_CORNER + randFloat() * POPULATED_REGION_SCALE, ELEMENT_SCALE);
+    }
+}
+
+static bool collectElementsOperation(OctreeElement* element, void* extraData) {
+    static_cast<QVector<OctreeElement*>*>(extraData)->push_back(element);
+    return true;
+}
+
+// looking down -z at the populated region from just outside of it, so that parts of it are out of view and out of LOD
+static void setUpViewFrustum(ViewFrustum& viewFrustum) {
+    viewFrustum.setProjection(glm::perspective(glm::radians(DEFAULT_FIELD_OF_VIEW_DEGREES), 1.0f,
+                                               DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP));
+    viewFrustum.setPosition(glm::vec3(REGION_CORNER + POPULATED_REGION_SCALE / 2.0f,
+                                      REGION_CORNER + POPULATED_REGION_SCALE / 2.0f,
+                                      REGION_CORNER + POPULATED_REGION_SCALE * 1.1f));
+    viewFrustum.setOrientation(glm::quat());
+    viewFrustum.calculate();
+}
+
+// encodes a whole scene the way a send thread does, one packet's worth at a time
+static QByteArray encodeScene(EntityTree& tree, const ViewFrustum& viewFrustum, const OctreeVisibleSet* visibleSet,
+                              int& encodeCalls) {
+    OctreeElementBag bag;
+    OctreeElementExtraEncodeData extraEncodeData;
+    OctreePacketData packetData;
+    QByteArray scene;
+
+    encodeCalls = 0;
+    bag.insert(tree.getRoot());
+    while (!bag.isEmpty()) {
+        OctreeElement* subTree = bag.extract();
+        EncodeBitstreamParams params(INT_MAX, &viewFrustum, WANT_COLOR, WANT_EXISTS_BITS, DONT_CHOP, false,
+                                     IGNORE_VIEW_FRUSTUM, NO_OCCLUSION_CULLING, IGNORE_COVERAGE_MAP, NO_BOUNDARY_ADJUST,
+                                     DEFAULT_OCTREE_SIZE_SCALE, IGNORE_LAST_SENT, true, IGNORE_SCENE_STATS,
+                                     IGNORE_JURISDICTION_MAP, &extraEncodeData, visibleSet);
+        packetData.reset();
+        tree.encodeTreeBitstream(subTree, &packetData, bag, params);
+        scene.append(reinterpret_cast<const char*>(packetData.getUncompressedData()), packetData.getUncompressedSize());
+        encodeCalls++;
+    }
+    tree.releaseSceneEncodeData(&extraEncodeData);
+    return scene;
+}
+
+void OctreeVisibleSetTests::initTestCase() {
+    // seed the random number generator so that our tests are reproducible
+    srand(0xFEEDBEEF);
+}
+
+void OctreeVisibleSetTests::visibleSetMatchesInlineTests() {
+    EntityTree tree;
+    populateTree(tree);
+
+    ViewFrustum viewFrustum;
+    setUpViewFrustum(viewFrustum);
+
+    OctreeVisibleSet visibleSet(viewFrustum, NO_BOUNDARY_ADJUST, DEFAULT_OCTREE_SIZE_SCALE);
+    visibleSet.compute(tree.getRoot());
+    QVERIFY(visibleSet.getSubtreeCount() > 1);
+    QVERIFY(visibleSet.matches(tree.getRoot()->getLastChanged(), viewFrustum, NO_BOUNDARY_ADJUST,
+                               DEFAULT_OCTREE_SIZE_SCALE));
+    QVERIFY(!visibleSet.matches(tree.getRoot()->getLastChanged(), viewFrustum, LOW_RES_MOVING_ADJUST,
+                                DEFAULT_OCTREE_SIZE_SCALE));
+
+    QVector<OctreeElement*> elements;
+    tree.recurseTreeWithOperation(collectElementsOperation, &elements);
+
+    int reached = 0;
+    foreach (OctreeElement* element, elements) {
+        ViewFrustum::location location;
+        bool inLOD, shouldRender;
+        if (!visibleSet.lookup(element, location, inLOD, shouldRender)) {
+            continue;
+        }
+        reached++;
+
+        QCOMPARE(location != ViewFrustum::OUTSIDE, element->isInView(viewFrustum));
+        if (location != ViewFrustum::OUTSIDE) {
+            float boundaryDistance = boundaryDistanceForRenderLevel(element->getLevel() + NO_BOUNDARY_ADJUST,
+                                                                    DEFAULT_OCTREE_SIZE_SCALE);
+            QCOMPARE(inLOD, element->distanceToCamera(viewFrustum) < boundaryDistance);
+            QCOMPARE(shouldRender, element->calculateShouldRender(&viewFrustum, DEFAULT_OCTREE_SIZE_SCALE,
+                                                                  NO_BOUNDARY_ADJUST));
+        }
+    }
+    QCOMPARE(reached, visibleSet.getElementCount());
+
+    // the walk stops where the encoder would, so it must not have visited the whole tree
+    QVERIFY(reached > 1);
+    QVERIFY(reached < elements.size());
+}
+
+void OctreeVisibleSetTests::encodeMatchesWithoutVisibleSet() {
+    EntityTree tree;
+    populateTree(tree);
+
+    ViewFrustum viewFrustum;
+    setUpViewFrustum(viewFrustum);
+
+    int encodeCalls = 0;
+    QByteArray expected = encodeScene(tree, viewFrustum, NULL, encodeCalls);
+    QVERIFY(!expected.isEmpty());
+
+    OctreeVisibleSet visibleSet(viewFrustum, NO_BOUNDARY_ADJUST, DEFAULT_OCTREE_SIZE_SCALE);
+    visibleSet.compute(tree.getRoot());
+
+    int visibleSetEncodeCalls = 0;
+    QByteArray encoded = encodeScene(tree, viewFrustum, &visibleSet, visibleSetEncodeCalls);
+    QCOMPARE(visibleSetEncodeCalls, encodeCalls);
+    QCOMPARE(encoded.size(), expected.size());
+    QVERIFY(encoded == expected);
+}
+
+void OctreeVisibleSetTests::benchmarkFullSceneEncode() {
+    const int SCENES = 5;
+
+    EntityTree tree;
+    populateTree(tree);
+
+    ViewFrustum viewFrustum;
+    setUpViewFrustum(viewFrustum);
+
+    int encodeCalls = 0;
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < SCENES; i++) {
+        encodeScene(tree, viewFrustum, NULL, encodeCalls);
+    }
+    quint64 inlineTime = usecTimestampNow() - start;
+
+    quint64 computeTime = 0;
+    int elementCount = 0;
+    start = usecTimestampNow();
+    for (int i = 0; i < SCENES; i++) {
+        OctreeVisibleSet visibleSet(viewFrustum, NO_BOUNDARY_ADJUST, DEFAULT_OCTREE_SIZE_SCALE);
+        visibleSet.compute(tree.getRoot());
+        computeTime += (quint64)visibleSet.getComputeTime();
+        elementCount = visibleSet.getElementCount();
+        encodeScene(tree, viewFrustum, &visibleSet, encodeCalls);
+    }
+    quint64 visibleSetTime = usecTimestampNow() - start;
+
+    qDebug() << "TIME - full scene of" << encodeCalls << "encode calls with inline view tests:"
+             << (float)inlineTime / SCENES / USECS_PER_MSEC << "msecs";
+    qDebug() << "TIME - full scene with a visible set of" << elementCount << "elements:"
+             << (float)visibleSetTime / SCENES / USECS_PER_MSEC << "msecs, of which searching"
+             << (float)computeTime / SCENES / USECS_PER_MSEC << "msecs on" << QThreadPool::globalInstance()->maxThreadCount()
+             << "threads";
+}
@@ -0,0 +1,27 @@
+//
+//  OctreeVisibleSetTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeVisibleSetTests_h
+#define hifi_OctreeVisibleSetTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeVisibleSetTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void visibleSetMatchesInlineTests();
+    void encodeMatchesWithoutVisibleSet();
+    void benchmarkFullSceneEncode();
+};
+
+#endif // hifi_OctreeVisibleSetTests_h
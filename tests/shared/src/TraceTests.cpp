@@ -0,0 +1,156 @@
+//
+//  TraceTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TraceTests.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+
+#include <SharedUtil.h>
+#include <Trace.h>
+
+QTEST_MAIN(TraceTests)
+
+static void tracedLeaf() {
+    TRACE_SCOPE("TraceTests::leaf");
+}
+
+static void tracedParent() {
+    TRACE_SCOPE("TraceTests::parent");
+    tracedLeaf();
+    tracedLeaf();
+}
+
+class TracedThread : public QThread {
+protected:
+    virtual void run() {
+        tracedParent();
+    }
+};
+
+static QJsonArray exportedEvents(const char* phase) {
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(Trace::toChromeTraceJSON(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qDebug() << "trace is not valid JSON:" << error.errorString();
+        return QJsonArray();
+    }
+
+    QJsonArray events;
+    foreach (const QJsonValue& event, document.object()["traceEvents"].toArray()) {
+        if (event.toObject()["ph"].toString() == phase) {
+            events.append(event);
+        }
+    }
+    return events;
+}
+
+void TraceTests::init() {
+    Trace::clear();
+}
+
+void TraceTests::cleanup() {
+    Trace::setEnabled(false);
+}
+
+void TraceTests::disabledRecordsNothing() {
+    Trace::setEnabled(false);
+    tracedParent();
+    QCOMPARE(Trace::getRecordedEventCount(), (quint64)0);
+    QCOMPARE(exportedEvents("X").size(), 0);
+}
+
+void TraceTests::nestedScopesExport() {
+    Trace::setEnabled(true);
+    tracedParent();
+    Trace::setEnabled(false);
+
+    QJsonArray events = exportedEvents("X");
+    QCOMPARE(events.size(), 3);
+
+    // scopes are recorded as they end, so the parent comes last and covers both leaves
+    QJsonObject parent = events[2].toObject();
+    QCOMPARE(parent["name"].toString(), QString("TraceTests::parent"));
+    double parentStart = parent["ts"].toDouble();
+    double parentEnd = parentStart + parent["dur"].toDouble();
+
+    for (int i = 0; i < 2; i++) {
+        QJsonObject leaf = events[i].toObject();
+        QCOMPARE(leaf["name"].toString(), QString("TraceTests::leaf"));
+        QCOMPARE(leaf["tid"].toInt(), parent["tid"].toInt());
+        QVERIFY(leaf["ts"].toDouble() >= parentStart);
+        QVERIFY(leaf["ts"].toDouble() + leaf["dur"].toDouble() <= parentEnd);
+    }
+}
+
+void TraceTests::threadsGetTheirOwnBuffers() {
+    Trace::setEnabled(true);
+    tracedParent();
+
+    TracedThread thread;
+    thread.setObjectName("traced thread");
+    thread.start();
+    thread.wait();
+    Trace::setEnabled(false);
+
+    // the events of a thread that has exited are still exported
+    QJsonArray events = exportedEvents("X");
+    QCOMPARE(events.size(), 6);
+    QVERIFY(events[0].toObject()["tid"].toInt() != events[5].toObject()["tid"].toInt());
+
+    bool foundThreadName = false;
+    foreach (const QJsonValue& metadata, exportedEvents("M")) {
+        if (metadata.toObject()["args"].toObject()["name"].toString() == "traced thread") {
+            foundThreadName = true;
+        }
+    }
+    QVERIFY(foundThreadName);
+}
+
+void TraceTests::ringBufferKeepsNewestEvents() {
+    Trace::setEnabled(true);
+    for (int i = 0; i < Trace::EVENTS_PER_THREAD + 100; i++) {
+        tracedLeaf();
+    }
+    tracedParent();
+    Trace::setEnabled(false);
+
+    QCOMPARE(Trace::getRecordedEventCount(), (quint64)Trace::EVENTS_PER_THREAD);
+
+    // the exporter leaves out a few of the oldest events in case they are being overwritten
+    QJsonArray events = exportedEvents("X");
+    QVERIFY(events.size() > Trace::EVENTS_PER_THREAD - 100);
+    QVERIFY(events.size() <= Trace::EVENTS_PER_THREAD);
+    QCOMPARE(events[events.size() - 1].toObject()["name"].toString(), QString("TraceTests::parent"));
+}
+
+void TraceTests::benchmarkScopes() {
+    const int TEST_ITERATIONS = 1000000;
+
+    Trace::setEnabled(false);
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < TEST_ITERATIONS; i++) {
+        tracedLeaf();
+    }
+    quint64 disabledTime = usecTimestampNow() - start;
+
+    Trace::setEnabled(true);
+    start = usecTimestampNow();
+    for (int i = 0; i < TEST_ITERATIONS; i++) {
+        tracedLeaf();
+    }
+    quint64 enabledTime = usecTimestampNow() - start;
+    Trace::setEnabled(false);
+
+    qDebug() << "TIME - disabled TRACE_SCOPE:" << (float)disabledTime * 1000.0f / TEST_ITERATIONS << "nsecs";
+    qDebug() << "TIME - enabled TRACE_SCOPE:" << (float)enabledTime * 1000.0f / TEST_ITERATIONS << "nsecs";
+}